@@ -31,6 +31,10 @@ function (lite_deps TARGET)
     foreach(var ${lite_deps_X86_DEPS})
       set(deps ${deps} ${var})
     endforeach(var)
+    # The targets depending on the arm cv library use its x86 build.
+    if(LITE_WITH_CV AND lite_deps_CV_DEPS)
+      set(deps ${deps} paddle_cv_x86)
+    endif()
   endif()
 
   if(LITE_WITH_CUDA)
@@ -358,13 +362,8 @@ function(add_kernel TARGET device level)
     endif()
 
 
+    # The host kernels are compiled in opt too, they fold the constants.
     if ("${device}" STREQUAL "Host")
-       if (LITE_ON_MODEL_OPTIMIZE_TOOL)
-            foreach(src ${args_SRCS})
-                file(APPEND ${fake_kernels_src_list} "${CMAKE_CURRENT_SOURCE_DIR}/${src}\n")
-            endforeach()
-            return()
-        endif()
         set(host_kernels "${host_kernels};${TARGET}" CACHE INTERNAL "")
     endif()
     if ("${device}" STREQUAL "ARM")
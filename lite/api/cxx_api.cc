@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "lite/api/paddle_use_passes.h"
+#include "lite/utils/env.h"
 #include "lite/utils/io.h"
 
 namespace paddle {
@@ -31,19 +32,52 @@ std::vector<std::string> GetAllOps() {
   return OpLiteFactory::Global().GetAllOps();
 }
 
+namespace {
+
+// Sets the attr 'prepacked_only' of the ops reading the packed weights which
+// replace their original weights.
+void MarkPrepackedOnly(const std::set<std::string>& prepacked_only,
+                       cpp::ProgramDesc* program_desc) {
+  if (prepacked_only.empty()) return;
+  for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
+    auto* block_desc = program_desc->GetBlock<cpp::BlockDesc>(i);
+    for (size_t j = 0; j < block_desc->OpsSize(); j++) {
+      auto* op_desc = block_desc->GetOp<cpp::OpDesc>(j);
+      for (auto& arg : op_desc->InputArgumentNames()) {
+        for (auto& name : op_desc->Input(arg)) {
+          if (prepacked_only.count(name)) {
+            op_desc->SetAttr<bool>("prepacked_only", true);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
 void Predictor::SaveModel(const std::string &dir,
                           lite_api::LiteModelType model_type,
                           bool record_info) {
   if (!program_) {
     GenRuntimeProgram();
   }
+  std::set<std::string> prepacked_only;
+  if (GetBoolFromEnv(PREPACK_WEIGHTS)) {
+    program_->AttachPrepackedWeights(&prepacked_only);
+  }
   program_->SaveToProgram(program_desc_);
+  // Only the loaded model releases the original weights replaced by the
+  // packed ones, this predictor and its clones share them with the kernels
+  // which have packed them at runtime.
+  cpp::ProgramDesc saved_desc = *program_desc_;
+  MarkPrepackedOnly(prepacked_only, &saved_desc);
   switch (model_type) {
     case lite_api::LiteModelType::kProtobuf:
-      SaveModelPb(dir, *program_->exec_scope(), *program_desc_.get(), true);
+      SaveModelPb(dir, *program_->exec_scope(), saved_desc, true);
       break;
     case lite_api::LiteModelType::kNaiveBuffer:
-      SaveModelNaive(dir, *program_->exec_scope(), *program_desc_.get());
+      SaveModelNaive(dir, *program_->exec_scope(), saved_desc);
       break;
     default:
       LOG(FATAL) << "Unknown model type";
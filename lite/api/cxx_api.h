@@ -20,6 +20,7 @@
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_api.h"
+#include "lite/core/async_executor.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer.h"
 #include "lite/core/program.h"
@@ -115,6 +116,7 @@ class LITE_API Predictor {
     // runtime_program.
     auto predictor =
         std::make_shared<Predictor>(program_desc_, scope_, valid_places_);
+    CopyRunSettingsTo(predictor.get());
     // step3. Return the result
     return predictor;
   }
@@ -149,12 +151,47 @@ class LITE_API Predictor {
           predictor->exec_scope_->Var(var_name)->GetMutable<Tensor>();
       sub_tensor->CopyDataFrom(*tensor);
     }
+    CopyRunSettingsTo(predictor.get());
     // step4. Return the result
     return predictor;
   }
 
   void GenRuntimeProgram();
 
+  // Run the independent ops concurrently, see
+  // RuntimeProgram::EnableInterOpParallel.
+  void SetInterOpThreads(
+      int threads,
+      int intra_op_threads = 1,
+      lite_api::PowerMode mode = lite_api::LITE_POWER_NO_BIND) {
+    if (!program_generated_) {
+      GenRuntimeProgram();
+    }
+    program_->EnableInterOpParallel(threads, intra_op_threads, mode);
+    inter_op_threads_ = threads;
+    intra_op_threads_ = intra_op_threads;
+    inter_op_mode_ = mode;
+  }
+
+  // Run the ops in the compiled mode, see CompiledProgram.
+  void SetCompiledExecution(bool enable, bool capture = false) {
+    if (!program_generated_) {
+      GenRuntimeProgram();
+    }
+    program_->EnableCompiledMode(enable, capture);
+    compiled_execution_ = enable;
+    graph_capture_ = capture;
+  }
+
+  // Tune the kernels of this predictor, see RuntimeProgram::EnableKernelTuning.
+  void SetKernelTuning(bool enable) {
+    if (!program_generated_) {
+      GenRuntimeProgram();
+    }
+    program_->EnableKernelTuning(enable);
+    kernel_tuning_ = enable;
+  }
+
   // Run the predictor for a single batch of data.
   void Run() {
     if (!program_generated_) {
@@ -204,6 +241,20 @@ class LITE_API Predictor {
   // #endif
 
  private:
+  // The clones run their programs the same way as this predictor.
+  void CopyRunSettingsTo(Predictor* predictor) const {
+    if (kernel_tuning_) {
+      predictor->SetKernelTuning(true);
+    }
+    if (inter_op_threads_ > 1) {
+      predictor->SetInterOpThreads(
+          inter_op_threads_, intra_op_threads_, inter_op_mode_);
+    }
+    if (compiled_execution_) {
+      predictor->SetCompiledExecution(true, graph_capture_);
+    }
+  }
+
   Optimizer optimizer_;
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
   std::shared_ptr<Scope> scope_;
@@ -213,6 +264,12 @@ class LITE_API Predictor {
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
   std::vector<Place> valid_places_;
+  int inter_op_threads_{1};
+  int intra_op_threads_{1};
+  lite_api::PowerMode inter_op_mode_{lite_api::LITE_POWER_NO_BIND};
+  bool compiled_execution_{false};
+  bool graph_capture_{false};
+  bool kernel_tuning_{false};
 };
 
 class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
@@ -264,11 +321,22 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
       bool record_info = false) override;
 
+ protected:
+  void PostTask(const std::function<void()>& task) override {
+    async_tasks_.Post(task);
+  }
+
  private:
   std::shared_ptr<Predictor> raw_predictor_;
   lite_api::CxxConfig config_;
   std::mutex mutex_;
   bool status_is_cloned_;
+  // The x86 threads of the runs of this predictor, the thread pool is shared
+  // by the predictors and may be larger.
+  int x86_threads_{1};
+  // Declared last to wait for the asynchronous runs before the predictor is
+  // destroyed.
+  SerialTaskQueue async_tasks_;
 };
 
 /*
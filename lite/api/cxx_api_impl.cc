@@ -13,11 +13,13 @@
 // limitations under the License.
 
 #include "lite/api/cxx_api.h"
+#include <algorithm>
 #include <memory>
 #include <mutex>  //NOLINT
 #include <string>
 #include "lite/api/paddle_api.h"
 #include "lite/core/device_info.h"
+#include "lite/core/tuning_cache.h"
 #include "lite/core/version.h"
 
 #ifndef LITE_ON_TINY_PUBLISH
@@ -29,6 +31,9 @@
 #include <omp.h>
 #include "lite/backends/x86/mklml.h"
 #endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/thread_pool.h"
+#endif
 namespace paddle {
 namespace lite {
 
@@ -85,16 +90,53 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
   Context<TargetType::kHuaweiAscendNPU>::SetSubgraphModelCacheDir(
       config.subgraph_model_cache_dir());
 #endif
-#if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
-    !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
   int num_threads = config.x86_math_library_num_threads();
   int real_num_threads = num_threads > 1 ? num_threads : 1;
+  auto thread_pool = paddle::lite::x86::ThreadPool::Global();
+  // The pool is shared by all the predictors, its settings are changed only
+  // when the config asks for a different value, so a predictor which keeps
+  // the defaults does not override the others. Binding restarts the workers.
+  int spin_count = config.x86_thread_pool_spin_count();
+  if (spin_count >= 0 && spin_count != thread_pool->spin_count()) {
+    thread_pool->SetSpinCount(spin_count);
+  }
+  if (config.x86_thread_pool_bind_core() && !thread_pool->core_binding()) {
+    thread_pool->SetCoreBinding(true);
+  }
+  thread_pool->ReserveThreads(real_num_threads);
+  x86_threads_ = real_num_threads;
+#ifdef PADDLE_WITH_MKLML
   paddle::lite::x86::MKL_Set_Num_Threads(real_num_threads);
   omp_set_num_threads(real_num_threads);
+#endif
   VLOG(3) << "set_x86_math_library_math_threads() is set successfully and the "
              "number of threads is:"
           << real_num_threads;
 #endif
+  if (config.kernel_tuning() || !config.tuning_cache_file().empty()) {
+    lite::TuningCache::Global().Init(config.tuning_cache_file(),
+                                     config.kernel_tuning());
+  }
+  // The clones get the tuning, inter-op and compiled settings from
+  // Predictor::Clone. The tuning goes first, the inter-op threads take it.
+  if (!status_is_cloned_ && config.kernel_tuning()) {
+    raw_predictor_->SetKernelTuning(true);
+  }
+  int inter_op_threads = config.inter_op_threads();
+  if (!status_is_cloned_ && inter_op_threads > 1) {
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+    int intra_op_threads = real_num_threads / inter_op_threads;
+#else
+    int intra_op_threads = threads_ / inter_op_threads;
+#endif
+    raw_predictor_->SetInterOpThreads(
+        inter_op_threads, std::max(intra_op_threads, 1), mode_);
+  }
+  if (!status_is_cloned_ &&
+      (config.compiled_execution() || config.graph_capture())) {
+    raw_predictor_->SetCompiledExecution(true, config.graph_capture());
+  }
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInput(int i) {
@@ -123,6 +165,9 @@ std::vector<std::string> CxxPaddleApiImpl::GetOutputNames() {
 void CxxPaddleApiImpl::Run() {
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
+#endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  x86::ScopedMaxThreads max_threads(x86_threads_);
 #endif
   raw_predictor_->Run();
 }
@@ -15,6 +15,8 @@
 #include "lite/api/light_api.h"
 #include <algorithm>
 #include <map>
+#include "lite/core/param_store.h"
+#include "lite/utils/env.h"
 
 namespace paddle {
 namespace lite {
@@ -31,6 +33,7 @@ void LightPredictor::Build(const std::string& lite_model_file,
   // For weight quantization of post training, load the int8/16 weights
   // for optimized model, and dequant it to fp32.
   DequantizeWeight();
+  ShareParams();
   BuildRuntimeProgram(program_desc_);
   PrepareFeedFetch();
   program_desc_.reset();
@@ -61,6 +64,7 @@ void LightPredictor::Build(const std::string& model_dir,
   }
 
   DequantizeWeight();
+  ShareParams();
   BuildRuntimeProgram(program_desc_);
   PrepareFeedFetch();
 }
@@ -162,6 +166,20 @@ void LightPredictor::BuildRuntimeProgram(
   program_.reset(new RuntimeProgram(program_desc, exe_scope, kRootBlockIdx));
 }
 
+void LightPredictor::ShareParams() {
+  // Only the light api shares the params, the passes of the full api write
+  // to the weights. It's called after DequantizeWeight for the same reason.
+  if (!GetBoolFromEnv(SHARE_MODEL_PARAMS)) return;
+  for (auto& name : scope_->LocalVarNames()) {
+    auto* var = scope_->FindLocalVar(name);
+    if (!var->IsType<Tensor>()) continue;
+    auto* tensor = var->GetMutable<Tensor>();
+    if (tensor->persistable()) {
+      ParamStore::Global().Share(tensor);
+    }
+  }
+}
+
 void LightPredictor::DequantizeWeight() {
   std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
 #define PROCESS_CONV2D_DATA()                                             \
@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_api.h"
+#include "lite/core/async_executor.h"
 #include "lite/core/context.h"
 #include "lite/core/program.h"
 #include "lite/core/tensor.h"
@@ -64,6 +65,23 @@ class LITE_API LightPredictor {
 
   void Run() { program_->Run(); }
 
+  // Run the independent ops concurrently, see
+  // RuntimeProgram::EnableInterOpParallel.
+  void SetInterOpThreads(
+      int threads,
+      int intra_op_threads = 1,
+      lite_api::PowerMode mode = lite_api::LITE_POWER_NO_BIND) {
+    program_->EnableInterOpParallel(threads, intra_op_threads, mode);
+  }
+
+  // Run the ops in the compiled mode, see CompiledProgram.
+  void SetCompiledExecution(bool enable, bool capture = false) {
+    program_->EnableCompiledMode(enable, capture);
+  }
+
+  // Tune the kernels of this predictor, see RuntimeProgram::EnableKernelTuning.
+  void SetKernelTuning(bool enable) { program_->EnableKernelTuning(enable); }
+
   // Get offset-th col of feed inputs.
   Tensor* GetInput(size_t offset);
   // get input by name.
@@ -99,6 +117,10 @@ class LITE_API LightPredictor {
 
   void DequantizeWeight();
 
+  // Share the identical params with the models loaded before if
+  // 'SHARE_MODEL_PARAMS' is true, see ParamStore.
+  void ShareParams();
+
  private:
   std::shared_ptr<Scope> scope_;
   std::unique_ptr<RuntimeProgram> program_;
@@ -132,8 +154,16 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
 
   void Init(const lite_api::MobileConfig& config);
 
+ protected:
+  void PostTask(const std::function<void()>& task) override {
+    async_tasks_.Post(task);
+  }
+
  private:
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  // Declared last to wait for the asynchronous runs before the predictor is
+  // destroyed.
+  SerialTaskQueue async_tasks_;
 };
 
 }  // namespace lite
@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #include "lite/api/light_api.h"
+#include <algorithm>
 #include <string>
 #include "lite/api/paddle_api.h"
+#include "lite/core/tuning_cache.h"
 #include "lite/core/version.h"
 #include "lite/model_parser/model_parser.h"
 
@@ -36,6 +38,21 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
   }
   mode_ = config.power_mode();
   threads_ = config.threads();
+  if (config.kernel_tuning() || !config.tuning_cache_file().empty()) {
+    lite::TuningCache::Global().Init(config.tuning_cache_file(),
+                                     config.kernel_tuning());
+  }
+  // The tuning goes first, the inter-op threads take it.
+  raw_predictor_->SetKernelTuning(config.kernel_tuning());
+  if (config.inter_op_threads() > 1) {
+    raw_predictor_->SetInterOpThreads(
+        config.inter_op_threads(),
+        std::max(threads_ / config.inter_op_threads(), 1),
+        mode_);
+  }
+  if (config.compiled_execution() || config.graph_capture()) {
+    raw_predictor_->SetCompiledExecution(true, config.graph_capture());
+  }
 
 #ifdef LITE_WITH_NPU
   // Store the model-level configuration into scope for kernels, and use
@@ -15,6 +15,8 @@
 #include "lite/api/light_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <stdlib.h>
+#include "lite/utils/env.h"
 
 DEFINE_string(optimized_model, "", "");
 
@@ -95,5 +97,48 @@ TEST(LightAPI, loadNaiveBuffer) {
   }
 }
 
+TEST(LightAPI, shareParams) {
+  if (FLAGS_optimized_model.empty()) {
+    FLAGS_optimized_model = "lite_naive_model";
+  }
+  setenv(SHARE_MODEL_PARAMS, "true", 1);
+  LightPredictor predictor0(FLAGS_optimized_model, "", "");
+  LightPredictor predictor1(FLAGS_optimized_model, "", "");
+  unsetenv(SHARE_MODEL_PARAMS);
+  LightPredictor predictor2(FLAGS_optimized_model, "", "");
+
+  // The params of the first two predictors share the buffers.
+  int num_params = 0;
+  for (auto& name : predictor0.scope()->LocalVarNames()) {
+    auto* var0 = predictor0.scope()->FindLocalVar(name);
+    if (!var0->IsType<Tensor>() || !var0->Get<Tensor>().persistable()) {
+      continue;
+    }
+    auto& param0 = var0->Get<Tensor>();
+    auto& param1 = predictor1.scope()->FindLocalVar(name)->Get<Tensor>();
+    auto& param2 = predictor2.scope()->FindLocalVar(name)->Get<Tensor>();
+    EXPECT_EQ(param0.raw_data(), param1.raw_data()) << name;
+    EXPECT_NE(param0.raw_data(), param2.raw_data()) << name;
+    num_params++;
+  }
+  EXPECT_GT(num_params, 0);
+
+  std::vector<const float*> outputs;
+  for (auto* predictor : {&predictor0, &predictor1, &predictor2}) {
+    auto* input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(DDim(std::vector<int64_t>({100, 100})));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = i;
+    }
+    predictor->Run();
+    outputs.push_back(predictor->GetOutput(0)->data<float>());
+  }
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(outputs[0][i], outputs[2][i]);
+    EXPECT_EQ(outputs[1][i], outputs[2][i]);
+  }
+}
+
 }  // namespace lite
 }  // namespace paddle
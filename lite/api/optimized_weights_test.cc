@@ -0,0 +1,326 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/utils/env.h"
+
+DEFINE_string(optimized_model_dir,
+              "optimized_weights_test_model",
+              "where the optimized model is saved and reloaded");
+
+namespace paddle {
+namespace lite {
+
+/*
+ * The passes which create or rewrite weights at optimize time must leave
+ * them where the clones, the saved and the reloaded optimized models find
+ * them. Each test builds a small program in memory, optimizes it and checks
+ * the outputs of the predictor, its clone and the reloaded model.
+ */
+class OptimizedWeightsTest : public ::testing::Test {
+ protected:
+  OptimizedWeightsTest() : program_desc_(new cpp::ProgramDesc) {
+    block_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_->SetIdx(0);
+    block_->SetParentIdx(-1);
+    AddVar("feed", cpp::VarDesc::Type::FEED_MINIBATCH, true);
+    AddVar("fetch", cpp::VarDesc::Type::FETCH_LIST, true);
+  }
+
+  void AddVar(const std::string& name,
+              cpp::VarDesc::Type type = cpp::VarDesc::Type::LOD_TENSOR,
+              bool persistable = false) {
+    auto* var = block_->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(type);
+    var->SetDataType(cpp::VarDesc::Type::FP32);
+    var->SetPersistable(persistable);
+  }
+
+  void AddWeight(const std::string& name,
+                 const std::vector<int64_t>& shape,
+                 const std::vector<float>& values) {
+    AddVar(name, cpp::VarDesc::Type::LOD_TENSOR, true);
+    weights_[name] = std::make_pair(shape, values);
+  }
+
+  cpp::OpDesc* AddOp(
+      const std::string& type,
+      const std::map<std::string, std::vector<std::string>>& inputs,
+      const std::map<std::string, std::vector<std::string>>& outputs) {
+    auto* op = block_->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    for (auto& input : inputs) op->SetInput(input.first, input.second);
+    for (auto& output : outputs) op->SetOutput(output.first, output.second);
+    return op;
+  }
+
+  void AddFeed(const std::string& name) {
+    AddVar(name);
+    AddOp("feed", {{"X", {"feed"}}}, {{"Out", {name}}})->SetAttr("col", 0);
+  }
+
+  void AddFetch(const std::string& name) {
+    AddOp("fetch", {{"X", {name}}}, {{"Out", {"fetch"}}})->SetAttr("col", 0);
+  }
+
+  // Builds the predictor with the weights, fills the input and checks the
+  // outputs of the predictor, its clones and the saved and reloaded model.
+  void BuildAndCheck(const std::vector<Place>& places,
+                     const std::vector<int64_t>& input_shape,
+                     const std::vector<float>& input,
+                     const std::vector<float>& expected,
+                     const std::vector<std::string>& removed_op_types) {
+    predictor_.reset(new Predictor);
+    auto& predictor = *predictor_;
+    for (auto& weight : weights_) {
+      auto* tensor = predictor.scope()->Var(weight.first)->GetMutable<Tensor>();
+      tensor->Resize(weight.second.first);
+      auto* data = tensor->mutable_data<float>();
+      for (size_t i = 0; i < weight.second.second.size(); i++) {
+        data[i] = weight.second.second[i];
+      }
+      tensor->set_persistable(true);
+    }
+    predictor.Build(program_desc_, places);
+    for (auto& inst : predictor.runtime_program().instructions()) {
+      for (auto& type : removed_op_types) {
+        EXPECT_NE(const_cast<OpLite*>(inst.op())->Type(), type)
+            << type << " is not optimized away";
+      }
+    }
+
+    // The clone is made before the first run, so it only gets the weights
+    // through the root scope.
+    auto clone = predictor.Clone();
+    Check(&predictor, input_shape, input, expected);
+    Check(clone.get(), input_shape, input, expected);
+
+    // Saving may add weights, e.g. the prepacked ones, they are shared by the
+    // clones made after it.
+    predictor.SaveModel(FLAGS_optimized_model_dir);
+    auto saved_clone = predictor.Clone();
+    Check(saved_clone.get(), input_shape, input, expected);
+    Predictor reloaded;
+    reloaded.Build(FLAGS_optimized_model_dir, "", "", places);
+    Check(&reloaded, input_shape, input, expected);
+  }
+
+  void Check(Predictor* predictor,
+             const std::vector<int64_t>& input_shape,
+             const std::vector<float>& input,
+             const std::vector<float>& expected) {
+    auto* x = predictor->GetInput(0);
+    x->Resize(input_shape);
+    auto* x_data = x->mutable_data<float>();
+    for (size_t i = 0; i < input.size(); i++) {
+      x_data[i] = input[i];
+    }
+    predictor->Run();
+    auto* out = predictor->GetOutput(0);
+    ASSERT_EQ(out->numel(), static_cast<int64_t>(expected.size()));
+    for (size_t i = 0; i < expected.size(); i++) {
+      EXPECT_NEAR(out->data<float>()[i], expected[i], 1e-5);
+    }
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  cpp::BlockDesc* block_{nullptr};
+  std::unique_ptr<Predictor> predictor_;
+  std::map<std::string, std::pair<std::vector<int64_t>, std::vector<float>>>
+      weights_;
+};
+
+#ifdef LITE_WITH_X86
+TEST_F(OptimizedWeightsTest, constant_folding) {
+  // out = x + (w * 2 + 1), the scale of the weight is folded.
+  AddFeed("x");
+  AddWeight("w", {4}, {1.f, 2.f, 3.f, 4.f});
+  AddVar("w_scaled");
+  AddVar("out");
+  auto* scale = AddOp("scale", {{"X", {"w"}}}, {{"Out", {"w_scaled"}}});
+  scale->SetAttr("scale", 2.f);
+  scale->SetAttr("bias", 1.f);
+  scale->SetAttr("bias_after_scale", true);
+  AddOp("elementwise_add",
+        {{"X", {"x"}}, {"Y", {"w_scaled"}}},
+        {{"Out", {"out"}}})
+      ->SetAttr("axis", -1);
+  AddFetch("out");
+
+  BuildAndCheck({Place{TARGET(kX86), PRECISION(kFloat)}},
+                {2, 4},
+                {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f},
+                {3.f, 6.f, 9.f, 12.f, 7.f, 10.f, 13.f, 16.f},
+                {"scale"});
+}
+
+TEST_F(OptimizedWeightsTest, channel_affine) {
+  // out = (x * w) * s * 2 + 0.5, folded into an fc with a new bias.
+  AddFeed("x");
+  AddWeight("w", {2, 3}, {1.f, -2.f, 0.5f, 3.f, 1.f, -1.f});
+  AddWeight("s", {3}, {1.f, -0.5f, 2.f});
+  AddVar("mul_out");
+  AddVar("mul2_out");
+  AddVar("out");
+  auto* mul =
+      AddOp("mul", {{"X", {"x"}}, {"Y", {"w"}}}, {{"Out", {"mul_out"}}});
+  mul->SetAttr("x_num_col_dims", 1);
+  mul->SetAttr("y_num_col_dims", 1);
+  AddOp("elementwise_mul",
+        {{"X", {"mul_out"}}, {"Y", {"s"}}},
+        {{"Out", {"mul2_out"}}})
+      ->SetAttr("axis", -1);
+  auto* scale = AddOp("scale", {{"X", {"mul2_out"}}}, {{"Out", {"out"}}});
+  scale->SetAttr("scale", 2.f);
+  scale->SetAttr("bias", 0.5f);
+  scale->SetAttr("bias_after_scale", true);
+  AddFetch("out");
+
+  std::vector<float> x{1.f, 2.f, -1.f, 0.5f};
+  std::vector<float> expected;
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) {
+      float v = x[i * 2] * weights_["w"].second[j] +
+                x[i * 2 + 1] * weights_["w"].second[3 + j];
+      expected.push_back(v * weights_["s"].second[j] * 2.f + 0.5f);
+    }
+  }
+  BuildAndCheck({Place{TARGET(kX86), PRECISION(kFloat)}},
+                {2, 2},
+                x,
+                expected,
+                {"mul", "elementwise_mul", "scale"});
+}
+
+TEST_F(OptimizedWeightsTest, matmul_fp16) {
+  // out = matmul(matmul(x, x^T), w) with a batched x: only the matmul of the
+  // weight takes the fp16 kernel, the one of two activations stays in fp32.
+  AddFeed("x");
+  AddWeight("w", {2, 3}, {0.5f, -1.f, 2.f, 1.5f, 0.25f, -0.75f});
+  AddVar("xx");
+  AddVar("out");
+  AddOp("matmul", {{"X", {"x"}}, {"Y", {"x"}}}, {{"Out", {"xx"}}})
+      ->SetAttr("transpose_Y", true);
+  AddOp("matmul", {{"X", {"xx"}}, {"Y", {"w"}}}, {{"Out", {"out"}}});
+  AddFetch("out");
+
+  std::vector<Place> places{Place{TARGET(kX86), PRECISION(kFP16)},
+                            Place{TARGET(kX86), PRECISION(kFloat)}};
+  std::vector<float> x{1.f, 2.f, 3.f, 4.f, 0.f, 1.f, -1.f, 2.f};
+  std::vector<float> expected;
+  for (int b = 0; b < 2; b++) {
+    const float* xb = x.data() + b * 4;
+    float xx[4];
+    for (int i = 0; i < 2; i++) {
+      for (int j = 0; j < 2; j++) {
+        xx[i * 2 + j] = xb[i * 2] * xb[j * 2] + xb[i * 2 + 1] * xb[j * 2 + 1];
+      }
+    }
+    for (int i = 0; i < 2; i++) {
+      for (int j = 0; j < 3; j++) {
+        expected.push_back(xx[i * 2] * weights_["w"].second[j] +
+                           xx[i * 2 + 1] * weights_["w"].second[3 + j]);
+      }
+    }
+  }
+  BuildAndCheck(places, {2, 2, 2}, x, expected, {});
+}
+#endif
+
+#ifdef LITE_WITH_ARM
+TEST_F(OptimizedWeightsTest, prepacked_conv) {
+  // A 1x1 conv2d takes the gemm-like kernel, which packs its filter.
+  AddFeed("x");
+  std::vector<float> w(3 * 4);
+  for (size_t i = 0; i < w.size(); i++) {
+    w[i] = 0.25f * static_cast<float>(i) - 1.f;
+  }
+  AddWeight("w", {3, 4, 1, 1}, w);
+  AddVar("out");
+  auto* conv = AddOp("conv2d",
+                     {{"Input", {"x"}}, {"Filter", {"w"}}},
+                     {{"Output", {"out"}}});
+  conv->SetAttr("strides", std::vector<int>{1, 1});
+  conv->SetAttr("paddings", std::vector<int>{0, 0});
+  conv->SetAttr("dilations", std::vector<int>{1, 1});
+  conv->SetAttr("groups", 1);
+  AddFetch("out");
+
+  std::vector<float> x(4 * 2 * 2);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<float>(i % 5) - 2.f;
+  }
+  std::vector<float> expected(3 * 2 * 2, 0.f);
+  for (int oc = 0; oc < 3; oc++) {
+    for (int ic = 0; ic < 4; ic++) {
+      for (int i = 0; i < 4; i++) {
+        expected[oc * 4 + i] += w[oc * 4 + ic] * x[ic * 4 + i];
+      }
+    }
+  }
+  setenv(PREPACK_WEIGHTS, "true", 1);
+  BuildAndCheck({Place{TARGET(kARM), PRECISION(kFloat)}},
+                {1, 4, 2, 2},
+                x,
+                expected,
+                {});
+  unsetenv(PREPACK_WEIGHTS);
+
+  // The packed filter is a weight of the root scope, not of the exec scope.
+  auto* exec_scope =
+      const_cast<RuntimeProgram&>(predictor_->runtime_program()).exec_scope();
+  int num_prepacked = 0;
+  auto* root = predictor_->scope();
+  for (auto& name : root->LocalVarNames()) {
+    if (name.find("w_prepacked_") != 0) continue;
+    EXPECT_TRUE(root->FindVar(name)->Get<Tensor>().persistable());
+    EXPECT_FALSE(exec_scope->FindLocalVar(name));
+    num_prepacked++;
+  }
+  EXPECT_EQ(num_prepacked, 1);
+
+  // The reloaded model runs the 1x1 output on the packed filter as well, and
+  // releases the original filter but keeps its dims.
+  Predictor reloaded;
+  reloaded.Build(FLAGS_optimized_model_dir,
+                 "",
+                 "",
+                 {Place{TARGET(kARM), PRECISION(kFloat)}});
+  std::vector<float> x1(x.begin(), x.begin() + 4);
+  std::vector<float> expected1(3, 0.f);
+  for (int oc = 0; oc < 3; oc++) {
+    for (int ic = 0; ic < 4; ic++) {
+      expected1[oc] += w[oc * 4 + ic] * x1[ic];
+    }
+  }
+  Check(&reloaded, {1, 4, 1, 1}, x1, expected1);
+  auto& filter = reloaded.scope()->FindVar("w")->Get<Tensor>();
+  EXPECT_FALSE(filter.IsInitialized());
+  EXPECT_EQ(filter.dims(), DDim({3, 4, 1, 1}));
+}
+#endif
+
+}  // namespace lite
+}  // namespace paddle
@@ -203,6 +203,42 @@ lod_t Tensor::lod() const { return ctensor(raw_tensor_)->lod(); }
 
 void Tensor::SetLoD(const lod_t &lod) { tensor(raw_tensor_)->set_lod(lod); }
 
+std::future<void> PaddlePredictor::RunAsync() {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  PostTask([this, promise] {
+#ifdef LITE_WITH_EXCEPTION
+    try {
+      Run();
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+      return;
+    }
+#else
+    Run();
+#endif
+    promise->set_value();
+  });
+  return future;
+}
+
+void PaddlePredictor::RunAsync(
+    const std::function<void(std::exception_ptr)> &callback) {
+  PostTask([this, callback] {
+    std::exception_ptr error;
+#ifdef LITE_WITH_EXCEPTION
+    try {
+      Run();
+    } catch (...) {
+      error = std::current_exception();
+    }
+#else
+    Run();
+#endif
+    if (callback) callback(error);
+  });
+}
+
 std::unique_ptr<Tensor> PaddlePredictor::GetMutableTensor(
     const std::string &name) {
   LOG(FATAL)
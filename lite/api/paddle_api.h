@@ -19,6 +19,9 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <exception>
+#include <functional>
+#include <future>  // NOLINT
 #include <memory>
 #include <string>
 #include <utility>
@@ -114,7 +117,23 @@ class LITE_API PaddlePredictor {
 
   virtual ~PaddlePredictor() = default;
 
+  /// Run on an internal thread pool, the future becomes ready once the
+  /// outputs are available. The inputs must not be modified nor the outputs
+  /// read before that. The runs of a predictor are executed in the order they
+  /// are issued, use the clones to pipeline successive requests. The error
+  /// raised by the run is rethrown by `future.get()`.
+  std::future<void> RunAsync();
+  /// Same as above, `callback` is called on the internal thread once the run
+  /// is done, with the error raised by the run or nullptr. It must not throw
+  /// nor destroy the predictor.
+  void RunAsync(const std::function<void(std::exception_ptr)>& callback);
+
  protected:
+  // Run the task on the executor of the asynchronous runs, in place by
+  // default. Declared after the existing virtual functions, so the vtable
+  // layout of the prebuilt clients is unchanged.
+  virtual void PostTask(const std::function<void()>& task) { task(); }
+
   int threads_{1};
   lite_api::PowerMode mode_{lite_api::LITE_POWER_NO_BIND};
 };
@@ -123,6 +142,11 @@ class LITE_API PaddlePredictor {
 class LITE_API ConfigBase {
   std::string model_dir_;
   int threads_{1};
+  int inter_op_threads_{1};
+  bool compiled_execution_{false};
+  bool graph_capture_{false};
+  bool kernel_tuning_{false};
+  std::string tuning_cache_file_{""};
   PowerMode mode_{LITE_POWER_NO_BIND};
   // gpu
   bool enable_opencl_tune_{false};
@@ -138,6 +162,28 @@ class LITE_API ConfigBase {
   // set Thread
   void set_threads(int threads);
   int threads() const { return threads_; }
+  // set the number of threads running independent ops concurrently, the
+  // intra-op threads are shared out among them. CPU only, default 1.
+  void set_inter_op_threads(int threads) { inter_op_threads_ = threads; }
+  int inter_op_threads() const { return inter_op_threads_; }
+  // run the ops in the compiled mode, which skips the shape inference when
+  // the input shapes are unchanged. CPU only, default false.
+  void set_compiled_execution(bool enable) { compiled_execution_ = enable; }
+  bool compiled_execution() const { return compiled_execution_; }
+  // capture the first run and replay it while the input shapes are unchanged,
+  // implies the compiled execution. CPU only, default false.
+  void set_graph_capture(bool enable) { graph_capture_ = enable; }
+  bool graph_capture() const { return graph_capture_; }
+  // time the implementations of the kernels having several ones (e.g. the
+  // arm conv) on the actual shapes and record the fastest, default false.
+  void set_kernel_tuning(bool enable) { kernel_tuning_ = enable; }
+  bool kernel_tuning() const { return kernel_tuning_; }
+  // the file storing the tuning records, which are used at load time even
+  // if the tuning is disabled.
+  void set_tuning_cache_file(const std::string& path) {
+    tuning_cache_file_ = path;
+  }
+  const std::string& tuning_cache_file() const { return tuning_cache_file_; }
   // set Power_mode
   void set_power_mode(PowerMode mode);
   PowerMode power_mode() const { return mode_; }
@@ -165,6 +211,9 @@ class LITE_API CxxConfig : public ConfigBase {
   bool model_from_memory_{false};
 #ifdef LITE_WITH_X86
   int x86_math_library_math_threads_ = 1;
+  // -1 keeps the setting of the pool, see set_x86_thread_pool_spin_count.
+  int x86_thread_pool_spin_count_ = -1;
+  bool x86_thread_pool_bind_core_{false};
 #endif
 #ifdef LITE_WITH_CUDA
   bool multi_stream_{false};
@@ -211,6 +260,22 @@ class LITE_API CxxConfig : public ConfigBase {
   int x86_math_library_num_threads() const {
     return x86_math_library_math_threads_;
   }
+  // Number of busy-wait iterations the idle x86 workers spin before sleeping,
+  // 0 makes them sleep at once. The x86 thread pool is shared by all the
+  // predictors of the process, so this setting is process-wide. When it is
+  // not set, the pool keeps its current value, which starts at
+  // x86::ThreadPool::kDefaultSpinCount.
+  void set_x86_thread_pool_spin_count(int spin_count) {
+    x86_thread_pool_spin_count_ = spin_count;
+  }
+  int x86_thread_pool_spin_count() const { return x86_thread_pool_spin_count_; }
+  // Pin the x86 worker threads to cores (Linux only). It is process-wide
+  // like the spin count: once a predictor binds the shared pool, the pool
+  // stays bound for the other predictors.
+  void set_x86_thread_pool_bind_core(bool bind_core) {
+    x86_thread_pool_bind_core_ = bind_core;
+  }
+  bool x86_thread_pool_bind_core() const { return x86_thread_pool_bind_core_; }
 #endif
 #ifdef LITE_WITH_CUDA
   void set_multi_stream(bool multi_stream) { multi_stream_ = multi_stream; }
@@ -15,6 +15,7 @@
 #include "lite/api/paddle_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <stdexcept>
 #include "lite/api/paddle_use_kernels.h"
 #include "lite/api/paddle_use_ops.h"
 #include "lite/utils/cp_logging.h"
@@ -68,6 +69,82 @@ TEST(CxxApi, run) {
       FLAGS_model_dir + ".opt2.naive", LiteModelType::kNaiveBuffer, true);
 }
 
+TEST(CxxApi, run_async) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto clone = predictor->Clone();
+  for (auto& p : {predictor, clone}) {
+    auto input_tensor = p->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = i;
+    }
+  }
+
+  // Two requests in flight on the predictor and its clone.
+  auto future = predictor->RunAsync();
+  std::promise<void> done;
+  clone->RunAsync([&done](std::exception_ptr error) {
+    EXPECT_FALSE(error);
+    done.set_value();
+  });
+  future.wait();
+  done.get_future().wait();
+
+  for (auto& p : {predictor, clone}) {
+    auto* out = p->GetOutput(0)->data<float>();
+    EXPECT_NEAR(out[0], 50.2132, 1e-3);
+    EXPECT_NEAR(out[1], -28.8729, 1e-3);
+  }
+}
+
+#ifdef LITE_WITH_EXCEPTION
+// A predictor whose runs fail, to check how RunAsync reports the errors.
+class FailingPredictor : public PaddlePredictor {
+ public:
+  std::unique_ptr<Tensor> GetInput(int i) override { return nullptr; }
+  std::unique_ptr<const Tensor> GetOutput(int i) const override {
+    return nullptr;
+  }
+  void Run() override { throw std::runtime_error("kernel failed"); }
+  std::shared_ptr<PaddlePredictor> Clone() override { return nullptr; }
+  std::shared_ptr<PaddlePredictor> Clone(
+      const std::vector<std::string>& var_names) override {
+    return nullptr;
+  }
+  std::string GetVersion() const override { return ""; }
+  std::vector<std::string> GetInputNames() override { return {}; }
+  std::vector<std::string> GetOutputNames() override { return {}; }
+  std::unique_ptr<Tensor> GetInputByName(const std::string& name) override {
+    return nullptr;
+  }
+  std::unique_ptr<const Tensor> GetTensor(
+      const std::string& name) const override {
+    return nullptr;
+  }
+};
+
+TEST(CxxApi, run_async_error) {
+  FailingPredictor predictor;
+  auto future = predictor.RunAsync();
+  EXPECT_THROW(future.get(), std::runtime_error);
+
+  bool called = false;
+  predictor.RunAsync([&called](std::exception_ptr error) {
+    called = true;
+    EXPECT_TRUE(error);
+  });
+  EXPECT_TRUE(called);
+}
+#endif
+
 // Demo1 for Mobile Devices :Load model from file and run
 #ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
 TEST(LightApi, run) {
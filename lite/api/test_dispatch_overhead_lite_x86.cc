@@ -0,0 +1,95 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/lite_api_test_helper.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/api/test_helper.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+void FillInput(Predictor* predictor) {
+  auto* input_tensor = predictor->GetInput(0);
+  input_tensor->Resize(DDim(std::vector<int64_t>({1, 100})));
+  auto* data = input_tensor->mutable_data<float>();
+  for (int i = 0; i < 100; i++) {
+    data[i] = 1;
+  }
+}
+
+// Returns the time spent per op in ns.
+double MeasureDispatch(Predictor* predictor) {
+  for (int i = 0; i < FLAGS_warmup; ++i) {
+    predictor->Run();
+  }
+  auto start = GetCurrentUS();
+  for (int i = 0; i < FLAGS_repeats; ++i) {
+    predictor->Run();
+  }
+  auto num_ops = predictor->runtime_program().instructions().size();
+  return (GetCurrentUS() - start) * 1000.0 / FLAGS_repeats / num_ops;
+}
+
+}  // namespace
+
+// The naive model is tiny, so the time per op is dominated by the framework.
+TEST(DispatchOverhead, test_dispatch_overhead_lite_x86) {
+  std::vector<Place> valid_places({Place{TARGET(kX86), PRECISION(kFloat)},
+                                   Place{TARGET(kHost), PRECISION(kFloat)}});
+  Predictor serial;
+  serial.Build(FLAGS_model_dir, "", "", valid_places);
+  FillInput(&serial);
+  double serial_ns = MeasureDispatch(&serial);
+
+  Predictor compiled;
+  compiled.Build(FLAGS_model_dir, "", "", valid_places);
+  compiled.SetCompiledExecution(true);
+  FillInput(&compiled);
+  double compiled_ns = MeasureDispatch(&compiled);
+
+  LOG(INFO) << "================== Speed Report ===================";
+  LOG(INFO) << "Model: " << FLAGS_model_dir << ", warmup: " << FLAGS_warmup
+            << ", repeats: " << FLAGS_repeats << ", serial: " << serial_ns
+            << " ns/op, compiled: " << compiled_ns << " ns/op";
+
+  auto* serial_out = serial.GetOutput(0);
+  auto* compiled_out = compiled.GetOutput(0);
+  ASSERT_EQ(serial_out->dims(), compiled_out->dims());
+  for (int64_t i = 0; i < serial_out->numel(); i++) {
+    EXPECT_NEAR(
+        serial_out->data<float>()[i], compiled_out->data<float>()[i], 1e-6);
+  }
+
+  // The shape inference runs again once the input shape changes.
+  auto* input_tensor = compiled.GetInput(0);
+  input_tensor->Resize(DDim(std::vector<int64_t>({2, 100})));
+  auto* data = input_tensor->mutable_data<float>();
+  for (int i = 0; i < 200; i++) {
+    data[i] = 1;
+  }
+  compiled.Run();
+  ASSERT_EQ(compiled.GetOutput(0)->dims()[0], 2);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,111 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "lite/api/lite_api_test_helper.h"
+#include "lite/api/paddle_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/api/test_helper.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+std::shared_ptr<lite_api::PaddlePredictor> CreatePredictor(bool capture) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({lite_api::Place{TARGET(kX86), PRECISION(kFloat)},
+                           lite_api::Place{TARGET(kHost), PRECISION(kFloat)}});
+  config.set_graph_capture(capture);
+  return lite_api::CreatePaddlePredictor(config);
+}
+
+void FillInput(lite_api::PaddlePredictor* predictor,
+               const std::vector<int64_t>& shape) {
+  auto input_tensor = predictor->GetInput(0);
+  input_tensor->Resize(shape);
+  auto* data = input_tensor->mutable_data<float>();
+  int64_t num = 1;
+  for (auto d : shape) {
+    num *= d;
+  }
+  for (int64_t i = 0; i < num; i++) {
+    data[i] = static_cast<float>(i % 255) / 255.f;
+  }
+}
+
+// Returns the average latency in ms.
+double Measure(lite_api::PaddlePredictor* predictor) {
+  for (int i = 0; i < FLAGS_warmup; ++i) {
+    predictor->Run();
+  }
+  auto start = GetCurrentUS();
+  for (int i = 0; i < FLAGS_repeats; ++i) {
+    predictor->Run();
+  }
+  return (GetCurrentUS() - start) / FLAGS_repeats / 1000.0;
+}
+
+void ExpectSameOutput(lite_api::PaddlePredictor* a,
+                      lite_api::PaddlePredictor* b) {
+  auto out_a = a->GetOutput(0);
+  auto out_b = b->GetOutput(0);
+  ASSERT_EQ(out_a->shape(), out_b->shape());
+  int64_t num = 1;
+  for (auto d : out_a->shape()) {
+    num *= d;
+  }
+  for (int64_t i = 0; i < num; i++) {
+    EXPECT_NEAR(out_a->data<float>()[i], out_b->data<float>()[i], 1e-5);
+  }
+}
+
+}  // namespace
+
+// Run with the models of fixed input shape, e.g. mobilenet_v1 and resnet50.
+TEST(GraphCapture, test_graph_capture_lite_x86) {
+  std::vector<int64_t> input_shape{1, 3, 224, 224};
+  auto serial = CreatePredictor(false);
+  FillInput(serial.get(), input_shape);
+  double serial_ms = Measure(serial.get());
+
+  auto captured = CreatePredictor(true);
+  FillInput(captured.get(), input_shape);
+  double captured_ms = Measure(captured.get());
+
+  LOG(INFO) << "================== Speed Report ===================";
+  LOG(INFO) << "Model: " << FLAGS_model_dir << ", warmup: " << FLAGS_warmup
+            << ", repeats: " << FLAGS_repeats << ", serial: " << serial_ms
+            << " ms, captured: " << captured_ms << " ms in average.";
+  ExpectSameOutput(serial.get(), captured.get());
+
+  // A new batch size invalidates the capture.
+  std::vector<int64_t> batch_shape{2, 3, 224, 224};
+  FillInput(serial.get(), batch_shape);
+  FillInput(captured.get(), batch_shape);
+  serial->Run();
+  captured->Run();
+  captured->Run();
+  ExpectSameOutput(serial.get(), captured.get());
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cmath>
+#include "lite/backends/host/math/beam_search.h"
 #include "lite/core/context.h"
 
 namespace paddle {
@@ -33,6 +34,7 @@ void beam_search(const Tensor* pre_ids,
                  int beam_size,
                  int end_id,
                  bool is_accumulated,
+                 host::math::BeamSearcher* searcher,
                  Context<TARGET(kARM)>* ctx);
 
 }  // namespace math
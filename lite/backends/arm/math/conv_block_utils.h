@@ -15,6 +15,7 @@
 #pragma once
 #include <arm_neon.h>
 #include <cmath>
+#include <string>
 #include "lite/backends/arm/math/gemm_s8.h"
 #include "lite/backends/arm/math/saturate.h"
 #include "lite/backends/arm/math/sgemm.h"
@@ -72,6 +73,34 @@ inline void trans_gemm_weights<PRECISION(kInt8)>(const Tensor& tin,
   prepackA_int8(&tout, tin, m, k, group, false, ctx);
 }
 
+/*
+ * The layout of the weights packed by trans_gemm_weights, it depends on the
+ * ISA and the row block of the gemm kernel picked for the CPU, so the weights
+ * packed on one device are only reused on the devices with the same tag.
+ */
+template <PrecisionType Ptype>
+inline std::string trans_gemm_weights_tag(ARMContext* ctx);
+
+#ifdef __aarch64__
+#define LITE_GEMM_WEIGHTS_ISA "armv8"
+#else
+#define LITE_GEMM_WEIGHTS_ISA "armv7"
+#endif
+
+template <>
+inline std::string trans_gemm_weights_tag<PRECISION(kFloat)>(ARMContext* ctx) {
+  return std::string("gemm_fp32_") + LITE_GEMM_WEIGHTS_ISA + "_m" +
+         std::to_string(lite::arm::math::get_hblock(ctx));
+}
+
+template <>
+inline std::string trans_gemm_weights_tag<PRECISION(kInt8)>(ARMContext* ctx) {
+  return std::string("gemm_int8_") + LITE_GEMM_WEIGHTS_ISA + "_m" +
+         std::to_string(lite::arm::math::get_hblock_int8(ctx));
+}
+
+#undef LITE_GEMM_WEIGHTS_ISA
+
 inline void fill_packed_biasc4(float* dout, const float* bias, int size) {
   float32x4_t vb = vld1q_f32(bias);
   int cnt = size / 4;
@@ -168,7 +168,8 @@ void conv1x1s1_gemm(const float* i_data,
                     const float* weights,
                     const float* bias,
                     const operators::ConvParam& param,
-                    ARMContext* ctx) {
+                    ARMContext* ctx,
+                    bool force_gemm) {
   int channel_size_out = ow * oh;
   int channel_size_in = win * ih;
 
@@ -185,7 +186,7 @@ void conv1x1s1_gemm(const float* i_data,
   int hblock = get_hblock(ctx);
   int m_roundup = hblock * ((m + hblock - 1) / hblock);
   int weights_size_per_group = m * k;
-  if (n > 1) {
+  if (n > 1 || force_gemm) {
     weights_size_per_group = ((m_roundup * k + 15) / 16) * 16;
   }
   //! use gemv when the output channel size = 1
@@ -200,7 +201,7 @@ void conv1x1s1_gemm(const float* i_data,
           static_cast<const float*>(weights) + g * weights_size_per_group;
       const float* bias_group = static_cast<const float*>(bias) + g * m;
 
-      if (n == 1) {
+      if (n == 1 && !force_gemm) {
         sgemv(weights_group,
               din_group,
               dout_group,
@@ -248,7 +249,8 @@ void conv1x1s1_gemm_int8(const int8_t* i_data,
                          const float* bias,
                          const operators::ConvParam& param,
                          ARMContext* ctx,
-                         const float* scale) {
+                         const float* scale,
+                         bool force_gemm) {
   int group = param.groups;
   int channel_size_out = ow * oh;
   int channel_size_in = win * ih;
@@ -259,7 +261,7 @@ void conv1x1s1_gemm_int8(const int8_t* i_data,
   int k_roundup = ROUNDUP(k, KBLOCK_INT8);
   int m_roundup = ROUNDUP(m, hblock);
   int weights_size_per_group = m * k;
-  if (n > 1) {
+  if (n > 1 || force_gemm) {
     weights_size_per_group = ((m_roundup * k_roundup + 15) / 16) * 16;
   }
   bool flag_relu = param.fuse_relu;
@@ -274,7 +276,7 @@ void conv1x1s1_gemm_int8(const int8_t* i_data,
       const int8_t* weights_group = weights + g * weights_size_per_group;
       const float* bias_group = bias + g * m;
       const float* scale_group = scale + g * m;
-      if (n == 1) {
+      if (n == 1 && !force_gemm) {
         gemv_int8(weights_group,
                   din_group,
                   dout_group,
@@ -320,7 +322,8 @@ template void conv1x1s1_gemm_int8<int8_t>(const int8_t* i_data,
                                           const float* bias,
                                           const operators::ConvParam& param,
                                           ARMContext* ctx,
-                                          const float* scale);
+                                          const float* scale,
+                                          bool force_gemm);
 
 template void conv1x1s1_gemm_int8<float>(const int8_t* i_data,
                                          float* o_data,
@@ -335,7 +338,8 @@ template void conv1x1s1_gemm_int8<float>(const int8_t* i_data,
                                          const float* bias,
                                          const operators::ConvParam& param,
                                          ARMContext* ctx,
-                                         const float* scale);
+                                         const float* scale,
+                                         bool force_gemm);
 
 /**
  * \brief convolution function for kernel size 3x3, stride size 2, gemm
@@ -353,7 +357,8 @@ void conv_im2col_gemm(const float* i_data,
                       const float* weights,
                       const float* bias,
                       const operators::ConvParam& param,
-                      ARMContext* ctx) {
+                      ARMContext* ctx,
+                      bool force_gemm) {
   const int group = param.groups;
   auto filter_dims = param.filter->dims();
   const int kernel_h = filter_dims[2];
@@ -371,7 +376,7 @@ void conv_im2col_gemm(const float* i_data,
   int weights_size_per_group = m * k;
 
   auto act_param = param.activation_param;
-  if (n > 1) {
+  if (n > 1 || force_gemm) {
     weights_size_per_group = ((m_roundup * k + 15) / 16) * 16;
   }
 
@@ -407,7 +412,7 @@ void conv_im2col_gemm(const float* i_data,
              dilations[1],
              dB);
 
-      if (n == 1) {
+      if (n == 1 && !force_gemm) {
         sgemv(weights_group,
               dB,
               dout_group,
@@ -456,7 +461,8 @@ void conv_im2col_gemm_int8(const int8_t* i_data,
                            const float* bias,
                            const operators::ConvParam& param,
                            ARMContext* ctx,
-                           const float* scale) {
+                           const float* scale,
+                           bool force_gemm) {
   int group = param.groups;
   auto filter_dims = param.filter->dims();
   auto paddings = *param.paddings;
@@ -484,7 +490,7 @@ void conv_im2col_gemm_int8(const int8_t* i_data,
   int k_roundup = ROUNDUP(k, KBLOCK_INT8);
   int m_roundup = ROUNDUP(m, hblock);
   int weights_size_per_group = m * k;
-  if (n > 1) {
+  if (n > 1 || force_gemm) {
     weights_size_per_group = ((m_roundup * k_roundup + 15) / 16) * 16;
   }
 
@@ -519,7 +525,7 @@ void conv_im2col_gemm_int8(const int8_t* i_data,
              dila_h,
              dila_w,
              dB);
-      if (n == 1) {
+      if (n == 1 && !force_gemm) {
         gemv_int8(weights_group,
                   dB,
                   dout_group,
@@ -565,7 +571,8 @@ template void conv_im2col_gemm_int8<int8_t>(const int8_t* i_data,
                                             const float* bias,
                                             const operators::ConvParam& param,
                                             ARMContext* ctx,
-                                            const float* scale);
+                                            const float* scale,
+                                            bool force_gemm);
 
 template void conv_im2col_gemm_int8<float>(const int8_t* i_data,
                                            float* o_data,
@@ -580,7 +587,8 @@ template void conv_im2col_gemm_int8<float>(const int8_t* i_data,
                                            const float* bias,
                                            const operators::ConvParam& param,
                                            ARMContext* ctx,
-                                           const float* scale);
+                                           const float* scale,
+                                           bool force_gemm);
 
 template void im2col<float>(const float* data_im,
                             int channels,
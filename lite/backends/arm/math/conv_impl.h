@@ -139,6 +139,9 @@ void conv_5x1s1_direct(const float* din,
                        bool flag_relu,
                        ARMContext& ctx);  // NOLINT
 
+//! The gemm-like convs run a gemv when the output is 1x1(n == 1), on the
+//! filter in its original layout. With force_gemm the weights are always
+//! packed and the gemm runs for n == 1 as well.
 void conv1x1s1_gemm(const float* din,
                     float* dout,
                     int num,
@@ -151,7 +154,8 @@ void conv1x1s1_gemm(const float* din,
                     const float* weights,
                     const float* bias,
                     const operators::ConvParam& param,
-                    ARMContext* ctx);
+                    ARMContext* ctx,
+                    bool force_gemm = false);
 
 template <typename Dtype>
 void conv1x1s1_gemm_int8(const int8_t* din,
@@ -167,7 +171,8 @@ void conv1x1s1_gemm_int8(const int8_t* din,
                          const float* bias,
                          const operators::ConvParam& param,
                          ARMContext* ctx,
-                         const float* scale);
+                         const float* scale,
+                         bool force_gemm = false);
 
 void conv_im2col_gemm(const float* din,
                       float* dout,
@@ -181,7 +186,8 @@ void conv_im2col_gemm(const float* din,
                       const float* weights,
                       const float* bias,
                       const operators::ConvParam& param,
-                      ARMContext* ctx);
+                      ARMContext* ctx,
+                      bool force_gemm = false);
 
 template <typename Dtype>
 void conv_im2col_gemm_int8(const int8_t* din,
@@ -197,7 +203,8 @@ void conv_im2col_gemm_int8(const int8_t* din,
                            const float* bias,
                            const operators::ConvParam& param,
                            ARMContext* ctx,
-                           const float* scale);
+                           const float* scale,
+                           bool force_gemm = false);
 
 /// depthwise conv
 void conv_depthwise_3x3_fp32(const void* din,
@@ -0,0 +1,143 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/arm/math/quant_weight_gemm.h"
+#include <algorithm>
+#include "lite/backends/arm/math/packed_sgemm.h"
+
+namespace paddle {
+namespace lite {
+namespace arm {
+namespace math {
+
+namespace {
+
+// The number of fp32 values of a dequantized weight panel, 128KB fits in the
+// L2 of the little cores.
+const int kPanelSize = 32 * 1024;
+const int kMinPanelDepth = 16;
+
+// The panels start at even rows, so the int4 pairs are never split.
+int PanelDepth(int width, int K) {
+  int depth = std::max(kPanelSize / std::max(width, 1), kMinPanelDepth) & ~1;
+  return std::min(depth, K);
+}
+
+// Returns the workspace that holds a packed [M, depth] panel of A, after the
+// part of the workspace used by sgemm_prepack.
+float* PackedPanelBuffer(int M, int depth, ARMContext* ctx) {
+  int hblock = get_hblock(ctx);
+  int m_round = hblock * ((M + hblock - 1) / hblock);
+  ctx->ExtendWorkspace(m_round * depth * sizeof(float));
+  return ctx->workspace_data<float>() + ctx->llc_size() / sizeof(float);
+}
+
+}  // namespace
+
+void QuantWeightGemm(bool trans_a,
+                     int M,
+                     int N,
+                     int K,
+                     float alpha,
+                     const float* A,
+                     int lda,
+                     const int8_t* B,
+                     const float* scale,
+                     int bits,
+                     float beta,
+                     float* C,
+                     int ldc,
+                     std::vector<float>* panel_buffer,
+                     ARMContext* ctx) {
+  CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+  int depth = PanelDepth(N, K);
+  CHECK(panel_buffer);
+  panel_buffer->resize(static_cast<size_t>(depth) * N);
+  float* panel = panel_buffer->data();
+  float* packed_a = PackedPanelBuffer(M, depth, ctx);
+  operators::ActivationParam act_param;
+  act_param.has_active = false;
+  for (int k = 0; k < K; k += depth) {
+    int kc = std::min(depth, K - k);
+    DequantizeWeight(B, scale, k, kc, N, bits, panel);
+    const float* a_panel = trans_a ? A + static_cast<int64_t>(k) * lda : A + k;
+    prepackA(packed_a, a_panel, alpha, lda, 0, M, 0, kc, trans_a, ctx);
+    sgemm_prepack(false,
+                  M,
+                  N,
+                  kc,
+                  packed_a,
+                  panel,
+                  N,
+                  k == 0 ? beta : 1.f,
+                  C,
+                  ldc,
+                  nullptr,
+                  false,
+                  act_param,
+                  ctx);
+  }
+}
+
+void QuantWeightGemm(int M,
+                     int N,
+                     int K,
+                     const int8_t* A,
+                     const float* scale,
+                     int bits,
+                     const float* B,
+                     int ldb,
+                     float* C,
+                     int ldc,
+                     const float* bias,
+                     bool has_bias,
+                     const operators::ActivationParam& act_param,
+                     std::vector<float>* panel_buffer,
+                     ARMContext* ctx) {
+  CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+  int depth = PanelDepth(M, K);
+  CHECK(panel_buffer);
+  panel_buffer->resize(static_cast<size_t>(depth) * M);
+  float* panel = panel_buffer->data();
+  float* packed_a = PackedPanelBuffer(M, depth, ctx);
+  operators::ActivationParam no_act;
+  no_act.has_active = false;
+  for (int k = 0; k < K; k += depth) {
+    int kc = std::min(depth, K - k);
+    bool last = k + kc == K;
+    // The panel holds the rows [k, k + kc) of A, which are the columns of
+    // A^T. The bias and the activation are applied with the last panel.
+    DequantizeWeight(A, scale, k, kc, M, bits, panel);
+    prepackA(packed_a, panel, 1.f, M, 0, M, 0, kc, true, ctx);
+    sgemm_prepack(false,
+                  M,
+                  N,
+                  kc,
+                  packed_a,
+                  B + static_cast<int64_t>(k) * ldb,
+                  ldb,
+                  k == 0 ? 0.f : 1.f,
+                  C,
+                  ldc,
+                  bias,
+                  has_bias && last,
+                  last ? act_param : no_act,
+                  ctx);
+  }
+}
+
+}  // namespace math
+}  // namespace arm
+}  // namespace lite
+}  // namespace paddle
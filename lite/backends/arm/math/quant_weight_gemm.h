@@ -0,0 +1,76 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/operators/op_params.h"
+#include "lite/utils/weight_quant.h"
+
+namespace paddle {
+namespace lite {
+namespace arm {
+namespace math {
+
+/*
+ * C = alpha * op(A) * B + beta * C, where B is the [K, N] weights quantized
+ * in the layout of lite/utils/weight_quant.h.
+ * B is dequantized by K-panels small enough to stay in cache and each panel
+ * is multiplied by the packed sgemm, so the weights are read from memory in
+ * their quantized size. The panels are dequantized into `panel`, which the
+ * kernels keep across the runs, and A is packed in the context workspace.
+ */
+void QuantWeightGemm(bool trans_a,
+                     int M,
+                     int N,
+                     int K,
+                     float alpha,
+                     const float* A,
+                     int lda,
+                     const int8_t* B,
+                     const float* scale,
+                     int bits,
+                     float beta,
+                     float* C,
+                     int ldc,
+                     std::vector<float>* panel,
+                     ARMContext* ctx);
+
+/*
+ * C = act(A^T * B + bias), where A is the [K, M] weights quantized in the
+ * layout of lite/utils/weight_quant.h and B is [K, N], as the filter and the
+ * im2col columns of conv2d. The bias holds one value per row of C.
+ */
+void QuantWeightGemm(int M,
+                     int N,
+                     int K,
+                     const int8_t* A,
+                     const float* scale,
+                     int bits,
+                     const float* B,
+                     int ldb,
+                     float* C,
+                     int ldc,
+                     const float* bias,
+                     bool has_bias,
+                     const operators::ActivationParam& act_param,
+                     std::vector<float>* panel,
+                     ARMContext* ctx);
+
+}  // namespace math
+}  // namespace arm
+}  // namespace lite
+}  // namespace paddle
@@ -13,17 +13,13 @@
 // limitations under the License.
 
 #include "lite/backends/arm/math/topk.h"
-#include <utility>
-#include <vector>
+#include <algorithm>
 #include "lite/backends/arm/math/funcs.h"
+#include "lite/backends/host/math/topk.h"
 namespace paddle {
 namespace lite {
 namespace arm {
 namespace math {
-bool comp_func(std::pair<float, int> a, std::pair<float, int> b) {
-  return (a.first > b.first);
-}
-
 void topk(const float* in_data,
           float* out_val,
           int64_t* out_ind,
@@ -31,18 +27,18 @@ void topk(const float* in_data,
           int n,
           int k,
           Context<TARGET(kARM)>* ctx) {
-  for (int i = 0; i < m; i++) {
-    const float* in_tmp = in_data + i * n;
-    float* out_val_tmp = out_val + i * k;
-    int64_t* out_ind_tmp = out_ind + i * k;
-    std::vector<std::pair<float, int>> vec;
-    for (int j = 0; j < n; j++) {
-      vec.push_back(std::make_pair(in_tmp[j], j));
-    }
-    std::partial_sort(vec.begin(), vec.begin() + k, vec.end(), comp_func);
-    for (int q = 0; q < k; q++) {
-      out_val_tmp[q] = vec[q].first;
-      out_ind_tmp[q] = vec[q].second;
+  int threads = std::max(std::min(ctx->threads(), m), 1);
+  int rows_per_thread = (m + threads - 1) / threads;
+#pragma omp parallel for
+  for (int t = 0; t < threads; t++) {
+    host::math::TopKSelector<float> selector;
+    int end = std::min(m, (t + 1) * rows_per_thread);
+    for (int i = t * rows_per_thread; i < end; i++) {
+      selector.Select(in_data + static_cast<int64_t>(i) * n,
+                      n,
+                      k,
+                      out_val + static_cast<int64_t>(i) * k,
+                      out_ind + static_cast<int64_t>(i) * k);
     }
   }
 }
@@ -0,0 +1,214 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+struct BeamItem {
+  // The prefix (row of the scores) the candidate extends.
+  size_t offset;
+  int64_t id;
+  float score;
+
+  bool operator<(const BeamItem& in) const {
+    return (score < in.score) || ((score == in.score) && (offset < in.offset));
+  }
+};
+
+/*
+ * The beam search step over the candidates of the prefixes, grouped into the
+ * source sentences by the high level offsets. The top beam_size candidates of
+ * a source are kept in a fixed-capacity pool of the searcher, so the buffers
+ * are allocated once and reused by the following steps.
+ * Once a pool is full, the scores of a prefix are scanned by blocks against
+ * the score of the last kept candidate, which is a branch-free loop the
+ * compiler vectorizes, and the blocks without a better candidate are skipped
+ * without computing the log of the probabilities.
+ * The outputs are the same as the insertion of all the candidates in turn.
+ */
+class BeamSearcher {
+ public:
+  // Selects the top beam_size candidates of each source. pre_ids and
+  // pre_scores have a value per prefix, scores has seq_width candidates per
+  // prefix whose ids are in ids, or the column indices if ids is nullptr.
+  void Select(const int64_t* pre_ids,
+              const float* pre_scores,
+              const int64_t* ids,
+              const float* scores,
+              const std::vector<uint64_t>& high_level,
+              size_t seq_width,
+              size_t beam_size,
+              int end_id,
+              bool is_accumulated) {
+    size_t num_seqs = high_level.size() - 1;
+    beam_size_ = beam_size;
+    num_prefixes_ = high_level.back();
+    items_.resize(num_seqs * beam_size);
+    sizes_.assign(num_seqs, 0);
+    if (beam_size == 0) return;
+    for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+      BeamItem* pool = items_.data() + seq_id * beam_size;
+      size_t* size = &sizes_[seq_id];
+      for (size_t offset = high_level[seq_id]; offset < high_level[seq_id + 1];
+           ++offset) {
+        float pre_score = pre_scores[offset];
+        if (pre_ids[offset] == end_id) {
+          // Allocate all probability mass to end_id for finished branchs and
+          // the other candidate ids can be ignored.
+          Insert(pool, size, BeamItem{offset, end_id, pre_score});
+          continue;
+        }
+        const float* row = scores + offset * seq_width;
+        const int64_t* row_ids = ids ? ids + offset * seq_width : nullptr;
+        for (size_t b = 0; b < seq_width; b += kBlock) {
+          size_t end = std::min(seq_width, b + kBlock);
+          float threshold = -std::numeric_limits<float>::infinity();
+          if (*size == beam_size) {
+            threshold = Threshold(pool[beam_size - 1].score,
+                                  pre_score,
+                                  is_accumulated);
+            int hit = 0;
+            for (size_t d = b; d < end; d++) {
+              hit |= MayInsert(row[d], threshold, is_accumulated);
+            }
+            if (!hit) continue;
+          }
+          for (size_t d = b; d < end; d++) {
+            if (!MayInsert(row[d], threshold, is_accumulated)) continue;
+            int64_t id = row_ids ? row_ids[d] : static_cast<int64_t>(d);
+            float score =
+                is_accumulated ? row[d] : pre_score + std::log(row[d]);
+            Insert(pool, size, BeamItem{offset, id, score});
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Prune the source sentences all branchs finished, and it is optional.
+   * Pruning must one step later than finishing (thus pre_ids is needed here),
+   * since the end tokens must be writed out.
+   */
+  void PruneEndBeams(const int64_t* pre_ids, int end_id) {
+    for (size_t seq_id = 0; seq_id < sizes_.size(); ++seq_id) {
+      const BeamItem* pool = items_.data() + seq_id * beam_size_;
+      bool finish_flag = true;
+      for (size_t i = 0; i < sizes_[seq_id] && finish_flag; i++) {
+        finish_flag = pool[i].id == end_id && pre_ids[pool[i].offset] == end_id;
+      }
+      if (finish_flag) sizes_[seq_id] = 0;
+    }
+  }
+
+  size_t num_selected() const {
+    size_t num = 0;
+    for (auto size : sizes_) num += size;
+    return num;
+  }
+
+  // Writes the selected candidates grouped by their prefixes, in the
+  // descending order of the scores within a prefix, and the offsets of the
+  // prefixes in low_level. parent_idx may be nullptr.
+  void Output(int64_t* selected_ids,
+              float* selected_scores,
+              int* parent_idx,
+              std::vector<uint64_t>* low_level) {
+    low_level->assign(num_prefixes_ + 1, 0);
+    uint64_t* starts = low_level->data();
+    for (size_t seq_id = 0; seq_id < sizes_.size(); ++seq_id) {
+      const BeamItem* pool = items_.data() + seq_id * beam_size_;
+      for (size_t i = 0; i < sizes_[seq_id]; i++) {
+        starts[pool[i].offset + 1]++;
+      }
+    }
+    for (size_t i = 0; i < num_prefixes_; i++) {
+      starts[i + 1] += starts[i];
+    }
+    cursors_.assign(low_level->begin(), low_level->end() - 1);
+    for (size_t seq_id = 0; seq_id < sizes_.size(); ++seq_id) {
+      const BeamItem* pool = items_.data() + seq_id * beam_size_;
+      for (size_t i = 0; i < sizes_[seq_id]; i++) {
+        size_t pos = cursors_[pool[i].offset]++;
+        selected_ids[pos] = pool[i].id;
+        selected_scores[pos] = pool[i].score;
+        if (parent_idx) parent_idx[pos] = static_cast<int>(pool[i].offset);
+      }
+    }
+  }
+
+ private:
+  static const size_t kBlock = 64;
+
+  // The lowest value of the block scan a candidate better than the last kept
+  // score may have, the probability if the scores are not accumulated. The
+  // items of a prefix are never before the last kept one, so a candidate is
+  // inserted iff its score is not less than that score.
+  static float Threshold(float last_score, float pre_score, bool accumulated) {
+    if (accumulated) return last_score;
+    if (!std::isfinite(last_score) || !std::isfinite(pre_score)) return 0.f;
+    // The margin covers the rounding of pre_score + log(p).
+    double margin =
+        1e-5 * (1.0 + std::fabs(last_score) + std::fabs(pre_score));
+    return static_cast<float>(
+        std::exp(static_cast<double>(last_score) - pre_score - margin));
+  }
+
+  // The NaN and negative probabilities are inserted as before.
+  static int MayInsert(float value, float threshold, bool accumulated) {
+    return (!(value < threshold)) | (!accumulated & (value < 0.f));
+  }
+
+  // Inserts the item into the pool sorted in the descending order, the last
+  // one is dropped if the pool is full.
+  void Insert(BeamItem* pool, size_t* size, const BeamItem& item) const {
+    size_t num_beams = *size;
+    if (num_beams < beam_size_) {
+      num_beams = ++(*size);
+    } else if (item < pool[beam_size_ - 1]) {
+      return;
+    }
+    for (int k = static_cast<int>(num_beams) - 2; k >= 0; --k) {
+      if (pool[k] < item) {
+        pool[k + 1] = pool[k];
+      } else {
+        pool[k + 1] = item;
+        return;
+      }
+    }
+    pool[0] = item;
+  }
+
+  size_t beam_size_{0};
+  size_t num_prefixes_{0};
+  std::vector<BeamItem> items_;
+  std::vector<size_t> sizes_;
+  std::vector<uint64_t> cursors_;
+};
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,236 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "lite/core/tensor.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+using LoDTensor = lite::Tensor;
+using LoDTensorArray = std::vector<lite::Tensor>;
+
+// all the lod have 2 levels.
+// The first is source level, the second is sentence level.
+// source level describe how many prefixes (branchs) for each source sentece
+// (beam). sentence level describe how these candidates belong to the prefixes.
+const size_t kSourceLevel = 0;
+const size_t kSentenceLevel = 1;
+
+/*
+ * The hypotheses are backtraced into flat buffers of beam_size sentences per
+ * source sentence, a sentence has at most a word per step, so the decoding
+ * allocates the buffers once instead of two vectors per hypothesis, and the
+ * sorted sentences are written to the output tensors directly.
+ */
+template <typename T>
+struct BeamSearchDecoder {
+  BeamSearchDecoder(size_t beam_size, int end_id)
+      : beam_size_(beam_size), end_id_(end_id) {}
+
+  /**
+   * convert the backtraced sentences of each source sentence into two
+   * LodTensor.
+   * One is all candidate sentences with word id, one is all candidate sentences
+   * with word score.
+   * Param:
+   *  id_tensor: result LoDTensor for sentences of id.
+   *  score_tensor: result LoDTensor for sentences of score.
+   *  reverse: whether ids of the sentences are reversed
+   *  sort_by_score: whether to sort hypotheses of each sentence by scores.
+   */
+  void ConvertSentencesToLodTensor(LoDTensor* id_tensor,
+                                   LoDTensor* score_tensor,
+                                   bool reverse = true,
+                                   bool sort_by_score = true) {
+    size_t src_num = lengths_.size() / beam_size_;
+    CHECK_GT(src_num, 0) << "src_num should not be 0";
+
+    size_t total_len = 0;
+    for (auto len : lengths_) total_len += len;
+    id_tensor->Resize({static_cast<int64_t>(total_len)});
+    score_tensor->Resize({static_cast<int64_t>(total_len)});
+    auto id_ptr = id_tensor->mutable_data<int64_t>();
+    auto score_ptr = score_tensor->mutable_data<T>();
+
+    LoD lod(2);
+    lod[kSourceLevel].reserve(src_num + 1);
+    lod[kSentenceLevel].reserve(lengths_.size() + 1);
+    lod[kSourceLevel].push_back(0);
+    lod[kSentenceLevel].push_back(0);
+    std::vector<size_t> order(beam_size_);
+    size_t pos = 0;
+    for (size_t src_idx = 0; src_idx < src_num; ++src_idx) {
+      const size_t first = src_idx * beam_size_;
+      for (size_t i = 0; i < beam_size_; i++) order[i] = first + i;
+      if (sort_by_score) {
+        // The empty sentences are put after the others.
+        std::stable_sort(
+            order.begin(), order.end(), [&](size_t a, size_t b) {
+              if (lengths_[a] == 0 || lengths_[b] == 0) {
+                return lengths_[b] == 0 && lengths_[a] > 0;
+              }
+              size_t a_word = reverse ? 0 : lengths_[a] - 1;
+              size_t b_word = reverse ? 0 : lengths_[b] - 1;
+              return scores_[a * step_num_ + a_word] >
+                     scores_[b * step_num_ + b_word];
+            });
+      }
+      for (auto sentence : order) {
+        const size_t len = lengths_[sentence];
+        const int64_t* ids = ids_.data() + sentence * step_num_;
+        const T* scores = scores_.data() + sentence * step_num_;
+        for (size_t k = 0; k < len; k++) {
+          size_t word = reverse ? len - 1 - k : k;
+          id_ptr[pos + k] = ids[word];
+          score_ptr[pos + k] = scores[word];
+        }
+        pos += len;
+        lod[kSentenceLevel].push_back(pos);
+      }
+      lod[kSourceLevel].push_back(lod[kSourceLevel].back() + beam_size_);
+    }
+
+    id_tensor->set_lod(lod);
+    score_tensor->set_lod(lod);
+  }
+
+  /**
+   * Gather the hypotheses for each source sentence by backtrace though the
+   * LoDTensorArray step_ids whose lods reserve the path in the tree.
+   */
+  void Backtrace(const LoDTensorArray& step_ids,
+                 const LoDTensorArray& step_scores,
+                 LoDTensor* id_tensor,
+                 LoDTensor* score_tensor) {
+    CHECK(!step_ids.empty()) << "step num should be larger than 0";
+    CHECK_EQ(step_ids.size(), step_scores.size())
+        << "step_ids and step_scores should be the same";
+    const size_t step_num = step_ids.size();
+    const size_t src_num = step_ids.at(0).lod().at(kSourceLevel).size() - 1;
+    step_num_ = step_num;
+    ids_.resize(src_num * beam_size_ * step_num);
+    scores_.resize(src_num * beam_size_ * step_num);
+    lengths_.assign(src_num * beam_size_, 0);
+    // The prefix of a sentence at the current step, its candidate at the
+    // previous step.
+    std::vector<size_t> prefix_idx_list(src_num * beam_size_);
+    std::vector<size_t> prefix_num_list(src_num, 0);
+    for (int step_id = step_num - 1; step_id >= 0; --step_id) {
+      auto& cur_ids = step_ids.at(step_id);
+      auto& source_level = cur_ids.lod().at(kSourceLevel);
+      auto& sentence_level = cur_ids.lod().at(kSentenceLevel);
+      auto* cur_id_data = cur_ids.data<int64_t>();
+      auto* cur_score_data = step_scores.at(step_id).data<T>();
+      for (size_t src_idx = 0; src_idx < src_num; ++src_idx) {
+        // for each source sentence
+        const size_t first = src_idx * beam_size_;
+        size_t* prefix_idx_vector = prefix_idx_list.data() + first;
+        size_t& prefix_num = prefix_num_list[src_idx];
+        size_t src_prefix_start = source_level[src_idx];
+        size_t src_prefix_end = source_level[src_idx + 1];
+        if (prefix_num == 0) {  // be finished and pruned at this step
+          // or the last time step
+          for (size_t prefix_idx = src_prefix_start;
+               prefix_idx < src_prefix_end;
+               ++prefix_idx) {
+            for (size_t candidate_idx = sentence_level[prefix_idx];
+                 candidate_idx < sentence_level[prefix_idx + 1];
+                 ++candidate_idx) {
+              CHECK_LT(prefix_num, beam_size_)
+                  << "the candidates of a source should be at most beam_size";
+              prefix_idx_vector[prefix_num] = prefix_idx;
+              Append(first + prefix_num,
+                     cur_id_data[candidate_idx],
+                     cur_score_data[candidate_idx]);
+              prefix_num++;
+            }
+          }
+        } else {  // use prefix_idx_vector to backtrace
+          size_t src_candidate_start = sentence_level[src_prefix_start];
+          size_t prefix_idx = src_prefix_start;
+          size_t candidate_num =
+              sentence_level[prefix_idx + 1] - sentence_level[prefix_idx];
+          for (size_t idx = 0; idx < prefix_num; ++idx) {
+            auto candidate_idx = prefix_idx_vector[idx];
+            auto cur_id = cur_id_data[candidate_idx];
+            if (cur_id != end_id_ || lengths_[first + idx] == 0) {
+              // to skip redundant end tokens
+              Append(first + idx, cur_id, cur_score_data[candidate_idx]);
+            }
+
+            while (src_candidate_start + candidate_num <=
+                   candidate_idx) {  // search the corresponding prefix
+              prefix_idx++;
+              candidate_num +=
+                  sentence_level[prefix_idx + 1] - sentence_level[prefix_idx];
+            }
+            prefix_idx_vector[idx] = prefix_idx;
+          }
+        }
+      }
+    }
+
+    ConvertSentencesToLodTensor(id_tensor, score_tensor, true, true);
+  }
+
+  // Appends a word to the sentence, which has at most a word per step.
+  void Append(size_t sentence, int64_t id, T score) {
+    size_t pos = sentence * step_num_ + lengths_[sentence]++;
+    ids_[pos] = id;
+    scores_[pos] = score;
+  }
+
+  size_t beam_size_;
+  int end_id_;
+  size_t step_num_{0};
+  // The words of the sentence i are at [i * step_num_, i * step_num_ +
+  // lengths_[i]) in the order of the backtrace.
+  std::vector<int64_t> ids_;
+  std::vector<T> scores_;
+  std::vector<size_t> lengths_;
+};
+
+// Backtraces the ids and scores of the steps into the sentences of each
+// source sentence, sorted by their scores.
+template <typename T>
+void BeamSearchDecode(const LoDTensorArray& step_ids,
+                      const LoDTensorArray& step_scores,
+                      size_t beam_size,
+                      int end_id,
+                      LoDTensor* sentence_ids,
+                      LoDTensor* sentence_scores) {
+  const size_t step_num = step_ids.size();
+  CHECK_GT(step_num, 0UL) << "beam search steps should be larger than 0";
+  const size_t source_num = step_ids.at(0).lod().at(0).size() - 1;
+  CHECK_GT(source_num, 0UL) << "source num should be larger than 0";
+  for (size_t i = 0; i < step_num; ++i) {
+    CHECK_EQ(step_ids.at(i).lod().size(), 2UL)
+        << "Level of LodTensor should be 2";
+  }
+  BeamSearchDecoder<T> decoder(beam_size, end_id);
+  decoder.Backtrace(step_ids, step_scores, sentence_ids, sentence_scores);
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
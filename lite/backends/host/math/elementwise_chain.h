@@ -0,0 +1,307 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+enum class ChainOp {
+  kAdd,
+  kSub,
+  kMul,
+  kDiv,
+  kMax,
+  kMin,
+  kScale,
+  kRelu,
+  kRelu6,
+  kLeakyRelu,
+  kSigmoid,
+  kTanh,
+  kExp,
+  kSquare,
+  kAbs,
+};
+
+// Returns false if the op can't be a step of an elementwise chain.
+inline bool ParseChainOp(const std::string& op_type, ChainOp* op) {
+  static const std::vector<std::pair<std::string, ChainOp>> kOps = {
+      {"elementwise_add", ChainOp::kAdd},
+      {"elementwise_sub", ChainOp::kSub},
+      {"elementwise_mul", ChainOp::kMul},
+      {"elementwise_div", ChainOp::kDiv},
+      {"elementwise_max", ChainOp::kMax},
+      {"elementwise_min", ChainOp::kMin},
+      {"scale", ChainOp::kScale},
+      {"relu", ChainOp::kRelu},
+      {"relu6", ChainOp::kRelu6},
+      {"leaky_relu", ChainOp::kLeakyRelu},
+      {"sigmoid", ChainOp::kSigmoid},
+      {"tanh", ChainOp::kTanh},
+      {"exp", ChainOp::kExp},
+      {"square", ChainOp::kSquare},
+      {"abs", ChainOp::kAbs}};
+  for (auto& item : kOps) {
+    if (item.first == op_type) {
+      *op = item.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool IsBinaryChainOp(ChainOp op) { return op <= ChainOp::kMin; }
+
+inline bool IsCommutativeChainOp(ChainOp op) {
+  return op == ChainOp::kAdd || op == ChainOp::kMul || op == ChainOp::kMax ||
+         op == ChainOp::kMin;
+}
+
+/*
+ * A step computes v[i + 1] = op(v[i], operand), v[0] is the chain input.
+ * The operand of a binary step is an external tensor if it's >= 0, or the
+ * chain input if it's kChainInput.
+ * The scale step computes v * alpha + beta, relu6 clips at alpha and
+ * leaky_relu uses alpha as the slope.
+ */
+struct ChainStep {
+  static const int kNoOperand = -1;
+  static const int kChainInput = -2;
+
+  ChainOp op;
+  int operand{kNoOperand};
+  float alpha{0.f};
+  float beta{0.f};
+};
+
+// Builds the steps from the attributes of fusion_elementwise_chain, returns
+// false if an op type is not supported.
+inline bool BuildChainSteps(const std::vector<std::string>& op_types,
+                            const std::vector<int>& operand_ids,
+                            const std::vector<float>& alphas,
+                            const std::vector<float>& betas,
+                            std::vector<ChainStep>* steps) {
+  steps->resize(op_types.size());
+  for (size_t i = 0; i < op_types.size(); i++) {
+    auto& step = (*steps)[i];
+    if (!ParseChainOp(op_types[i], &step.op)) return false;
+    step.operand = operand_ids[i];
+    step.alpha = alphas[i];
+    step.beta = betas[i];
+    if (IsBinaryChainOp(step.op) == (step.operand == ChainStep::kNoOperand)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The operand value of the flat index i is data[(i / post) % n], which covers
+// the same shape(n = numel, post = 1) and the broadcasting of a [pre, n, post]
+// layout.
+struct ChainOperand {
+  const float* data{nullptr};
+  int64_t n{1};
+  int64_t post{1};
+};
+
+// Finds the n and post of the operand broadcast to the chain values by the
+// rule of the elementwise ops, returns false if the operand is larger than
+// the chain values or can't be laid out as [pre, n, post].
+inline bool ChainOperandLayout(const std::vector<int64_t>& x_dims,
+                               std::vector<int64_t> y_dims,
+                               int axis,
+                               ChainOperand* operand) {
+  int64_t x_numel = 1;
+  for (auto d : x_dims) x_numel *= d;
+  if (x_dims == y_dims) {
+    operand->n = x_numel;
+    operand->post = 1;
+    return true;
+  }
+  if (y_dims.size() > x_dims.size()) return false;
+  if (axis < 0) axis = static_cast<int>(x_dims.size() - y_dims.size());
+  // The trailing dims of size 1 are broadcast as the post dims.
+  while (!y_dims.empty() && y_dims.back() == 1) y_dims.pop_back();
+  if (axis + y_dims.size() > x_dims.size()) return false;
+  int64_t n = 1;
+  for (size_t i = 0; i < y_dims.size(); i++) {
+    if (y_dims[i] != x_dims[axis + i]) return false;
+    n *= y_dims[i];
+  }
+  int64_t post = 1;
+  for (size_t i = axis + y_dims.size(); i < x_dims.size(); i++) {
+    post *= x_dims[i];
+  }
+  operand->n = n;
+  operand->post = y_dims.empty() ? 1 : post;
+  return true;
+}
+
+// The chain values of a tile stay in cache from the first step to the last.
+const int kChainTileSize = 1024;
+
+// Returns the operand values of [begin, begin + len), the buffer is only used
+// if they are not contiguous in memory.
+inline const float* ChainOperandTile(const ChainOperand& operand,
+                                     int64_t begin,
+                                     int len,
+                                     float* buffer) {
+  if (operand.post == 1) {
+    int64_t pos = begin % operand.n;
+    if (pos + len <= operand.n) return operand.data + pos;
+    for (int i = 0; i < len;) {
+      int run = static_cast<int>(std::min<int64_t>(len - i, operand.n - pos));
+      memcpy(buffer + i, operand.data + pos, sizeof(float) * run);
+      i += run;
+      pos = 0;
+    }
+    return buffer;
+  }
+  int64_t idx = begin / operand.post;
+  int64_t offset = begin % operand.post;
+  for (int i = 0; i < len; idx++) {
+    int run =
+        static_cast<int>(std::min<int64_t>(len - i, operand.post - offset));
+    std::fill(buffer + i, buffer + i + run, operand.data[idx % operand.n]);
+    i += run;
+    offset = 0;
+  }
+  return buffer;
+}
+
+// The portable sigmoid, tanh and exp, the backends pass their SIMD versions.
+struct ChainTranscendental {
+  void operator()(ChainOp op, const float* x, float* y, int len) const {
+    switch (op) {
+      case ChainOp::kSigmoid:
+        for (int i = 0; i < len; i++) y[i] = 1.f / (1.f + std::exp(-x[i]));
+        break;
+      case ChainOp::kTanh:
+        for (int i = 0; i < len; i++) y[i] = std::tanh(x[i]);
+        break;
+      default:
+        for (int i = 0; i < len; i++) y[i] = std::exp(x[i]);
+        break;
+    }
+  }
+};
+
+/*
+ * Computes out[begin, end) of the chain tile by tile, each step is a simple
+ * loop over the tile which the compiler vectorizes, so the intermediate
+ * values never go to memory. The Transcendental functor computes the
+ * sigmoid, tanh and exp steps of a tile.
+ */
+template <typename Transcendental>
+void ElementwiseChain(const float* x,
+                      const std::vector<ChainOperand>& operands,
+                      const std::vector<ChainStep>& steps,
+                      int64_t begin,
+                      int64_t end,
+                      float* out,
+                      const Transcendental& transcendental) {
+  float operand_buffer[kChainTileSize];
+  float input_buffer[kChainTileSize];
+  for (int64_t t = begin; t < end; t += kChainTileSize) {
+    int len = static_cast<int>(std::min<int64_t>(kChainTileSize, end - t));
+    const float* in0 = x + t;
+    // The output may share the memory with the chain input.
+    if (x == out) {
+      memcpy(input_buffer, in0, sizeof(float) * len);
+      in0 = input_buffer;
+    }
+    const float* v = in0;
+    float* o = out + t;
+    for (auto& step : steps) {
+      const float* y = nullptr;
+      if (step.operand == ChainStep::kChainInput) {
+        y = in0;
+      } else if (step.operand >= 0) {
+        y = ChainOperandTile(operands[step.operand], t, len, operand_buffer);
+      }
+      switch (step.op) {
+        case ChainOp::kAdd:
+          for (int i = 0; i < len; i++) o[i] = v[i] + y[i];
+          break;
+        case ChainOp::kSub:
+          for (int i = 0; i < len; i++) o[i] = v[i] - y[i];
+          break;
+        case ChainOp::kMul:
+          for (int i = 0; i < len; i++) o[i] = v[i] * y[i];
+          break;
+        case ChainOp::kDiv:
+          for (int i = 0; i < len; i++) o[i] = v[i] / y[i];
+          break;
+        case ChainOp::kMax:
+          for (int i = 0; i < len; i++) o[i] = std::max(v[i], y[i]);
+          break;
+        case ChainOp::kMin:
+          for (int i = 0; i < len; i++) o[i] = std::min(v[i], y[i]);
+          break;
+        case ChainOp::kScale: {
+          const float alpha = step.alpha;
+          const float beta = step.beta;
+          for (int i = 0; i < len; i++) o[i] = v[i] * alpha + beta;
+          break;
+        }
+        case ChainOp::kRelu:
+          for (int i = 0; i < len; i++) o[i] = std::max(v[i], 0.f);
+          break;
+        case ChainOp::kRelu6: {
+          const float threshold = step.alpha;
+          for (int i = 0; i < len; i++) {
+            o[i] = std::min(std::max(v[i], 0.f), threshold);
+          }
+          break;
+        }
+        case ChainOp::kLeakyRelu: {
+          const float alpha = step.alpha;
+          for (int i = 0; i < len; i++) {
+            o[i] = v[i] > 0.f ? v[i] : v[i] * alpha;
+          }
+          break;
+        }
+        case ChainOp::kSquare:
+          for (int i = 0; i < len; i++) o[i] = v[i] * v[i];
+          break;
+        case ChainOp::kAbs:
+          for (int i = 0; i < len; i++) o[i] = std::fabs(v[i]);
+          break;
+        default:
+          transcendental(step.op, v, o, len);
+          break;
+      }
+      v = o;
+    }
+    if (steps.empty()) {
+      memcpy(o, in0, sizeof(float) * len);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
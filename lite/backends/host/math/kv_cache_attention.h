@@ -0,0 +1,265 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "lite/core/tensor.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+/*
+ * The keys and values of the decoded tokens are cached in [B, H, capacity, D]
+ * tensors, the tokens of a head are contiguous rows of D values. A decoding
+ * step writes the K and V of its T new tokens at the rows [pos, pos + T) in
+ * place, and the new token t attends to the rows [0, pos + t], so a step
+ * reads the cache once instead of concatenating and copying the whole prefix.
+ */
+struct KVCacheShape {
+  int batch{0};
+  int heads{0};
+  int tokens{0};
+  int dim{0};
+  int capacity{0};
+  // The number of the cached tokens before the new ones.
+  int pos{0};
+
+  int64_t head_size() const { return static_cast<int64_t>(capacity) * dim; }
+};
+
+// The additive mask of the scores, [batch, heads, tokens, len] where the
+// first three dims may be 1 to broadcast, and len >= pos + tokens.
+struct KVCacheBias {
+  const float* data{nullptr};
+  int batch{1};
+  int heads{1};
+  int tokens{1};
+  int64_t len{0};
+
+  const float* Row(int b, int h, int t) const {
+    return data +
+           ((static_cast<int64_t>(b % batch) * heads + h % heads) * tokens +
+            t % tokens) *
+               len;
+  }
+};
+
+// Returns true if the beams keep their own cache rows.
+template <typename IndexT>
+bool IsIdentityIndex(const IndexT* index, int n) {
+  for (int i = 0; i < n; i++) {
+    if (index[i] != i) return false;
+  }
+  return true;
+}
+
+// Copies the first len_size values of the cached heads to the contiguous
+// heads of buffer, the beam b takes the heads of the beam index[b] of the
+// previous step.
+template <typename IndexT>
+void KVCacheGather(const float* cache,
+                   const IndexT* index,
+                   int batch,
+                   int heads,
+                   int64_t head_size,
+                   int64_t len_size,
+                   float* buffer) {
+  int64_t beam_size = heads * head_size;
+  for (int b = 0; b < batch; b++) {
+    for (int h = 0; h < heads; h++) {
+      memcpy(buffer + (static_cast<int64_t>(b) * heads + h) * len_size,
+             cache + index[b] * beam_size + h * head_size,
+             sizeof(float) * len_size);
+    }
+  }
+}
+
+// Copies the contiguous heads gathered by KVCacheGather back to the cache.
+inline void KVCacheScatter(const float* buffer,
+                           int num_heads,
+                           int64_t head_size,
+                           int64_t len_size,
+                           float* cache) {
+  for (int i = 0; i < num_heads; i++) {
+    memcpy(
+        cache + i * head_size, buffer + i * len_size, sizeof(float) * len_size);
+  }
+}
+
+// Writes the [B, H, T, D] keys or values of the new tokens at the rows
+// [pos, pos + T) of the cache.
+inline void KVCacheAppend(const float* x,
+                          const KVCacheShape& shape,
+                          float* cache) {
+  int64_t size = static_cast<int64_t>(shape.tokens) * shape.dim;
+  for (int i = 0; i < shape.batch * shape.heads; i++) {
+    memcpy(cache + i * shape.head_size() +
+               static_cast<int64_t>(shape.pos) * shape.dim,
+           x + i * size,
+           sizeof(float) * size);
+  }
+}
+
+// 8 independent sums, so the loop is vectorized without reassociation.
+inline float KVCacheDot(const float* a, const float* b, int n) {
+  float acc[8] = {0.f};
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    for (int k = 0; k < 8; k++) {
+      acc[k] += a[i + k] * b[i + k];
+    }
+  }
+  float sum = 0.f;
+  for (; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+  for (int k = 0; k < 8; k++) {
+    sum += acc[k];
+  }
+  return sum;
+}
+
+/*
+ * out[b, h, t] = softmax(alpha * q[b, h, t] . K[b, h, j] + bias[b, h, t, j])
+ * . V[b, h, j] over the cached rows j <= pos + t, for the heads [begin, end)
+ * of the B * H heads. The new tokens must be appended to the caches first,
+ * scores is a buffer of pos + T values.
+ */
+inline void KVCacheAttention(const float* q,
+                             const float* cache_k,
+                             const float* cache_v,
+                             const KVCacheBias& bias,
+                             const KVCacheShape& shape,
+                             float alpha,
+                             int begin,
+                             int end,
+                             float* scores,
+                             float* out) {
+  const int dim = shape.dim;
+  int64_t size = static_cast<int64_t>(shape.tokens) * dim;
+  for (int i = begin; i < end; i++) {
+    int b = i / shape.heads;
+    int h = i % shape.heads;
+    const float* k = cache_k + i * shape.head_size();
+    const float* v = cache_v + i * shape.head_size();
+    for (int t = 0; t < shape.tokens; t++) {
+      const float* qt = q + i * size + t * dim;
+      float* o = out + i * size + t * dim;
+      const float* bias_row = bias.data ? bias.Row(b, h, t) : nullptr;
+      int len = shape.pos + t + 1;
+      float max_score = -std::numeric_limits<float>::infinity();
+      for (int j = 0; j < len; j++) {
+        float s = alpha * KVCacheDot(qt, k + j * dim, dim);
+        if (bias_row) s += bias_row[j];
+        scores[j] = s;
+        max_score = std::max(max_score, s);
+      }
+      float sum = 0.f;
+      for (int j = 0; j < len; j++) {
+        scores[j] = std::exp(scores[j] - max_score);
+        sum += scores[j];
+      }
+      const float inv_sum = 1.f / sum;
+      std::fill(o, o + dim, 0.f);
+      for (int j = 0; j < len; j++) {
+        const float p = scores[j] * inv_sum;
+        const float* vj = v + j * dim;
+        for (int d = 0; d < dim; d++) {
+          o[d] += p * vj[d];
+        }
+      }
+    }
+  }
+}
+
+// Reads the int32 or int64 indices of x.
+inline std::vector<int64_t> ReadIndices(const lite::Tensor* x) {
+  std::vector<int64_t> indices(x->numel());
+  if (x->precision() == PRECISION(kInt32)) {
+    const int32_t* data = x->data<int32_t>();
+    std::copy(data, data + indices.size(), indices.begin());
+  } else {
+    const int64_t* data = x->data<int64_t>();
+    std::copy(data, data + indices.size(), indices.begin());
+  }
+  return indices;
+}
+
+// Reorders the cached tokens by the parent beams and appends the new ones.
+inline void UpdateCache(const lite::Tensor* x,
+                        const std::vector<int64_t>& parent_idx,
+                        const KVCacheShape& shape,
+                        std::vector<float>* buffer,
+                        lite::Tensor* cache) {
+  int64_t len_size = static_cast<int64_t>(shape.pos) * shape.dim;
+  bool reorder = false;
+  if (shape.pos > 0) {
+    CHECK(cache->IsInitialized())
+        << "The kv cache is empty at the position " << shape.pos;
+    auto cache_dims = cache->dims();
+    CHECK(cache_dims.size() == 4 && cache_dims[1] == shape.heads &&
+          cache_dims[2] == shape.capacity && cache_dims[3] == shape.dim)
+        << "The kv cache of shape " << cache_dims << " doesn't match the "
+        << shape.heads << " heads of dim " << shape.dim << " and capacity "
+        << shape.capacity;
+    const int64_t cached_batch = cache_dims[0];
+    reorder = !parent_idx.empty() &&
+              !(cached_batch == shape.batch &&
+                IsIdentityIndex(parent_idx.data(), shape.batch));
+    if (reorder) {
+      for (auto parent : parent_idx) {
+        CHECK(parent >= 0 && parent < cached_batch)
+            << "The parent " << parent << " is out of the " << cached_batch
+            << " cached beams";
+      }
+    } else {
+      CHECK_EQ(cached_batch, shape.batch)
+          << "The batch changes without the parent indices";
+    }
+  }
+  if (reorder) {
+    buffer->resize(static_cast<size_t>(shape.batch) * shape.heads * len_size);
+    KVCacheGather(cache->data<float>(),
+                  parent_idx.data(),
+                  shape.batch,
+                  shape.heads,
+                  shape.head_size(),
+                  len_size,
+                  buffer->data());
+  }
+  cache->Resize({shape.batch, shape.heads, shape.capacity, shape.dim});
+  float* data = cache->mutable_data<float>();
+  if (reorder) {
+    KVCacheScatter(buffer->data(),
+                   shape.batch * shape.heads,
+                   shape.head_size(),
+                   len_size,
+                   data);
+  }
+  KVCacheAppend(x->data<float>(), shape, data);
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
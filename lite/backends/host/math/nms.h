@@ -0,0 +1,168 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// Descending scores, the ties are in the ascending order of the indices, as
+// the stable sort of the candidates in the order of the indices.
+template <class T>
+inline bool ScoreIndexGreater(const std::pair<float, T>& a,
+                              const std::pair<float, T>& b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+/*
+ * Collects the scores[i * stride] > threshold of the n candidates, and keeps
+ * the top_k of them(all if top_k is -1) in the descending order of the
+ * scores. Only the kept candidates are sorted, the others are dropped by a
+ * partial selection first.
+ */
+inline void SelectTopKScores(const float* scores,
+                             int64_t n,
+                             int64_t stride,
+                             float threshold,
+                             int64_t top_k,
+                             std::vector<std::pair<float, int>>* selected) {
+  selected->clear();
+  for (int64_t i = 0; i < n; i++) {
+    float score = scores[i * stride];
+    if (score > threshold) {
+      selected->emplace_back(score, static_cast<int>(i));
+    }
+  }
+  if (top_k > -1 && top_k < static_cast<int64_t>(selected->size())) {
+    std::nth_element(selected->begin(),
+                     selected->begin() + top_k,
+                     selected->end(),
+                     ScoreIndexGreater<int>);
+    selected->resize(top_k);
+  }
+  std::sort(selected->begin(), selected->end(), ScoreIndexGreater<int>);
+}
+
+/*
+ * The greedy NMS over the candidates sorted by descending scores: a box is
+ * kept if its IoU with every box kept before is <= the adaptive threshold.
+ * The kept boxes are stored as structure of arrays, so the IoUs of a box with
+ * the kept set are computed by a branch-free loop which the compiler
+ * vectorizes, and the loop exits early by blocks once the box is suppressed.
+ * The boxes are [xmin, ymin, xmax, ymax] at boxes + index * box_stride.
+ */
+class NmsKeptSet {
+ public:
+  NmsKeptSet(bool normalized, float nms_threshold, float eta)
+      : norm_(normalized ? 0.f : 1.f),
+        threshold_(nms_threshold),
+        eta_(eta) {}
+
+  void Reserve(size_t n) {
+    x1_.reserve(n);
+    y1_.reserve(n);
+    x2_.reserve(n);
+    y2_.reserve(n);
+    area_.reserve(n);
+  }
+
+  size_t size() const { return x1_.size(); }
+
+  // Returns true and adds the box to the kept set if it's not suppressed.
+  bool TryKeep(const float* box) {
+    const float bx1 = box[0];
+    const float by1 = box[1];
+    const float bx2 = box[2];
+    const float by2 = box[3];
+    const float barea = Area(bx1, by1, bx2, by2);
+    const float threshold = threshold_;
+    const float norm = norm_;
+    const int n = static_cast<int>(x1_.size());
+    const float* x1 = x1_.data();
+    const float* y1 = y1_.data();
+    const float* x2 = x2_.data();
+    const float* y2 = y2_.data();
+    const float* area = area_.data();
+    for (int b = 0; b < n; b += kBlock) {
+      const int end = std::min(n, b + kBlock);
+      int suppressed = 0;
+      for (int i = b; i < end; i++) {
+        bool disjoint =
+            (x1[i] > bx2) | (x2[i] < bx1) | (y1[i] > by2) | (y2[i] < by1);
+        float w = std::min(bx2, x2[i]) - std::max(bx1, x1[i]) + norm;
+        float h = std::min(by2, y2[i]) - std::max(by1, y1[i]) + norm;
+        float inter = disjoint ? 0.f : w * h;
+        float iou = disjoint ? 0.f : inter / (barea + area[i] - inter);
+        // A NaN IoU suppresses the box as the reference implementation.
+        suppressed |= !(iou <= threshold);
+      }
+      if (suppressed) return false;
+    }
+    x1_.push_back(bx1);
+    y1_.push_back(by1);
+    x2_.push_back(bx2);
+    y2_.push_back(by2);
+    area_.push_back(barea);
+    if (eta_ < 1.f && threshold_ > 0.5f) {
+      threshold_ *= eta_;
+    }
+    return true;
+  }
+
+ private:
+  static const int kBlock = 16;
+
+  float Area(float x1, float y1, float x2, float y2) const {
+    if (x2 < x1 || y2 < y1) return 0.f;
+    return (x2 - x1 + norm_) * (y2 - y1 + norm_);
+  }
+
+  float norm_;
+  float threshold_;
+  float eta_;
+  std::vector<float> x1_;
+  std::vector<float> y1_;
+  std::vector<float> x2_;
+  std::vector<float> y2_;
+  std::vector<float> area_;
+};
+
+// Runs the NMS over the sorted candidates and appends the kept indices.
+inline void NmsSorted(const float* boxes,
+                      int64_t box_stride,
+                      const std::vector<std::pair<float, int>>& sorted,
+                      float nms_threshold,
+                      float eta,
+                      bool normalized,
+                      std::vector<int>* kept) {
+  NmsKeptSet kept_set(normalized, nms_threshold, eta);
+  kept_set.Reserve(sorted.size());
+  for (auto& candidate : sorted) {
+    if (kept_set.TryKeep(boxes + candidate.second * box_stride)) {
+      kept->push_back(candidate.second);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
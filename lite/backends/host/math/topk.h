@@ -0,0 +1,107 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// Descending values, the ties are in the ascending order of the indices.
+template <typename T>
+inline bool TopKGreater(const std::pair<T, int>& a,
+                        const std::pair<T, int>& b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+/*
+ * Selects the top k values of the rows. A small k keeps the candidates in a
+ * min-heap of k items, and the values are scanned by blocks against the
+ * smallest kept one, which is a branch-free loop the compiler vectorizes, so
+ * most blocks of a long row are dropped without touching the heap. A large k
+ * relative to the row length uses the partial sort of all the values. The
+ * heap is reused by the rows.
+ */
+template <typename T>
+class TopKSelector {
+ public:
+  // Writes the k largest of the n values in the descending order, the ties
+  // in the ascending order of the indices. Requires k <= n.
+  template <typename IndexT>
+  void Select(const T* in, int n, int k, T* out_val, IndexT* out_ind) {
+    if (static_cast<int64_t>(k) * kHeapRatio > n) {
+      SelectBySort(in, n, k);
+    } else {
+      SelectByHeap(in, n, k);
+    }
+    for (int i = 0; i < k; i++) {
+      out_val[i] = heap_[i].first;
+      out_ind[i] = static_cast<IndexT>(heap_[i].second);
+    }
+  }
+
+ private:
+  static const int kBlock = 64;
+  // The heap is used if the row has at least kHeapRatio values per item.
+  static const int kHeapRatio = 16;
+
+  void SelectBySort(const T* in, int n, int k) {
+    heap_.resize(n);
+    for (int i = 0; i < n; i++) {
+      heap_[i] = std::make_pair(in[i], i);
+    }
+    std::partial_sort(
+        heap_.begin(), heap_.begin() + k, heap_.end(), TopKGreater<T>);
+  }
+
+  void SelectByHeap(const T* in, int n, int k) {
+    heap_.resize(k);
+    for (int i = 0; i < k; i++) {
+      heap_[i] = std::make_pair(in[i], i);
+    }
+    // The front is the smallest item by TopKGreater.
+    std::make_heap(heap_.begin(), heap_.end(), TopKGreater<T>);
+    for (int b = k; b < n; b += kBlock) {
+      const int end = std::min(n, b + kBlock);
+      // A later value equal to the smallest kept one is after it.
+      T threshold = heap_.front().first;
+      int hit = 0;
+      for (int i = b; i < end; i++) {
+        hit |= in[i] > threshold;
+      }
+      if (!hit) continue;
+      for (int i = b; i < end; i++) {
+        if (in[i] > heap_.front().first) {
+          std::pop_heap(heap_.begin(), heap_.end(), TopKGreater<T>);
+          heap_.back() = std::make_pair(in[i], i);
+          std::push_heap(heap_.begin(), heap_.end(), TopKGreater<T>);
+        }
+      }
+    }
+    std::sort_heap(heap_.begin(), heap_.end(), TopKGreater<T>);
+  }
+
+  std::vector<std::pair<T, int>> heap_;
+};
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <string>
 #include <vector>
+#include "lite/backends/host/math/beam_search.h"
 #include "lite/core/context.h"
 #include "lite/core/tensor.h"
 
@@ -102,6 +103,9 @@ class BeamSearchFunctor {
    * selected_ids.
    *   It stores the corresponding scores of candidate ids in selected_ids.
    *
+   *  @searcher: the candidate pools, owned by the kernel to be reused by the
+   * steps of the decoding loop.
+   *
    * Return false if all the input tensor is empty, in machine translation task
    * that means no candidates is provided, and the task will stop running.
    */
@@ -116,7 +120,8 @@ class BeamSearchFunctor {
                   size_t level,
                   size_t beam_size,
                   int end_id,
-                  bool is_accumulated);
+                  bool is_accumulated,
+                  lite::host::math::BeamSearcher* searcher);
 };
 
 }  // namespace math
@@ -0,0 +1,211 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/half_gemm.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/blas.h"
+#include "lite/utils/cp_logging.h"
+
+#ifdef _MSC_VER
+#define LITE_F16C_TARGET
+#else
+#define LITE_F16C_TARGET __attribute__((target("f16c,avx")))
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The number of fp32 values of a converted weight panel, 256KB fits in L2.
+const int kPanelSize = 64 * 1024;
+const int kMinPanelDepth = 16;
+
+bool UseF16C() {
+  static const bool use_f16c = MayIUse(f16c);
+  return use_f16c;
+}
+
+LITE_F16C_TARGET void HalfToFloatF16C(const float16* src,
+                                      float* dst,
+                                      int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+LITE_F16C_TARGET void FloatToHalfF16C(const float* src,
+                                      float16* dst,
+                                      int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),
+                                _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+  }
+  for (; i < n; i++) {
+    dst[i] = float16(src[i]);
+  }
+}
+
+// Converts `rows` rows of `cols` values, the source rows are `ld` apart and
+// the destination is packed.
+void ConvertPanel(
+    const float16* src, int ld, int rows, int cols, float* dst) {
+  if (ld == cols) {
+    HalfToFloat(src, dst, static_cast<int64_t>(rows) * cols);
+    return;
+  }
+  for (int r = 0; r < rows; r++) {
+    HalfToFloat(src + static_cast<int64_t>(r) * ld, dst + r * cols, cols);
+  }
+}
+
+int PanelDepth(int K, int width) {
+  int depth = std::max(kPanelSize / std::max(width, 1), kMinPanelDepth);
+  return std::min(depth, K);
+}
+
+}  // namespace
+
+void HalfToFloat(const float16* src, float* dst, int64_t n) {
+  if (UseF16C()) {
+    HalfToFloatF16C(src, dst, n);
+    return;
+  }
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+void FloatToHalf(const float* src, float16* dst, int64_t n) {
+  if (UseF16C()) {
+    FloatToHalfF16C(src, dst, n);
+    return;
+  }
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = float16(src[i]);
+  }
+}
+
+void HalfWeightGemm(const X86Context& context,
+                    bool trans_a,
+                    bool trans_b,
+                    int M,
+                    int N,
+                    int K,
+                    float alpha,
+                    const float* A,
+                    int lda,
+                    const float16* B,
+                    int ldb,
+                    float beta,
+                    float* C,
+                    int ldc,
+                    std::vector<float>* panel_buffer) {
+  auto blas = GetBlas<lite::TargetType::kX86, float>(context);
+  int depth = PanelDepth(K, N);
+  CHECK(panel_buffer);
+  panel_buffer->resize(static_cast<size_t>(depth) * N);
+  float* panel = panel_buffer->data();
+  for (int k = 0; k < K; k += depth) {
+    int kc = std::min(depth, K - k);
+    // op(B) is K x N: the panel holds its rows [k, k + kc).
+    int ld_panel = 0;
+    if (trans_b) {
+      ConvertPanel(B + k, ldb, N, kc, panel);
+      ld_panel = kc;
+    } else {
+      ConvertPanel(B + static_cast<int64_t>(k) * ldb, ldb, kc, N, panel);
+      ld_panel = N;
+    }
+    const float* a_panel = trans_a ? A + static_cast<int64_t>(k) * lda : A + k;
+    blas.GEMM(trans_a,
+              trans_b,
+              M,
+              N,
+              kc,
+              alpha,
+              a_panel,
+              lda,
+              panel,
+              ld_panel,
+              k == 0 ? beta : 1.f,
+              C,
+              ldc);
+  }
+}
+
+void HalfWeightGemm(const X86Context& context,
+                    bool trans_a,
+                    bool trans_b,
+                    int M,
+                    int N,
+                    int K,
+                    float alpha,
+                    const float16* A,
+                    int lda,
+                    const float* B,
+                    int ldb,
+                    float beta,
+                    float* C,
+                    int ldc,
+                    std::vector<float>* panel_buffer) {
+  auto blas = GetBlas<lite::TargetType::kX86, float>(context);
+  int depth = PanelDepth(K, M);
+  CHECK(panel_buffer);
+  panel_buffer->resize(static_cast<size_t>(depth) * M);
+  float* panel = panel_buffer->data();
+  for (int k = 0; k < K; k += depth) {
+    int kc = std::min(depth, K - k);
+    // op(A) is M x K: the panel holds its columns [k, k + kc).
+    int ld_panel = 0;
+    if (trans_a) {
+      ConvertPanel(A + static_cast<int64_t>(k) * lda, lda, kc, M, panel);
+      ld_panel = M;
+    } else {
+      ConvertPanel(A + k, lda, M, kc, panel);
+      ld_panel = kc;
+    }
+    const float* b_panel = trans_b ? B + k : B + static_cast<int64_t>(k) * ldb;
+    blas.GEMM(trans_a,
+              trans_b,
+              M,
+              N,
+              kc,
+              alpha,
+              panel,
+              ld_panel,
+              b_panel,
+              ldb,
+              k == 0 ? beta : 1.f,
+              C,
+              ldc);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
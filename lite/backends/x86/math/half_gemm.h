@@ -0,0 +1,74 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/utils/float16.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Converts between fp16 and fp32, F16C is used when the CPU supports it.
+void HalfToFloat(const float16* src, float* dst, int64_t n);
+void FloatToHalf(const float* src, float16* dst, int64_t n);
+
+/*
+ * C = alpha * op(A) * op(B) + beta * C, where one of A and B holds fp16
+ * weights. The weights are converted to fp32 by K-panels small enough to stay
+ * in cache and each panel is multiplied by the fp32 GEMM, so the weights are
+ * read from memory at half the size and never expanded as a whole. The
+ * panels are converted into `panel`, which the kernels keep across the runs
+ * so it is only allocated once.
+ */
+void HalfWeightGemm(const X86Context& context,
+                    bool trans_a,
+                    bool trans_b,
+                    int M,
+                    int N,
+                    int K,
+                    float alpha,
+                    const float* A,
+                    int lda,
+                    const float16* B,
+                    int ldb,
+                    float beta,
+                    float* C,
+                    int ldc,
+                    std::vector<float>* panel);
+
+void HalfWeightGemm(const X86Context& context,
+                    bool trans_a,
+                    bool trans_b,
+                    int M,
+                    int N,
+                    int K,
+                    float alpha,
+                    const float16* A,
+                    int lda,
+                    const float* B,
+                    int ldb,
+                    float beta,
+                    float* C,
+                    int ldc,
+                    std::vector<float>* panel);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
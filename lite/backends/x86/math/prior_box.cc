@@ -0,0 +1,316 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/prior_box.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+inline bool IsUnitRatio(float ar) { return std::fabs(ar - 1.f) < 1e-6f; }
+
+inline void WriteBox(float center_x,
+                     float center_y,
+                     float box_w,
+                     float box_h,
+                     float img_w,
+                     float img_h,
+                     float* out) {
+  out[0] = (center_x - box_w / 2.f) / img_w;
+  out[1] = (center_y - box_h / 2.f) / img_h;
+  out[2] = (center_x + box_w / 2.f) / img_w;
+  out[3] = (center_y + box_h / 2.f) / img_h;
+}
+
+// The density boxes are only clamped at the sides they may cross.
+inline void WriteDensityBox(float center_x,
+                            float center_y,
+                            float box_w,
+                            float box_h,
+                            float img_w,
+                            float img_h,
+                            float* out) {
+  WriteBox(center_x, center_y, box_w, box_h, img_w, img_h, out);
+  out[0] = std::max(out[0], 0.f);
+  out[1] = std::max(out[1], 0.f);
+  out[2] = std::min(out[2], 1.f);
+  out[3] = std::min(out[3], 1.f);
+}
+
+// Writes the box of the s-th max size, returns the end of the box.
+inline float* PriorBoxMax(const PriorBoxConfig& config,
+                          size_t s,
+                          float center_x,
+                          float center_y,
+                          float* out) {
+  // The sizes are truncated to integers as the reference kernels.
+  int min_size = config.min_sizes[s];
+  int max_size = config.max_sizes[s];
+  float size = sqrtf(min_size * max_size);
+  WriteBox(center_x, center_y, size, size, config.img_w, config.img_h, out);
+  return out + 4;
+}
+
+// Writes the priors of a cell of prior_box.
+void PriorBoxCell(const PriorBoxConfig& config,
+                  float center_x,
+                  float center_y,
+                  float* out) {
+  const float img_w = config.img_w;
+  const float img_h = config.img_h;
+  float* ptr = out;
+  for (size_t s = 0; s < config.min_sizes.size(); ++s) {
+    int min_size = config.min_sizes[s];
+    WriteBox(center_x, center_y, min_size, min_size, img_w, img_h, ptr);
+    ptr += 4;
+    const bool has_max = !config.max_sizes.empty();
+    if (has_max && config.min_max_aspect_ratios_order) {
+      ptr = PriorBoxMax(config, s, center_x, center_y, ptr);
+    }
+    for (auto ar : config.aspect_ratios) {
+      if (IsUnitRatio(ar)) continue;
+      float box_w = min_size * std::sqrt(ar);
+      float box_h = min_size / std::sqrt(ar);
+      WriteBox(center_x, center_y, box_w, box_h, img_w, img_h, ptr);
+      ptr += 4;
+    }
+    if (has_max && !config.min_max_aspect_ratios_order) {
+      ptr = PriorBoxMax(config, s, center_x, center_y, ptr);
+    }
+  }
+}
+
+// Writes the priors of a cell of density_prior_box.
+void DensityPriorBoxCell(const PriorBoxConfig& config,
+                         float center_x,
+                         float center_y,
+                         float* out) {
+  const float img_w = config.img_w;
+  const float img_h = config.img_h;
+  const int step_average =
+      static_cast<int>((config.step_w + config.step_h) * 0.5f);
+  float* ptr = out;
+  for (size_t s = 0; s < config.fixed_sizes.size(); ++s) {
+    int fixed_size = config.fixed_sizes[s];
+    int density = config.density_sizes[s];
+    if (!config.fixed_ratios.empty()) {
+      int shift = step_average / density;
+      float start_x = center_x - step_average / 2.f + shift / 2.f;
+      float start_y = center_y - step_average / 2.f + shift / 2.f;
+      for (auto ar : config.fixed_ratios) {
+        float box_w = config.fixed_sizes[s] * std::sqrt(ar);
+        float box_h = config.fixed_sizes[s] / std::sqrt(ar);
+        for (int p = 0; p < density; ++p) {
+          for (int c = 0; c < density; ++c) {
+            WriteDensityBox(start_x + c * shift,
+                            start_y + p * shift,
+                            box_w,
+                            box_h,
+                            img_w,
+                            img_h,
+                            ptr);
+            ptr += 4;
+          }
+        }
+      }
+      continue;
+    }
+    int shift = config.fixed_sizes[s] / density;
+    float start_x = center_x - fixed_size / 2.f + shift / 2.f;
+    float start_y = center_y - fixed_size / 2.f + shift / 2.f;
+    for (int p = 0; p < density; ++p) {
+      for (int c = 0; c < density; ++c) {
+        WriteDensityBox(start_x + c * shift,
+                        start_y + p * shift,
+                        fixed_size,
+                        fixed_size,
+                        img_w,
+                        img_h,
+                        ptr);
+        ptr += 4;
+      }
+    }
+    for (auto ar : config.aspect_ratios) {
+      if (IsUnitRatio(ar)) continue;
+      float box_w = config.fixed_sizes[s] * std::sqrt(ar);
+      float box_h = config.fixed_sizes[s] / std::sqrt(ar);
+      for (int p = 0; p < density; ++p) {
+        for (int c = 0; c < density; ++c) {
+          WriteDensityBox(start_x + c * shift,
+                          start_y + p * shift,
+                          box_w,
+                          box_h,
+                          img_w,
+                          img_h,
+                          ptr);
+          ptr += 4;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void ExpandAspectRatios(const std::vector<float>& input_aspect_ratios,
+                        bool flip,
+                        std::vector<float>* output_aspect_ratios) {
+  constexpr float epsilon = 1e-6;
+  output_aspect_ratios->clear();
+  output_aspect_ratios->push_back(1.0f);
+  for (auto ar : input_aspect_ratios) {
+    bool already_exist = false;
+    for (auto exist : *output_aspect_ratios) {
+      if (std::fabs(ar - exist) < epsilon) {
+        already_exist = true;
+        break;
+      }
+    }
+    if (!already_exist) {
+      output_aspect_ratios->push_back(ar);
+      if (flip) {
+        output_aspect_ratios->push_back(1.0f / ar);
+      }
+    }
+  }
+}
+
+int PriorBoxNum(const PriorBoxConfig& config) {
+  int num_ratios = 0;
+  for (auto ar : config.aspect_ratios) {
+    if (!IsUnitRatio(ar)) num_ratios++;
+  }
+  int num = 0;
+  if (config.fixed_sizes.empty()) {
+    for (size_t s = 0; s < config.min_sizes.size(); ++s) {
+      num += 1 + num_ratios + (config.max_sizes.empty() ? 0 : 1);
+    }
+    return num;
+  }
+  CHECK_EQ(config.fixed_sizes.size(), config.density_sizes.size())
+      << "fixed_sizes should be same with density_sizes";
+  for (size_t s = 0; s < config.fixed_sizes.size(); ++s) {
+    int density = config.density_sizes[s];
+    CHECK_GT(density, 0);
+    int ratios = config.fixed_ratios.empty()
+                     ? 1 + num_ratios
+                     : static_cast<int>(config.fixed_ratios.size());
+    num += ratios * density * density;
+  }
+  return num;
+}
+
+void PriorBox(const PriorBoxConfig& config,
+              int height,
+              int width,
+              float* boxes,
+              float* variances) {
+  CHECK_EQ(config.variances.size(), 4UL);
+  if (!config.fixed_sizes.empty()) {
+    CHECK_EQ(config.fixed_sizes.size(), config.density_sizes.size())
+        << "fixed_sizes should be same with density_sizes";
+  } else if (!config.max_sizes.empty()) {
+    CHECK_EQ(config.min_sizes.size(), config.max_sizes.size());
+  }
+  const int64_t cell_size = PriorBoxNum(config) * 4;
+  const bool density = !config.fixed_sizes.empty();
+  lite::x86::RunParallelFor(0, height, [&](int64_t begin, int64_t end) {
+    for (int64_t h = begin; h < end; ++h) {
+      for (int w = 0; w < width; ++w) {
+        int64_t offset = (h * width + w) * cell_size;
+        float* cell = boxes + offset;
+        float center_x = (w + config.offset) * config.step_w;
+        float center_y = (h + config.offset) * config.step_h;
+        if (density) {
+          DensityPriorBoxCell(config, center_x, center_y, cell);
+        } else {
+          PriorBoxCell(config, center_x, center_y, cell);
+        }
+        if (config.clip) {
+          for (int64_t i = 0; i < cell_size; ++i) {
+            cell[i] = std::min(std::max(cell[i], 0.f), 1.f);
+          }
+        }
+        float* var = variances + offset;
+        for (int64_t i = 0; i < cell_size; ++i) {
+          var[i] = config.variances[i & 3];
+        }
+      }
+    }
+  });
+}
+
+void AnchorGenerator(int height,
+                     int width,
+                     const std::vector<float>& anchor_sizes,
+                     const std::vector<float>& aspect_ratios,
+                     const std::vector<float>& stride,
+                     const std::vector<float>& variances,
+                     float offset,
+                     float* anchors,
+                     float* anchor_variances) {
+  CHECK_EQ(stride.size(), 2UL);
+  CHECK_EQ(variances.size(), 4UL);
+  const float stride_w = stride[0];
+  const float stride_h = stride[1];
+  const int64_t cell_size = aspect_ratios.size() * anchor_sizes.size() * 4;
+  // The anchor sizes are the same at every cell, only the centers move.
+  std::vector<float> half_w;
+  std::vector<float> half_h;
+  for (auto ar : aspect_ratios) {
+    float area_ratios = stride_w * stride_h / ar;
+    float base_w = std::round(std::sqrt(area_ratios));
+    float base_h = std::round(base_w * ar);
+    for (auto anchor_size : anchor_sizes) {
+      float anchor_w = anchor_size / stride_w * base_w;
+      float anchor_h = anchor_size / stride_h * base_h;
+      half_w.push_back(0.5 * (anchor_w - 1));
+      half_h.push_back(0.5 * (anchor_h - 1));
+    }
+  }
+  const int num_anchors = static_cast<int>(half_w.size());
+  lite::x86::RunParallelFor(0, height, [&](int64_t begin, int64_t end) {
+    for (int64_t h = begin; h < end; ++h) {
+      float y_ctr = (h * stride_h) + offset * (stride_h - 1);
+      for (int w = 0; w < width; ++w) {
+        float x_ctr = (w * stride_w) + offset * (stride_w - 1);
+        int64_t cell_offset = (h * width + w) * cell_size;
+        float* cell = anchors + cell_offset;
+        for (int i = 0; i < num_anchors; ++i) {
+          cell[i * 4] = x_ctr - half_w[i];
+          cell[i * 4 + 1] = y_ctr - half_h[i];
+          cell[i * 4 + 2] = x_ctr + half_w[i];
+          cell[i * 4 + 3] = y_ctr + half_h[i];
+        }
+        float* var = anchor_variances + cell_offset;
+        for (int64_t i = 0; i < cell_size; ++i) {
+          var[i] = variances[i & 3];
+        }
+      }
+    }
+  });
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,82 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Expands the aspect ratios as the prior_box op: 1 first, then the ratios
+// not seen before and their reciprocals if flip.
+void ExpandAspectRatios(const std::vector<float>& input_aspect_ratios,
+                        bool flip,
+                        std::vector<float>* output_aspect_ratios);
+
+// The attributes of prior_box and density_prior_box, the sizes of the
+// image and the steps are the resolved ones.
+struct PriorBoxConfig {
+  int img_w{0};
+  int img_h{0};
+  float step_w{0.f};
+  float step_h{0.f};
+  float offset{0.5f};
+  bool clip{false};
+  bool min_max_aspect_ratios_order{false};
+  std::vector<float> min_sizes;
+  std::vector<float> max_sizes;
+  // The expanded ratios for prior_box, the raw ones for density_prior_box.
+  std::vector<float> aspect_ratios;
+  std::vector<float> variances;
+  std::vector<float> fixed_sizes;
+  std::vector<float> fixed_ratios;
+  std::vector<int> density_sizes;
+};
+
+// Returns the number of the priors generated at each feature cell.
+int PriorBoxNum(const PriorBoxConfig& config);
+
+/*
+ * Generates the [height, width, prior_num, 4] boxes and variances of
+ * prior_box, or of density_prior_box if the fixed sizes are given, with the
+ * same values as the reference kernels. The cells are independent, so the
+ * rows are generated in parallel.
+ */
+void PriorBox(const PriorBoxConfig& config,
+              int height,
+              int width,
+              float* boxes,
+              float* variances);
+
+/*
+ * Generates the [height, width, num_anchors, 4] anchors and variances of
+ * anchor_generator, the rows are generated in parallel.
+ */
+void AnchorGenerator(int height,
+                     int width,
+                     const std::vector<float>& anchor_sizes,
+                     const std::vector<float>& aspect_ratios,
+                     const std::vector<float>& stride,
+                     const std::vector<float>& variances,
+                     float offset,
+                     float* anchors,
+                     float* anchor_variances);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,124 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/quant_weight_gemm.h"
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/math/blas.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The number of fp32 values of a dequantized weight panel, 256KB fits in L2.
+const int kPanelSize = 64 * 1024;
+const int kMinPanelDepth = 16;
+
+// The panels start at even rows, so the int4 pairs are never split.
+int PanelDepth(int width, int K) {
+  int depth = std::max(kPanelSize / std::max(width, 1), kMinPanelDepth) & ~1;
+  return std::min(depth, K);
+}
+
+}  // namespace
+
+void QuantWeightGemm(const X86Context& context,
+                     bool trans_a,
+                     int M,
+                     int N,
+                     int K,
+                     float alpha,
+                     const float* A,
+                     int lda,
+                     const int8_t* B,
+                     const float* scale,
+                     int bits,
+                     float beta,
+                     float* C,
+                     int ldc,
+                     std::vector<float>* panel_buffer) {
+  CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+  auto blas = GetBlas<lite::TargetType::kX86, float>(context);
+  int depth = PanelDepth(N, K);
+  CHECK(panel_buffer);
+  panel_buffer->resize(static_cast<size_t>(depth) * N);
+  float* panel = panel_buffer->data();
+  for (int k = 0; k < K; k += depth) {
+    int kc = std::min(depth, K - k);
+    DequantizeWeight(B, scale, k, kc, N, bits, panel);
+    const float* a_panel = trans_a ? A + static_cast<int64_t>(k) * lda : A + k;
+    blas.GEMM(trans_a,
+              false,
+              M,
+              N,
+              kc,
+              alpha,
+              a_panel,
+              lda,
+              panel,
+              N,
+              k == 0 ? beta : 1.f,
+              C,
+              ldc);
+  }
+}
+
+void QuantWeightGemm(const X86Context& context,
+                     int M,
+                     int N,
+                     int K,
+                     float alpha,
+                     const int8_t* A,
+                     const float* scale,
+                     int bits,
+                     const float* B,
+                     int ldb,
+                     float beta,
+                     float* C,
+                     int ldc,
+                     std::vector<float>* panel_buffer) {
+  CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+  auto blas = GetBlas<lite::TargetType::kX86, float>(context);
+  int depth = PanelDepth(M, K);
+  CHECK(panel_buffer);
+  panel_buffer->resize(static_cast<size_t>(depth) * M);
+  float* panel = panel_buffer->data();
+  for (int k = 0; k < K; k += depth) {
+    int kc = std::min(depth, K - k);
+    // The panel holds the rows [k, k + kc) of A, which are the columns of
+    // A^T.
+    DequantizeWeight(A, scale, k, kc, M, bits, panel);
+    blas.GEMM(true,
+              false,
+              M,
+              N,
+              kc,
+              alpha,
+              panel,
+              M,
+              B + static_cast<int64_t>(k) * ldb,
+              ldb,
+              k == 0 ? beta : 1.f,
+              C,
+              ldc);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -17,6 +17,7 @@ limitations under the License. */
 #include <vector>
 
 #include "lite/core/context.h"
+#include "lite/core/scratch_arena.h"
 #include "lite/core/tensor.h"
 #include "lite/fluid/eigen.h"
 #include "lite/utils/cp_logging.h"
@@ -65,7 +66,7 @@ class LoDTensor2BatchFunctor {
                   bool is_cal_batch_lod,
                   bool is_reverse = false) const {
     if (!is_cal_batch_lod) {
-      auto lods = batch->lod();
+      const auto& lods = batch->lod();
       CHECK_GT(lods.size(), 2UL)
           << "The LoD of LoDTensor should inlcude at least 2-level "
              "sequence information.";
@@ -76,12 +77,14 @@ class LoDTensor2BatchFunctor {
       return;
     }
 
-    auto lods = lod_tensor.lod();
+    const auto& lods = lod_tensor.lod();
     CHECK_EQ(lods.size(), 1UL) << "Only support one level sequence now.";
 
     const auto& lod = lods[0];
 
-    std::vector<SeqInfo> seq_info(lod.size() - 1);
+    lite::ScratchScope scratch(context.scratch_arena());
+    lite::ScratchVector<SeqInfo> seq_info(
+        lod.size() - 1, SeqInfo(), scratch.arena());
     for (size_t seq_id = 0; seq_id < lod.size() - 1; ++seq_id) {
       int length = lod[seq_id + 1] - lod[seq_id];
       seq_info[seq_id].start = lod[seq_id];
@@ -89,9 +92,14 @@ class LoDTensor2BatchFunctor {
       seq_info[seq_id].seq_idx = seq_id;
     }
 
-    std::stable_sort(seq_info.begin(),
-                     seq_info.end(),
-                     [](SeqInfo a, SeqInfo b) { return a.length > b.length; });
+    // Ties are broken by index so the order matches std::stable_sort without
+    // its temporary buffer.
+    std::sort(seq_info.begin(),
+              seq_info.end(),
+              [](const SeqInfo& a, const SeqInfo& b) {
+                return a.length > b.length ||
+                       (a.length == b.length && a.seq_idx < b.seq_idx);
+              });
 
     // Calculate the start position of each batch.
     // example:  sequences = {s0, s1, s2}
@@ -161,7 +169,7 @@ class Batch2LoDTensorFunctor {
   void operator()(const lite::Context<Target>& context,
                   const lite::Tensor& batch,
                   lite::Tensor* lod_tensor) const {
-    auto in_lod = batch.lod();
+    const auto& in_lod = batch.lod();
     CHECK_GT(in_lod.size(), 2UL)
         << "The LoD of LoDTensor should inlcude at least 2-level "
            "sequence information.";
@@ -19,10 +19,10 @@ namespace lite {
 namespace x86 {
 namespace math {
 
-template <typename T>
+template <typename T, typename Offsets>
 void CopyValidData(lite::Tensor* dst_tensor,
                    const lite::Tensor* src_tensor,
-                   const std::vector<uint64_t>& seq_offsets,
+                   const Offsets& seq_offsets,
                    int pad_seq_len,
                    int step_width,
                    bool norm_by_len,
@@ -92,8 +92,9 @@ class PaddingLoDTensorFunctor<lite::TargetType::kX86, T> {
                   int lod_level = 0,
                   bool norm_by_times = false,
                   const PadLayout layout = kBatchLengthWidth) {
-    auto seq_lod = seq_tensor.lod();
-    const auto seq_offsets = lite::fluid::ToAbsOffset(seq_lod)[lod_level];
+    lite::ScratchScope scratch(context.scratch_arena());
+    lite::ScratchVector<uint64_t> seq_offsets(scratch.arena());
+    lite::fluid::ToAbsOffsetLevel(seq_tensor.lod(), lod_level, &seq_offsets);
     const auto& seq_tensor_dims = seq_tensor.dims();
     const auto& pad_tensor_dims = pad_tensor->dims();
     if (pad_seq_len == -1) {
@@ -144,7 +145,9 @@ class UnpaddingLoDTensorFunctor<lite::TargetType::kX86, T> {
                   int lod_level = 0,
                   bool norm_by_times = false,
                   const PadLayout layout = kBatchLengthWidth) {
-    auto seq_offsets = lite::fluid::ToAbsOffset(seq_tensor->lod())[lod_level];
+    lite::ScratchScope scratch(context.scratch_arena());
+    lite::ScratchVector<uint64_t> seq_offsets(scratch.arena());
+    lite::fluid::ToAbsOffsetLevel(seq_tensor->lod(), lod_level, &seq_offsets);
     const auto& seq_tensor_dims = seq_tensor->dims();
     const auto& pad_tensor_dims = pad_tensor.dims();
     if (pad_seq_len == -1) {
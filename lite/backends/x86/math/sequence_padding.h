@@ -30,8 +30,8 @@ enum PadLayout { kBatchLengthWidth = 0, kLengthBatchWidth };
 
 enum CopyType { kSeqToPad, kPadToSeq };
 
-inline static uint64_t MaximumSequenceLength(
-    const std::vector<uint64_t>& seq_offset) {
+template <typename Offsets>
+inline static uint64_t MaximumSequenceLength(const Offsets& seq_offset) {
   uint64_t seq_num = seq_offset.size() - 1;
   uint64_t max_seq_len = 0;
   for (size_t i = 0; i < seq_num; ++i) {
@@ -40,9 +40,10 @@ inline static uint64_t MaximumSequenceLength(
   return max_seq_len;
 }
 
+template <typename Offsets>
 inline static void CheckDims(const lite::DDim& seq_tensor_dims,
                              const lite::DDim& pad_tensor_dims,
-                             const std::vector<uint64_t>& seq_offset,
+                             const Offsets& seq_offset,
                              int64_t padded_seq_len,
                              int64_t step_width,
                              const PadLayout& layout) {
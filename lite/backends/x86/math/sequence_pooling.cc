@@ -53,7 +53,7 @@ class MaxSeqPoolFunctor {
     }
     CHECK_EQ(idx_dims, out_dims);
 
-    auto starts = input.lod()[0];
+    const auto& starts = input.lod()[0];
     const T* in_data = input.data<T>();
     T* out_data = output->template mutable_data<T>();
     int* max_index = index->mutable_data<int>();
@@ -101,7 +101,7 @@ class MaxSeqPoolFunctor<T, true> {
       CHECK_EQ(in_dims[i], out_dims[i]);
     }
 
-    auto starts = input.lod()[0];
+    const auto& starts = input.lod()[0];
     const T* in_data = input.data<T>();
     T* out_data = output->template mutable_data<T>();
 
@@ -174,7 +174,7 @@ class LastSeqPoolFunctor {
 
     // Calculate the size of each item in sequence
     int64_t item_size = input.numel() / input.dims()[0];
-    auto lod = input.lod()[0];
+    const auto& lod = input.lod()[0];
     int seq_num = static_cast<int>(lod.size()) - 1;
     for (int i = 0; i < seq_num; ++i) {
       // Calculate the length of each sequence
@@ -207,7 +207,7 @@ class FirstSeqPoolFunctor {
 
     // Calculate the size of each item in sequence
     int64_t item_size = input.numel() / input.dims()[0];
-    auto lod = input.lod()[0];
+    const auto& lod = input.lod()[0];
     int seq_num = static_cast<int>(lod.size()) - 1;
     for (int i = 0; i < seq_num; ++i) {
       // Calculate the length of each sequence
@@ -233,7 +233,7 @@ class SumSeqPoolGradFunctor {
   void operator()(const lite::X86Context& context,
                   const lite::Tensor& out_grad,
                   lite::Tensor* in_grad) {
-    auto lod = in_grad->lod()[0];
+    const auto& lod = in_grad->lod()[0];
     int64_t out_w = out_grad.numel() / out_grad.dims()[0];
     int64_t in_w = in_grad->numel() / in_grad->dims()[0];
     CHECK(in_w == out_w);
@@ -285,7 +285,7 @@ class SequencePoolFunctor<TARGET(kX86), T> {
       return;
     }
 
-    auto lod = input.lod()[0];
+    const auto& lod = input.lod()[0];
     if (pooltype == "SUM") {
       const T* src = input.data<T>();
       T* dst = output->template mutable_data<T>(TARGET(kX86));
@@ -363,7 +363,7 @@ class SequencePoolGradFunctor<TARGET(kX86), T> {
       return;
     }
 
-    auto lod = in_grad->lod()[0];
+    const auto& lod = in_grad->lod()[0];
 
     auto eigen_device = lite::fluid::EigenDeviceType<TARGET(kX86)>();
     for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
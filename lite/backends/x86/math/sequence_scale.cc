@@ -13,7 +13,6 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/x86/math/sequence_scale.h"
-#include "lite/fluid/lod.h"
 
 namespace paddle {
 namespace lite {
@@ -27,10 +26,9 @@ class ScaleLoDTensorFunctor<lite::TargetType::kX86, T> {
                   const T* scales,
                   lite::Tensor* seq) {
     const size_t level = 0;
-    auto lod = seq->lod();
+    const auto& lod = seq->lod();
     const size_t num_seq = lod[level].size() - 1;
     size_t seq_width = seq->dims()[1];
-    lite::LoD abs_offset_lod = lite::fluid::ToAbsOffset(lod);
 
     T* seq_data = seq->template mutable_data<T>(lite::TargetType::kX86);
     for (size_t i = 0; i < num_seq; ++i) {
@@ -15,43 +15,30 @@ limitations under the License. */
 #include "lite/backends/x86/math/sequence_topk_avg_pooling.h"
 #include <algorithm>
 #include <vector>
+#include "lite/backends/host/math/topk.h"
+#include "lite/core/scratch_arena.h"
+#include "lite/fluid/lod.h"
 
 namespace paddle {
 namespace lite {
 namespace x86 {
 namespace math {
 
+// Writes the positions of the top min(k, length) values in the descending
+// order, and -1 to the rest of the k positions.
 template <typename T>
-void get_topk_pos(const T* data, int length, int k, int* pos, bool debug) {
-  size_t real_k = k < length ? k : length;
-
-  std::vector<T> v(data, data + length);
-
-  std::vector<int> topk_pos;
-  T min_val = -10000000.0;
-  while (topk_pos.size() < real_k) {
-    T max_val = min_val;
-    int max_pos = -1;
-    for (int i = 0; i < length; ++i) {
-      if (v[i] > max_val) {
-        max_pos = i;
-        max_val = v[i];
-      }
-    }
-
-    assert(max_pos >= 0);
-
-    topk_pos.push_back(max_pos);
-    v[max_pos] = min_val;
+void get_topk_pos(host::math::TopKSelector<T>* selector,
+                  const T* data,
+                  int length,
+                  int k,
+                  T* values,
+                  int* pos) {
+  int real_k = k < length ? k : length;
+  if (real_k > 0) {
+    selector->Select(data, length, real_k, values, pos);
   }
-
-  assert(topk_pos.size() > 0);
-  while (topk_pos.size() < (size_t)k) {
-    topk_pos.push_back(-1);
-  }
-
-  for (size_t i = 0; i < topk_pos.size(); ++i) {
-    pos[i] = topk_pos[i];
+  for (int i = real_k; i < k; ++i) {
+    pos[i] = -1;
   }
 }
 
@@ -62,42 +49,34 @@ void get_topk_pos(const T* data, int length, int k, int* pos, bool debug) {
 template <typename T>
 class SequenceTopkAvgPoolingFunctor<lite::TargetType::kX86, T> {
  public:
-  void operator()(const lite::Tensor& in,
+  void operator()(const lite::Context<lite::TargetType::kX86>& context,
+                  const lite::Tensor& in,
                   const lite::Tensor& row,
                   const lite::Tensor& col,
                   lite::Tensor* out,
                   lite::Tensor* pos,
                   int channel_num,
-                  std::vector<int> topks) {
+                  const std::vector<int>& topks) {
     auto k_num = topks.size();
     auto max_k = topks[topks.size() - 1];
-    std::vector<int64_t> vec_pos_shape;
-    auto in_lod = in.lod()[0];
-    auto row_lod = row.lod()[0];
-    auto col_lod = col.lod()[0];
+    const auto& in_lod = in.lod()[0];
+    const auto& row_lod = row.lod()[0];
+    const auto& col_lod = col.lod()[0];
     int batch_size = row_lod.size() - 1;
     int pos_total_size = row_lod[batch_size] * channel_num * max_k;
-    vec_pos_shape.push_back(pos_total_size);
-    lite::DDim dims(vec_pos_shape);
-    pos->Resize(dims);
+    pos->Resize({pos_total_size});
     auto pos_data = pos->mutable_data<int>(lite::TargetType::kX86);
 
-    int offset = 0;
-    std::vector<uint64_t> vec_out_lod;
-    vec_out_lod.reserve(batch_size + 1);
-    for (int i = 0; i <= batch_size; ++i) {
-      offset = row_lod[i];
-      vec_out_lod.push_back(offset);
-    }
-
-    lite::LoD lod_temp;
-    lod_temp.push_back(vec_out_lod);
-    out->set_lod(lod_temp);
+    lite::fluid::SetSingleLevelLoD(
+        row_lod.begin(), row_lod.end(), out->mutable_lod());
 
     auto in_data = in.data<T>();
     auto out_data = out->template mutable_data<T>(lite::TargetType::kX86);
 
-    T* sum_data = new T[max_k];
+    lite::ScratchScope scratch(context.scratch_arena());
+    lite::ScratchVector<T> sum_data(max_k, T(0), scratch.arena());
+    host::math::TopKSelector<T> selector;
+    lite::ScratchVector<T> topk_values(max_k, T(0), scratch.arena());
     for (int i = 0; i < batch_size; ++i) {
       int total_size = in_lod[i + 1] - in_lod[i];
       int row_size = row_lod[i + 1] - row_lod[i];
@@ -117,7 +96,12 @@ class SequenceTopkAvgPoolingFunctor<lite::TargetType::kX86, T> {
           auto out_slice_data = out_data + row_lod[i] * channel_num * k_num +
                                 r * channel_num * k_num + j * k_num;
 
-          get_topk_pos<T>(row_data, col_size, max_k, pos_slice_data);
+          get_topk_pos<T>(&selector,
+                          row_data,
+                          col_size,
+                          max_k,
+                          topk_values.data(),
+                          pos_slice_data);
           if (pos_slice_data[0] == -1) {
             sum_data[0] = 0.0;
           } else {
@@ -136,7 +120,6 @@ class SequenceTopkAvgPoolingFunctor<lite::TargetType::kX86, T> {
         }
       }
     }
-    delete[] sum_data;
   }
 };
 
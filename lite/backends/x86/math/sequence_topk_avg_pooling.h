@@ -22,20 +22,18 @@ namespace paddle {
 namespace lite {
 namespace x86 {
 namespace math {
-template <typename T>
-void get_topk_pos(
-    const T* data, int length, int k, int* pos, bool debug = false);
 
 template <lite::TargetType Target, typename T>
 class SequenceTopkAvgPoolingFunctor {
  public:
-  void operator()(const lite::Tensor& X,
+  void operator()(const lite::Context<Target>& context,
+                  const lite::Tensor& X,
                   const lite::Tensor& ROW,
                   const lite::Tensor& COLUMN,
                   lite::Tensor* Out,
                   lite::Tensor* pos,
                   int channel_num,
-                  std::vector<int> topks);
+                  const std::vector<int>& topks);
 };
 
 }  // namespace math
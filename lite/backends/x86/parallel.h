@@ -15,57 +15,57 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 #include "lite/backends/x86/mklml.h"
 #endif
+#include "lite/backends/x86/thread_pool.h"
 
 namespace paddle {
 namespace lite {
 namespace x86 {
 
 static void SetNumThreads(int num_threads) {
-#ifdef PADDLE_WITH_MKLML
   int real_num_threads = std::max(num_threads, 1);
+  ThreadPool::Global()->SetNumThreads(real_num_threads);
+#ifdef PADDLE_WITH_MKLML
   x86::MKL_Set_Num_Threads(real_num_threads);
   omp_set_num_threads(real_num_threads);
 #endif
 }
 
 static inline int64_t GetMaxThreads() {
-  int64_t num_threads = 1;
-#ifdef PADDLE_WITH_MKLML
-  // Do not support nested omp parallem.
-  num_threads = omp_in_parallel() ? 1 : omp_get_max_threads();
-#endif
-  return std::max<int>(num_threads, 1L);
+  // Do not support nested parallel regions.
+  if (ThreadPool::InParallelRegion()) {
+    return 1;
+  }
+  int64_t max_threads = ThreadPool::Global()->num_threads();
+  if (ThreadPool::GetThreadLocalMaxThreads() > 0) {
+    max_threads = std::min<int64_t>(max_threads,
+                                    ThreadPool::GetThreadLocalMaxThreads());
+  }
+  return std::max<int64_t>(max_threads, 1L);
 }
 
 using ThreadHandler =
     std::function<void(const int64_t begin, const int64_t end)>;
 
+// Runs on the persistent x86 thread pool whatever the BLAS library is, so
+// the kernels are multi-threaded in builds without MKLML/OpenMP too.
 static inline void RunParallelFor(const int64_t begin,
                                   const int64_t end,
-                                  const ThreadHandler& f) {
-  if (begin >= end) {
-    return;
-  }
-
-#ifdef PADDLE_WITH_MKLML
-  int64_t num_threads = std::min(GetMaxThreads(), end - begin);
-  if (num_threads > 1) {
-#pragma omp parallel num_threads(num_threads)
-    {
-      int64_t tid = omp_get_thread_num();
-      int64_t chunk_size = (end - begin + num_threads - 1) / num_threads;
-      int64_t begin_tid = begin + tid * chunk_size;
-      f(begin_tid, std::min(end, chunk_size + begin_tid));
-    }
-    return;
-  }
-#endif
+                                  const ThreadHandler& f,
+                                  const int64_t grain = 1) {
+  ThreadPool::Global()->ParallelFor(begin, end, grain, f);
+}
 
-  f(begin, end);
+static inline void RunParallel2D(const int64_t rows,
+                                 const int64_t cols,
+                                 const int64_t tile_rows,
+                                 const int64_t tile_cols,
+                                 const ThreadPool::TileFunc& f) {
+  ThreadPool::Global()->Parallel2D(rows, cols, tile_rows, tile_cols, f);
 }
 
 }  // namespace x86
@@ -0,0 +1,254 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/thread_pool.h"
+#include <algorithm>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(PADDLE_WITH_MKLML) && !defined(LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/mklml.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+
+namespace {
+
+// Every worker gets about kChunksPerThread chunks so that stealing can
+// balance uneven iterations without paying an atomic per iteration.
+constexpr int64_t kChunksPerThread = 4;
+
+thread_local bool tls_in_parallel_region = false;
+thread_local int tls_max_threads = 0;
+
+inline void CpuRelax() {
+#if defined(__SSE2__) || defined(_M_X64)
+  _mm_pause();
+#endif
+}
+
+}  // namespace
+
+constexpr int ThreadPool::kDefaultSpinCount;
+
+std::shared_ptr<ThreadPool> ThreadPool::Global() {
+  static std::shared_ptr<ThreadPool> x(new ThreadPool);
+  return x;
+}
+
+bool ThreadPool::InParallelRegion() { return tls_in_parallel_region; }
+
+void ThreadPool::SetThreadLocalMaxThreads(int max_threads) {
+  tls_max_threads = std::max(max_threads, 0);
+}
+
+int ThreadPool::GetThreadLocalMaxThreads() { return tls_max_threads; }
+
+ThreadPool::ThreadPool(int num_threads, int spin_count, bool bind_core)
+    : num_threads_(std::max(num_threads, 1)),
+      spin_count_(spin_count),
+      bind_core_(bind_core) {
+  StartWorkers();
+}
+
+ThreadPool::~ThreadPool() { StopWorkers(); }
+
+void ThreadPool::SetNumThreads(int num_threads) {
+  num_threads = std::max(num_threads, 1);
+  std::lock_guard<std::mutex> lock(dispatch_mutex_);
+  if (num_threads == num_threads_) return;
+  StopWorkers();
+  num_threads_ = num_threads;
+  StartWorkers();
+}
+
+void ThreadPool::ReserveThreads(int num_threads) {
+  std::lock_guard<std::mutex> lock(dispatch_mutex_);
+  if (num_threads <= num_threads_) return;
+  StopWorkers();
+  num_threads_ = num_threads;
+  StartWorkers();
+}
+
+void ThreadPool::SetCoreBinding(bool bind_core) {
+  std::lock_guard<std::mutex> lock(dispatch_mutex_);
+  if (bind_core == bind_core_) return;
+  StopWorkers();
+  bind_core_ = bind_core;
+  StartWorkers();
+}
+
+void ThreadPool::StartWorkers() {
+  slices_.reset(new Slice[num_threads_]);
+  stop_ = false;
+  generation_ = 0;
+  for (int i = 1; i < num_threads_; ++i) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+void ThreadPool::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void ThreadPool::BindCurrentThread(int id) {
+#if defined(__linux__) && !defined(__ANDROID__)
+  int num_cores = static_cast<int>(std::thread::hardware_concurrency());
+  if (num_cores <= 0) return;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(id % num_cores, &mask);
+  pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+#endif
+}
+
+void ThreadPool::WorkerLoop(int id) {
+  if (bind_core_) BindCurrentThread(id);
+  uint64_t seen = 0;
+  while (true) {
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    int spins = 0;
+    while (generation == seen) {
+      if (stop_.load(std::memory_order_acquire)) return;
+      if (++spins < spin_count_) {
+        CpuRelax();
+      } else {
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [&] {
+          return stop_ || generation_.load(std::memory_order_acquire) != seen;
+        });
+        if (stop_) return;
+        spins = 0;
+      }
+      generation = generation_.load(std::memory_order_acquire);
+    }
+    seen = generation;
+    if (id < active_threads_) {
+      RunChunks(id);
+    }
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+void ThreadPool::RunChunks(int id) {
+  tls_in_parallel_region = true;
+#if defined(PADDLE_WITH_MKLML) && !defined(LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // The pool already owns the cores, MKL must not start its own threads
+  // inside the chunks.
+  int mkl_threads = MKL_Set_Num_Threads_Local(1);
+#endif
+  for (int k = 0; k < active_threads_; ++k) {
+    // Drain the own slice first, then steal from the neighbours.
+    Slice& slice = slices_[(id + k) % active_threads_];
+    while (true) {
+      int64_t chunk = slice.next.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= slice.end) break;
+      int64_t chunk_begin = begin_ + chunk * chunk_size_;
+      (*func_)(chunk_begin, std::min(end_, chunk_begin + chunk_size_));
+    }
+  }
+#if defined(PADDLE_WITH_MKLML) && !defined(LITE_ON_MODEL_OPTIMIZE_TOOL)
+  MKL_Set_Num_Threads_Local(mkl_threads);
+#endif
+  tls_in_parallel_region = false;
+}
+
+void ThreadPool::ParallelFor(int64_t begin,
+                             int64_t end,
+                             int64_t grain,
+                             const RangeFunc& f) {
+  if (begin >= end) return;
+  int64_t range = end - begin;
+  grain = std::max<int64_t>(grain, 1);
+  int64_t max_chunks = (range + grain - 1) / grain;
+  int max_threads = tls_max_threads > 0 ? std::min(tls_max_threads, num_threads_)
+                                        : num_threads_;
+  if (max_threads <= 1 || max_chunks <= 1 || tls_in_parallel_region) {
+    f(begin, end);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(dispatch_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // Another thread owns the pool, don't wait for it.
+    f(begin, end);
+    return;
+  }
+
+  int threads = static_cast<int>(std::min<int64_t>(max_threads, max_chunks));
+  int64_t chunk_size =
+      std::max(grain, (range + threads * kChunksPerThread - 1) /
+                          (threads * kChunksPerThread));
+  int64_t chunks = (range + chunk_size - 1) / chunk_size;
+  for (int i = 0; i < threads; ++i) {
+    slices_[i].next.store(chunks * i / threads, std::memory_order_relaxed);
+    slices_[i].end = chunks * (i + 1) / threads;
+  }
+  func_ = &f;
+  begin_ = begin;
+  end_ = end;
+  chunk_size_ = chunk_size;
+  active_threads_ = threads;
+  pending_.store(num_threads_ - 1, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> sleep_lock(sleep_mutex_);
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+  sleep_cv_.notify_all();
+
+  RunChunks(0);
+  while (pending_.load(std::memory_order_acquire) > 0) {
+    CpuRelax();
+  }
+  func_ = nullptr;
+}
+
+void ThreadPool::Parallel2D(int64_t rows,
+                            int64_t cols,
+                            int64_t tile_rows,
+                            int64_t tile_cols,
+                            const TileFunc& f) {
+  if (rows <= 0 || cols <= 0) return;
+  tile_rows = std::max<int64_t>(std::min(tile_rows, rows), 1);
+  tile_cols = std::max<int64_t>(std::min(tile_cols, cols), 1);
+  int64_t tiles_per_row = (cols + tile_cols - 1) / tile_cols;
+  int64_t tiles = (rows + tile_rows - 1) / tile_rows * tiles_per_row;
+  ParallelFor(0, tiles, 1, [&](int64_t tile_begin, int64_t tile_end) {
+    for (int64_t t = tile_begin; t < tile_end; ++t) {
+      int64_t row_begin = t / tiles_per_row * tile_rows;
+      int64_t col_begin = t % tiles_per_row * tile_cols;
+      f(row_begin,
+        std::min(rows, row_begin + tile_rows),
+        col_begin,
+        std::min(cols, col_begin + tile_cols));
+    }
+  });
+}
+
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,157 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+
+// A persistent worker pool used by the x86 kernels for intra-op parallelism.
+// It does not depend on OpenMP or MKLML, so kernels are multi-threaded with
+// any BLAS choice.
+//
+// The calling thread always takes part in the work as worker 0. The range
+// of a ParallelFor is split into one contiguous slice of chunks per worker,
+// and a worker that finishes its own slice steals the remaining chunks of
+// the others. Idle workers spin for `spin_count` iterations before going to
+// sleep, which trades some CPU time for a low wake-up latency between two
+// consecutive parallel regions.
+class ThreadPool {
+ public:
+  using RangeFunc = std::function<void(int64_t begin, int64_t end)>;
+  using TileFunc = std::function<void(
+      int64_t row_begin, int64_t row_end, int64_t col_begin, int64_t col_end)>;
+
+  static constexpr int kDefaultSpinCount = 20000;
+
+  // The process-wide pool shared by all the X86Contexts.
+  static std::shared_ptr<ThreadPool> Global();
+
+  explicit ThreadPool(int num_threads = 1,
+                      int spin_count = kDefaultSpinCount,
+                      bool bind_core = false);
+  ~ThreadPool();
+
+  // Resizing restarts the workers, it must not be called from inside a
+  // parallel region.
+  void SetNumThreads(int num_threads);
+  // Grows the pool to num_threads workers if it's smaller. The pool is shared
+  // by all the predictors of the process, so its size is the max of what they
+  // ask for, and each predictor limits its own regions with ScopedMaxThreads.
+  void ReserveThreads(int num_threads);
+  int num_threads() const { return num_threads_; }
+
+  void SetSpinCount(int spin_count) { spin_count_ = spin_count; }
+  int spin_count() const { return spin_count_; }
+
+  // Pin worker i to logical core i (Linux only). The calling thread is left
+  // untouched. Restarts the workers like SetNumThreads.
+  void SetCoreBinding(bool bind_core);
+  bool core_binding() const { return bind_core_; }
+
+  // Run f on sub-ranges of [begin, end), each sub-range is at least `grain`
+  // long except the last one. Nested calls, calls from several threads at
+  // the same time and ranges too small to split run serially in the calling
+  // thread.
+  void ParallelFor(int64_t begin,
+                   int64_t end,
+                   int64_t grain,
+                   const RangeFunc& f);
+
+  // Run f on the tiles of a rows x cols iteration space.
+  void Parallel2D(int64_t rows,
+                  int64_t cols,
+                  int64_t tile_rows,
+                  int64_t tile_cols,
+                  const TileFunc& f);
+
+  // Whether the current thread is executing a chunk of a parallel region.
+  static bool InParallelRegion();
+
+  // Limit the number of threads used by the parallel regions issued from the
+  // current thread, 0 means no limit. It is the intra-op thread budget of the
+  // inter-op executor threads.
+  static void SetThreadLocalMaxThreads(int max_threads);
+  static int GetThreadLocalMaxThreads();
+
+ private:
+  struct alignas(64) Slice {
+    std::atomic<int64_t> next{0};
+    int64_t end{0};
+  };
+
+  void StartWorkers();
+  void StopWorkers();
+  void WorkerLoop(int id);
+  void RunChunks(int id);
+  void BindCurrentThread(int id);
+
+  int num_threads_{1};
+  std::atomic<int> spin_count_{kDefaultSpinCount};
+  std::atomic<bool> bind_core_{false};
+
+  std::vector<std::thread> workers_;
+  std::unique_ptr<Slice[]> slices_;
+
+  // The job being executed. They are written by the dispatching thread
+  // before `generation_` is bumped and are read-only afterwards.
+  const RangeFunc* func_{nullptr};
+  int64_t begin_{0};
+  int64_t end_{0};
+  int64_t chunk_size_{1};
+  int active_threads_{1};
+
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<int> pending_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  // Serializes the parallel regions issued from different threads.
+  std::mutex dispatch_mutex_;
+};
+
+// Limits the parallel regions issued from the current thread to max_threads
+// in the scope. A tighter limit set before, such as the budget of an inter-op
+// worker, is kept.
+class ScopedMaxThreads {
+ public:
+  explicit ScopedMaxThreads(int max_threads)
+      : saved_(ThreadPool::GetThreadLocalMaxThreads()) {
+    int limit = std::max(max_threads, 1);
+    if (saved_ > 0) limit = std::min(limit, saved_);
+    ThreadPool::SetThreadLocalMaxThreads(limit);
+  }
+  ~ScopedMaxThreads() { ThreadPool::SetThreadLocalMaxThreads(saved_); }
+
+ private:
+  ScopedMaxThreads(const ScopedMaxThreads&) = delete;
+  ScopedMaxThreads& operator=(const ScopedMaxThreads&) = delete;
+
+  int saved_;
+};
+
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
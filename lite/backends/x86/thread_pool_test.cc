@@ -0,0 +1,128 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <mutex>   // NOLINT
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+
+TEST(ThreadPool, ParallelFor) {
+  ThreadPool pool(4, 100);
+  for (int64_t n : {0, 1, 3, 17, 1000, 100003}) {
+    std::vector<int> visited(n, 0);
+    pool.ParallelFor(0, n, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        visited[i]++;
+      }
+    });
+    for (int64_t i = 0; i < n; ++i) {
+      ASSERT_EQ(visited[i], 1);
+    }
+  }
+}
+
+TEST(ThreadPool, Grain) {
+  ThreadPool pool(4);
+  std::atomic<int> calls{0};
+  pool.ParallelFor(0, 100, 40, [&](int64_t begin, int64_t end) {
+    EXPECT_TRUE(end - begin >= 40 || end == 100);
+    calls++;
+  });
+  EXPECT_LE(calls.load(), 3);
+}
+
+TEST(ThreadPool, Nested) {
+  ThreadPool pool(3);
+  std::atomic<int64_t> sum{0};
+  pool.ParallelFor(0, 8, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      pool.ParallelFor(0, 10, 1, [&](int64_t b, int64_t e) { sum += e - b; });
+    }
+  });
+  EXPECT_EQ(sum.load(), 80);
+}
+
+TEST(ThreadPool, Parallel2D) {
+  ThreadPool pool(4, 0, true);
+  const int64_t rows = 37, cols = 53;
+  std::vector<int> visited(rows * cols, 0);
+  pool.Parallel2D(
+      rows, cols, 8, 16, [&](int64_t r0, int64_t r1, int64_t c0, int64_t c1) {
+        for (int64_t r = r0; r < r1; ++r) {
+          for (int64_t c = c0; c < c1; ++c) {
+            visited[r * cols + c]++;
+          }
+        }
+      });
+  for (auto v : visited) {
+    ASSERT_EQ(v, 1);
+  }
+}
+
+TEST(ThreadPool, Resize) {
+  ThreadPool pool(2);
+  for (int threads : {1, 4, 2}) {
+    pool.SetNumThreads(threads);
+    EXPECT_EQ(pool.num_threads(), threads);
+    std::atomic<int64_t> sum{0};
+    pool.ParallelFor(0, 1000, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) sum += i;
+    });
+    EXPECT_EQ(sum.load(), 999 * 1000 / 2);
+  }
+}
+
+TEST(ThreadPool, ReserveAndScopedMaxThreads) {
+  ThreadPool pool(2);
+  pool.ReserveThreads(4);
+  EXPECT_EQ(pool.num_threads(), 4);
+  // A smaller request doesn't shrink the pool shared by the predictors.
+  pool.ReserveThreads(1);
+  EXPECT_EQ(pool.num_threads(), 4);
+
+  auto max_chunk_threads = [&pool]() {
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    pool.ParallelFor(0, 64, 1, [&](int64_t begin, int64_t end) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      std::lock_guard<std::mutex> lock(mutex);
+      ids.insert(std::this_thread::get_id());
+    });
+    return ids.size();
+  };
+  {
+    ScopedMaxThreads max_threads(2);
+    EXPECT_LE(max_chunk_threads(), 2UL);
+    {
+      // The tighter limit of the outer scope is kept.
+      ScopedMaxThreads inner(3);
+      EXPECT_EQ(ThreadPool::GetThreadLocalMaxThreads(), 2);
+    }
+    ScopedMaxThreads single(1);
+    EXPECT_EQ(max_chunk_threads(), 1UL);
+  }
+  EXPECT_EQ(ThreadPool::GetThreadLocalMaxThreads(), 0);
+}
+
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
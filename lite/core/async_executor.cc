@@ -0,0 +1,95 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/async_executor.h"
+#include <algorithm>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+AsyncExecutor& AsyncExecutor::Global() {
+  // Never destroyed, the workers may still be blocked at exit.
+  static AsyncExecutor* x = new AsyncExecutor(
+      std::max(static_cast<int>(std::thread::hardware_concurrency()), 2));
+  return *x;
+}
+
+AsyncExecutor::AsyncExecutor(int num_threads) {
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&AsyncExecutor::WorkerLoop, this);
+    workers_.back().detach();
+  }
+}
+
+void AsyncExecutor::Post(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void AsyncExecutor::WorkerLoop() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !tasks_.empty(); });
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void SerialTaskQueue::Post(AsyncExecutor::Task task) {
+  bool start = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    if (!running_) {
+      running_ = true;
+      start = true;
+    }
+  }
+  if (start) {
+    AsyncExecutor::Global().Post([this] { Drain(); });
+  }
+}
+
+void SerialTaskQueue::Drain() {
+  while (true) {
+    AsyncExecutor::Task task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (tasks_.empty()) {
+        running_ = false;
+        idle_cv_.notify_all();
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void SerialTaskQueue::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cv_.wait(lock, [this] { return !running_; });
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,81 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * AsyncExecutor is a process-wide pool of threads running the asynchronous
+ * predictions, so a server doesn't need one thread per in-flight request.
+ * The tasks are posted through a SerialTaskQueue, which runs the tasks of one
+ * predictor in order.
+ */
+class AsyncExecutor {
+ public:
+  using Task = std::function<void()>;
+
+  static AsyncExecutor& Global();
+
+  void Post(Task task);
+
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+
+ private:
+  explicit AsyncExecutor(int num_threads);
+  ~AsyncExecutor() = delete;
+
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Task> tasks_;
+  std::vector<std::thread> workers_;
+};
+
+/*
+ * SerialTaskQueue runs its tasks one after another on the AsyncExecutor, it
+ * holds at most one thread of the pool at a time. The destructor waits for
+ * the pending tasks, which keeps the objects they use alive until they are
+ * done.
+ */
+class SerialTaskQueue {
+ public:
+  SerialTaskQueue() = default;
+  ~SerialTaskQueue() { Wait(); }
+
+  void Post(AsyncExecutor::Task task);
+
+  // Wait for all of the posted tasks to finish.
+  void Wait();
+
+ private:
+  void Drain();
+
+  std::mutex mutex_;
+  std::condition_variable idle_cv_;
+  std::deque<AsyncExecutor::Task> tasks_;
+  bool running_{false};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,57 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/async_executor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(SerialTaskQueue, order) {
+  std::vector<int> order;
+  {
+    SerialTaskQueue queue;
+    for (int i = 0; i < 100; i++) {
+      queue.Post([&order, i] { order.push_back(i); });
+    }
+  }
+  ASSERT_EQ(order.size(), 100u);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(SerialTaskQueue, concurrent_queues) {
+  const int num_queues = 8;
+  std::atomic<int> count{0};
+  std::vector<std::unique_ptr<SerialTaskQueue>> queues;
+  for (int i = 0; i < num_queues; i++) {
+    queues.emplace_back(new SerialTaskQueue);
+  }
+  for (int j = 0; j < 50; j++) {
+    for (auto& queue : queues) {
+      queue->Post([&count] { count++; });
+    }
+  }
+  for (auto& queue : queues) {
+    queue->Wait();
+  }
+  EXPECT_EQ(count.load(), num_queues * 50);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,267 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/compiled_program.h"
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <string>
+#include "lite/core/device_info.h"
+#include "lite/core/program.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The output shapes of these ops depend on the values of their inputs. The
+// new ops declare it with OpLite::HasDataDependentOutputShape instead.
+const std::set<std::string> kDynamicShapeOpTypes = {
+    "while",
+    "conditional_block",
+    "subgraph",
+    "multiclass_nms",
+    "multiclass_nms2",
+    "multiclass_nms3",
+    "matrix_nms",
+    "generate_proposals",
+    "distribute_fpn_proposals",
+    "collect_fpn_proposals",
+    "retinanet_detection_output",
+    "where_index",
+    "range",
+    "lod_reset",
+    "unique",
+    "masked_select",
+    "beam_search",
+    "beam_search_decode",
+    "ctc_align",
+    "bilinear_interp",
+    "nearest_interp",
+    "bilinear_interp_v2",
+    "nearest_interp_v2",
+    "increment",
+};
+
+// Input arguments like `ShapeTensor`, `StartsTensor`, `SizeTensor` or
+// `depth_tensor` carry a shape as values, the names are matched regardless
+// of the case.
+bool IsShapeTensorArg(const std::string& arg) {
+  std::string name(arg);
+  std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  auto ends_with = [&](const std::string& s) {
+    return name.size() >= s.size() &&
+           name.compare(name.size() - s.size(), s.size(), s) == 0;
+  };
+  return ends_with("tensor") || ends_with("tensorlist") || name == "shape" ||
+         name == "outsize";
+}
+
+}  // namespace
+
+bool CompiledProgram::IsSupported(const std::vector<Instruction>& insts) {
+  return CPUOnlyInstructions(insts);
+}
+
+CompiledProgram::CompiledProgram(std::vector<Instruction>* insts,
+                                 bool capture)
+    : insts_(insts), capture_(capture) {
+  CHECK(insts_);
+  CHECK(IsSupported(*insts_))
+      << "The compiled mode only supports the kernels of CPU targets";
+}
+
+void CompiledProgram::Compile() {
+  std::map<const Tensor*, int> num_writers;
+  std::set<const Tensor*> written;
+  std::set<const Tensor*> read;
+  std::vector<const Tensor*> read_order;
+  for (auto& inst : *insts_) {
+    if (inst.is_feed_fetch_op()) continue;
+    auto* op = const_cast<OpLite*>(inst.op());
+    auto* op_info = op->op_info();
+    auto* scope = op->scope();
+    Step step;
+    step.op = op;
+    step.kernel = inst.mutable_kernel();
+    step.run_once = op->run_once();
+    step.dynamic_shape = kDynamicShapeOpTypes.count(op_info->Type()) > 0 ||
+                         op->HasDataDependentOutputShape();
+    for (auto& arg : op_info->input_argnames()) {
+      if (IsShapeTensorArg(arg) && !op_info->Input(arg).empty()) {
+        step.dynamic_shape = true;
+      }
+      for (auto& name : op_info->Input(arg)) {
+        auto* var = scope->FindVar(name);
+        if (!var || !var->IsType<Tensor>()) {
+          step.dynamic_shape = true;
+          continue;
+        }
+        const Tensor* tensor = &var->Get<Tensor>();
+        step.inputs.push_back(tensor);
+        if (!tensor->persistable() && !written.count(tensor) &&
+            !read.count(tensor)) {
+          read_order.push_back(tensor);
+        }
+        read.insert(tensor);
+      }
+    }
+    for (auto& name : op_info->output_names()) {
+      auto* var = scope->FindVar(name);
+      if (!var || !var->IsType<Tensor>()) {
+        step.dynamic_shape = true;
+        continue;
+      }
+      Tensor* tensor = var->GetMutable<Tensor>();
+      step.outputs.push_back(tensor);
+      written.insert(tensor);
+      num_writers[tensor]++;
+    }
+    static_shape_ = static_shape_ && !step.dynamic_shape;
+    steps_.push_back(std::move(step));
+  }
+  for (auto& step : steps_) {
+    for (auto* out : step.outputs) {
+      step.shared_outputs.push_back(num_writers[out] > 1);
+    }
+    step.input_dims.resize(step.inputs.size());
+    step.input_lods.resize(step.inputs.size());
+    step.output_dims.resize(step.outputs.size());
+    step.output_lods.resize(step.outputs.size());
+  }
+  // The tensors read before being written by any op are the inputs of the
+  // block: the feeds, or the values carried from the previous iteration of a
+  // while block, which are written again later in the block.
+  feeds_ = read_order;
+  feed_dims_.resize(feeds_.size());
+  feed_lods_.resize(feeds_.size());
+  compiled_ = true;
+}
+
+bool CompiledProgram::FeedsChanged() {
+  bool changed = false;
+  for (size_t i = 0; i < feeds_.size(); i++) {
+    if (feeds_[i]->dims() != feed_dims_[i] ||
+        feeds_[i]->lod() != feed_lods_[i]) {
+      feed_dims_[i] = feeds_[i]->dims();
+      feed_lods_[i] = feeds_[i]->lod();
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+bool CompiledProgram::InputsChanged(const Step& step) const {
+  for (size_t i = 0; i < step.inputs.size(); i++) {
+    if (step.inputs[i]->dims() != step.input_dims[i] ||
+        step.inputs[i]->lod() != step.input_lods[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CompiledProgram::InferShape(Step* step) {
+  step->op->InferShape();
+  num_shape_inferences_++;
+  RecordShapes(step);
+}
+
+void CompiledProgram::RecordShapes(Step* step) {
+  for (size_t i = 0; i < step->inputs.size(); i++) {
+    step->input_dims[i] = step->inputs[i]->dims();
+    step->input_lods[i] = step->inputs[i]->lod();
+  }
+  for (size_t i = 0; i < step->outputs.size(); i++) {
+    step->output_dims[i] = step->outputs[i]->dims();
+    step->output_lods[i] = step->outputs[i]->lod();
+  }
+}
+
+void CompiledProgram::RestoreOutputs(const Step& step, bool shared_only) {
+  for (size_t i = 0; i < step.outputs.size(); i++) {
+    if (shared_only && !step.shared_outputs[i]) continue;
+    step.outputs[i]->Resize(step.output_dims[i]);
+    step.outputs[i]->set_lod(step.output_lods[i]);
+  }
+}
+
+void CompiledProgram::RecordWorkspace() {
+  workspace_size_ =
+      std::max(workspace_size_, WorkSpace::Global_Host().cursor());
+#ifdef LITE_WITH_ARM
+  arm_workspace_size_ =
+      std::max(arm_workspace_size_, DeviceInfo::Global().workspace_size());
+#endif
+}
+
+void CompiledProgram::Replay() {
+  WorkSpace::Global_Host().Reserve(workspace_size_);
+#ifdef LITE_WITH_ARM
+  // The ARM kernels grow the workspace of the running thread, it's reserved
+  // at the largest size seen by the capture.
+  DeviceInfo::Global().ReserveWorkspace(arm_workspace_size_);
+#endif
+  for (auto& step : steps_) {
+    if (step.run_once) continue;
+    RestoreOutputs(step, true);
+    step.kernel->Replay();
+  }
+}
+
+void CompiledProgram::Run() {
+  num_shape_inferences_ = 0;
+  if (!compiled_) {
+    // The first run goes through the instructions, which check the shapes
+    // and prepare the kernels, and records the shapes seen by each op.
+    Compile();
+    FeedsChanged();
+    size_t idx = 0;
+    for (auto& inst : *insts_) {
+      if (inst.is_feed_fetch_op()) continue;
+      inst.Run();
+      RecordShapes(&steps_[idx++]);
+      if (capture_) RecordWorkspace();
+    }
+    captured_ = capture_ && static_shape_;
+    return;
+  }
+
+  bool feeds_changed = FeedsChanged();
+  if (captured_ && !feeds_changed) {
+    Replay();
+    return;
+  }
+  bool skip_all = !feeds_changed && static_shape_;
+  for (auto& step : steps_) {
+    if (step.run_once) continue;
+    if (skip_all) {
+      RestoreOutputs(step, true);
+    } else if (step.dynamic_shape || InputsChanged(step)) {
+      InferShape(&step);
+    } else {
+      RestoreOutputs(step, false);
+    }
+    step.kernel->Launch();
+    if (capture_) RecordWorkspace();
+  }
+  captured_ = capture_ && static_shape_;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,115 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+class OpLite;
+class KernelBase;
+
+/*
+ * CompiledProgram is the "compiled" execution mode of a block, it aims at the
+ * tiny models where the framework overhead exceeds the compute.
+ *
+ * The ops, kernels and the tensors they read and write are resolved once into
+ * a contiguous array of steps, and the first run goes through
+ * Instruction::Run to record the shapes seen by each op. On the following
+ * runs:
+ * - if the shapes and LoDs of the inputs of the block (the feeds, or the
+ *   loop-carried values of a while block) are unchanged and no op has a
+ *   data-dependent output shape, InferShape is skipped for every op;
+ * - otherwise, InferShape is only called for the ops whose input shapes
+ *   changed or whose output shape depends on the input values.
+ * When InferShape is skipped, the outputs written by several ops (after the
+ * memory reuse pass) get their cached shape back, the others keep it.
+ *
+ * With `capture` set, the first run of a block without data-dependent shapes
+ * also records the workspace size of its kernels, and the following runs
+ * replay the captured steps: no InferShape, no ReInitWhenNeeded and the
+ * host workspace and the ARM workspace of DeviceInfo are reserved once, so
+ * no memory is allocated. Any change of the
+ * feed shapes invalidates the capture, the run goes through the compiled
+ * path and captures the block again.
+ */
+class CompiledProgram {
+ public:
+  explicit CompiledProgram(std::vector<Instruction>* insts,
+                           bool capture = false);
+
+  void Run();
+
+  size_t num_steps() const { return steps_.size(); }
+  // The number of InferShape calls done by the last run.
+  int64_t num_shape_inferences() const { return num_shape_inferences_; }
+  // Whether the next run replays the captured steps if the feed shapes are
+  // unchanged.
+  bool captured() const { return captured_; }
+  size_t workspace_size() const { return workspace_size_; }
+
+  // Returns whether the instructions can be run in the compiled mode.
+  static bool IsSupported(const std::vector<Instruction>& insts);
+
+ private:
+  struct Step {
+    OpLite* op{nullptr};
+    KernelBase* kernel{nullptr};
+    bool run_once{false};
+    // The output shape depends on the values of the inputs, or the op reads
+    // or writes a variable other than a tensor.
+    bool dynamic_shape{false};
+    std::vector<const Tensor*> inputs;
+    std::vector<Tensor*> outputs;
+    // Whether outputs[i] is also written by another step.
+    std::vector<bool> shared_outputs;
+    std::vector<DDim> input_dims;
+    std::vector<LoD> input_lods;
+    std::vector<DDim> output_dims;
+    std::vector<LoD> output_lods;
+  };
+
+  void Compile();
+  bool FeedsChanged();
+  bool InputsChanged(const Step& step) const;
+  void InferShape(Step* step);
+  void RecordShapes(Step* step);
+  void RestoreOutputs(const Step& step, bool shared_only);
+  void RecordWorkspace();
+  void Replay();
+
+  std::vector<Instruction>* insts_{nullptr};
+  bool compiled_{false};
+  bool capture_{false};
+  bool captured_{false};
+  // The largest workspace used by a kernel.
+  size_t workspace_size_{0};
+  // The largest DeviceInfo workspace used by an ARM kernel.
+  size_t arm_workspace_size_{0};
+  std::vector<Step> steps_;
+  // Nothing in the block has a data-dependent shape.
+  bool static_shape_{true};
+  std::vector<const Tensor*> feeds_;
+  std::vector<DDim> feed_dims_;
+  std::vector<LoD> feed_lods_;
+  int64_t num_shape_inferences_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -31,6 +31,9 @@
 #ifdef LITE_WITH_XPU
 #include "lite/backends/xpu/xpu_header_sitter.h"
 #endif
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/thread_pool.h"
+#endif
 
 #include <map>
 #include <memory>
@@ -40,6 +43,7 @@
 #include <vector>
 #include "lite/core/device_info.h"
 #include "lite/core/scope.h"
+#include "lite/core/scratch_arena.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
 #include "lite/utils/all.h"
@@ -226,6 +230,10 @@ class Context<TargetType::kARM> {
     return DeviceInfo::Global().ExtendWorkspace(size);
   }
 
+  // The arena of the short-lived host buffers of a kernel run, see
+  // ScratchArena.
+  ScratchArena* scratch_arena() const { return &ScratchArena::ThreadLocal(); }
+
   std::string name() const { return "ARMContext"; }
 };
 #endif
@@ -331,15 +339,38 @@ template <>
 class Context<TargetType::kX86> {
  public:
   // NOTE: InitOnce should only be used by ContextScheduler
-  void InitOnce() {}
+  void InitOnce() { thread_pool_ = x86::ThreadPool::Global(); }
+
+  void CopySharedTo(X86Context* ctx) { ctx->thread_pool_ = thread_pool_; }
+
+  x86::ThreadPool* thread_pool() const {
+    return thread_pool_ ? thread_pool_.get() : x86::ThreadPool::Global().get();
+  }
+
+  void ParallelFor(int64_t begin,
+                   int64_t end,
+                   const x86::ThreadPool::RangeFunc& f,
+                   int64_t grain = 1) const {
+    thread_pool()->ParallelFor(begin, end, grain, f);
+  }
+
+  void Parallel2D(int64_t rows,
+                  int64_t cols,
+                  int64_t tile_rows,
+                  int64_t tile_cols,
+                  const x86::ThreadPool::TileFunc& f) const {
+    thread_pool()->Parallel2D(rows, cols, tile_rows, tile_cols, f);
+  }
 
-  void CopySharedTo(X86Context* ctx) {}
+  // The arena of the short-lived host buffers of a kernel run, e.g. the
+  // index vectors of the sequence kernels, see ScratchArena.
+  ScratchArena* scratch_arena() const { return &ScratchArena::ThreadLocal(); }
 
   std::string name() const { return "X86Context"; }
 
  private:
   // overall information
-  //
+  std::shared_ptr<x86::ThreadPool> thread_pool_;
   // kernel information
 };
 #endif
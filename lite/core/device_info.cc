@@ -1157,6 +1157,12 @@ bool DeviceInfo::ExtendWorkspace(size_t size) {
   return workspace_.mutable_data<int8_t>() != nullptr;
 }
 
+bool DeviceInfo::ReserveWorkspace(size_t size) {
+  if (size <= workspace_size()) return true;
+  workspace_.Resize({static_cast<int64_t>(size)});
+  return workspace_.mutable_data<int8_t>() != nullptr;
+}
+
 #endif  // LITE_WITH_ARM
 
 #ifdef LITE_WITH_MLU
@@ -71,12 +71,20 @@ class DeviceInfo {
   }
   bool has_dot() const { return dot_[active_ids_[0]]; }
   bool has_fp16() const { return fp16_[active_ids_[0]]; }
+  const std::string& dev_name() const { return dev_name_; }
 
   template <typename T>
   T* workspace_data() {
     return reinterpret_cast<T*>(workspace_.mutable_data<int8_t>());
   }
   bool ExtendWorkspace(size_t size);
+  // The bytes of the workspace of the current thread.
+  size_t workspace_size() const {
+    return static_cast<size_t>(workspace_.numel());
+  }
+  // Makes the workspace hold at least size bytes, so the following
+  // ExtendWorkspace calls up to that size don't allocate.
+  bool ReserveWorkspace(size_t size);
 
  private:
   int core_num_;
@@ -0,0 +1,256 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/inter_op_executor.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The output of these ops may share the buffer of their input `X`.
+const std::set<std::string> kViewOpTypes = {"reshape",
+                                            "reshape2",
+                                            "flatten",
+                                            "flatten2",
+                                            "squeeze",
+                                            "squeeze2",
+                                            "unsqueeze",
+                                            "unsqueeze2"};
+
+// These ops run a sub-block which may touch any variable of the scope.
+const std::set<std::string> kBarrierOpTypes = {
+    "while", "conditional_block", "subgraph"};
+
+}  // namespace
+
+bool InterOpExecutor::IsSupported(const std::vector<Instruction>& insts) {
+  return CPUOnlyInstructions(insts);
+}
+
+InterOpExecutor::InterOpExecutor(std::vector<Instruction>* insts,
+                                 int num_threads,
+                                 const std::function<void()>& worker_init)
+    : insts_(insts), worker_init_(worker_init) {
+  CHECK(insts_);
+  CHECK(IsSupported(*insts_))
+      << "InterOpExecutor only supports the kernels of CPU targets";
+  BuildGraph();
+  pending_predecessors_.reset(new std::atomic<int>[nodes_.size()]);
+  num_threads = std::max(num_threads, 1);
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&InterOpExecutor::WorkerLoop, this);
+  }
+  VLOG(4) << "InterOpExecutor: " << nodes_.size() << " ops, " << num_threads
+          << " threads, critical path " << critical_path_length_;
+}
+
+InterOpExecutor::~InterOpExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  ready_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void InterOpExecutor::BuildGraph() {
+  // Map every variable to the buffer it refers to, the views share the buffer
+  // id of their input.
+  std::map<std::string, int> buffer_ids;
+  auto buffer_id = [&](const std::string& name) {
+    auto it = buffer_ids.find(name);
+    if (it != buffer_ids.end()) return it->second;
+    int id = static_cast<int>(buffer_ids.size());
+    buffer_ids.emplace(name, id);
+    return id;
+  };
+
+  for (size_t i = 0; i < insts_->size(); i++) {
+    if ((*insts_)[i].is_feed_fetch_op()) continue;
+    nodes_.push_back(static_cast<int>(i));
+  }
+  successors_.resize(nodes_.size());
+  num_predecessors_.assign(nodes_.size(), 0);
+
+  std::vector<std::set<int>> predecessors(nodes_.size());
+  std::map<int, int> last_writer;
+  std::map<int, std::vector<int>> readers;
+  int last_barrier = -1;
+  for (size_t n = 0; n < nodes_.size(); n++) {
+    const auto* op = (*insts_)[nodes_[n]].op();
+    const auto* op_info = op->op_info();
+    const auto& op_type = op_info->Type();
+    int node = static_cast<int>(n);
+    auto& preds = predecessors[n];
+    if (kBarrierOpTypes.count(op_type)) {
+      for (int i = last_barrier + 1; i < node; i++) {
+        preds.insert(i);
+      }
+      if (last_barrier >= 0) preds.insert(last_barrier);
+      last_barrier = node;
+      continue;
+    }
+    if (last_barrier >= 0) preds.insert(last_barrier);
+
+    std::vector<int> reads;
+    for (auto& name : op_info->input_names()) {
+      reads.push_back(buffer_id(name));
+    }
+    if (kViewOpTypes.count(op_type) && op_info->HasInput("X") &&
+        !op_info->Input("X").empty() && op_info->HasOutput("Out")) {
+      int x = buffer_id(op_info->Input("X").front());
+      for (auto& out : op_info->Output("Out")) {
+        buffer_ids[out] = x;
+      }
+    }
+    std::vector<int> writes;
+    for (auto& name : op_info->output_names()) {
+      writes.push_back(buffer_id(name));
+    }
+
+    // Read after write.
+    for (int r : reads) {
+      auto it = last_writer.find(r);
+      if (it != last_writer.end()) preds.insert(it->second);
+    }
+    // Write after write and write after read.
+    for (int w : writes) {
+      auto it = last_writer.find(w);
+      if (it != last_writer.end()) preds.insert(it->second);
+      for (int reader : readers[w]) {
+        preds.insert(reader);
+      }
+      readers[w].clear();
+      last_writer[w] = node;
+    }
+    for (int r : reads) {
+      readers[r].push_back(node);
+    }
+    preds.erase(node);
+  }
+
+  std::vector<int> depth(nodes_.size(), 1);
+  for (size_t n = 0; n < nodes_.size(); n++) {
+    num_predecessors_[n] = static_cast<int>(predecessors[n].size());
+    if (predecessors[n].empty()) roots_.push_back(static_cast<int>(n));
+    for (int pred : predecessors[n]) {
+      successors_[pred].push_back(static_cast<int>(n));
+      depth[n] = std::max(depth[n], depth[pred] + 1);
+    }
+    critical_path_length_ = std::max(critical_path_length_, depth[n]);
+  }
+}
+
+void InterOpExecutor::Push(int node) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.push(node);
+  }
+  ready_cv_.notify_one();
+}
+
+void InterOpExecutor::Run() {
+  if (nodes_.empty()) return;
+  for (size_t n = 0; n < nodes_.size(); n++) {
+    pending_predecessors_[n].store(num_predecessors_[n],
+                                   std::memory_order_relaxed);
+  }
+  remaining_.store(static_cast<int>(nodes_.size()), std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int root : roots_) {
+      ready_.push(root);
+    }
+  }
+  ready_cv_.notify_all();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] {
+    return remaining_.load(std::memory_order_acquire) == 0;
+  });
+#ifdef LITE_WITH_EXCEPTION
+  if (error_) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+#endif
+}
+
+void InterOpExecutor::WorkerLoop() {
+  if (worker_init_) worker_init_();
+  while (true) {
+    int node = -1;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+      if (stop_) return;
+      node = ready_.top();
+      ready_.pop();
+    }
+    bool failed = false;
+#ifdef LITE_WITH_EXCEPTION
+    try {
+      (*insts_)[nodes_[node]].Run();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+      failed = true;
+    }
+#else
+    (*insts_)[nodes_[node]].Run();
+#endif
+    // On failure the successors are skipped but still accounted for, so Run
+    // returns and reports the error.
+    int finished = 1;
+    std::vector<int> skipped;
+    for (int succ : successors_[node]) {
+      if (pending_predecessors_[succ].fetch_sub(
+              1, std::memory_order_acq_rel) == 1) {
+        if (failed) {
+          skipped.push_back(succ);
+        } else {
+          Push(succ);
+        }
+      }
+    }
+    while (!skipped.empty()) {
+      int n = skipped.back();
+      skipped.pop_back();
+      finished++;
+      for (int succ : successors_[n]) {
+        if (pending_predecessors_[succ].fetch_sub(
+                1, std::memory_order_acq_rel) == 1) {
+          skipped.push_back(succ);
+        }
+      }
+    }
+    if (remaining_.fetch_sub(finished, std::memory_order_acq_rel) ==
+        finished) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_cv_.notify_all();
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,98 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <queue>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+/*
+ * InterOpExecutor runs the instructions of a block on a pool of threads,
+ * launching an instruction as soon as all the instructions it depends on have
+ * finished, so independent branches (inception blocks, detection heads, the
+ * towers of CTR models) are executed concurrently.
+ *
+ * The dependencies are derived from the variables read and written by each
+ * op, including the write-after-read and write-after-write hazards introduced
+ * by the memory reuse pass, and the ops producing a view of their input
+ * (reshape, flatten, squeeze ...) are tracked as aliases of it. Ops owning a
+ * sub-block (while, conditional_block, subgraph) act as barriers.
+ *
+ * Only CPU kernels are supported. Each worker thread calls `worker_init` once
+ * at startup, which is where the caller restricts the intra-op thread number
+ * of the kernels so that the two levels of parallelism don't oversubscribe
+ * the cores.
+ */
+class InterOpExecutor {
+ public:
+  InterOpExecutor(std::vector<Instruction>* insts,
+                  int num_threads,
+                  const std::function<void()>& worker_init = nullptr);
+  ~InterOpExecutor();
+
+  // Run all of the instructions once and wait for them to finish.
+  void Run();
+
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+  // The longest chain of dependent instructions, which bounds the speedup.
+  int critical_path_length() const { return critical_path_length_; }
+
+  // Returns whether the instructions can be run by this executor.
+  static bool IsSupported(const std::vector<Instruction>& insts);
+
+ private:
+  void BuildGraph();
+  void WorkerLoop();
+  void Push(int idx);
+
+  std::vector<Instruction>* insts_{nullptr};
+  // The indices of the instructions to run and their dependencies, the feed
+  // and fetch instructions are not part of the graph.
+  std::vector<int> nodes_;
+  std::vector<std::vector<int>> successors_;
+  std::vector<int> num_predecessors_;
+  std::vector<int> roots_;
+  int critical_path_length_{0};
+
+  std::unique_ptr<std::atomic<int>[]> pending_predecessors_;
+  std::atomic<int> remaining_{0};
+  // Lowest index first, which keeps the order close to the serial one.
+  std::priority_queue<int, std::vector<int>, std::greater<int>> ready_;
+  std::mutex mutex_;
+  std::condition_variable ready_cv_;
+  std::condition_variable done_cv_;
+#ifdef LITE_WITH_EXCEPTION
+  // The first error raised by a kernel, rethrown by Run.
+  std::exception_ptr error_;
+#endif
+  bool stop_{false};
+  std::function<void()> worker_init_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace lite
+}  // namespace paddle
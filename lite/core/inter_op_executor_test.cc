@@ -0,0 +1,148 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/inter_op_executor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The start and finish ticks of every op of a run.
+struct RunRecord {
+  explicit RunRecord(int n) : start(n), finish(n) {}
+  std::atomic<int> tick{0};
+  std::vector<int> start;
+  std::vector<int> finish;
+};
+
+// The dependencies are only derived from the op descs, the op does nothing.
+class RecordOp : public OpLite {
+ public:
+  RecordOp() : OpLite("record") {}
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return "record"; }
+};
+
+class RecordKernel : public KernelLite<TARGET(kHost), PRECISION(kFloat)> {
+ public:
+  RecordKernel(int id, RunRecord* record) : id_(id), record_(record) {}
+
+  void Run() override {
+    record_->start[id_] = record_->tick++;
+    // Gives the ops which don't wait for this one the time to overtake it.
+    std::this_thread::sleep_for(std::chrono::milliseconds((id_ % 3) * 2));
+    record_->finish[id_] = record_->tick++;
+  }
+
+ private:
+  int id_;
+  RunRecord* record_;
+};
+
+struct OpSpec {
+  std::string type;
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+};
+
+std::vector<Instruction> BuildInstructions(const std::vector<OpSpec>& specs,
+                                           Scope* scope,
+                                           RunRecord* record) {
+  std::vector<Instruction> insts;
+  for (size_t i = 0; i < specs.size(); i++) {
+    cpp::OpDesc desc;
+    desc.SetType(specs[i].type);
+    desc.SetInput("X", specs[i].inputs);
+    desc.SetOutput("Out", specs[i].outputs);
+    std::shared_ptr<OpLite> op(new RecordOp);
+    op->Attach(desc, scope);
+    std::unique_ptr<KernelBase> kernel(
+        new RecordKernel(static_cast<int>(i), record));
+    insts.emplace_back(op, std::move(kernel));
+  }
+  return insts;
+}
+
+}  // namespace
+
+TEST(InterOpExecutor, dependency_order) {
+  // The memory optimize pass reuses `a` and `c`, so besides the read after
+  // write edges the executor must keep the write after write and the write
+  // after read ones. `d` is a view of `c`.
+  std::vector<OpSpec> specs = {
+      {"relu", {"x"}, {"a"}},                  // 0
+      {"relu", {"x"}, {"b"}},                  // 1
+      {"elementwise_add", {"a", "b"}, {"c"}},  // 2: RAW 0, 1
+      {"relu", {"x"}, {"a"}},                  // 3: WAW 0, WAR 2
+      {"reshape2", {"c"}, {"d"}},              // 4: RAW 2
+      {"relu", {"d"}, {"e"}},                  // 5: RAW 4
+      {"relu", {"x"}, {"c"}},                  // 6: WAR 4, 5 through the view
+      {"relu", {"a"}, {"f"}},                  // 7: RAW 3
+  };
+  std::vector<std::pair<int, int>> edges = {
+      {0, 2}, {1, 2}, {0, 3}, {2, 3}, {2, 4}, {4, 5}, {4, 6}, {5, 6}, {3, 7}};
+
+  Scope scope;
+  RunRecord record(static_cast<int>(specs.size()));
+  auto insts = BuildInstructions(specs, &scope, &record);
+  InterOpExecutor executor(&insts, 4);
+  EXPECT_EQ(executor.critical_path_length(), 5);
+  for (int run = 0; run < 20; run++) {
+    record.tick = 0;
+    executor.Run();
+    EXPECT_EQ(record.tick.load(), static_cast<int>(specs.size()) * 2);
+    for (auto& edge : edges) {
+      EXPECT_LT(record.finish[edge.first], record.start[edge.second])
+          << "op " << edge.second << " started before op " << edge.first
+          << " finished";
+    }
+  }
+}
+
+TEST(InterOpExecutor, barrier) {
+  // The ops around a sub-block op never overlap with it.
+  std::vector<OpSpec> specs = {
+      {"relu", {"x"}, {"a"}},
+      {"relu", {"y"}, {"b"}},
+      {"while", {"a"}, {"c"}},
+      {"relu", {"z"}, {"d"}},
+  };
+  Scope scope;
+  RunRecord record(static_cast<int>(specs.size()));
+  auto insts = BuildInstructions(specs, &scope, &record);
+  InterOpExecutor executor(&insts, 3);
+  for (int run = 0; run < 10; run++) {
+    record.tick = 0;
+    executor.Run();
+    EXPECT_LT(record.finish[0], record.start[2]);
+    EXPECT_LT(record.finish[1], record.start[2]);
+    EXPECT_LT(record.finish[2], record.start[3]);
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
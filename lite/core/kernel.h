@@ -57,6 +57,19 @@ class KernelBase {
   /// Run the kernel. Before Run, both the param_ and context_ should be valid.
   virtual void Run() = 0;
 
+  /// Get the weights packed by `PrepareForRun` from the input `arg`, and the
+  /// tag of their layout. They are saved with the model, so the kernel loads
+  /// them instead of packing the weights again.
+  virtual bool GetPrepackedWeights(std::string* arg,
+                                   const Tensor** packed,
+                                   std::string* tag) const {
+    return false;
+  }
+
+  /// Whether every path of the kernel runs on the prepacked weights, then
+  /// the original weights are not needed by the loaded model.
+  virtual bool PrepackedWeightsOnly() const { return false; }
+
 #ifdef LITE_WITH_PROFILE
   void SetProfiler(profile::Profiler* profiler, int id) {
     profiler_ = profiler;
@@ -121,6 +134,15 @@ class KernelBase {
 #endif
   }
 
+  // Run the kernel again with the shapes of the previous launch, it's used by
+  // the captured programs, which skip the re-init checks. The workspace is
+  // still reset as the kernels share it.
+  void Replay() {
+    CHECK(!is_first_epoch_) << "The kernel must be launched before replay";
+    WorkSpace::Global_Host().AllocReset();
+    Run();
+  }
+
   void SetContext(std::unique_ptr<KernelContext>&& ctx) {
     ctx_ = std::move(ctx);
   }
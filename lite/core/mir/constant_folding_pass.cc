@@ -0,0 +1,186 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/constant_folding_pass.h"
+#include <map>
+#include <utility>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// These ops have side effects, produce random values or run a sub-block.
+const std::set<std::string> kUnfoldableOpTypes = {"feed",
+                                                  "fetch",
+                                                  "while",
+                                                  "conditional_block",
+                                                  "subgraph",
+                                                  "io_copy",
+                                                  "io_copy_once",
+                                                  "layout_once",
+                                                  "calib_once",
+                                                  "uniform_random",
+                                                  "gaussian_random",
+                                                  "sampling_id",
+                                                  "dropout",
+                                                  "increment",
+                                                  "print"};
+
+bool IsPersistableTensor(Scope* scope, const std::string& name) {
+  auto* var = scope->FindVar(name);
+  if (!var || !var->IsType<Tensor>()) return false;
+  auto& tensor = var->Get<Tensor>();
+  return tensor.persistable() && tensor.IsInitialized();
+}
+
+// The weights of these targets are in the host memory.
+bool UsesHostMemory(TargetType target) {
+  return target == TARGET(kHost) || target == TARGET(kX86) ||
+         target == TARGET(kARM);
+}
+
+// Whether the kernels of the target can run here. The opt tool links the
+// implementations of the host kernels only, the others are registered
+// without them.
+bool IsRunnable(TargetType target) {
+#ifdef LITE_ON_MODEL_OPTIMIZE_TOOL
+  return target == TARGET(kHost);
+#else
+  return target == TARGET(kHost) || target == TARGET(kX86);
+#endif
+}
+
+// Creates a host kernel of the op with the precision of the picked kernel,
+// returns nullptr if there is none.
+std::unique_ptr<KernelBase> CreateHostKernel(OpLite* op,
+                                             const KernelBase& picked) {
+  auto kernels = op->CreateKernels(
+      {Place(TARGET(kHost), picked.precision(), picked.layout())});
+  if (kernels.empty()) return nullptr;
+  auto kernel = std::move(kernels.front());
+  kernel->SetContext(ContextScheduler::Global().NewContext(TARGET(kHost)));
+  return kernel;
+}
+
+}  // namespace
+
+bool ConstantFoldingPass::IsFoldable(
+    Node* node, const std::set<std::string>& reassigned_vars) {
+  auto& stmt = node->AsStmt();
+  if (kUnfoldableOpTypes.count(stmt.op_type())) return false;
+  if (stmt.kernels().empty()) return false;
+  if (!UsesHostMemory(stmt.picked_kernel().target())) return false;
+  auto* scope = stmt.op()->scope();
+  for (auto* in : node->inlinks) {
+    if (!in->IsArg()) return false;
+    auto& arg = in->AsArg();
+    if (!arg.is_weight || !IsPersistableTensor(scope, arg.name)) {
+      return false;
+    }
+  }
+  if (node->outlinks.empty()) return false;
+  for (auto* out : node->outlinks) {
+    if (!out->IsArg()) return false;
+    auto& arg = out->AsArg();
+    // The outputs must be plain tensors, not written by any other op.
+    auto* var = scope->FindVar(arg.name);
+    if (!var || !var->IsType<Tensor>() || reassigned_vars.count(arg.name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ConstantFoldingPass::Fold(SSAGraph* graph, Node* node) {
+  auto& stmt = node->AsStmt();
+  auto op = stmt.op();
+  auto* kernel = &stmt.picked_kernel();
+  std::unique_ptr<KernelBase> host_kernel;
+  if (!IsRunnable(kernel->target())) {
+    host_kernel = CreateHostKernel(op.get(), *kernel);
+    if (!host_kernel) {
+      VLOG(4) << "Skip " << op->Type() << " without a host kernel";
+      return false;
+    }
+    kernel = host_kernel.get();
+  }
+  CHECK(op->CheckShape()) << "Failed to check the shapes of " << op->Type();
+  CHECK(op->InferShape()) << "Failed to infer the shapes of " << op->Type();
+  kernel->PrepareForRun();
+  WorkSpace::Global_Host().AllocReset();
+  kernel->Run();
+  VLOG(4) << "Fold " << op->Type();
+
+  // The outputs become weights. Like the loaded ones they must be in the
+  // root scope, where the clones and the reloaded optimized models look for
+  // the persistable variables, the ops of this program keep using the
+  // tensors of the exec scope which share the same buffers.
+  auto* scope = op->scope();
+  auto* root = scope->Root();
+  std::set<const Node*> nodes_to_remove({node});
+  for (auto* out : node->outlinks) {
+    auto& arg = out->AsArg();
+    auto* tensor = scope->FindVar(arg.name)->GetMutable<Tensor>();
+    tensor->set_persistable(true);
+    if (root != scope) {
+      auto* weight = root->Var(arg.name)->GetMutable<Tensor>();
+      weight->ShareDataWith(*tensor);
+      weight->set_persistable(true);
+    }
+    arg.is_weight = true;
+    if (out->outlinks.empty()) {
+      nodes_to_remove.insert(out);
+    }
+  }
+  for (auto* in : node->inlinks) {
+    if (in->outlinks.size() == 1) {
+      nodes_to_remove.insert(in);
+    }
+  }
+  GraphSafeRemoveNodes(graph, nodes_to_remove);
+  return true;
+}
+
+void ConstantFoldingPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  std::map<std::string, int> num_writers;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    for (auto* out : node->outlinks) {
+      num_writers[out->AsArg().name]++;
+    }
+  }
+  std::set<std::string> reassigned_vars;
+  for (auto& item : num_writers) {
+    if (item.second > 1) reassigned_vars.insert(item.first);
+  }
+
+  int num_folded = 0;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!IsFoldable(node, reassigned_vars)) continue;
+    if (Fold(graph.get(), node)) num_folded++;
+  }
+  VLOG(3) << "Folded " << num_folded << " ops";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(constant_folding_pass, paddle::lite::mir::ConstantFoldingPass)
+    .BindTargets({TARGET(kX86), TARGET(kHost)});
@@ -0,0 +1,49 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ConstantFoldingPass executes at optimize time the ops whose inputs are all
+ * persistable, e.g. `fill_constant -> scale -> elementwise_add` or a
+ * transpose/cast of the weights. The outputs become persistable variables,
+ * which are saved along with the optimized model, and the ops are removed
+ * from the graph. Chains are folded in topological order.
+ *
+ * The picked host or x86 kernels compute the outputs in the full builds. The
+ * other kernels, e.g. the arm ones or all but the host ones in the opt tool
+ * which registers them without their implementations, are replaced by the
+ * host kernels of the ops. The ops without a host kernel are kept.
+ */
+class ConstantFoldingPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool IsFoldable(Node* node, const std::set<std::string>& reassigned_vars);
+  bool Fold(SSAGraph* graph, Node* node);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,175 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/constant_folding_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Stands for the kernels which can't run at optimize time, e.g. the ones the
+// opt tool registers without their implementations.
+class FakeScaleCompute
+    : public KernelLite<TARGET(kARM), PRECISION(kFloat), DATALAYOUT(kNCHW)> {
+ public:
+  void Run() override { LOG(FATAL) << "the fake kernel can't run"; }
+};
+
+class ConstantFoldingPassTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    program_desc_ = std::make_shared<cpp::ProgramDesc>();
+    scope_ = std::make_shared<Scope>();
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->SetIdx(0);
+    block_desc_->SetParentIdx(-1);
+  }
+
+  void AddVar(const std::string& name, bool persistable = false) {
+    auto* var = block_desc_->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetDataType(cpp::VarDesc::Type::FP32);
+    var->SetPersistable(persistable);
+  }
+
+  void AddWeight(const std::string& name,
+                 const std::vector<int64_t>& shape,
+                 const std::vector<float>& values) {
+    AddVar(name, true);
+    auto* w = scope_->Var(name)->GetMutable<Tensor>();
+    w->Resize(shape);
+    auto* w_data = w->mutable_data<float>();
+    for (size_t i = 0; i < values.size(); i++) {
+      w_data[i] = values[i];
+    }
+    w->set_persistable(true);
+  }
+
+  cpp::OpDesc* AddOp(const std::string& type,
+                     const std::vector<std::string>& x,
+                     const std::string& out) {
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    if (!x.empty()) op->SetInput("X", {x[0]});
+    if (x.size() > 1) op->SetInput("Y", {x[1]});
+    op->SetOutput("Out", {out});
+    AddVar(out);
+    return op;
+  }
+
+  // Runs the pass and returns the types of the remaining ops.
+  std::vector<std::string> Apply() {
+    std::vector<Place> valid_places{{TARGET(kARM), PRECISION(kFloat)},
+                                    {TARGET(kHost), PRECISION(kFloat)}};
+    program_.reset(new Program(program_desc_, scope_, valid_places));
+    graph_.reset(new SSAGraph);
+    graph_->Build(*program_, valid_places);
+    ConstantFoldingPass pass;
+    pass.Apply(graph_);
+    std::vector<std::string> ops;
+    for (auto& node : graph_->StmtTopologicalOrder()) {
+      ops.push_back(node->AsStmt().op_type());
+    }
+    return ops;
+  }
+
+  const Tensor& Var(const std::string& name) {
+    return program_->exec_scope()->FindVar(name)->Get<Tensor>();
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_desc_{nullptr};
+  std::unique_ptr<Program> program_;
+  std::unique_ptr<SSAGraph> graph_;
+};
+
+// fill_constant -> scale -> elementwise_add on the weights is folded, the
+// picked scale kernel can't run so its host kernel computes the output. The
+// add of the activation is kept.
+TEST_F(ConstantFoldingPassTest, host_kernels) {
+  AddVar("x");
+  AddWeight("w", {3}, {1.f, 2.f, 3.f});
+  auto* fill = AddOp("fill_constant", {}, "c");
+  fill->SetAttr("shape", std::vector<int64_t>{3});
+  fill->SetAttr("dtype", static_cast<int>(lite::core::FluidType::FP32));
+  fill->SetAttr("value", 2.f);
+  fill->SetAttr("force_cpu", false);
+  auto* scale = AddOp("scale", {"c"}, "s");
+  scale->SetAttr("scale", 3.f);
+  scale->SetAttr("bias", 1.f);
+  scale->SetAttr("bias_after_scale", true);
+  AddOp("elementwise_add", {"s", "w"}, "y")->SetAttr("axis", -1);
+  AddOp("elementwise_add", {"x", "y"}, "out")->SetAttr("axis", -1);
+
+  auto ops = Apply();
+  ASSERT_EQ(ops.size(), 1UL);
+  EXPECT_EQ(ops[0], "elementwise_add");
+  auto& y = Var("y");
+  EXPECT_TRUE(y.persistable());
+  ASSERT_EQ(y.numel(), 3);
+  const float expected[] = {8.f, 9.f, 10.f};
+  for (int i = 0; i < 3; i++) {
+    EXPECT_FLOAT_EQ(y.data<float>()[i], expected[i]);
+  }
+}
+
+// Both inputs of the elementwise_mul are broadcast, [2, 1] * [3] = [2, 3].
+TEST_F(ConstantFoldingPassTest, broadcast) {
+  AddVar("x");
+  AddWeight("a", {2, 1}, {1.f, 2.f});
+  AddWeight("b", {3}, {1.f, 10.f, 100.f});
+  AddOp("elementwise_mul", {"a", "b"}, "y")->SetAttr("axis", -1);
+  AddOp("elementwise_add", {"x", "y"}, "out")->SetAttr("axis", -1);
+
+  auto ops = Apply();
+  ASSERT_EQ(ops.size(), 1UL);
+  auto& y = Var("y");
+  ASSERT_EQ(y.dims(), DDim(std::vector<int64_t>({2, 3})));
+  const float expected[] = {1.f, 10.f, 100.f, 2.f, 20.f, 200.f};
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(y.data<float>()[i], expected[i]);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(scale,
+                     kARM,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::mir::FakeScaleCompute,
+                     fake)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
+    .Finalize();
+
+USE_LITE_OP(fill_constant);
+USE_LITE_OP(scale);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(elementwise_mul);
+USE_LITE_KERNEL(fill_constant, kHost, kAny, kNCHW, def);
+USE_LITE_KERNEL(scale, kHost, kFloat, kNCHW, def);
+USE_LITE_KERNEL(elementwise_add, kHost, kFloat, kNCHW, def);
+USE_LITE_KERNEL(elementwise_mul, kHost, kFloat, kNCHW, def);
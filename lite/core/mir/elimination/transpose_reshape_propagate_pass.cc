@@ -0,0 +1,350 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/elimination/transpose_reshape_propagate_pass.h"
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+const std::set<std::string> kTransposeTypes = {"transpose", "transpose2"};
+
+const std::set<std::string> kReshapeTypes = {"reshape",
+                                             "reshape2",
+                                             "squeeze",
+                                             "squeeze2",
+                                             "unsqueeze",
+                                             "unsqueeze2",
+                                             "flatten",
+                                             "flatten2"};
+
+// The ops computing each value alone, they commute with a transpose.
+const std::set<std::string> kLayoutAgnosticTypes = {"relu",
+                                                    "relu6",
+                                                    "leaky_relu",
+                                                    "sigmoid",
+                                                    "tanh",
+                                                    "exp",
+                                                    "log",
+                                                    "abs",
+                                                    "square",
+                                                    "sqrt",
+                                                    "rsqrt",
+                                                    "floor",
+                                                    "hard_sigmoid",
+                                                    "hard_swish",
+                                                    "swish",
+                                                    "gelu",
+                                                    "softsign",
+                                                    "cast",
+                                                    "scale"};
+
+const std::set<std::string> kElementwiseTypes = {"elementwise_add",
+                                                 "elementwise_sub",
+                                                 "elementwise_mul",
+                                                 "elementwise_div",
+                                                 "elementwise_max",
+                                                 "elementwise_min",
+                                                 "elementwise_pow"};
+
+Node* FindArg(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) return link;
+  }
+  return nullptr;
+}
+
+bool HasArgs(const OpInfo* op_info, const std::string& param, bool is_input) {
+  if (is_input) {
+    return op_info->HasInput(param) && !op_info->Input(param).empty();
+  }
+  return op_info->HasOutput(param) && !op_info->Output(param).empty();
+}
+
+Node* InputOf(Node* op, const std::string& param) {
+  auto* op_info = op->AsStmt().op_info();
+  if (!HasArgs(op_info, param, true)) return nullptr;
+  return FindArg(op->inlinks, op_info->Input(param).front());
+}
+
+Node* OutputOf(Node* op, const std::string& param) {
+  auto* op_info = op->AsStmt().op_info();
+  if (!HasArgs(op_info, param, false)) return nullptr;
+  return FindArg(op->outlinks, op_info->Output(param).front());
+}
+
+bool IsType(Node* op, const std::set<std::string>& types) {
+  auto* op_info = op->AsStmt().op_info();
+  if (op_info->HasAttr("enable_int8") &&
+      op_info->GetAttr<bool>("enable_int8")) {
+    return false;
+  }
+  return types.count(op_info->Type()) > 0;
+}
+
+// Returns the only op reading `var`, if it reads it only as X.
+Node* SoleXReader(Node* var) {
+  if (!var || var->AsArg().is_weight || var->outlinks.size() != 1) {
+    return nullptr;
+  }
+  auto* op = var->outlinks.front();
+  auto* op_info = op->AsStmt().op_info();
+  for (auto& item : op_info->inputs()) {
+    for (auto& name : item.second) {
+      if (name == var->AsArg().name && item.first != "X") return nullptr;
+    }
+  }
+  return InputOf(op, "X") == var ? op : nullptr;
+}
+
+bool IsLayoutAgnostic(Node* op) {
+  auto* op_info = op->AsStmt().op_info();
+  if (IsType(op, kLayoutAgnosticTypes)) {
+    return op->inlinks.size() == 1 && op->outlinks.size() == 1;
+  }
+  if (!IsType(op, kElementwiseTypes) || op->inlinks.size() != 2) {
+    return false;
+  }
+  // The other input must be a scalar weight.
+  auto* y = InputOf(op, "Y");
+  if (!y || !y->AsArg().is_weight) return false;
+  auto* var = op->AsStmt().op()->scope()->FindVar(y->AsArg().name);
+  return var && var->IsType<Tensor>() && var->Get<Tensor>().numel() == 1 &&
+         op_info->Output("Out").size() == 1;
+}
+
+// A reshape to a shape depending only on the number of values.
+bool IsStaticReshape(Node* op) {
+  auto* op_info = op->AsStmt().op_info();
+  if (!IsType(op, {"reshape", "reshape2"}) ||
+      HasArgs(op_info, "Shape", true) ||
+      HasArgs(op_info, "ShapeTensor", true) || !op_info->HasAttr("shape")) {
+    return false;
+  }
+  for (auto d : op_info->GetAttr<std::vector<int>>("shape")) {
+    if (d == 0) return false;
+  }
+  return op->inlinks.size() == 1;
+}
+
+void ResetOp(SSAGraph* graph, Node* op, const cpp::OpDesc& op_desc) {
+  op->AsStmt().ResetOp(op_desc, graph->valid_places());
+}
+
+// Makes `op` read `to` instead of `from`.
+void ReplaceInput(SSAGraph* graph, Node* op, Node* from, Node* to) {
+  cpp::OpDesc op_desc = *op->AsStmt().op_info();
+  for (auto& item : *op_desc.mutable_inputs()) {
+    for (auto& name : item.second) {
+      if (name == from->AsArg().name) name = to->AsArg().name;
+    }
+  }
+  ResetOp(graph, op, op_desc);
+  from->outlinks.remove(op);
+  op->inlinks.remove(from);
+  IR_NODE_LINK_TO(to, op);
+}
+
+// Collects the op and its outputs which are not read by any op.
+void CollectRemovedOp(Node* op, std::set<const Node*>* nodes) {
+  nodes->insert(op);
+  for (auto* out : op->outlinks) {
+    if (out->outlinks.empty() ||
+        (out->outlinks.size() == 1 && nodes->count(out->outlinks.front()))) {
+      nodes->insert(out);
+    }
+  }
+}
+
+// Returns true if `out` is the only output of the op read by other ops, e.g.
+// the XShape of transpose2 and reshape2 is not read.
+bool OnlyOutputRead(Node* op, Node* out) {
+  for (auto* var : op->outlinks) {
+    if (var != out && !var->outlinks.empty()) return false;
+  }
+  return true;
+}
+
+std::vector<int> Perm(Node* op) {
+  return op->AsStmt().op_info()->GetAttr<std::vector<int>>("axis");
+}
+
+bool IsIdentity(const std::vector<int>& perm) {
+  for (size_t i = 0; i < perm.size(); i++) {
+    if (perm[i] != static_cast<int>(i)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int TransposeReshapePropagatePass::ComposeTransposes(SSAGraph* graph) {
+  int num_composed = 0;
+  std::set<const Node*> removed;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (removed.count(node) || !IsType(node, kTransposeTypes)) continue;
+    auto* in = InputOf(node, "X");
+    auto* out = OutputOf(node, "Out");
+    if (!in || !out || !OnlyOutputRead(node, out)) continue;
+    std::vector<Node*> path;
+    Node* cur = out;
+    Node* next = SoleXReader(cur);
+    while (next && IsLayoutAgnostic(next)) {
+      path.push_back(next);
+      cur = OutputOf(next, "Out");
+      next = SoleXReader(cur);
+    }
+    if (!next || !IsType(next, kTransposeTypes) ||
+        !OnlyOutputRead(next, OutputOf(next, "Out"))) {
+      continue;
+    }
+    auto first_perm = Perm(node);
+    auto second_perm = Perm(next);
+    if (first_perm.size() != second_perm.size()) continue;
+    // transpose(transpose(x, p1), p2)[i] = x[p1[p2[i]]]
+    std::vector<int> perm(first_perm.size());
+    for (size_t i = 0; i < perm.size(); i++) {
+      perm[i] = first_perm[second_perm[i]];
+    }
+
+    // The layout agnostic ops read the input of the first transpose.
+    std::set<const Node*> nodes_to_remove;
+    ReplaceInput(graph, path.empty() ? next : path.front(), out, in);
+    CollectRemovedOp(node, &nodes_to_remove);
+
+    auto* second_in = InputOf(next, "X");
+    auto* second_out = OutputOf(next, "Out");
+    if (IsIdentity(perm) && !path.empty()) {
+      // The last layout agnostic op writes the output of the transposes.
+      auto* last = path.back();
+      cpp::OpDesc op_desc = *last->AsStmt().op_info();
+      op_desc.SetOutput("Out", {second_out->AsArg().name});
+      ResetOp(graph, last, op_desc);
+      last->outlinks.remove(second_in);
+      second_in->inlinks.remove(last);
+      IR_OP_VAR_LINK(last, second_out);
+      nodes_to_remove.insert(second_in);
+      CollectRemovedOp(next, &nodes_to_remove);
+    } else if (IsIdentity(perm) && !second_out->outlinks.empty()) {
+      std::vector<Node*> readers(second_out->outlinks.begin(),
+                                 second_out->outlinks.end());
+      for (auto* reader : readers) {
+        ReplaceInput(graph, reader, second_out, second_in);
+      }
+      CollectRemovedOp(next, &nodes_to_remove);
+    } else {
+      cpp::OpDesc op_desc = *next->AsStmt().op_info();
+      op_desc.SetAttr("axis", perm);
+      ResetOp(graph, next, op_desc);
+    }
+    removed.insert(nodes_to_remove.begin(), nodes_to_remove.end());
+    GraphSafeRemoveNodes(graph, nodes_to_remove);
+    num_composed++;
+  }
+  return num_composed;
+}
+
+int TransposeReshapePropagatePass::ComposeReshapes(SSAGraph* graph) {
+  int num_composed = 0;
+  std::set<const Node*> removed;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (removed.count(node) || !IsStaticReshape(node)) continue;
+    auto* node_in = InputOf(node, "X");
+    Node* in = node_in;
+    std::vector<Node*> dropped;
+    while (in && !in->AsArg().is_weight && in->outlinks.size() == 1 &&
+           in->inlinks.size() == 1) {
+      auto* producer = in->inlinks.front();
+      if (!IsType(producer, kReshapeTypes) ||
+          OutputOf(producer, "Out") != in || producer->inlinks.size() != 1 ||
+          !OnlyOutputRead(producer, in)) {
+        break;
+      }
+      dropped.push_back(producer);
+      in = InputOf(producer, "X");
+    }
+    if (dropped.empty() || !in) continue;
+    ReplaceInput(graph, node, node_in, in);
+    std::set<const Node*> nodes_to_remove;
+    for (auto* op : dropped) {
+      CollectRemovedOp(op, &nodes_to_remove);
+    }
+    removed.insert(nodes_to_remove.begin(), nodes_to_remove.end());
+    GraphSafeRemoveNodes(graph, nodes_to_remove);
+    num_composed++;
+  }
+  return num_composed;
+}
+
+int TransposeReshapePropagatePass::SetInplaceReshapes(SSAGraph* graph) {
+  std::map<std::string, int> num_writers;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    for (auto* out : node->outlinks) {
+      num_writers[out->AsArg().name]++;
+    }
+  }
+  int num_inplace = 0;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!IsType(node, kReshapeTypes)) continue;
+    auto* op_info = node->AsStmt().op_info();
+    if (op_info->HasAttr("inplace") && op_info->GetAttr<bool>("inplace")) {
+      continue;
+    }
+    // The memory is shared only if neither of the variables is written again.
+    auto* in = InputOf(node, "X");
+    auto* out = OutputOf(node, "Out");
+    if (!in || !out || in->AsArg().is_weight || in->AsArg().is_persist ||
+        num_writers[in->AsArg().name] > 1 ||
+        num_writers[out->AsArg().name] > 1) {
+      continue;
+    }
+    cpp::OpDesc op_desc = *op_info;
+    op_desc.SetAttr("inplace", true);
+    ResetOp(graph, node, op_desc);
+    num_inplace++;
+  }
+  return num_inplace;
+}
+
+void TransposeReshapePropagatePass::Apply(
+    const std::unique_ptr<SSAGraph>& graph) {
+  int num_transposes = 0;
+  int composed = 0;
+  // A composed transpose can meet another one.
+  while ((composed = ComposeTransposes(graph.get())) > 0) {
+    num_transposes += composed;
+  }
+  int num_reshapes = ComposeReshapes(graph.get());
+  int num_inplace = SetInplaceReshapes(graph.get());
+  VLOG(3) << "Composed " << num_transposes << " transposes and "
+          << num_reshapes << " reshapes, " << num_inplace
+          << " reshapes share the memory of the inputs";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(transpose_reshape_propagate_pass,
+                  paddle::lite::mir::TransposeReshapePropagatePass)
+    .BindTargets({TARGET(kAny)})
+    .ExcludeTargets({TARGET(kXPU)});
@@ -0,0 +1,48 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * TransposeReshapePropagatePass cleans up the transpose and reshape runs of
+ * the models converted from TensorFlow or ONNX:
+ *  - A transpose is moved behind the layout agnostic ops after it, e.g. the
+ *    activations, so it meets the next transpose. The two are composed into
+ *    one, and both are removed if the composed permutation is the identity.
+ *  - The reshape-like ops (reshape, squeeze, unsqueeze, flatten) before a
+ *    reshape to a static shape are removed.
+ *  - The remaining reshape-like ops share the memory of their inputs instead
+ *    of copying them, by setting their `inplace` attr.
+ */
+class TransposeReshapePropagatePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  int ComposeTransposes(SSAGraph* graph);
+  int ComposeReshapes(SSAGraph* graph);
+  int SetInplaceReshapes(SSAGraph* graph);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
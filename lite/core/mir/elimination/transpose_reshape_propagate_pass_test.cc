@@ -0,0 +1,222 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/elimination/transpose_reshape_propagate_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/memory_optimize_pass.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+class TransposeReshapePropagatePassTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    program_desc_ = std::make_shared<cpp::ProgramDesc>();
+    scope_ = std::make_shared<Scope>();
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->SetIdx(0);
+    block_desc_->SetParentIdx(-1);
+  }
+
+  void AddVar(const std::string& name, bool persistable = false) {
+    auto* var = block_desc_->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetDataType(cpp::VarDesc::Type::FP32);
+    var->SetPersistable(persistable);
+  }
+
+  void AddWeight(const std::string& name, int64_t numel) {
+    AddVar(name, true);
+    auto* w = scope_->Var(name)->GetMutable<Tensor>();
+    w->Resize({numel});
+    auto* w_data = w->mutable_data<float>();
+    for (int64_t i = 0; i < numel; i++) {
+      w_data[i] = 0.5f;
+    }
+    w->set_persistable(true);
+  }
+
+  // Adds `type`(x) -> out, the ops ending with 2 also write an XShape.
+  cpp::OpDesc* AddOp(const std::string& type,
+                     const std::string& x,
+                     const std::string& out) {
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    op->SetInput("X", {x});
+    op->SetOutput("Out", {out});
+    AddVar(out);
+    if (type.back() == '2') {
+      op->SetOutput("XShape", {out + "_xshape"});
+      AddVar(out + "_xshape");
+    }
+    return op;
+  }
+
+  cpp::OpDesc* AddTranspose(const std::string& x,
+                            const std::string& out,
+                            const std::vector<int>& axis) {
+    auto* op = AddOp("transpose2", x, out);
+    op->SetAttr("axis", axis);
+    return op;
+  }
+
+  // Runs the pass and returns the op descs in topological order.
+  std::vector<const OpInfo*> Apply(ProgramPass* pass) {
+    std::vector<Place> valid_places{{TARGET(kHost), PRECISION(kFloat)}};
+    program_.reset(new Program(program_desc_, scope_, valid_places));
+    graph_.reset(new SSAGraph);
+    graph_->Build(*program_, valid_places);
+    pass->Apply(graph_);
+    std::vector<const OpInfo*> ops;
+    for (auto& node : graph_->StmtTopologicalOrder()) {
+      ops.push_back(node->stmt()->op_info());
+    }
+    return ops;
+  }
+
+  static bool Inplace(const OpInfo* op) {
+    return op->HasAttr("inplace") && op->GetAttr<bool>("inplace");
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_desc_{nullptr};
+  std::unique_ptr<Program> program_;
+  std::unique_ptr<SSAGraph> graph_;
+};
+
+// transpose(relu(transpose(x) + w)) with inverse perms and a scalar w: both
+// transposes are removed.
+TEST_F(TransposeReshapePropagatePassTest, scalar_elementwise) {
+  AddVar("x");
+  AddWeight("w", 1);
+  AddTranspose("x", "t0", {0, 2, 3, 1});
+  auto* add = AddOp("elementwise_add", "t0", "a");
+  add->SetInput("Y", {"w"});
+  add->SetAttr("axis", -1);
+  AddOp("relu", "a", "r");
+  AddTranspose("r", "out", {0, 3, 1, 2});
+
+  TransposeReshapePropagatePass pass;
+  auto ops = Apply(&pass);
+  ASSERT_EQ(ops.size(), 2UL);
+  EXPECT_EQ(ops[0]->Type(), "elementwise_add");
+  EXPECT_EQ(ops[0]->Input("X").front(), "x");
+  EXPECT_EQ(ops[0]->Input("Y").front(), "w");
+  EXPECT_EQ(ops[1]->Type(), "relu");
+  EXPECT_EQ(ops[1]->Input("X").front(), "a");
+  EXPECT_EQ(ops[1]->Output("Out").front(), "out");
+}
+
+// The transposes are composed into one if the perms are not inverse.
+TEST_F(TransposeReshapePropagatePassTest, composed_transpose) {
+  AddVar("x");
+  AddTranspose("x", "t0", {0, 2, 3, 1});
+  AddOp("relu", "t0", "r");
+  AddTranspose("r", "out", {0, 2, 3, 1});
+
+  TransposeReshapePropagatePass pass;
+  auto ops = Apply(&pass);
+  ASSERT_EQ(ops.size(), 2UL);
+  EXPECT_EQ(ops[0]->Type(), "relu");
+  EXPECT_EQ(ops[0]->Input("X").front(), "x");
+  EXPECT_EQ(ops[1]->Type(), "transpose2");
+  EXPECT_EQ(ops[1]->Output("Out").front(), "out");
+  EXPECT_EQ(ops[1]->GetAttr<std::vector<int>>("axis"),
+            (std::vector<int>{0, 3, 1, 2}));
+}
+
+// A broadcast weight depends on the layout, nothing is propagated.
+TEST_F(TransposeReshapePropagatePassTest, tensor_elementwise) {
+  AddVar("x");
+  AddWeight("w", 4);
+  AddTranspose("x", "t0", {0, 2, 3, 1});
+  auto* add = AddOp("elementwise_add", "t0", "a");
+  add->SetInput("Y", {"w"});
+  add->SetAttr("axis", -1);
+  AddTranspose("a", "out", {0, 3, 1, 2});
+
+  TransposeReshapePropagatePass pass;
+  auto ops = Apply(&pass);
+  ASSERT_EQ(ops.size(), 3UL);
+  EXPECT_EQ(ops[0]->Type(), "transpose2");
+  EXPECT_EQ(ops[1]->Type(), "elementwise_add");
+  EXPECT_EQ(ops[1]->Input("X").front(), "t0");
+  EXPECT_EQ(ops[2]->Type(), "transpose2");
+}
+
+// reshape2(squeeze2(x)) becomes reshape2(x), the reshapes then share the
+// memory of their inputs.
+TEST_F(TransposeReshapePropagatePassTest, inplace_reshape) {
+  AddVar("x");
+  AddOp("squeeze2", "x", "s")->SetAttr("axes", std::vector<int>{1});
+  AddOp("reshape2", "s", "r")->SetAttr("shape", std::vector<int>{2, -1});
+  AddOp("flatten2", "r", "out")->SetAttr("axis", 1);
+
+  TransposeReshapePropagatePass pass;
+  auto ops = Apply(&pass);
+  ASSERT_EQ(ops.size(), 2UL);
+  EXPECT_EQ(ops[0]->Type(), "reshape2");
+  EXPECT_EQ(ops[0]->Input("X").front(), "x");
+  EXPECT_TRUE(Inplace(ops[0]));
+  EXPECT_EQ(ops[1]->Type(), "flatten2");
+  EXPECT_TRUE(Inplace(ops[1]));
+}
+
+// The input and output of an inplace squeeze2 are not reused by
+// memory_optimize_pass, the other variables are.
+TEST_F(TransposeReshapePropagatePassTest, memory_optimize) {
+  AddVar("x");
+  auto* squeeze = AddOp("squeeze2", "x", "s");
+  squeeze->SetAttr("axes", std::vector<int>{1});
+  squeeze->SetAttr("inplace", true);
+  AddOp("unsqueeze2", "s", "u")->SetAttr("axes", std::vector<int>{1});
+  AddOp("squeeze2", "u", "q")->SetAttr("axes", std::vector<int>{1});
+  AddOp("flatten2", "q", "out")->SetAttr("axis", 1);
+
+  MemoryOptimizePass pass;
+  auto ops = Apply(&pass);
+  ASSERT_EQ(ops.size(), 4UL);
+  EXPECT_EQ(ops[0]->Input("X").front(), "x");
+  EXPECT_EQ(ops[0]->Output("Out").front(), "s");
+  EXPECT_EQ(ops[1]->Input("X").front(), "s");
+  // u does not live with the output of the flatten2, it takes the memory of
+  // another variable.
+  EXPECT_NE(ops[1]->Output("Out").front(), "u");
+  EXPECT_EQ(ops[2]->Input("X").front(), ops[1]->Output("Out").front());
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(transpose2);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(relu);
+USE_LITE_OP(reshape2);
+USE_LITE_OP(squeeze2);
+USE_LITE_OP(unsqueeze2);
+USE_LITE_OP(flatten2);
+USE_LITE_KERNEL(reshape2, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(flatten2, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(squeeze2, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(unsqueeze2, kHost, kAny, kAny, def);
@@ -0,0 +1,55 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/channel_affine_fuse_pass.h"
+#include <memory>
+#include <vector>
+#include "lite/core/mir/fusion/channel_affine_fuser.h"
+#include "lite/core/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void ChannelAffineFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  std::vector<std::string> producer_types{
+      "conv2d", "depthwise_conv2d", "mul", "matmul", "fc"};
+  std::vector<std::string> affine_types{"batch_norm",
+                                        "affine_channel",
+                                        "scale",
+                                        "elementwise_mul",
+                                        "elementwise_add"};
+  // A folded op can be followed by another affine op, e.g. conv-bn-scale,
+  // and a mul becomes fc once it gets a bias, so fold until nothing changes.
+  bool fused = true;
+  while (fused) {
+    fused = false;
+    for (auto& producer_type : producer_types) {
+      for (auto& affine_type : affine_types) {
+        fusion::ChannelAffineFuser fuser(producer_type, affine_type);
+        fuser(graph.get());
+        fused = fused || fuser.num_fused() > 0;
+      }
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_channel_affine_fuse_pass,
+                  paddle::lite::mir::ChannelAffineFusePass)
+    .BindTargets({TARGET(kAny)})
+    .ExcludeTargets({TARGET(kXPU), TARGET(kBM)});
@@ -0,0 +1,139 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/mir/fusion/channel_affine_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void AddVarDesc(cpp::BlockDesc* block_desc,
+                const std::string& name,
+                bool persistable = false) {
+  auto* var = block_desc->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+  var->SetDataType(cpp::VarDesc::Type::FP32);
+  var->SetPersistable(persistable);
+}
+
+// out = scale(elementwise_mul(mul(x, w), s), bias = 0.25), where the mul is
+// int8 and s has a negative channel: the mul becomes an fc with a new bias.
+TEST(ChannelAffineFusePass, int8_mul) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->SetIdx(0);
+  block_desc->SetParentIdx(-1);
+  AddVarDesc(block_desc, "x");
+  AddVarDesc(block_desc, "w", true);
+  AddVarDesc(block_desc, "s", true);
+  AddVarDesc(block_desc, "mul_out");
+  AddVarDesc(block_desc, "mul2_out");
+  AddVarDesc(block_desc, "out");
+
+  const std::vector<int8_t> w_values{-128, 127, -128, 5, -7, 0};
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({2, 3});
+  std::copy(w_values.begin(), w_values.end(), w->mutable_data<int8_t>());
+  w->set_persistable(true);
+  auto* s = scope->Var("s")->GetMutable<Tensor>();
+  s->Resize({3});
+  auto* s_data = s->mutable_data<float>();
+  s_data[0] = 2.f;
+  s_data[1] = -1.f;
+  s_data[2] = -0.5f;
+  s->set_persistable(true);
+
+  auto* mul = block_desc->AddOp<cpp::OpDesc>();
+  mul->SetType("mul");
+  mul->SetInput("X", {"x"});
+  mul->SetInput("Y", {"w"});
+  mul->SetOutput("Out", {"mul_out"});
+  mul->SetAttr("x_num_col_dims", 1);
+  mul->SetAttr("y_num_col_dims", 1);
+  mul->SetAttr("enable_int8", true);
+  mul->SetAttr("X0_scale", std::vector<float>{0.1f});
+  mul->SetAttr("Y0_scale", std::vector<float>{0.02f});
+  auto* elementwise_mul = block_desc->AddOp<cpp::OpDesc>();
+  elementwise_mul->SetType("elementwise_mul");
+  elementwise_mul->SetInput("X", {"mul_out"});
+  elementwise_mul->SetInput("Y", {"s"});
+  elementwise_mul->SetOutput("Out", {"mul2_out"});
+  elementwise_mul->SetAttr("axis", -1);
+  auto* scale = block_desc->AddOp<cpp::OpDesc>();
+  scale->SetType("scale");
+  scale->SetInput("X", {"mul2_out"});
+  scale->SetOutput("Out", {"out"});
+  scale->SetAttr("scale", 1.f);
+  scale->SetAttr("bias", 0.25f);
+  scale->SetAttr("bias_after_scale", true);
+
+  std::vector<Place> valid_places{{TARGET(kHost), PRECISION(kFloat)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  ChannelAffineFusePass pass;
+  pass.Apply(graph);
+
+  std::vector<const OpInfo*> ops;
+  for (auto& node : graph->StmtTopologicalOrder()) {
+    ops.push_back(node->stmt()->op_info());
+  }
+  ASSERT_EQ(ops.size(), 1UL);
+  ASSERT_EQ(ops[0]->Type(), "fc");
+  EXPECT_EQ(ops[0]->Input("Input").front(), "x");
+  EXPECT_EQ(ops[0]->Output("Out").front(), "out");
+
+  // The weights of the negative channels are negated, -128 saturates.
+  const std::vector<int8_t> folded{-128, -127, 127, 5, 7, 0};
+  for (size_t i = 0; i < folded.size(); i++) {
+    EXPECT_EQ(w->data<int8_t>()[i], folded[i]) << i;
+  }
+  auto w_scale = ops[0]->GetInputScale("w");
+  ASSERT_EQ(w_scale.size(), 3UL);
+  EXPECT_FLOAT_EQ(w_scale[0], 0.04f);
+  EXPECT_FLOAT_EQ(w_scale[1], 0.02f);
+  EXPECT_FLOAT_EQ(w_scale[2], 0.01f);
+
+  // The new bias is a weight of the root scope.
+  auto bias_name = ops[0]->Input("Bias").front();
+  auto* bias_var = scope->FindLocalVar(bias_name);
+  ASSERT_TRUE(bias_var);
+  EXPECT_FALSE(program.exec_scope()->FindLocalVar(bias_name));
+  auto& bias = bias_var->Get<Tensor>();
+  EXPECT_TRUE(bias.persistable());
+  ASSERT_EQ(bias.numel(), 3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_FLOAT_EQ(bias.data<float>()[i], 0.25f);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(mul);
+USE_LITE_OP(fc);
+USE_LITE_OP(elementwise_mul);
+USE_LITE_OP(scale);
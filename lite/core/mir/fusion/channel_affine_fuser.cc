@@ -0,0 +1,513 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/channel_affine_fuser.h"
+#include <cmath>
+#include <limits>
+#include <list>
+#include <set>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+namespace {
+
+struct ProducerInfo {
+  std::string input_param;
+  std::string weight_param;
+  std::string out_param;
+  // The output channel is dims[channel_axis] of the output of rank `rank`,
+  // the rank is 0 if it's unknown at optimize time and the channel is the
+  // last dim.
+  int rank{0};
+  int channel_axis{0};
+  int channels{0};
+  // The channels are the rows of the weights, or the columns of the [K, N]
+  // weights of fc/mul/matmul.
+  bool weight_rows{true};
+};
+
+bool GetProducerParams(const std::string& op_type, ProducerInfo* info) {
+  if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+    info->input_param = "Input";
+    info->weight_param = "Filter";
+    info->out_param = "Output";
+  } else if (op_type == "fc") {
+    info->input_param = "Input";
+    info->weight_param = "W";
+    info->out_param = "Out";
+  } else if (op_type == "mul" || op_type == "matmul") {
+    info->input_param = "X";
+    info->weight_param = "Y";
+    info->out_param = "Out";
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::string AffineOutParam(const std::string& op_type) {
+  return op_type == "batch_norm" ? "Y" : "Out";
+}
+
+Tensor* FindTensor(Scope* scope, const std::string& name) {
+  auto* var = scope->FindVar(name);
+  if (!var || !var->IsType<Tensor>()) return nullptr;
+  return var->GetMutable<Tensor>();
+}
+
+// Returns the persistable fp32 tensor of the input `param` if it has `numel`
+// values, numel < 0 for any size.
+Tensor* FindParamTensor(const OpInfo* op_info,
+                        Scope* scope,
+                        const std::string& param,
+                        int64_t numel) {
+  if (!op_info->HasInput(param) || op_info->Input(param).empty()) {
+    return nullptr;
+  }
+  auto* tensor = FindTensor(scope, op_info->Input(param).front());
+  if (!tensor || !tensor->persistable() || !tensor->IsInitialized() ||
+      tensor->precision() != PRECISION(kFloat) ||
+      (numel >= 0 && tensor->numel() != numel)) {
+    return nullptr;
+  }
+  return tensor;
+}
+
+Node* FindLink(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->arg()->name == name) return link;
+  }
+  return nullptr;
+}
+
+bool IsInt8Op(const OpInfo* op_info) {
+  return op_info->HasAttr("enable_int8") &&
+         op_info->GetAttr<bool>("enable_int8");
+}
+
+bool GetProducerInfo(const Node* node, ProducerInfo* info) {
+  auto* op_info = node->stmt()->op_info();
+  auto* scope = node->stmt()->op()->scope();
+  auto op_type = op_info->Type();
+  if (!GetProducerParams(op_type, info)) return false;
+  if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+    if ((op_info->HasAttr("with_act") && op_info->GetAttr<bool>("with_act")) ||
+        (op_info->HasAttr("data_format") &&
+         op_info->GetAttr<std::string>("data_format") == "NHWC")) {
+      return false;
+    }
+    info->rank = 4;
+    info->channel_axis = 1;
+    info->weight_rows = true;
+  } else if (op_type == "fc") {
+    if ((op_info->HasAttr("activation_type") &&
+         !op_info->GetAttr<std::string>("activation_type").empty()) ||
+        (op_info->HasAttr("padding_weights") &&
+         op_info->GetAttr<bool>("padding_weights"))) {
+      return false;
+    }
+    info->rank = op_info->GetAttr<int>("in_num_col_dims") + 1;
+    info->channel_axis = info->rank - 1;
+    info->weight_rows = false;
+  } else if (op_type == "mul") {
+    if (op_info->HasAttr("y_num_col_dims") &&
+        op_info->GetAttr<int>("y_num_col_dims") != 1) {
+      return false;
+    }
+    info->rank = op_info->GetAttr<int>("x_num_col_dims") + 1;
+    info->channel_axis = info->rank - 1;
+    info->weight_rows = false;
+  } else {
+    // The rank of the matmul output depends on the input.
+    info->rank = 0;
+    info->weight_rows = op_info->HasAttr("transpose_Y") &&
+                        op_info->GetAttr<bool>("transpose_Y");
+  }
+
+  auto weight_name = op_info->Input(info->weight_param).front();
+  auto* weight = FindTensor(scope, weight_name);
+  if (!weight || !weight->persistable()) return false;
+  auto weight_dims = weight->dims();
+  bool is_conv = info->weight_param == "Filter";
+  if (weight_dims.size() != (is_conv ? 4UL : 2UL)) return false;
+  info->channels = static_cast<int>(info->weight_rows ? weight_dims[0]
+                                                      : weight_dims[1]);
+
+  if (IsInt8Op(op_info)) {
+    if (weight->precision() != PRECISION(kInt8) ||
+        !op_info->HasInputScale(weight_name)) {
+      return false;
+    }
+    auto scale_size = op_info->GetInputScale(weight_name).size();
+    if (scale_size != 1 && scale_size != static_cast<size_t>(info->channels)) {
+      return false;
+    }
+  } else if (op_info->HasAttr("quantize_weight_bits")) {
+    auto scale_name = weight_name + "_quant_scale";
+    if (!op_info->HasAttr(scale_name) ||
+        op_info->GetAttr<std::vector<float>>(scale_name).size() !=
+            static_cast<size_t>(info->channels)) {
+      return false;
+    }
+  } else if (weight->precision() != PRECISION(kFloat)) {
+    return false;
+  }
+  // The bias is folded too, it must be a weight of the producer.
+  if (op_info->HasInput("Bias") && !op_info->Input("Bias").empty() &&
+      !FindParamTensor(op_info, scope, "Bias", info->channels)) {
+    return false;
+  }
+  return true;
+}
+
+// Returns true if the per-channel operand of an elementwise op is broadcast
+// along the output channel, the value of channel c is y[c * stride].
+bool GetChannelOperand(const std::vector<int64_t>& y_dims,
+                       int axis,
+                       const ProducerInfo& info,
+                       int64_t* stride) {
+  int64_t numel = 1;
+  for (auto d : y_dims) numel *= d;
+  if (numel == 1) {
+    *stride = 0;
+    return true;
+  }
+  int idx = -1;
+  for (size_t i = 0; i < y_dims.size(); i++) {
+    if (y_dims[i] == 1) continue;
+    if (idx >= 0 || y_dims[i] != info.channels) return false;
+    idx = static_cast<int>(i);
+  }
+  *stride = 1;
+  int y_rank = static_cast<int>(y_dims.size());
+  if (axis == -1) {
+    // Y is aligned to the last dims of the output.
+    if (info.rank > 0 && y_rank > info.rank) return false;
+    int channel_from_end =
+        info.rank > 0 ? info.rank - 1 - info.channel_axis : 0;
+    return y_rank - 1 - idx == channel_from_end;
+  }
+  return info.rank > 0 && axis + y_rank <= info.rank &&
+         axis + idx == info.channel_axis;
+}
+
+// Computes the alpha and beta of y = alpha[c] * x + beta[c].
+bool GetChannelAffine(const Node* node,
+                      const ProducerInfo& info,
+                      std::vector<float>* alpha,
+                      std::vector<float>* beta) {
+  auto* op_info = node->stmt()->op_info();
+  auto* scope = node->stmt()->op()->scope();
+  auto op_type = op_info->Type();
+  const int channels = info.channels;
+  alpha->assign(channels, 1.f);
+  beta->assign(channels, 0.f);
+  bool channel_first = info.rank > 0 && info.channel_axis == 1;
+  bool channel_last = info.rank == 0 || info.channel_axis == info.rank - 1;
+  if (op_type == "batch_norm") {
+    if ((op_info->HasAttr("data_layout") &&
+         op_info->GetAttr<std::string>("data_layout") != "NCHW") ||
+        !channel_first) {
+      return false;
+    }
+    auto* scale = FindParamTensor(op_info, scope, "Scale", channels);
+    auto* bias = FindParamTensor(op_info, scope, "Bias", channels);
+    auto* mean = FindParamTensor(op_info, scope, "Mean", channels);
+    auto* variance = FindParamTensor(op_info, scope, "Variance", channels);
+    if (!scale || !bias || !mean || !variance) return false;
+    float eps = op_info->GetAttr<float>("epsilon");
+    auto* scale_data = scale->data<float>();
+    auto* bias_data = bias->data<float>();
+    auto* mean_data = mean->data<float>();
+    auto* variance_data = variance->data<float>();
+    for (int c = 0; c < channels; c++) {
+      (*alpha)[c] = scale_data[c] / std::sqrt(variance_data[c] + eps);
+      (*beta)[c] = bias_data[c] - mean_data[c] * (*alpha)[c];
+    }
+  } else if (op_type == "affine_channel") {
+    std::string layout = op_info->HasAttr("data_layout")
+                             ? op_info->GetAttr<std::string>("data_layout")
+                             : "NCHW";
+    if (!(layout == "NCHW" ? channel_first : channel_last)) return false;
+    auto* scale = FindParamTensor(op_info, scope, "Scale", channels);
+    auto* bias = FindParamTensor(op_info, scope, "Bias", channels);
+    if (!scale || !bias) return false;
+    alpha->assign(scale->data<float>(), scale->data<float>() + channels);
+    beta->assign(bias->data<float>(), bias->data<float>() + channels);
+  } else if (op_type == "scale") {
+    if ((op_info->HasInput("ScaleTensor") &&
+         !op_info->Input("ScaleTensor").empty()) ||
+        (op_info->HasAttr("activation_type") &&
+         !op_info->GetAttr<std::string>("activation_type").empty())) {
+      return false;
+    }
+    float scale = op_info->GetAttr<float>("scale");
+    float bias = op_info->GetAttr<float>("bias");
+    if (!op_info->GetAttr<bool>("bias_after_scale")) bias *= scale;
+    alpha->assign(channels, scale);
+    beta->assign(channels, bias);
+  } else if (op_type == "elementwise_add" || op_type == "elementwise_mul") {
+    auto* y = FindParamTensor(op_info, scope, "Y", -1);
+    if (!y) return false;
+    int axis = op_info->HasAttr("axis") ? op_info->GetAttr<int>("axis") : -1;
+    int64_t stride = 0;
+    if (!GetChannelOperand(y->dims().Vectorize(), axis, info, &stride)) {
+      return false;
+    }
+    auto* y_data = y->data<float>();
+    auto* values = op_type == "elementwise_add" ? beta : alpha;
+    for (int c = 0; c < channels; c++) {
+      (*values)[c] = y_data[c * stride];
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool HasBeta(const std::vector<float>& beta) {
+  for (auto b : beta) {
+    if (b != 0.f) return true;
+  }
+  return false;
+}
+
+// Finds the producer of the affine op and computes the folded transform,
+// returns false if they can't be folded.
+bool CanFold(const Node* affine,
+             Node** producer,
+             ProducerInfo* info,
+             std::vector<float>* alpha,
+             std::vector<float>* beta) {
+  auto* op_info = affine->stmt()->op_info();
+  auto* x = FindLink(affine->inlinks, op_info->Input("X").front());
+  if (!x || x->inlinks.size() != 1 || !x->inlinks.front()->IsStmt()) {
+    return false;
+  }
+  *producer = x->inlinks.front();
+  if (!GetProducerInfo(*producer, info) ||
+      !GetChannelAffine(affine, *info, alpha, beta)) {
+    return false;
+  }
+  // The matmul has no bias.
+  return (*producer)->stmt()->op_info()->Type() != "matmul" || !HasBeta(*beta);
+}
+
+bool AffineTeller(const Node* node) {
+  Node* producer = nullptr;
+  ProducerInfo info;
+  std::vector<float> alpha;
+  std::vector<float> beta;
+  return CanFold(node, &producer, &info, &alpha, &beta);
+}
+
+// Scales the channels of the weights by alpha.
+void FoldWeights(OpInfo* op_info,
+                 const ProducerInfo& info,
+                 const std::vector<float>& alpha,
+                 Tensor* weight) {
+  auto weight_name = op_info->Input(info.weight_param).front();
+  int64_t rows = weight->dims()[0];
+  int64_t cols = weight->numel() / rows;
+  auto channel_of = [&](int64_t r, int64_t c) {
+    return info.weight_rows ? r : c;
+  };
+  if (IsInt8Op(op_info)) {
+    // The scales become per-channel, the int8 weights are only negated, -128
+    // saturates to 127.
+    auto scale = op_info->GetInputScale(weight_name);
+    if (scale.size() == 1) scale.assign(info.channels, scale[0]);
+    for (int c = 0; c < info.channels; c++) {
+      scale[c] *= std::fabs(alpha[c]);
+    }
+    auto* weight_data = weight->mutable_data<int8_t>();
+    for (int64_t r = 0; r < rows; r++) {
+      for (int64_t c = 0; c < cols; c++) {
+        if (alpha[channel_of(r, c)] < 0.f) {
+          int8_t& w = weight_data[r * cols + c];
+          w = w == std::numeric_limits<int8_t>::min()
+                  ? std::numeric_limits<int8_t>::max()
+                  : static_cast<int8_t>(-w);
+        }
+      }
+    }
+    op_info->SetInputScale(weight_name, scale);
+  } else if (op_info->HasAttr("quantize_weight_bits")) {
+    auto scale_name = weight_name + "_quant_scale";
+    auto scale = op_info->GetAttr<std::vector<float>>(scale_name);
+    for (int c = 0; c < info.channels; c++) {
+      scale[c] *= alpha[c];
+    }
+    op_info->SetAttr(scale_name, scale);
+  } else {
+    auto* weight_data = weight->mutable_data<float>();
+    for (int64_t r = 0; r < rows; r++) {
+      for (int64_t c = 0; c < cols; c++) {
+        weight_data[r * cols + c] *= alpha[channel_of(r, c)];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void ChannelAffineFuser::BuildPattern() {
+  ProducerInfo info;
+  CHECK(GetProducerParams(producer_type_, &info)) << producer_type_;
+  auto* input = VarNode("input")
+                    ->assert_is_op_input(producer_type_, info.input_param)
+                    ->AsInput();
+  auto* weight = VarNode("weight")
+                     ->assert_is_op_input(producer_type_, info.weight_param)
+                     ->assert_is_persistable_var()
+                     ->assert_only_one_output()
+                     ->AsInput();
+  auto* producer =
+      OpNode("producer", producer_type_)->assert_is_op(producer_type_);
+  auto* producer_out = VarNode("producer_out")
+                           ->assert_is_op_output(producer_type_, info.out_param)
+                           ->assert_is_op_input(affine_type_, "X")
+                           ->assert_var_not_persistable()
+                           ->assert_only_one_output()
+                           ->AsIntermediate();
+  // The affine op has parameters out of the pattern, e.g. the Y of the
+  // elementwise ops or the mean of batch_norm, so it's not an intermediate
+  // node but removed with them in InsertNewNode.
+  auto* affine = OpNode("affine", affine_type_)
+                     ->assert_is_op(affine_type_)
+                     ->assert_node_satisfied(AffineTeller);
+  auto* affine_out =
+      VarNode("affine_out")
+          ->assert_is_op_output(affine_type_, AffineOutParam(affine_type_))
+          ->AsOutput();
+
+  std::vector<PMNode*> producer_inputs{input, weight};
+  producer_inputs >> *producer >> *producer_out;
+  *producer_out >> *affine >> *affine_out;
+}
+
+void ChannelAffineFuser::InsertNewNode(SSAGraph* graph,
+                                       const key2nodes_t& matched) {
+  auto* affine = matched.at("affine");
+  Node* producer = nullptr;
+  ProducerInfo info;
+  std::vector<float> alpha;
+  std::vector<float> beta;
+  CHECK(CanFold(affine, &producer, &info, &alpha, &beta));
+  CHECK(producer == matched.at("producer"));
+
+  auto* stmt = producer->stmt();
+  auto* scope = stmt->op()->scope();
+  OpInfo op_desc = *stmt->op_info();
+  auto weight_name = op_desc.Input(info.weight_param).front();
+  FoldWeights(&op_desc, info, alpha, FindTensor(scope, weight_name));
+
+  //   affine(producer(x)) = alpha * (w * x + b) + beta
+  //                       = (alpha * w) * x + (alpha * b + beta)
+  std::vector<float> bias = beta;
+  Node* bias_node = nullptr;
+  std::set<const Node*> nodes_to_remove;
+  if (op_desc.HasInput("Bias") && !op_desc.Input("Bias").empty()) {
+    auto bias_name = op_desc.Input("Bias").front();
+    bias_node = FindLink(producer->inlinks, bias_name);
+    auto* old_bias = FindTensor(scope, bias_name)->data<float>();
+    for (int c = 0; c < info.channels; c++) {
+      bias[c] += alpha[c] * old_bias[c];
+    }
+  }
+  if (bias_node && bias_node->outlinks.size() == 1) {
+    auto* bias_tensor = FindTensor(scope, bias_node->arg()->name);
+    std::copy(bias.begin(), bias.end(), bias_tensor->mutable_data<float>());
+  } else if (bias_node || HasBeta(beta)) {
+    // The shared bias is kept for the other ops.
+    if (bias_node) {
+      bias_node->outlinks.remove(producer);
+      producer->inlinks.remove(bias_node);
+    }
+    // The new bias is a weight, it's created in the root scope with the
+    // loaded ones to be found by the clones and saved with the model.
+    std::string bias_name = weight_name + "_affine_bias";
+    while (scope->FindVar(bias_name)) bias_name += "_";
+    auto* bias_tensor = scope->Root()->NewTensor(bias_name);
+    bias_tensor->Resize({info.channels});
+    std::copy(bias.begin(), bias.end(), bias_tensor->mutable_data<float>());
+    bias_tensor->set_persistable(true);
+    bias_node = graph->NewArgumentNode(bias_name);
+    bias_node->arg()->is_weight = true;
+    bias_node->arg()->type = LiteType::GetTensorTy(
+        TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW));
+    IR_NODE_LINK_TO(bias_node, producer);
+    op_desc.SetInput("Bias", {bias_name});
+  }
+
+  auto& out_name = matched.at("affine_out")->arg()->name;
+  if (op_desc.Type() == "mul" && bias_node) {
+    // The mul turns into fc to have a bias.
+    auto x_name = op_desc.Input("X").front();
+    bool is_quantized_op =
+        op_desc.HasInputScale(x_name) && op_desc.HasInputScale(weight_name);
+    std::vector<float> x_scale;
+    std::vector<float> weight_scale;
+    if (is_quantized_op) {
+      x_scale = op_desc.GetInputScale(x_name);
+      weight_scale = op_desc.GetInputScale(weight_name);
+    }
+    int in_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
+    auto bias_name = op_desc.Input("Bias").front();
+    op_desc.mutable_inputs()->clear();
+    op_desc.mutable_outputs()->clear();
+    op_desc.SetType("fc");
+    op_desc.SetInput("Input", {x_name});
+    op_desc.SetInput("W", {weight_name});
+    op_desc.SetInput("Bias", {bias_name});
+    op_desc.SetOutput("Out", {out_name});
+    op_desc.SetAttr("in_num_col_dims", in_num_col_dims);
+    if (is_quantized_op) {
+      op_desc.SetInputScale(x_name, x_scale);
+      op_desc.SetInputScale(weight_name, weight_scale);
+    }
+  } else {
+    op_desc.SetOutput(info.out_param, {out_name});
+  }
+  auto* affine_info = affine->stmt()->op_info();
+  if (affine_info->HasOutputScale(out_name)) {
+    op_desc.SetOutputScale(out_name, affine_info->GetOutputScale(out_name));
+  }
+  stmt->ResetOp(op_desc, graph->valid_places());
+
+  // The parameters and the unused outputs of the affine op, e.g. the mean and
+  // the variance of batch_norm.
+  for (auto* in : affine->inlinks) {
+    if (in != matched.at("producer_out") && in->outlinks.size() == 1) {
+      nodes_to_remove.insert(in);
+    }
+  }
+  for (auto* out : affine->outlinks) {
+    if (out != matched.at("affine_out") && out->outlinks.empty()) {
+      nodes_to_remove.insert(out);
+    }
+  }
+  nodes_to_remove.insert(affine);
+  GraphSafeRemoveNodes(graph, nodes_to_remove);
+  IR_OP_VAR_LINK(producer, matched.at("affine_out"));
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
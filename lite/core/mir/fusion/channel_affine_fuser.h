@@ -0,0 +1,56 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/mir/pattern_matcher_high_api.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/*
+ * ChannelAffineFuser folds a per-channel affine transform y = alpha[c] * x +
+ * beta[c] into the weights and the bias of the op producing x.
+ *
+ * The producers are conv2d, depthwise_conv2d, fc, mul and matmul with
+ * persistable weights, the affine ops are batch_norm, affine_channel, scale
+ * and elementwise_add/elementwise_mul with a persistable per-channel operand.
+ * A mul gets a bias by turning into fc, a matmul only takes the affine ops
+ * without beta. The per-channel int8 weight scales are multiplied by
+ * |alpha[c]| and the weights of the negative alpha[c] are negated.
+ */
+class ChannelAffineFuser : public FuseBase {
+ public:
+  ChannelAffineFuser(const std::string& producer_type,
+                     const std::string& affine_type)
+      : producer_type_(producer_type), affine_type_(affine_type) {}
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+  size_t num_fused() const { return key2nodes_.size(); }
+
+ private:
+  std::string producer_type_;
+  std::string affine_type_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
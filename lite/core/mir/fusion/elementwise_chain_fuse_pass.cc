@@ -0,0 +1,283 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <algorithm>
+#include <list>
+#include <string>
+#include <utility>
+#include "lite/backends/host/math/elementwise_chain.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+using host::math::ChainOp;
+using host::math::ChainStep;
+
+const size_t kMinChainLength = 3;
+
+Node* FindArg(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) return link;
+  }
+  return nullptr;
+}
+
+bool HasSingleArg(const OpInfo* op_info,
+                  const std::string& param,
+                  bool is_input) {
+  if (is_input) {
+    return op_info->HasInput(param) && op_info->Input(param).size() == 1;
+  }
+  return op_info->HasOutput(param) && op_info->Output(param).size() == 1;
+}
+
+bool IsFloatArg(Node* node) {
+  auto* type = node->AsArg().type;
+  return !type || type->precision() == PRECISION(kFloat) ||
+         type->precision() == PRECISION(kAny);
+}
+
+// Returns true if the op can be a step of a chain, the op type is parsed to
+// `op`.
+bool IsChainable(Node* node, ChainOp* op) {
+  if (!node->IsStmt()) return false;
+  auto* op_info = node->AsStmt().op_info();
+  if (!host::math::ParseChainOp(op_info->Type(), op)) return false;
+  if (op_info->HasAttr("enable_int8") &&
+      op_info->GetAttr<bool>("enable_int8")) {
+    return false;
+  }
+  if (*op == ChainOp::kScale && op_info->HasAttr("activation_type") &&
+      !op_info->GetAttr<std::string>("activation_type").empty()) {
+    return false;
+  }
+  bool binary = host::math::IsBinaryChainOp(*op);
+  if (!HasSingleArg(op_info, "X", true) ||
+      !HasSingleArg(op_info, "Out", false) ||
+      binary != HasSingleArg(op_info, "Y", true)) {
+    return false;
+  }
+  // No ScaleTensor or other optional inputs.
+  if (node->inlinks.size() != (binary ? 2UL : 1UL) ||
+      node->outlinks.size() != 1) {
+    return false;
+  }
+  for (auto* link : node->inlinks) {
+    if (!IsFloatArg(link)) return false;
+  }
+  return IsFloatArg(node->outlinks.front());
+}
+
+// Returns true if the Y operand of the binary step `node` provably
+// broadcasts into the chain values, whose dims are the var desc shape of the
+// chain input, so the fused op keeps the shape of each step. The operand must
+// be a weight, the unknown(-1) dims of the chain input match only the
+// broadcast dims of size 1.
+bool IsBroadcastOperand(Node* node,
+                        const std::string& value_name,
+                        const std::string& input_name) {
+  auto* op_info = node->AsStmt().op_info();
+  auto x_name = op_info->Input("X").front();
+  auto y_name = op_info->Input("Y").front();
+  auto& operand_name = x_name == value_name ? y_name : x_name;
+  if (operand_name == input_name) return true;
+  auto* operand = FindArg(node->inlinks, operand_name);
+  if (!operand || !operand->AsArg().is_weight) return false;
+  auto* scope = node->AsStmt().op()->scope();
+  auto* input_var = scope->FindVar(input_name);
+  auto* operand_var = scope->FindVar(operand_name);
+  if (!input_var || !operand_var || !input_var->IsType<Tensor>() ||
+      !operand_var->IsType<Tensor>()) {
+    return false;
+  }
+  auto x_dims = input_var->Get<Tensor>().dims().Vectorize();
+  auto y_dims = operand_var->Get<Tensor>().dims().Vectorize();
+  if (x_dims.empty() || y_dims.empty()) return false;
+  int axis = op_info->HasAttr("axis") ? op_info->GetAttr<int>("axis") : -1;
+  host::math::ChainOperand layout;
+  return host::math::ChainOperandLayout(x_dims, y_dims, axis, &layout);
+}
+
+}  // namespace
+
+std::vector<Node*> ElementwiseChainFusePass::FindChain(
+    Node* node, const std::set<Node*>& fused) {
+  ChainOp op;
+  if (fused.count(node) || !IsChainable(node, &op)) return {};
+  const std::string input_name = node->AsStmt().op_info()->Input("X").front();
+  if (host::math::IsBinaryChainOp(op) &&
+      !IsBroadcastOperand(node, input_name, input_name)) {
+    return {};
+  }
+  std::vector<Node*> chain({node});
+  while (true) {
+    auto* out = chain.back()->outlinks.front();
+    if (out->AsArg().is_weight || out->outlinks.size() != 1) break;
+    auto* next = out->outlinks.front();
+    if (fused.count(next) || !IsChainable(next, &op)) break;
+    auto* op_info = next->AsStmt().op_info();
+    auto& out_name = out->AsArg().name;
+    bool from_x = op_info->Input("X").front() == out_name;
+    bool from_y = host::math::IsBinaryChainOp(op) &&
+                  op_info->Input("Y").front() == out_name;
+    // The chain value enters the Y input only if X is the chain input, so
+    // the shape of the chain value is kept.
+    if (from_x == from_y ||
+        (from_y && (!host::math::IsCommutativeChainOp(op) ||
+                    op_info->Input("X").front() != input_name))) {
+      break;
+    }
+    if (host::math::IsBinaryChainOp(op) &&
+        !IsBroadcastOperand(next, out_name, input_name)) {
+      break;
+    }
+    chain.push_back(next);
+  }
+  if (chain.size() < kMinChainLength) return {};
+  return chain;
+}
+
+void ElementwiseChainFusePass::Fuse(SSAGraph* graph,
+                                    const std::vector<Node*>& chain) {
+  auto first_op = chain.front()->AsStmt().op();
+  auto* scope = first_op->scope();
+  const std::string input_name =
+      chain.front()->AsStmt().op_info()->Input("X").front();
+  Node* input = FindArg(chain.front()->inlinks, input_name);
+  Node* output = chain.back()->outlinks.front();
+
+  std::vector<std::string> op_types;
+  std::vector<int> operand_ids;
+  std::vector<float> alphas;
+  std::vector<float> betas;
+  std::vector<std::string> y_names;
+  std::vector<int> axes;
+  std::vector<Node*> y_nodes;
+  std::set<const Node*> nodes_to_remove;
+  std::string value_name = input_name;
+  for (auto* node : chain) {
+    auto* op_info = node->AsStmt().op_info();
+    ChainOp op;
+    CHECK(host::math::ParseChainOp(op_info->Type(), &op));
+    int operand = ChainStep::kNoOperand;
+    float alpha = 0.f;
+    float beta = 0.f;
+    if (host::math::IsBinaryChainOp(op)) {
+      auto x_name = op_info->Input("X").front();
+      auto y_name = op_info->Input("Y").front();
+      auto& operand_name = x_name == value_name ? y_name : x_name;
+      int axis = op_info->HasAttr("axis") ? op_info->GetAttr<int>("axis") : -1;
+      if (operand_name == input_name) {
+        operand = ChainStep::kChainInput;
+      } else {
+        for (size_t i = 0; i < y_names.size(); i++) {
+          if (y_names[i] == operand_name && axes[i] == axis) {
+            operand = static_cast<int>(i);
+          }
+        }
+        if (operand == ChainStep::kNoOperand) {
+          operand = static_cast<int>(y_names.size());
+          y_names.push_back(operand_name);
+          axes.push_back(axis);
+          auto* y_node = FindArg(node->inlinks, operand_name);
+          if (std::find(y_nodes.begin(), y_nodes.end(), y_node) ==
+              y_nodes.end()) {
+            y_nodes.push_back(y_node);
+          }
+        }
+      }
+    } else if (op == ChainOp::kScale) {
+      float scale = op_info->GetAttr<float>("scale");
+      float bias = op_info->GetAttr<float>("bias");
+      bool bias_after_scale = op_info->GetAttr<bool>("bias_after_scale");
+      alpha = scale;
+      beta = bias_after_scale ? bias : bias * scale;
+    } else if (op == ChainOp::kRelu6) {
+      alpha = op_info->HasAttr("threshold")
+                  ? op_info->GetAttr<float>("threshold")
+                  : 6.f;
+    } else if (op == ChainOp::kLeakyRelu) {
+      alpha = op_info->GetAttr<float>("alpha");
+    }
+    op_types.push_back(op_info->Type());
+    operand_ids.push_back(operand);
+    alphas.push_back(alpha);
+    betas.push_back(beta);
+    nodes_to_remove.insert(node);
+    if (node != chain.back()) {
+      nodes_to_remove.insert(node->outlinks.front());
+    }
+    value_name = node->outlinks.front()->AsArg().name;
+  }
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fusion_elementwise_chain");
+  op_desc.SetInput("X", {input_name});
+  op_desc.SetInput("Y", y_names);
+  op_desc.SetOutput("Out", {output->AsArg().name});
+  op_desc.SetAttr("axes", axes);
+  op_desc.SetAttr("op_types", op_types);
+  op_desc.SetAttr("operand_ids", operand_ids);
+  op_desc.SetAttr("alphas", alphas);
+  op_desc.SetAttr("betas", betas);
+
+  auto fused_op = LiteOpRegistry::Global().Create("fusion_elementwise_chain");
+  fused_op->Attach(op_desc, scope);
+  auto* fused_node =
+      graph->GraphCreateInstructNode(fused_op, first_op->valid_places());
+  GraphSafeRemoveNodes(graph, nodes_to_remove);
+  IR_NODE_LINK_TO(input, fused_node);
+  for (auto* y_node : y_nodes) {
+    IR_NODE_LINK_TO(y_node, fused_node);
+  }
+  IR_NODE_LINK_TO(fused_node, output);
+}
+
+void ElementwiseChainFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  std::set<Node*> fused;
+  int num_chains = 0;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto chain = FindChain(node, fused);
+    if (chain.empty()) continue;
+    fused.insert(chain.begin(), chain.end());
+    Fuse(graph.get(), chain);
+    num_chains++;
+  }
+  VLOG(3) << "Fused " << num_chains << " elementwise chains";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_elementwise_chain_fuse_pass,
+                  paddle::lite::mir::ElementwiseChainFusePass)
+    .BindTargets({TARGET(kX86), TARGET(kARM)})
+    .ExcludeTargets({TARGET(kXPU),
+                     TARGET(kBM),
+                     TARGET(kNPU),
+                     TARGET(kAPU),
+                     TARGET(kRKNPU),
+                     TARGET(kMLU),
+                     TARGET(kHuaweiAscendNPU),
+                     TARGET(kOpenCL),
+                     TARGET(kCUDA),
+                     TARGET(kFPGA)})
+    .BindKernel("fusion_elementwise_chain");
@@ -0,0 +1,50 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <vector>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ElementwiseChainFusePass collapses the linear chains of elementwise, scale
+ * and activation ops, e.g. the `elementwise_mul -> elementwise_add -> sigmoid
+ * -> elementwise_mul` of the gating layers, into one fusion_elementwise_chain
+ * op which computes the whole chain tile by tile in cache.
+ *
+ * The chain value flows through the X input of each op, or through the Y input
+ * of add/mul/max/min whose X is the chain input, and every intermediate
+ * variable must have only one consumer. The other inputs must be weights
+ * whose dims provably broadcast to the var desc shape of the chain input at
+ * the axis of the op, otherwise the chain ends before the op. The chains of
+ * two ops are left to the specialized fusers.
+ */
+class ElementwiseChainFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  std::vector<Node*> FindChain(Node* node, const std::set<Node*>& fused);
+  void Fuse(SSAGraph* graph, const std::vector<Node*>& chain);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
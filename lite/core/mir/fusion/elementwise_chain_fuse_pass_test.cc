@@ -0,0 +1,189 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+class ElementwiseChainFusePassTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    program_desc_ = std::make_shared<cpp::ProgramDesc>();
+    scope_ = std::make_shared<Scope>();
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->SetIdx(0);
+    block_desc_->SetParentIdx(-1);
+  }
+
+  void AddVar(const std::string& name,
+              const std::vector<int64_t>& shape,
+              bool persistable = false) {
+    auto* var = block_desc_->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetDataType(cpp::VarDesc::Type::FP32);
+    var->SetShape(shape);
+    var->SetPersistable(persistable);
+  }
+
+  void AddWeight(const std::string& name, const std::vector<int64_t>& dims) {
+    AddVar(name, dims, true);
+    auto* weight = scope_->Var(name)->GetMutable<Tensor>();
+    weight->Resize(dims);
+    weight->mutable_data<float>();
+    weight->set_persistable(true);
+  }
+
+  void AddBinary(const std::string& type,
+                 const std::string& x,
+                 const std::string& y,
+                 int axis,
+                 const std::string& out) {
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    op->SetInput("X", {x});
+    op->SetInput("Y", {y});
+    op->SetOutput("Out", {out});
+    op->SetAttr("axis", axis);
+  }
+
+  void AddUnary(const std::string& type,
+                const std::string& x,
+                const std::string& out) {
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    op->SetInput("X", {x});
+    op->SetOutput("Out", {out});
+    if (type == "scale") {
+      op->SetAttr("scale", 2.f);
+      op->SetAttr("bias", 1.f);
+      op->SetAttr("bias_after_scale", true);
+    }
+  }
+
+  // Returns the op types in the topological order after the pass.
+  std::vector<std::string> Apply() {
+    std::vector<Place> valid_places{{TARGET(kHost), PRECISION(kFloat)}};
+    program_.reset(new Program(program_desc_, scope_, valid_places));
+    graph_.reset(new SSAGraph);
+    graph_->Build(*program_, valid_places);
+    ElementwiseChainFusePass pass;
+    pass.Apply(graph_);
+    std::vector<std::string> types;
+    for (auto& node : graph_->StmtTopologicalOrder()) {
+      types.push_back(node->stmt()->op_type());
+    }
+    return types;
+  }
+
+  const OpInfo* FindOp(const std::string& type) {
+    for (auto& node : graph_->StmtTopologicalOrder()) {
+      if (node->stmt()->op_type() == type) return node->stmt()->op_info();
+    }
+    return nullptr;
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_desc_{};
+  std::unique_ptr<Program> program_;
+  std::unique_ptr<SSAGraph> graph_;
+};
+
+// out = x * sigmoid(x * s + b), where s [8] and b [4, 1] broadcast into the
+// [-1, 4, 8] chain values at the axes -1 and 1.
+TEST_F(ElementwiseChainFusePassTest, broadcast_weights) {
+  AddVar("x", {-1, 4, 8});
+  AddWeight("s", {8});
+  AddWeight("b", {4, 1});
+  AddVar("mul_out", {-1, 4, 8});
+  AddVar("add_out", {-1, 4, 8});
+  AddVar("sigmoid_out", {-1, 4, 8});
+  AddVar("out", {-1, 4, 8});
+  AddBinary("elementwise_mul", "x", "s", -1, "mul_out");
+  AddBinary("elementwise_add", "mul_out", "b", 1, "add_out");
+  AddUnary("sigmoid", "add_out", "sigmoid_out");
+  AddBinary("elementwise_mul", "x", "sigmoid_out", -1, "out");
+
+  auto types = Apply();
+  ASSERT_EQ(types, std::vector<std::string>({"fusion_elementwise_chain"}));
+  auto* op_info = FindOp("fusion_elementwise_chain");
+  EXPECT_EQ(op_info->Input("X"), std::vector<std::string>({"x"}));
+  EXPECT_EQ(op_info->Input("Y"), std::vector<std::string>({"s", "b"}));
+  EXPECT_EQ(op_info->Output("Out"), std::vector<std::string>({"out"}));
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("axes"),
+            std::vector<int>({-1, 1}));
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("operand_ids"),
+            std::vector<int>({0, 1, -1, -2}));
+}
+
+// The weight w [4, 8] is larger than the [-1, 8] chain values, so the add
+// broadcasts its X into Y and the chain ends before it. The Y of the last
+// add is not a weight, its -1 dim can't be proved to match the chain values.
+TEST_F(ElementwiseChainFusePassTest, unproven_broadcast) {
+  AddVar("x", {-1, 8});
+  AddVar("y", {-1, 8});
+  AddWeight("w", {4, 8});
+  AddVar("exp_out", {-1, 8});
+  AddVar("relu_out", {-1, 8});
+  AddVar("scale_out", {-1, 8});
+  AddVar("add_out", {4, 8});
+  AddVar("tanh_out", {4, 8});
+  AddVar("abs_out", {4, 8});
+  AddVar("out", {4, 8});
+  AddUnary("exp", "x", "exp_out");
+  AddUnary("relu", "exp_out", "relu_out");
+  AddUnary("scale", "relu_out", "scale_out");
+  AddBinary("elementwise_add", "scale_out", "w", -1, "add_out");
+  AddUnary("tanh", "add_out", "tanh_out");
+  AddUnary("abs", "tanh_out", "abs_out");
+  AddBinary("elementwise_add", "abs_out", "y", -1, "out");
+
+  auto types = Apply();
+  ASSERT_EQ(types,
+            std::vector<std::string>({"fusion_elementwise_chain",
+                                      "elementwise_add",
+                                      "tanh",
+                                      "abs",
+                                      "elementwise_add"}));
+  auto* op_info = FindOp("fusion_elementwise_chain");
+  EXPECT_EQ(op_info->Input("X"), std::vector<std::string>({"x"}));
+  EXPECT_TRUE(op_info->Input("Y").empty());
+  EXPECT_EQ(op_info->Output("Out"), std::vector<std::string>({"scale_out"}));
+  EXPECT_EQ(op_info->GetAttr<std::vector<std::string>>("op_types"),
+            std::vector<std::string>({"exp", "relu", "scale"}));
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(elementwise_mul);
+USE_LITE_OP(sigmoid);
+USE_LITE_OP(tanh);
+USE_LITE_OP(exp);
+USE_LITE_OP(abs);
+USE_LITE_OP(relu);
+USE_LITE_OP(scale);
+USE_LITE_OP(fusion_elementwise_chain);
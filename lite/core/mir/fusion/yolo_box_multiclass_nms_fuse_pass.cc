@@ -0,0 +1,277 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/yolo_box_multiclass_nms_fuse_pass.h"
+#include <algorithm>
+#include <list>
+#include <string>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+Node* FindArg(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) return link;
+  }
+  return nullptr;
+}
+
+// The variable is computed by one op and used only by the next op.
+bool IsIntermediate(Node* var) {
+  return var && var->IsArg() && !var->AsArg().is_weight &&
+         !var->AsArg().is_persist && var->inlinks.size() == 1 &&
+         var->outlinks.size() == 1 && var->inlinks.front()->IsStmt();
+}
+
+std::string OpType(Node* op) { return op->AsStmt().op_info()->Type(); }
+
+// Returns the yolo_box op whose output `param` is the variable.
+Node* YoloBoxOf(Node* var, const std::string& param) {
+  if (!IsIntermediate(var)) return nullptr;
+  auto* op = var->inlinks.front();
+  if (OpType(op) != "yolo_box") return nullptr;
+  auto* op_info = op->AsStmt().op_info();
+  if (!op_info->HasOutput(param) || op_info->Output(param).size() != 1 ||
+      op_info->Output(param).front() != var->AsArg().name) {
+    return nullptr;
+  }
+  return op;
+}
+
+// Returns true if the op concatenates only its X inputs of rank 3 on the axis.
+bool IsConcat(Node* op, int axis) {
+  if (OpType(op) != "concat") return false;
+  auto* op_info = op->AsStmt().op_info();
+  if (op->inlinks.size() != op_info->Input("X").size()) return false;
+  int concat_axis = op_info->GetAttr<int>("axis");
+  return (concat_axis < 0 ? concat_axis + 3 : concat_axis) == axis;
+}
+
+// Collects the yolo_box ops whose output `param` is the variable, or is
+// concatenated on the axis to the variable.
+bool TraceYoloBoxes(Node* var,
+                    const std::string& param,
+                    int axis,
+                    std::vector<Node*>* heads,
+                    std::set<const Node*>* nodes) {
+  auto* head = YoloBoxOf(var, param);
+  if (head) {
+    heads->push_back(head);
+    nodes->insert(var);
+    return true;
+  }
+  if (!IsIntermediate(var)) return false;
+  auto* concat = var->inlinks.front();
+  if (!IsConcat(concat, axis)) return false;
+  for (auto& name : concat->AsStmt().op_info()->Input("X")) {
+    auto* input = FindArg(concat->inlinks, name);
+    head = YoloBoxOf(input, param);
+    if (!head) return false;
+    heads->push_back(head);
+    nodes->insert(input);
+  }
+  nodes->insert(var);
+  nodes->insert(concat);
+  return true;
+}
+
+// Returns the input of the transpose which swaps the last two dims of the
+// variable, or nullptr.
+Node* TransposeInput(Node* var, std::set<const Node*>* nodes) {
+  if (!IsIntermediate(var)) return nullptr;
+  auto* transpose = var->inlinks.front();
+  auto type = OpType(transpose);
+  if (type != "transpose" && type != "transpose2") return nullptr;
+  auto* op_info = transpose->AsStmt().op_info();
+  if (op_info->GetAttr<std::vector<int>>("axis") !=
+      std::vector<int>({0, 2, 1})) {
+    return nullptr;
+  }
+  // The XShape of transpose2 must not be used.
+  for (auto* out : transpose->outlinks) {
+    if (out != var && !out->outlinks.empty()) return nullptr;
+  }
+  auto* input = FindArg(transpose->inlinks, op_info->Input("X").front());
+  if (!input) return nullptr;
+  nodes->insert(transpose->outlinks.begin(), transpose->outlinks.end());
+  nodes->insert(transpose);
+  return input;
+}
+
+}  // namespace
+
+std::vector<Node*> YoloBoxMulticlassNmsFusePass::MatchHeads(
+    Node* nms, std::set<const Node*>* nodes) {
+  auto type = OpType(nms);
+  if (type != "multiclass_nms" && type != "multiclass_nms2") return {};
+  auto* op_info = nms->AsStmt().op_info();
+  if (op_info->GetAttr<float>("score_threshold") < 0.f) return {};
+  if (nms->inlinks.size() != 2) return {};
+  auto* bboxes = FindArg(nms->inlinks, op_info->Input("BBoxes").front());
+  auto* scores = FindArg(nms->inlinks, op_info->Input("Scores").front());
+
+  std::vector<Node*> heads;
+  if (!TraceYoloBoxes(bboxes, "Boxes", 1, &heads, nodes)) return {};
+  std::vector<Node*> score_heads;
+  auto* transposed = TransposeInput(scores, nodes);
+  if (transposed) {
+    // The scores are concatenated and then transposed.
+    if (!TraceYoloBoxes(transposed, "Scores", 1, &score_heads, nodes)) {
+      return {};
+    }
+  } else {
+    // The scores of each head are transposed and then concatenated.
+    if (!IsIntermediate(scores)) return {};
+    auto* concat = scores->inlinks.front();
+    if (!IsConcat(concat, 2)) return {};
+    for (auto& name : concat->AsStmt().op_info()->Input("X")) {
+      auto* input = FindArg(concat->inlinks, name);
+      auto* head = YoloBoxOf(TransposeInput(input, nodes), "Scores");
+      if (!head) return {};
+      score_heads.push_back(head);
+      nodes->insert(head->outlinks.begin(), head->outlinks.end());
+    }
+    nodes->insert(scores);
+    nodes->insert(concat);
+  }
+  if (heads != score_heads) return {};
+
+  auto* first = heads.front()->AsStmt().op_info();
+  std::set<Node*> unique_heads;
+  for (auto* head : heads) {
+    if (!unique_heads.insert(head).second || head->outlinks.size() != 2) {
+      return {};
+    }
+    auto* head_info = head->AsStmt().op_info();
+    if (head_info->Input("ImgSize") != first->Input("ImgSize") ||
+        head_info->GetAttr<int>("class_num") !=
+            first->GetAttr<int>("class_num") ||
+        head_info->GetAttr<float>("conf_thresh") !=
+            first->GetAttr<float>("conf_thresh")) {
+      return {};
+    }
+    // The attributes of the newer yolo_box which the fused kernel ignores.
+    if ((head_info->HasAttr("clip_bbox") &&
+         !head_info->GetAttr<bool>("clip_bbox")) ||
+        (head_info->HasAttr("scale_x_y") &&
+         head_info->GetAttr<float>("scale_x_y") != 1.f)) {
+      return {};
+    }
+  }
+  return heads;
+}
+
+void YoloBoxMulticlassNmsFusePass::Fuse(SSAGraph* graph,
+                                        Node* nms,
+                                        const std::vector<Node*>& heads,
+                                        std::set<const Node*> nodes) {
+  auto nms_op = nms->AsStmt().op();
+  auto* scope = nms_op->scope();
+  auto* nms_info = nms->AsStmt().op_info();
+  auto* first = heads.front()->AsStmt().op_info();
+  auto img_size_name = first->Input("ImgSize").front();
+  Node* img_size = FindArg(heads.front()->inlinks, img_size_name);
+
+  std::vector<std::string> x_names;
+  std::vector<Node*> x_nodes;
+  std::vector<int> anchors;
+  std::vector<int> anchor_nums;
+  std::vector<int> downsample_ratios;
+  for (auto* head : heads) {
+    auto* head_info = head->AsStmt().op_info();
+    auto x_name = head_info->Input("X").front();
+    x_names.push_back(x_name);
+    x_nodes.push_back(FindArg(head->inlinks, x_name));
+    auto head_anchors = head_info->GetAttr<std::vector<int>>("anchors");
+    anchors.insert(anchors.end(), head_anchors.begin(), head_anchors.end());
+    anchor_nums.push_back(static_cast<int>(head_anchors.size() / 2));
+    downsample_ratios.push_back(head_info->GetAttr<int>("downsample_ratio"));
+    nodes.insert(head);
+  }
+  nodes.insert(nms);
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fusion_yolo_box_multiclass_nms");
+  op_desc.SetInput("X", x_names);
+  op_desc.SetInput("ImgSize", {img_size_name});
+  op_desc.SetOutput("Out", nms_info->Output("Out"));
+  std::vector<Node*> out_nodes;
+  for (auto* out : nms->outlinks) {
+    out_nodes.push_back(out);
+  }
+  if (nms_info->HasOutput("Index") && !nms_info->Output("Index").empty()) {
+    op_desc.SetOutput("Index", nms_info->Output("Index"));
+  }
+  op_desc.SetAttr("anchors", anchors);
+  op_desc.SetAttr("anchor_nums", anchor_nums);
+  op_desc.SetAttr("downsample_ratios", downsample_ratios);
+  op_desc.SetAttr("class_num", first->GetAttr<int>("class_num"));
+  op_desc.SetAttr("conf_thresh", first->GetAttr<float>("conf_thresh"));
+  op_desc.SetAttr("background_label",
+                  nms_info->GetAttr<int>("background_label"));
+  op_desc.SetAttr("keep_top_k", nms_info->GetAttr<int>("keep_top_k"));
+  op_desc.SetAttr("nms_top_k", nms_info->GetAttr<int>("nms_top_k"));
+  op_desc.SetAttr("score_threshold",
+                  nms_info->GetAttr<float>("score_threshold"));
+  op_desc.SetAttr("nms_threshold", nms_info->GetAttr<float>("nms_threshold"));
+  op_desc.SetAttr("nms_eta", nms_info->GetAttr<float>("nms_eta"));
+  if (nms_info->HasAttr("normalized")) {
+    op_desc.SetAttr("normalized", nms_info->GetAttr<bool>("normalized"));
+  }
+
+  auto fused_op =
+      LiteOpRegistry::Global().Create("fusion_yolo_box_multiclass_nms");
+  fused_op->Attach(op_desc, scope);
+  auto* fused_node =
+      graph->GraphCreateInstructNode(fused_op, nms_op->valid_places());
+  GraphSafeRemoveNodes(graph, nodes);
+  for (auto* x_node : x_nodes) {
+    IR_NODE_LINK_TO(x_node, fused_node);
+  }
+  IR_NODE_LINK_TO(img_size, fused_node);
+  for (auto* out : out_nodes) {
+    IR_NODE_LINK_TO(fused_node, out);
+  }
+}
+
+void YoloBoxMulticlassNmsFusePass::Apply(
+    const std::unique_ptr<SSAGraph>& graph) {
+  std::vector<Node*> nms_nodes;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto type = OpType(node);
+    if (type == "multiclass_nms" || type == "multiclass_nms2") {
+      nms_nodes.push_back(node);
+    }
+  }
+  for (auto* nms : nms_nodes) {
+    std::set<const Node*> nodes;
+    auto heads = MatchHeads(nms, &nodes);
+    if (heads.empty()) continue;
+    Fuse(graph.get(), nms, heads, nodes);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_yolo_box_multiclass_nms_fuse_pass,
+                  paddle::lite::mir::YoloBoxMulticlassNmsFusePass)
+    .BindTargets({TARGET(kX86), TARGET(kARM)})
+    .BindKernel("fusion_yolo_box_multiclass_nms");
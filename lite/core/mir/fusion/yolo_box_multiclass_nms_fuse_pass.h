@@ -0,0 +1,58 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <vector>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * YoloBoxMulticlassNmsFusePass fuses the post-processing of the YOLOv3
+ * models, the yolo_box ops of the detection heads whose outputs are
+ * concatenated and fed to multiclass_nms(2), into one
+ * fusion_yolo_box_multiclass_nms op:
+ *
+ *   yolo_box.Boxes -> [concat(axis=1)] -----------------------> BBoxes
+ *   yolo_box.Scores -> transpose -> [concat(axis=2)] ----------> Scores
+ *   yolo_box.Scores -> [concat(axis=1)] -> transpose ---------> Scores
+ *
+ * where the transposes swap the last two dims. The fused kernel decodes only
+ * the anchors which may pass the thresholds, so the fusion requires the
+ * score_threshold of the NMS >= 0, which drops the zero scores yolo_box
+ * gives to the other anchors. Every intermediate variable must be used only
+ * by the pattern.
+ */
+class YoloBoxMulticlassNmsFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // Returns the yolo_box ops of the nms op, or empty if the pattern doesn't
+  // match, the other nodes of the pattern are added to the nodes.
+  std::vector<Node*> MatchHeads(Node* nms, std::set<const Node*>* nodes);
+  void Fuse(SSAGraph* graph,
+            Node* nms,
+            const std::vector<Node*>& heads,
+            std::set<const Node*> nodes);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,204 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/yolo_box_multiclass_nms_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+class YoloBoxMulticlassNmsFusePassTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    program_desc_ = std::make_shared<cpp::ProgramDesc>();
+    scope_ = std::make_shared<Scope>();
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->SetIdx(0);
+    block_desc_->SetParentIdx(-1);
+    AddVar("img_size");
+  }
+
+  void AddVar(const std::string& name) {
+    auto* var = block_desc_->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetDataType(cpp::VarDesc::Type::FP32);
+    var->SetPersistable(false);
+  }
+
+  // Adds the yolo_box of the head `i`, which writes boxes<i> and scores<i>.
+  void AddYoloBox(int i, const std::vector<int>& anchors, int ratio) {
+    auto suffix = std::to_string(i);
+    AddVar("x" + suffix);
+    AddVar("boxes" + suffix);
+    AddVar("scores" + suffix);
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType("yolo_box");
+    op->SetInput("X", {"x" + suffix});
+    op->SetInput("ImgSize", {"img_size"});
+    op->SetOutput("Boxes", {"boxes" + suffix});
+    op->SetOutput("Scores", {"scores" + suffix});
+    op->SetAttr("anchors", anchors);
+    op->SetAttr("class_num", 80);
+    op->SetAttr("conf_thresh", 0.01f);
+    op->SetAttr("downsample_ratio", ratio);
+  }
+
+  void AddConcat(const std::vector<std::string>& inputs,
+                 const std::string& out,
+                 int axis) {
+    AddVar(out);
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType("concat");
+    op->SetInput("X", inputs);
+    op->SetOutput("Out", {out});
+    op->SetAttr("axis", axis);
+  }
+
+  void AddTranspose(const std::string& x, const std::string& out) {
+    AddVar(out);
+    AddVar(out + "_xshape");
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType("transpose2");
+    op->SetInput("X", {x});
+    op->SetOutput("Out", {out});
+    op->SetOutput("XShape", {out + "_xshape"});
+    op->SetAttr("axis", std::vector<int>{0, 2, 1});
+  }
+
+  void AddNms(const std::string& boxes,
+              const std::string& scores,
+              float score_threshold) {
+    AddVar("out");
+    AddVar("index");
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType("multiclass_nms2");
+    op->SetInput("BBoxes", {boxes});
+    op->SetInput("Scores", {scores});
+    op->SetOutput("Out", {"out"});
+    op->SetOutput("Index", {"index"});
+    op->SetAttr("background_label", -1);
+    op->SetAttr("keep_top_k", 100);
+    op->SetAttr("nms_top_k", 1000);
+    op->SetAttr("score_threshold", score_threshold);
+    op->SetAttr("nms_threshold", 0.45f);
+    op->SetAttr("nms_eta", 1.f);
+    op->SetAttr("normalized", false);
+  }
+
+  // Adds two heads whose scores are transposed and then concatenated, or
+  // concatenated and then transposed.
+  void AddTwoHeads(bool transpose_first, float score_threshold) {
+    AddYoloBox(0, {116, 90, 156, 198, 373, 326}, 32);
+    AddYoloBox(1, {30, 61, 62, 45}, 16);
+    AddConcat({"boxes0", "boxes1"}, "boxes", 1);
+    if (transpose_first) {
+      AddTranspose("scores0", "scores0_t");
+      AddTranspose("scores1", "scores1_t");
+      AddConcat({"scores0_t", "scores1_t"}, "scores", 2);
+    } else {
+      AddConcat({"scores0", "scores1"}, "scores_c", 1);
+      AddTranspose("scores_c", "scores");
+    }
+    AddNms("boxes", "scores", score_threshold);
+  }
+
+  // Runs the pass and returns the op descs in topological order.
+  std::vector<const OpInfo*> Apply() {
+    std::vector<Place> valid_places{{TARGET(kHost), PRECISION(kFloat)}};
+    program_.reset(new Program(program_desc_, scope_, valid_places));
+    graph_.reset(new SSAGraph);
+    graph_->Build(*program_, valid_places);
+    YoloBoxMulticlassNmsFusePass pass;
+    pass.Apply(graph_);
+    std::vector<const OpInfo*> ops;
+    for (auto& node : graph_->StmtTopologicalOrder()) {
+      ops.push_back(node->stmt()->op_info());
+    }
+    return ops;
+  }
+
+  void CheckFused(const std::vector<const OpInfo*>& ops) {
+    ASSERT_EQ(ops.size(), 1UL);
+    auto* op = ops[0];
+    ASSERT_EQ(op->Type(), "fusion_yolo_box_multiclass_nms");
+    EXPECT_EQ(op->Input("X"), (std::vector<std::string>{"x0", "x1"}));
+    EXPECT_EQ(op->Input("ImgSize").front(), "img_size");
+    EXPECT_EQ(op->Output("Out").front(), "out");
+    EXPECT_EQ(op->Output("Index").front(), "index");
+    EXPECT_EQ(op->GetAttr<std::vector<int>>("anchors"),
+              (std::vector<int>{116, 90, 156, 198, 373, 326, 30, 61, 62, 45}));
+    EXPECT_EQ(op->GetAttr<std::vector<int>>("anchor_nums"),
+              (std::vector<int>{3, 2}));
+    EXPECT_EQ(op->GetAttr<std::vector<int>>("downsample_ratios"),
+              (std::vector<int>{32, 16}));
+    EXPECT_EQ(op->GetAttr<int>("class_num"), 80);
+    EXPECT_FLOAT_EQ(op->GetAttr<float>("conf_thresh"), 0.01f);
+    EXPECT_EQ(op->GetAttr<int>("keep_top_k"), 100);
+    EXPECT_EQ(op->GetAttr<int>("nms_top_k"), 1000);
+    EXPECT_FLOAT_EQ(op->GetAttr<float>("nms_threshold"), 0.45f);
+    EXPECT_FALSE(op->GetAttr<bool>("normalized"));
+    // The compiled mode infers the output shapes on every run.
+    auto* node = graph_->StmtTopologicalOrder().front();
+    EXPECT_TRUE(node->AsStmt().op()->HasDataDependentOutputShape());
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_desc_{nullptr};
+  std::unique_ptr<Program> program_;
+  std::unique_ptr<SSAGraph> graph_;
+};
+
+TEST_F(YoloBoxMulticlassNmsFusePassTest, transpose_then_concat) {
+  AddTwoHeads(true, 0.005f);
+  CheckFused(Apply());
+}
+
+TEST_F(YoloBoxMulticlassNmsFusePassTest, concat_then_transpose) {
+  AddTwoHeads(false, 0.f);
+  CheckFused(Apply());
+}
+
+// The zero scores of the skipped anchors would be kept by a negative
+// score_threshold.
+TEST_F(YoloBoxMulticlassNmsFusePassTest, negative_score_threshold) {
+  AddTwoHeads(true, -1.f);
+  EXPECT_EQ(Apply().size(), 7UL);
+}
+
+// The boxes of a head are also read by another op.
+TEST_F(YoloBoxMulticlassNmsFusePassTest, intermediate_used_outside) {
+  AddTwoHeads(false, 0.f);
+  AddConcat({"boxes1"}, "boxes1_copy", 1);
+  EXPECT_EQ(Apply().size(), 7UL);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(yolo_box);
+USE_LITE_OP(concat);
+USE_LITE_OP(transpose2);
+USE_LITE_OP(multiclass_nms2);
+USE_LITE_OP(fusion_yolo_box_multiclass_nms);
+USE_LITE_KERNEL(fusion_yolo_box_multiclass_nms, kHost, kFloat, kNCHW, def);
@@ -49,6 +49,7 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
                                             "lod_reset",
                                             "concat",
                                             "yolo_box",
+                                            "fusion_kv_cache_attention",
                                             "subgraph",
                                             "feed",
                                             "fetch"};
@@ -99,7 +100,13 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
     std::map<std::string,
              std::pair<std::set<std::string>, std::set<std::string>>>
         inplace_op_nodes = {{"reshape", {{"X"}, {"Out"}}},
-                            {"reshape2", {{"X"}, {"Out"}}}};
+                            {"reshape2", {{"X"}, {"Out"}}},
+                            {"squeeze", {{"X"}, {"Out"}}},
+                            {"squeeze2", {{"X"}, {"Out"}}},
+                            {"unsqueeze", {{"X"}, {"Out"}}},
+                            {"unsqueeze2", {{"X"}, {"Out"}}},
+                            {"flatten", {{"X"}, {"Out"}}},
+                            {"flatten2", {{"X"}, {"Out"}}}};
     auto inplace_op_node = inplace_op_nodes.find(op_type);
     if (inplace_op_node != inplace_op_nodes.end()) {
       bool inplace = false;
@@ -43,14 +43,14 @@ void mir::Node::Stmt::ResetOp(const cpp::OpDesc &op_desc,
                               lite::Scope *scope) {
   CHECK((op_ && op_->scope()) || scope) << "Either scope should be set";
   lite::Scope *the_scope = scope ? scope : op_->scope();
-  op_->Attach(op_desc, the_scope);
-  // Recreate the kernels with the latest OpInfo.
-  valid_kernels_.clear();
-
+  // The op of another type is created before being attached to the desc.
   if (!op_ || op_->op_info()->Type() != op_desc.Type()) {
     op_ = LiteOpRegistry::Global().Create(op_desc.Type());
     CHECK(op_) << "No op found for " << op_desc.Type();
   }
+  op_->Attach(op_desc, the_scope);
+  // Recreate the kernels with the latest OpInfo.
+  valid_kernels_.clear();
   valid_kernels_ = op_->CreateKernels(valid_places);
 }
 void mir::Node::Stmt::ResetKernels(const std::vector<Place> &valid_places) {
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <array>
+#include <list>
 #include <string>
 #include <vector>
 
@@ -106,6 +107,7 @@ void PatternMatcher::operator()(SSAGraph *graph,
 
   if (subgraphs.empty()) return;
   LOG(INFO) << "detected " << subgraphs.size() << " subgraph";
+  graph->AddMatchedSubgraphs(subgraphs.size());
   int id = 0;
   for (auto &g : subgraphs) {
     VLOG(3) << "optimizing #" << id++ << " subgraph";
@@ -115,20 +117,70 @@ void PatternMatcher::operator()(SSAGraph *graph,
 
 bool PatternMatcher::MarkPMNodesInGraph(SSAGraph *graph) {
   VLOG(3) << "mark pmnodes in graph";
+  pmnodes2nodes_.clear();
   if (graph->nodes().empty()) return false;
-  for (auto &node : graph->mutable_nodes()) {
-    for (const auto &pmnode : pattern_.nodes()) {
-      if (pmnode->Tell(&node)) {
-        pmnodes2nodes_[pmnode.get()].insert(&node);
-      }
+  // A PMNode without any matched Node fails the whole pattern, so stop early.
+  auto mark = [&](PMNode *pmnode, const std::set<Node *> &hits) {
+    if (hits.empty()) {
+      VLOG(4) << pmnode->name() << " can't find matched Node, early stop";
+      pmnodes2nodes_.clear();
+      return false;
+    }
+    pmnodes2nodes_[pmnode] = hits;
+    return true;
+  };
+
+  // The op PMNodes with a known type only check the statements of the type.
+  std::list<PMNode *> pending;
+  for (const auto &pmnode : pattern_.nodes()) {
+    auto op_type = pmnode->asserted_op_type();
+    if (op_type.empty()) {
+      pending.push_back(pmnode.get());
+      continue;
     }
+    std::set<Node *> hits;
+    for (auto *node : graph->StmtsOfType(op_type)) {
+      if (pmnode->Tell(node)) hits.insert(node);
+    }
+    if (!mark(pmnode.get(), hits)) return false;
   }
-  // Check to early stop if some PMNode can't find matched Node.
-  for (auto &pmnode : pattern_.nodes()) {
-    if (!pmnodes2nodes_.count(pmnode.get())) {
-      VLOG(4) << pmnode->name() << " can't find matched Node, early stop";
-      // return false;
+
+  // The PMNodes linked to a marked one only check the neighbors of its
+  // candidates, the whole graph is scanned only if no such PMNode is left.
+  while (!pending.empty()) {
+    auto it = pending.begin();
+    const std::set<Node *> *neighbors = nullptr;
+    bool is_outlink = false;
+    for (; it != pending.end(); ++it) {
+      for (const auto &edge : pattern_.edges()) {
+        if (edge.second == *it && pmnodes2nodes_.count(edge.first)) {
+          neighbors = &pmnodes2nodes_[edge.first];
+          is_outlink = true;
+          break;
+        }
+        if (edge.first == *it && pmnodes2nodes_.count(edge.second)) {
+          neighbors = &pmnodes2nodes_[edge.second];
+          break;
+        }
+      }
+      if (neighbors) break;
     }
+    std::set<Node *> hits;
+    if (neighbors) {
+      for (auto *neighbor : *neighbors) {
+        for (auto *node :
+             is_outlink ? neighbor->outlinks : neighbor->inlinks) {
+          if ((*it)->Tell(node)) hits.insert(node);
+        }
+      }
+    } else {
+      it = pending.begin();
+      for (auto &node : graph->mutable_nodes()) {
+        if ((*it)->Tell(&node)) hits.insert(&node);
+      }
+    }
+    if (!mark(*it, hits)) return false;
+    pending.erase(it);
   }
   VLOG(3) << pmnodes2nodes_.size() << " nodes marked";
 
@@ -191,16 +243,6 @@ struct HitGroup {
   std::set<Node *> nodes_;
 };
 
-// Tell whether Node a links to b.
-bool IsNodesLink(Node *a, Node *b) {
-  for (auto *node : a->outlinks) {
-    if (b == node) {
-      return true;
-    }
-  }
-  return false;
-}
-
 std::vector<PatternMatcher::subgraph_t> PatternMatcher::DetectPatterns() {
   // Init empty subgraphs.
   std::vector<PatternMatcher::subgraph_t> result;
@@ -230,20 +272,37 @@ std::vector<PatternMatcher::subgraph_t> PatternMatcher::DetectPatterns() {
     cur_groups.clear();
     if (pre_groups.empty()) break;
     // source -> target
-    for (Node *source : pmnodes2nodes_[edge.first]) {
-      for (Node *target : pmnodes2nodes_[edge.second]) {
-        // TODO(Superjomn) add some prune strategies.
-        for (const auto &group : pre_groups) {
-          if (IsNodesLink(source, target)) {
-            HitGroup new_group = group;
-            bool flag = new_group.Match(source, edge.first) &&
-                        new_group.Match(target, edge.second);
-            if (flag) {
-              new_group.Register(source, edge.first);
-              new_group.Register(target, edge.second);
-              cur_groups.push_back(new_group);
-              // TODO(Superjomn) need to unique
-            }
+    const auto &sources = pmnodes2nodes_[edge.first];
+    const auto &targets = pmnodes2nodes_[edge.second];
+    for (const auto &group : pre_groups) {
+      auto extend = [&](Node *source, Node *target) {
+        HitGroup new_group = group;
+        bool flag = new_group.Match(source, edge.first) &&
+                    new_group.Match(target, edge.second);
+        if (flag) {
+          new_group.Register(source, edge.first);
+          new_group.Register(target, edge.second);
+          cur_groups.push_back(new_group);
+          // TODO(Superjomn) need to unique
+        }
+      };
+      // Only the links of the nodes matched by the group can extend it.
+      auto source_it = group.roles.find(edge.first);
+      auto target_it = group.roles.find(edge.second);
+      if (source_it != group.roles.end()) {
+        Node *source = source_it->second;
+        for (Node *target : source->outlinks) {
+          if (targets.count(target)) extend(source, target);
+        }
+      } else if (target_it != group.roles.end()) {
+        Node *target = target_it->second;
+        for (Node *source : target->inlinks) {
+          if (sources.count(source)) extend(source, target);
+        }
+      } else {
+        for (Node *source : sources) {
+          for (Node *target : source->outlinks) {
+            if (targets.count(target)) extend(source, target);
           }
         }
       }
@@ -371,6 +430,7 @@ PMNode *PMNode::assert_only_one_output() {
 }
 
 PMNode *PMNode::assert_is_op(const std::string &op_type) {
+  asserted_op_type_ = op_type;
   asserts_.emplace_back([op_type](const Node *x) {
     if (x && x->IsStmt()) {
       auto *op_info = x->stmt()->op_info();
@@ -80,6 +80,12 @@ struct PMNode {
   bool IsOp() const { return type_ == Type::kOp; }
   bool IsVar() const { return type_ == Type::kVar; }
 
+  // The op type required by assert_is_op(op_type), the candidates can be found
+  // from the op type index of the graph. It's empty if the type is unknown.
+  std::string asserted_op_type() const {
+    return teller_ ? std::string() : asserted_op_type_;
+  }
+
   const std::string& name() const { return name_; }
 
   PMNode& operator=(const PMNode&) = delete;
@@ -195,6 +201,7 @@ struct PMNode {
   PMPattern* pattern_;
   std::string name_;
   std::string op_type_;
+  std::string asserted_op_type_;
   Type type_;
   Role role_{Role::kUnknown};
 };
@@ -264,9 +271,12 @@ class PMPattern {
  * This helper can be used to support fuse(conv+batchnorm => batchnorm e.g.).
  *
  * The algorithm has three phases:
- *   1. Mark the nodes that match the defined PMNodes in a PMPattern,
+ *   1. Mark the nodes that match the defined PMNodes in a PMPattern, the op
+ *      PMNodes with a known type only check the statements of the type, and
+ *      the PMNodes linked to them only check their neighbors,
  *   2. Extend a PMNode to subgraphs by deducing the connection relation defined
- *      in PAPattern(the edges),
+ *      in PAPattern(the edges), each partial subgraph is only extended along
+ *      the links of the nodes it has matched,
  *   3. Get the filtered subgraphs and treat them with a pre-defined handler.
  *
  * Usage:
@@ -14,6 +14,7 @@
 
 #include "lite/core/mir/ssa_graph.h"
 #include <algorithm>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <set>
@@ -140,16 +141,15 @@ std::vector<mir::Node *> SSAGraph::NodeTopologicalOrder() {
 
 Node *SSAGraph::GraphCreateInstructNode(
     const std::shared_ptr<OpLite> &op, const std::vector<Place> &valid_places) {
-  node_storage_.emplace_back();
+  auto &new_node = *NewNode();
   // TODO(Superjomn) remove one valid_places here.
   op->SetValidPlaces(valid_places);
-  auto &new_node = node_storage_.back();
   auto kernels = op->CreateKernels(valid_places);
-  node_storage_.back().AsStmt(op->op_type_, std::move(kernels), op);
+  new_node.AsStmt(op->op_type_, std::move(kernels), op);
 
   CHECK(new_node.inlinks.empty()) << "duplicate Build found";
   CHECK(new_node.outlinks.empty()) << "duplicate Build found";
-  return &node_storage_.back();
+  return &new_node;
 }
 
 void SSAGraph::Build(const Program &program,
@@ -176,8 +176,7 @@ void SSAGraph::Build(const Program &program,
       if (arg_update_node_map.count(var_name)) {
         arg_node = arg_update_node_map.at(var_name);
       } else {
-        node_storage_.emplace_back();
-        arg_node = &node_storage_.back();
+        arg_node = NewNode();
         arg_node->AsArg(var_name, node_storage_.size() - 1);
         arg_update_node_map[var_name] = arg_node;
       }
@@ -199,8 +198,7 @@ void SSAGraph::Build(const Program &program,
       DirectedLink(arg_node, op_node);
     }
     for (const auto &var_name : op->op_info()->output_names()) {
-      node_storage_.emplace_back();
-      auto *arg_node = &node_storage_.back();
+      auto *arg_node = NewNode();
       arg_node->AsArg(var_name, node_storage_.size() - 1);
       arg_update_node_map[var_name] = arg_node;
       if (var_type_map.count(var_name) && !arg_node->arg()->type) {
@@ -219,11 +217,35 @@ void SSAGraph::Build(const Program &program,
 }
 
 void SSAGraph::RemoveNode(const mir::Node *node) {
-  auto pos = std::find_if(node_storage_.begin(),
-                          node_storage_.end(),
-                          [&node](mir::Node &n) { return &n == node; });
-  CHECK(pos != node_storage_.end());
-  node_storage_.erase(pos);
+  stmts_by_type_dirty_ = true;
+  auto pos = node_positions_.find(node);
+  if (pos != node_positions_.end()) {
+    node_storage_.erase(pos->second);
+    node_positions_.erase(pos);
+    return;
+  }
+  // The node was added by mutable_nodes() directly.
+  auto it = std::find_if(node_storage_.begin(),
+                         node_storage_.end(),
+                         [&node](mir::Node &n) { return &n == node; });
+  CHECK(it != node_storage_.end());
+  node_storage_.erase(it);
+}
+
+const std::vector<mir::Node *> &SSAGraph::StmtsOfType(
+    const std::string &op_type) {
+  if (stmts_by_type_dirty_) {
+    stmts_by_type_.clear();
+    for (auto &node : node_storage_) {
+      if (node.IsStmt() && node.stmt()->op()) {
+        stmts_by_type_[node.stmt()->op_type()].push_back(&node);
+      }
+    }
+    stmts_by_type_dirty_ = false;
+  }
+  static const std::vector<mir::Node *> kEmpty;
+  auto it = stmts_by_type_.find(op_type);
+  return it == stmts_by_type_.end() ? kEmpty : it->second;
 }
 
 mir::Node *SSAGraph::Argument(const std::string &name) {
@@ -285,14 +307,17 @@ bool SSAGraph::CheckLinksRoleSet() {
 }
 
 Node *SSAGraph::NewArgumentNode(const std::string &name) {
-  node_storage_.emplace_back();
-  auto &arg_node = node_storage_.back();
+  auto &arg_node = *NewNode();
   arg_node.AsArg(name, node_storage_.size() - 1);
   return &arg_node;
 }
 
-Node *SSAGraph::NewInstructNode() {
+Node *SSAGraph::NewInstructNode() { return NewNode(); }
+
+Node *SSAGraph::NewNode() {
   node_storage_.emplace_back();
+  node_positions_[&node_storage_.back()] = std::prev(node_storage_.end());
+  stmts_by_type_dirty_ = true;
   return &node_storage_.back();
 }
 
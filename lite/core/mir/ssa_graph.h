@@ -20,6 +20,7 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "lite/core/kernel.h"
 #include "lite/core/mir/node.h"
@@ -55,10 +56,23 @@ class SSAGraph : GraphBase {
   std::vector<mir::Node *> outputs();
 
   const std::list<mir::Node> &nodes() const { return node_storage_; }
-  std::list<mir::Node> &mutable_nodes() { return node_storage_; }
+  std::list<mir::Node> &mutable_nodes() {
+    // The caller may retype or add the statements.
+    stmts_by_type_dirty_ = true;
+    return node_storage_;
+  }
 
   mir::Node *RetrieveArgument(const std::string &arg);
 
+  // The statements of the op type. The index is rebuilt lazily after the
+  // nodes are added or removed, or mutable_nodes() is called.
+  const std::vector<mir::Node *> &StmtsOfType(const std::string &op_type);
+
+  // The number of the subgraphs matched by the pattern matchers, it's used to
+  // report the work of each pass.
+  size_t matched_subgraphs() const { return matched_subgraphs_; }
+  void AddMatchedSubgraphs(size_t count) { matched_subgraphs_ += count; }
+
   Node *NewArgumentNode(const std::string &name);
   Node *NewInstructNode();
 
@@ -77,6 +91,7 @@ class SSAGraph : GraphBase {
 
  private:
   mir::Node *Argument(const std::string &name);
+  mir::Node *NewNode();
   // Check the bidirectional connection.
   bool CheckBidirectionalConnection();
   bool CheckNodesRoleSet();
@@ -102,6 +117,12 @@ class SSAGraph : GraphBase {
 
  private:
   std::list<mir::Node> node_storage_;
+  // The positions in node_storage_, so RemoveNode needn't search the list.
+  std::unordered_map<const mir::Node *, std::list<mir::Node>::iterator>
+      node_positions_;
+  std::map<std::string, std::vector<mir::Node *>> stmts_by_type_;
+  bool stmts_by_type_dirty_{true};
+  size_t matched_subgraphs_{0};
   std::map<std::string, mir::Node *> arguments_;
   std::vector<Place> valid_places_;
 };
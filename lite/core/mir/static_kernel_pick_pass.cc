@@ -32,6 +32,40 @@ bool KernelScoreCmp(const std::pair<float, std::unique_ptr<KernelBase>>& a,
   return a.first > b.first;
 }
 
+// The x86 fp16 kernels take fp32 activations and keep their weights in fp16,
+// they can't be picked when an fp16 input is not a weight, e.g. the second
+// activation of a matmul, which would be cast at every run and might not have
+// the shape of a weight.
+static bool HasHalfActivation(Node* node, const KernelBase& kernel) {
+  if (kernel.target() != TARGET(kX86) ||
+      kernel.precision() != PRECISION(kFP16)) {
+    return false;
+  }
+  auto& instruct = node->AsStmt();
+  for (auto* in : node->inlinks) {
+    std::string arg_name;
+    if (!instruct.op_info()->GetInputArgname(in->AsArg().name, &arg_name)) {
+      continue;
+    }
+    if (kernel.GetInputDeclType(arg_name)->precision() == PRECISION(kFP16) &&
+        !in->AsArg().is_weight) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The weight-only kernels read the weights kept quantized by
+// weight_only_quantization_pass, so they only run the ops marked by it and
+// the other kernels can't run these ops.
+static bool MismatchWeightOnly(Node* node, const KernelBase& kernel) {
+  auto* op_info = node->AsStmt().op_info();
+  bool weight_only =
+      op_info->HasAttr("quantization_type") &&
+      op_info->GetAttr<std::string>("quantization_type") == "weight_only";
+  return weight_only != (kernel.alias() == "weight_only");
+}
+
 void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   kernel_pick_factors_.ConsiderTarget();
   kernel_pick_factors_.ConsiderPrecision();
@@ -75,6 +109,10 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
                                 out_types,
                                 instruct.op_info()->input_names(),
                                 instruct.op_info()->output_names());
+      if (HasHalfActivation(&node, *kernel) ||
+          MismatchWeightOnly(&node, *kernel)) {
+        score = 0;
+      }
       VLOG(4) << "kernel->summary():" << kernel->summary()
               << " score:" << score;
       scored.emplace_back(score, std::move(kernel));
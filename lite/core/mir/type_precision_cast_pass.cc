@@ -21,6 +21,7 @@
 #include "lite/core/mir/graph_visualize_pass.h"
 #include "lite/core/mir/pass_registry.h"
 #include "lite/operators/subgraph_op.h"
+#include "lite/utils/float16.h"
 
 namespace paddle {
 namespace lite {
@@ -101,6 +102,37 @@ static bool InferScale(Node* var_node, Node* op_node, float* scale) {
   return found;
 }
 
+// The fp32 weights only read by an x86 kernel which stores them in fp16 are
+// converted in place instead of being cast at runtime, so the optimized model
+// keeps the fp16 weights and loads half the bytes.
+static bool CastWeightToFP16(Node* var_node,
+                             Node* op_node,
+                             const Type& from,
+                             const Type& to) {
+  auto& arg = var_node->AsArg();
+  if (!arg.is_weight || var_node->outlinks.size() != 1 ||
+      from.precision() != PRECISION(kFloat) ||
+      to.precision() != PRECISION(kFP16) || to.target() != TARGET(kX86)) {
+    return false;
+  }
+  auto* var = op_node->AsStmt().op()->scope()->FindVar(arg.name);
+  if (!var || !var->IsType<Tensor>()) return false;
+  auto* tensor = var->GetMutable<Tensor>();
+  if (!tensor->IsInitialized() || tensor->precision() != PRECISION(kFloat)) {
+    return false;
+  }
+  const float* src = tensor->data<float>();
+  std::vector<float> fp32(src, src + tensor->numel());
+  auto* dst = tensor->mutable_data<float16>();
+  for (size_t i = 0; i < fp32.size(); i++) {
+    dst[i] = float16(fp32[i]);
+  }
+  tensor->set_precision(PRECISION(kFP16));
+  arg.type = LiteType::GetTensorTy(from.target(), to.precision(), from.layout());
+  VLOG(4) << "convert weight " << arg.name << " to fp16";
+  return true;
+}
+
 void PrecisionCastPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   // Start from inputs of the graph, those should have place set.
   std::list<Node*> nodes;
@@ -151,6 +183,9 @@ void PrecisionCastPass::ComplementInputs(
   // if (!in->AsArg().is_weight && !PrecisionCompatibleTo(*in->AsArg().type,
   // *decl_arg_type)) {
   if (!PrecisionCompatibleTo(*in->AsArg().type, *decl_arg_type)) {
+    if (CastWeightToFP16(in, inst_node, *in->AsArg().type, *decl_arg_type)) {
+      return;
+    }
     VLOG(4) << "found Target unmatched tensor: " << in->AsArg().name
             << " for kernel " << inst.op()->DebugString() << " "
             << *in->AsArg().type << " -> " << *decl_arg_type;
@@ -0,0 +1,198 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/weight_only_quantization_pass.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/weight_quantization_preprocess_pass.h"
+#include "lite/utils/env.h"
+#include "lite/utils/weight_quant.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+const char kWeightOnlyAlias[] = "weight_only";
+
+std::string WeightArgname(const std::string& op_type) {
+  if (op_type == "fc") return "W";
+  return op_type == "conv2d" ? "Filter" : "Y";
+}
+
+// Returns whether the op reads a [K, N] weight matrix that is not transposed,
+// or the filter of a conv2d without groups.
+bool IsSupportedOp(const OpInfo& op_info) {
+  const auto& op_type = op_info.Type();
+  if (op_type == "mul") {
+    return op_info.GetAttr<int>("y_num_col_dims") == 1;
+  } else if (op_type == "matmul") {
+    return !op_info.GetAttr<bool>("transpose_Y");
+  } else if (op_type == "conv2d") {
+    return op_info.GetAttr<int>("groups") == 1;
+  }
+  return op_type == "fc";
+}
+
+// Transposes the [N, K] filter of conv2d into the [K, N] weight matrix.
+template <typename T>
+std::vector<T> TransposeFilter(const T* filter, int N, int K) {
+  std::vector<T> w(static_cast<size_t>(K) * N);
+  for (int n = 0; n < N; n++) {
+    for (int k = 0; k < K; k++) {
+      w[static_cast<int64_t>(k) * N + n] =
+          filter[static_cast<int64_t>(n) * K + k];
+    }
+  }
+  return w;
+}
+
+}  // namespace
+
+bool WeightOnlyQuantizationPass::Quantize(Node* node, int bits) {
+  auto& inst = node->AsStmt();
+  auto* op_info = inst.mutable_op_info();
+  auto weight_name = op_info->Input(WeightArgname(op_info->Type())).front();
+  Node* weight_node = nullptr;
+  for (auto* in : node->inlinks) {
+    if (in->AsArg().name == weight_name) weight_node = in;
+  }
+  if (!weight_node || !weight_node->AsArg().is_weight ||
+      weight_node->outlinks.size() != 1) {
+    return false;
+  }
+  auto* scope = inst.op()->scope();
+  auto* weight = scope->FindVar(weight_name)->GetMutable<Tensor>();
+  bool is_conv = op_info->Type() == "conv2d";
+  if (weight->dims().size() != (is_conv ? 4U : 2U)) return false;
+
+  bool padding = op_info->Type() == "fc" &&
+                 op_info->HasAttr("padding_weights") &&
+                 op_info->GetAttr<bool>("padding_weights");
+  // The conv2d filter [N, C, kh, kw] is kept as the [C * kh * kw, N] weights
+  // in the dims [N, rows / (kh * kw), kh, kw], so the op still infers the
+  // output shape from it. The int4 pairs need an even C, the other filters
+  // are quantized to 8 bits.
+  int K = is_conv ? weight->dims().production() / weight->dims()[0]
+                  : weight->dims()[0] - (padding ? 4 : 0);
+  int N = is_conv ? weight->dims()[0] : weight->dims()[1] - (padding ? 4 : 0);
+  if (is_conv && bits == 4 && weight->dims()[1] % 2 != 0) bits = 8;
+  std::string scale_name = weight_name + "_quant_scale";
+  std::vector<float> scale(N);
+  if (IsAbsMaxQuantizedOp(*op_info)) {
+    // Keep the 8-bit weights of the post training weight quantization.
+    if (padding || weight->precision() != PRECISION(kInt8) ||
+        op_info->GetAttr<int>("quantize_weight_bits") != 8 ||
+        !op_info->HasAttr(scale_name) ||
+        op_info->GetAttr<std::vector<float>>(scale_name).size() !=
+            static_cast<size_t>(N)) {
+      return false;
+    }
+    scale = op_info->GetAttr<std::vector<float>>(scale_name);
+    bits = 8;
+    if (is_conv) {
+      auto q = TransposeFilter(weight->data<int8_t>(), N, K);
+      std::copy(q.begin(), q.end(), weight->mutable_data<int8_t>());
+    }
+  } else {
+    if (bits != 8 && bits != 4) return false;
+    if (weight->precision() != PRECISION(kFloat)) return false;
+    std::vector<float> fp32;
+    const float* w = weight->data<float>();
+    if (is_conv) {
+      fp32 = TransposeFilter(w, N, K);
+    } else {
+      // Drop the padding of the fc weights, the quantized GEMM does not use
+      // it.
+      fp32.resize(static_cast<size_t>(K) * N);
+      int ld = weight->dims()[1];
+      for (int k = 0; k < K; k++) {
+        std::copy(w + static_cast<int64_t>(k) * ld,
+                  w + static_cast<int64_t>(k) * ld + N,
+                  fp32.begin() + static_cast<int64_t>(k) * N);
+      }
+    }
+    int64_t rows = QuantWeightRows(K, bits);
+    if (is_conv) {
+      auto dims = weight->dims();
+      int64_t kernel_size = dims[2] * dims[3];
+      weight->Resize({dims[0], rows / kernel_size, dims[2], dims[3]});
+    } else {
+      weight->Resize({rows, N});
+    }
+    QuantizeWeight(
+        fp32.data(), K, N, bits, weight->mutable_data<int8_t>(), scale.data());
+    weight->set_precision(PRECISION(kInt8));
+    weight->set_persistable(true);
+    if (padding) op_info->SetAttr<bool>("padding_weights", false);
+  }
+  op_info->SetAttr<std::string>("quantization_type", "weight_only");
+  op_info->SetAttr<int>("quantize_weight_bits", bits);
+  op_info->SetAttr<std::vector<float>>(scale_name, scale);
+
+  // Attach the op again to read the new attributes, then pick the kernel.
+  cpp::OpDesc op_desc = *op_info;
+  inst.op()->Attach(op_desc, scope);
+  auto target = inst.picked_kernel().target();
+  auto kernels = inst.op()->CreateKernels(
+      {Place{target, PRECISION(kInt8), DATALAYOUT(kNCHW)}});
+  auto it = std::find_if(
+      kernels.begin(), kernels.end(), [](std::unique_ptr<KernelBase>& k) {
+        return k->alias() == kWeightOnlyAlias;
+      });
+  CHECK(it != kernels.end()) << "No weight-only kernel for "
+                             << op_desc.Type();
+  inst.kernels().clear();
+  inst.kernels().emplace_back(std::move(*it));
+  weight_node->AsArg().type = LiteType::GetTensorTy(
+      weight_node->AsArg().type ? weight_node->AsArg().type->target()
+                                : TARGET(kHost),
+      PRECISION(kInt8));
+  VLOG(3) << "weight-only quantize " << weight_name << " of "
+          << op_desc.Type() << " to " << bits << " bits";
+  return true;
+}
+
+void WeightOnlyQuantizationPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  int bits = GetIntFromEnv(WEIGHT_ONLY_QUANT_BITS, 0);
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto& inst = node->AsStmt();
+    const auto& op_type = inst.op_type();
+    if (op_type != "fc" && op_type != "mul" && op_type != "matmul" &&
+        op_type != "conv2d") {
+      continue;
+    }
+    const auto& kernel = inst.picked_kernel();
+    if ((kernel.target() != TARGET(kX86) &&
+         kernel.target() != TARGET(kARM)) ||
+        kernel.precision() != PRECISION(kFloat) ||
+        !IsSupportedOp(*inst.op_info())) {
+      continue;
+    }
+    if (bits == 0 && !IsAbsMaxQuantizedOp(*inst.op_info())) continue;
+    Quantize(node, bits);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(weight_only_quantization_pass,
+                  paddle::lite::mir::WeightOnlyQuantizationPass)
+    .BindTargets({TARGET(kX86), TARGET(kARM)});
@@ -0,0 +1,47 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * WeightOnlyQuantizationPass keeps the weights of the x86 and ARM fc, mul,
+ * matmul and conv2d (without groups) kernels quantized, and picks their
+ * `weight_only` kernels which dequantize the weights panel by panel inside
+ * the GEMM while the activations stay fp32.
+ * - The 8-bit weights of the models quantized by post_weight_abs_max are kept
+ *   as they are, instead of being dequantized to fp32 when they are loaded.
+ * - With the environment variable WEIGHT_ONLY_QUANT_BITS set to 8 or 4, the
+ *   fp32 weights are quantized with the abs max of each output channel.
+ * The ops are marked with quantization_type `weight_only`, so the light
+ * predictor loads their weights as they are.
+ */
+class WeightOnlyQuantizationPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool Quantize(Node* node, int bits);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,173 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/weight_only_quantization_pass.h"
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/mir/static_kernel_pick_pass.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/utils/env.h"
+#include "lite/utils/weight_quant.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+class WeightOnlyQuantizationPassTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    program_desc_ = std::make_shared<cpp::ProgramDesc>();
+    scope_ = std::make_shared<Scope>();
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->SetIdx(0);
+    block_desc_->SetParentIdx(-1);
+  }
+
+  void TearDown() override { unsetenv(WEIGHT_ONLY_QUANT_BITS); }
+
+  void AddVar(const std::string& name, bool persistable = false) {
+    auto* var = block_desc_->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetDataType(cpp::VarDesc::Type::FP32);
+    var->SetPersistable(persistable);
+  }
+
+  // Adds the conv2d of the [out_channels, channels, 3, 3] filter `w`.
+  void AddConv(const std::string& x,
+               const std::string& w,
+               int out_channels,
+               int channels,
+               const std::string& out) {
+    AddVar(w, true);
+    auto* filter = scope_->Var(w)->GetMutable<Tensor>();
+    filter->Resize({out_channels, channels, 3, 3});
+    auto* data = filter->mutable_data<float>();
+    for (int64_t i = 0; i < filter->numel(); i++) {
+      data[i] = static_cast<float>(i % 13) * 0.1f - 0.6f;
+    }
+    filter->set_persistable(true);
+    filters_.emplace_back(data, data + filter->numel());
+
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType("conv2d");
+    op->SetInput("Input", {x});
+    op->SetInput("Filter", {w});
+    op->SetOutput("Output", {out});
+    op->SetAttr("strides", std::vector<int>{1, 1});
+    op->SetAttr("paddings", std::vector<int>{1, 1});
+    op->SetAttr("dilations", std::vector<int>{1, 1});
+    op->SetAttr("groups", 1);
+    AddVar(out);
+  }
+
+  // Picks the kernels with the int8 places valid, then quantizes the weights.
+  void Apply(int bits) {
+    std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kInt8)},
+                                    {TARGET(kX86), PRECISION(kFloat)},
+                                    {TARGET(kHost), PRECISION(kFloat)}};
+    program_.reset(new Program(program_desc_, scope_, valid_places));
+    graph_.reset(new SSAGraph);
+    graph_->Build(*program_, valid_places);
+    graph_->SetValidPlaces(valid_places);
+    StaticKernelPickPass pick_pass;
+    pick_pass.Apply(graph_);
+    for (auto* node : graph_->StmtTopologicalOrder()) {
+      EXPECT_NE(node->AsStmt().picked_kernel().alias(), "weight_only");
+    }
+    setenv(WEIGHT_ONLY_QUANT_BITS, std::to_string(bits).c_str(), 1);
+    WeightOnlyQuantizationPass pass;
+    pass.Apply(graph_);
+  }
+
+  Node* Stmt(int i) { return graph_->StmtTopologicalOrder()[i]; }
+
+  // Checks the i-th conv2d picks the weight-only kernel and keeps its filter
+  // as the [C * 3 * 3, out_channels] weights quantized to `bits`.
+  void CheckConv(int i, const std::string& w, int bits) {
+    auto& inst = Stmt(i)->AsStmt();
+    EXPECT_EQ(inst.picked_kernel().alias(), "weight_only");
+    EXPECT_EQ(inst.picked_kernel().precision(), PRECISION(kInt8));
+    auto* op_info = inst.op_info();
+    EXPECT_EQ(op_info->GetAttr<std::string>("quantization_type"),
+              "weight_only");
+    EXPECT_EQ(op_info->GetAttr<int>("quantize_weight_bits"), bits);
+    auto scale = op_info->GetAttr<std::vector<float>>(w + "_quant_scale");
+
+    auto& filter = scope_->FindVar(w)->Get<Tensor>();
+    EXPECT_EQ(filter.precision(), PRECISION(kInt8));
+    int N = filter.dims()[0];
+    int K = filters_[i].size() / N;
+    ASSERT_EQ(scale.size(), static_cast<size_t>(N));
+    ASSERT_EQ(filter.numel(), QuantWeightRows(K, bits) * N);
+    EXPECT_EQ(filter.dims()[2], 3);
+    EXPECT_EQ(filter.dims()[3], 3);
+    std::vector<float> dequantized(filters_[i].size());
+    DequantizeWeight(filter.data<int8_t>(),
+                     scale.data(),
+                     0,
+                     K,
+                     N,
+                     bits,
+                     dequantized.data());
+    for (int n = 0; n < N; n++) {
+      for (int k = 0; k < K; k++) {
+        EXPECT_NEAR(dequantized[k * N + n], filters_[i][n * K + k], scale[n]);
+      }
+    }
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_desc_{nullptr};
+  std::unique_ptr<Program> program_;
+  std::unique_ptr<SSAGraph> graph_;
+  std::vector<std::vector<float>> filters_;
+};
+
+TEST_F(WeightOnlyQuantizationPassTest, conv2d) {
+  AddVar("x");
+  AddConv("x", "w0", 6, 4, "y");
+  AddConv("y", "w1", 5, 6, "out");
+  Apply(8);
+  CheckConv(0, "w0", 8);
+  CheckConv(1, "w1", 8);
+}
+
+// The int4 rows of a filter with odd channels don't fit its 4-D dims, so it
+// is quantized to 8 bits.
+TEST_F(WeightOnlyQuantizationPassTest, conv2d_int4) {
+  AddVar("x");
+  AddConv("x", "w0", 3, 4, "y");
+  AddConv("y", "w1", 5, 3, "out");
+  Apply(4);
+  CheckConv(0, "w0", 4);
+  EXPECT_EQ(scope_->FindVar("w0")->Get<Tensor>().dims(),
+            DDim(std::vector<int64_t>({3, 2, 3, 3})));
+  CheckConv(1, "w1", 8);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(conv2d);
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, weight_only);
@@ -21,6 +21,11 @@
 namespace paddle {
 namespace lite {
 namespace mir {
+
+// Returns whether the op is quantized by the abs_max method in
+// WeightQuantization.
+bool IsAbsMaxQuantizedOp(const OpInfo& op_info);
+
 /*
  * If the model is quantized by WeightQuantization in PostTrainingQuantization,
  * the data type of the weight in quantized ops (conv2d, depthwise_conv2d) is
@@ -72,6 +72,10 @@ class OpLite : public Registry {
   virtual bool Run();
   // Indicate whether the Op runs only once or not
   virtual bool run_once() const { return false; }
+  // Indicate whether the output shapes depend on the values of the inputs,
+  // such as the number of the boxes kept by a NMS. The compiled mode infers
+  // the shapes of these ops on every run.
+  virtual bool HasDataDependentOutputShape() const { return false; }
   std::string Type() { return op_type_; }
 #ifdef LITE_WITH_PROFILE
   virtual void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {}
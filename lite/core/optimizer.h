@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <map>
 #include <memory>
 #include <set>
@@ -93,14 +95,18 @@ class Optimizer {
            "lite_var_conv_2d_activation_fuse_pass",       //
            "lite_match_matrix_activation_fuse_pass",      //
            "lite_fc_fuse_pass",                           //
+           "lite_channel_affine_fuse_pass",               //
            "lite_shuffle_channel_fuse_pass",              //
            "lite_transpose_softmax_transpose_fuse_pass",  //
+           "lite_yolo_box_multiclass_nms_fuse_pass",      //
+           "transpose_reshape_propagate_pass",            //
            "lite_interpolate_fuse_pass",                  //
            "identity_scale_eliminate_pass",               //
            "lite_scales_fuse_pass",                       //
            "lite_sequence_reverse_embedding_fuse_pass",   //
            "elementwise_mul_constant_eliminate_pass",     //
            "lite_sequence_pool_concat_fuse_pass",         //
+           "lite_elementwise_chain_fuse_pass",            //
            "lite_scale_activation_fuse_pass",             //
 #if (defined LITE_WITH_LIGHT_WEIGHT_FRAMEWORK) || (defined LITE_WITH_CUDA) || \
     (defined LITE_WITH_ARM)
@@ -128,6 +134,7 @@ class Optimizer {
            "mlu_subgraph_pass",
            "control_flow_op_unused_inputs_and_outputs_eliminate_pass",
            "static_kernel_pick_pass",  // pick original kernel from graph
+           "weight_only_quantization_pass",
 
            "remove_tf_redundant_ops_pass",
            "variable_place_inference_pass",  // inference arg/var's
@@ -165,6 +172,8 @@ class Optimizer {
            "runtime_context_assign_pass",
            "argument_type_display_pass",
 
+           "constant_folding_pass",  // precompute the ops on the weights
+
            "memory_optimize_pass"}};
 
       if (passes.size() == 1) {
@@ -245,8 +254,13 @@ class Optimizer {
  protected:
   void SpecifyKernelPickTactic(core::KernelPickFactor factor);
 
+  // The wall time(ms) and the number of the matched subgraphs of a pass.
+  using pass_cost_t = std::pair<double, size_t>;
+
   // Specify the passes and run them.
   void RunPasses(const std::vector<std::string>& passes) {
+    // The costs of a pass which runs several times are summed up.
+    std::map<std::string, pass_cost_t> pass_costs;
     for (auto& x : passes) {
       LOG(INFO) << "== Running pass: " << x;
       mir::Pass* pass = mir::PassManager::Global().LookUp(x);
@@ -264,6 +278,8 @@ class Optimizer {
         LOG(INFO) << "   - Skip " << x
                   << " because the target or kernel does not match.";
       } else {
+        size_t subgraphs = MatchedSubgraphs();
+        auto start = std::chrono::steady_clock::now();
         // Check the pass whether it is supported for processing subblocks
         if (kSubblockUnsupportedPasses.count(x)) {
           pass->Apply(graphs_[kRootBlockIdx]);
@@ -272,9 +288,47 @@ class Optimizer {
             pass->Apply(graph);
           }
         }
-        LOG(INFO) << "== Finished running: " << x;
+        double elapse_ms = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+        subgraphs = MatchedSubgraphs() - subgraphs;
+        pass_costs[x].first += elapse_ms;
+        pass_costs[x].second += subgraphs;
+        LOG(INFO) << "== Finished running: " << x << ", " << elapse_ms
+                  << " ms, " << subgraphs << " subgraphs matched";
       }
     }
+    ReportPassCosts(pass_costs);
+  }
+
+  size_t MatchedSubgraphs() const {
+    size_t matched = 0;
+    for (auto& graph : graphs_) {
+      matched += graph->matched_subgraphs();
+    }
+    return matched;
+  }
+
+  // Print the passes from the most expensive one.
+  void ReportPassCosts(const std::map<std::string, pass_cost_t>& pass_costs) {
+    std::vector<std::pair<std::string, pass_cost_t>> costs(pass_costs.begin(),
+                                                           pass_costs.end());
+    std::stable_sort(
+        costs.begin(),
+        costs.end(),
+        [](const std::pair<std::string, pass_cost_t>& a,
+           const std::pair<std::string, pass_cost_t>& b) {
+          return a.second.first > b.second.first;
+        });
+    double total_ms = 0;
+    for (auto& cost : costs) {
+      total_ms += cost.second.first;
+    }
+    LOG(INFO) << "== Pass costs, " << total_ms << " ms in total:";
+    for (auto& cost : costs) {
+      LOG(INFO) << "   " << cost.first << ": " << cost.second.first << " ms, "
+                << cost.second.second << " subgraphs matched";
+    }
   }
 
  private:
@@ -0,0 +1,110 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/param_store.h"
+#include <cstring>
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+const uint64_t kHashMul = 0x9ddfea08eb382d69ULL;
+// The expired entries are removed after adding this many buffers.
+const size_t kCleanupInterval = 256;
+
+inline uint64_t HashMix(uint64_t h, uint64_t v) {
+  h = (h ^ v) * kHashMul;
+  return h ^ (h >> 47);
+}
+
+}  // namespace
+
+ParamStore& ParamStore::Global() {
+  static ParamStore store;
+  return store;
+}
+
+// Four independent lanes over 32-byte blocks, so the hash isn't bound by the
+// latency of the multiplications.
+uint64_t ParamStore::Hash(const void* data, size_t size) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  uint64_t lanes[4] = {size, size ^ kHashMul, size + kHashMul, ~size};
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    uint64_t v[4];
+    memcpy(v, bytes + i, sizeof(v));
+    for (int l = 0; l < 4; l++) {
+      lanes[l] = HashMix(lanes[l], v[l]);
+    }
+  }
+  for (; i + 8 <= size; i += 8) {
+    uint64_t v;
+    memcpy(&v, bytes + i, sizeof(v));
+    lanes[0] = HashMix(lanes[0], v);
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, bytes + i, size - i);
+  uint64_t h = HashMix(lanes[0], tail);
+  for (int l = 1; l < 4; l++) {
+    h = HashMix(h, lanes[l]);
+  }
+  return h;
+}
+
+bool ParamStore::Share(Tensor* tensor) {
+  CHECK(tensor);
+  size_t size = tensor->memory_size();
+  if (size == 0 || tensor->offset() != 0 ||
+      tensor->target() != TARGET(kHost)) {
+    return false;
+  }
+  const void* data = tensor->raw_data();
+  uint64_t key = Hash(data, size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = entries_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto buffer = it->second.buffer.lock();
+    if (!buffer || it->second.size != size) continue;
+    // The bytes are compared, a hash collision never shares the buffer.
+    if (buffer->data() == data || memcmp(buffer->data(), data, size) == 0) {
+      tensor->ResetBuffer(buffer, size);
+      return true;
+    }
+  }
+  if (++num_added_ % kCleanupInterval == 0) {
+    RemoveExpired();
+  }
+  entries_.emplace(key, Entry{tensor->buffer(), size});
+  return false;
+}
+
+size_t ParamStore::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RemoveExpired();
+  return entries_.size();
+}
+
+void ParamStore::RemoveExpired() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.buffer.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,65 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include "lite/core/memory.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * ParamStore deduplicates the weights of the models loaded in one process,
+ * eg. the variants of a model for A/B tests which share most of the params.
+ * The buffers of the loaded params are keyed by a hash of their bytes, a
+ * param identical to one loaded before shares its buffer instead of keeping
+ * a copy, so the memory only grows with the params which differ.
+ * The store holds the buffers weakly: a buffer is released with the last
+ * tensor referring to it. The kernels must not write to the shared params.
+ */
+class ParamStore {
+ public:
+  static ParamStore& Global();
+
+  // Make `tensor` share the buffer of an identical param in the store, or
+  // add its buffer to the store. Returns true if the buffer is shared.
+  bool Share(Tensor* tensor);
+
+  // The number of the buffers alive in the store.
+  size_t size();
+
+  static uint64_t Hash(const void* data, size_t size);
+
+ private:
+  ParamStore() = default;
+
+  void RemoveExpired();
+
+  struct Entry {
+    std::weak_ptr<Buffer> buffer;
+    size_t size;
+  };
+
+  std::mutex mutex_;
+  std::multimap<uint64_t, Entry> entries_;
+  size_t num_added_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,76 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/param_store.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+std::unique_ptr<Tensor> NewParam(float value, int size) {
+  std::unique_ptr<Tensor> tensor(new Tensor);
+  tensor->Resize({size});
+  auto* data = tensor->mutable_data<float>();
+  for (int i = 0; i < size; i++) {
+    data[i] = value + i;
+  }
+  tensor->set_persistable(true);
+  return tensor;
+}
+
+TEST(ParamStore, share) {
+  auto& store = ParamStore::Global();
+  size_t base = store.size();
+  auto a = NewParam(1.f, 100);
+  auto b = NewParam(1.f, 100);
+  auto c = NewParam(2.f, 100);
+  auto d = NewParam(1.f, 99);
+  EXPECT_FALSE(store.Share(a.get()));
+  EXPECT_TRUE(store.Share(b.get()));
+  EXPECT_FALSE(store.Share(c.get()));
+  EXPECT_FALSE(store.Share(d.get()));
+  EXPECT_EQ(a->data<float>(), b->data<float>());
+  EXPECT_NE(a->data<float>(), c->data<float>());
+  EXPECT_EQ(b->data<float>()[99], 100.f);
+  EXPECT_EQ(store.size(), base + 3);
+
+  // The shared buffer lives until the last tensor referring to it is gone.
+  a.reset();
+  EXPECT_EQ(b->data<float>()[0], 1.f);
+  EXPECT_EQ(store.size(), base + 3);
+  b.reset();
+  EXPECT_EQ(store.size(), base + 2);
+  auto e = NewParam(1.f, 100);
+  EXPECT_FALSE(store.Share(e.get()));
+}
+
+TEST(ParamStore, hash) {
+  std::vector<uint8_t> bytes(77);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  uint64_t h = ParamStore::Hash(bytes.data(), bytes.size());
+  EXPECT_EQ(h, ParamStore::Hash(bytes.data(), bytes.size()));
+  EXPECT_NE(h, ParamStore::Hash(bytes.data(), bytes.size() - 1));
+  for (size_t i = 0; i < bytes.size(); i += 7) {
+    bytes[i] ^= 1;
+    EXPECT_NE(h, ParamStore::Hash(bytes.data(), bytes.size()));
+    bytes[i] ^= 1;
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
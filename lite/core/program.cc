@@ -16,6 +16,8 @@
 #include <algorithm>
 #include <map>
 #include <set>
+#include "lite/core/device_info.h"
+#include "lite/core/tuning_cache.h"
 #include "lite/model_parser/cpp_desc.h"
 #include "lite/operators/conditional_block_op.h"
 #include "lite/operators/subgraph_op.h"
@@ -23,10 +25,63 @@
 #ifdef LITE_WITH_PRECISION_PROFILE
 #include "lite/core/profile/precision_profiler.h"
 #endif
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/thread_pool.h"
+#endif
 
 namespace paddle {
 namespace lite {
 
+void RuntimeProgram::AttachPrepackedWeights(
+    std::set<std::string>* prepacked_only) {
+  // The number of the ops reading each var, and the packed weights of each
+  // original weight with whether the kernels run on them only.
+  std::map<std::string, int> num_readers;
+  std::map<std::string, std::vector<std::pair<std::string, bool>>> packings;
+  for (auto& insts : instructions_) {
+    for (auto& inst : insts) {
+      for (auto& name : inst.op()->op_info()->input_names()) {
+        num_readers[name]++;
+      }
+    }
+  }
+  for (auto& insts : instructions_) {
+    for (auto& inst : insts) {
+      std::string arg;
+      std::string tag;
+      const Tensor* packed = nullptr;
+      if (!inst.kernel()->GetPrepackedWeights(&arg, &packed, &tag)) continue;
+      auto* op = const_cast<OpLite*>(inst.op());
+      auto* op_info = op->mutable_op_info();
+      // The weights shared by the ops may be packed in different layouts.
+      auto weight_name = op_info->Input(arg).front();
+      auto packed_name = weight_name + "_prepacked_" + tag;
+      packings[weight_name].emplace_back(
+          packed_name, inst.kernel()->PrepackedWeightsOnly());
+      // Like the other weights, they live in the root scope shared by the
+      // clones.
+      auto* tensor =
+          op->scope()->Root()->Var(packed_name)->GetMutable<Tensor>();
+      if (tensor != packed) {
+        tensor->ShareDataWith(*packed);
+      }
+      tensor->set_persistable(true);
+      op_info->SetInput("Prepacked" + arg, {packed_name});
+      op_info->SetAttr<std::string>("prepacked_tag", tag);
+      VLOG(4) << "Attach the prepacked weights " << packed_name << " to "
+              << op_info->Type();
+    }
+  }
+  for (auto& packing : packings) {
+    auto& uses = packing.second;
+    bool only = static_cast<int>(uses.size()) == num_readers[packing.first];
+    for (auto& use : uses) {
+      only = only && use.second && use.first == uses.front().first;
+    }
+    if (only) prepacked_only->insert(uses.front().first);
+  }
+}
+
 void RuntimeProgram::SaveToProgram(
     std::shared_ptr<cpp::ProgramDesc> program_desc) {
   CHECK(program_desc);
@@ -74,6 +129,15 @@ void RuntimeProgram::SaveToProgram(
         if (it != origin_var_maps.end()) {
           v->SetType(it->second.GetType());
           v->SetPersistable(it->second.Persistable());
+          // The outputs of the ops folded at optimize time become weights.
+          if (!it->second.Persistable() &&
+              it->second.GetType() == cpp::VarDesc::Type::LOD_TENSOR) {
+            auto* var = scope->FindVar(var_name);
+            if (var && var->IsType<Tensor>() &&
+                var->Get<Tensor>().persistable()) {
+              v->SetPersistable(true);
+            }
+          }
           if (var_name != "feed" && var_name != "fetch") {
             v->SetShape(it->second.GetShape());
             v->SetDataType(it->second.GetDataType());
@@ -256,7 +320,90 @@ RuntimeProgram::RuntimeProgram(
   Init();
 }
 
+bool CPUOnlyInstructions(const std::vector<Instruction>& insts) {
+  for (auto& inst : insts) {
+    if (inst.is_feed_fetch_op()) continue;
+    if (!inst.kernel()) return false;
+    auto target = inst.kernel()->target();
+    if (target != TARGET(kHost) && target != TARGET(kX86) &&
+        target != TARGET(kARM) && target != TARGET(kAny)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RuntimeProgram::EnableCompiledMode(bool enable, bool capture) {
+  compiled_program_.reset();
+  // The sub-blocks of the control flow ops follow the main block, their
+  // kernels enable the compiled mode of their programs on the next run.
+  for (auto& inst : instructions_[kRootBlockIdx]) {
+    auto* kernel = inst.mutable_kernel();
+    if (!kernel || kernel->target() != TARGET(kHost)) continue;
+    auto op_type = inst.op()->op_info()->Type();
+    if (op_type == "while") {
+      kernel->Param<operators::WhileParam>().compiled_execution = enable;
+    } else if (op_type == "conditional_block") {
+      kernel->Param<operators::ConditionalBlockParam>().compiled_execution =
+          enable;
+    }
+  }
+  if (!enable) return;
+#if defined(LITE_WITH_PROFILE) || defined(LITE_WITH_PRECISION_PROFILE) || \
+    defined(LITE_WITH_NVTX) || defined(LITE_WITH_FPGA)
+  LOG(WARNING) << "The compiled mode is disabled in the profile, nvtx and "
+                  "fpga builds";
+#else
+  auto& insts = instructions_[kRootBlockIdx];
+  if (!CompiledProgram::IsSupported(insts)) {
+    LOG(WARNING) << "The compiled mode only supports the CPU kernels";
+    return;
+  }
+  compiled_program_.reset(new CompiledProgram(&insts, capture));
+#endif
+}
+
+void RuntimeProgram::EnableInterOpParallel(int threads,
+                                           int intra_op_threads,
+                                           lite_api::PowerMode mode) {
+  inter_op_executor_.reset();
+  if (threads < 2) return;
+  intra_op_threads = std::max(intra_op_threads, 1);
+  bool kernel_tuning = kernel_tuning_;
+  auto worker_init = [=]() {
+    TuningCache::SetThreadLocalTuning(kernel_tuning);
+#ifdef LITE_WITH_ARM
+    DeviceInfo::Global().SetRunMode(mode, intra_op_threads);
+#endif
+#ifdef LITE_WITH_X86
+    x86::ThreadPool::SetThreadLocalMaxThreads(intra_op_threads);
+#endif
+  };
+#if defined(LITE_WITH_PROFILE) || defined(LITE_WITH_PRECISION_PROFILE) || \
+    defined(LITE_WITH_NVTX) || defined(LITE_WITH_FPGA)
+  LOG(WARNING) << "Inter-op parallelism is disabled in the profile, nvtx and "
+                  "fpga builds, the instructions run serially";
+#else
+  auto& insts = instructions_[kRootBlockIdx];
+  if (!InterOpExecutor::IsSupported(insts)) {
+    LOG(WARNING) << "Inter-op parallelism only supports the CPU kernels, the "
+                    "instructions run serially";
+    return;
+  }
+  inter_op_executor_.reset(new InterOpExecutor(&insts, threads, worker_init));
+#endif
+}
+
 void RuntimeProgram::Run() {
+  ScopedTuning tuning(kernel_tuning_);
+  if (inter_op_executor_) {
+    inter_op_executor_->Run();
+    return;
+  }
+  if (compiled_program_) {
+    compiled_program_->Run();
+    return;
+  }
 #ifdef LITE_WITH_PRECISION_PROFILE
   auto inst_precision_profiler = paddle::lite::profile::PrecisionProfiler();
   std::string precision_profiler_summary =
@@ -16,9 +16,12 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/core/compiled_program.h"
+#include "lite/core/inter_op_executor.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
@@ -173,6 +176,9 @@ struct Instruction {
 #endif  // LITE_WITH_PROFILE
 };
 
+// Whether all the kernels, except the feed and fetch ones, run on the CPU.
+bool CPUOnlyInstructions(const std::vector<Instruction>& insts);
+
 /*
  * A program contains kernels for runtime.
  */
@@ -213,6 +219,31 @@ class LITE_API RuntimeProgram {
 
   void Run();
 
+  // Run the independent instructions of the main block concurrently on
+  // `threads` threads, the kernels launched by each of them use at most
+  // `intra_op_threads` threads. A thread number less than 2 restores the
+  // serial execution.
+  void EnableInterOpParallel(
+      int threads,
+      int intra_op_threads = 1,
+      lite_api::PowerMode mode = lite_api::LITE_POWER_NO_BIND);
+
+  // Tune the kernels prepared by the runs of this program, see TuningCache.
+  // It's called before EnableInterOpParallel, whose threads take it when
+  // they start.
+  void EnableKernelTuning(bool enable) { kernel_tuning_ = enable; }
+
+  // Run the main block in the compiled mode, see CompiledProgram. With
+  // `capture`, the runs with the same feed shapes replay the first one. It
+  // has no effect when the inter-op parallelism is enabled.
+  void EnableCompiledMode(bool enable, bool capture = false);
+
+  // The compiled program of the main block, or nullptr if the compiled mode
+  // is disabled.
+  const CompiledProgram* compiled_program() const {
+    return compiled_program_.get();
+  }
+
   void set_exec_scope(Scope* x) { exec_scope_ = x; }
   Scope* exec_scope() { return exec_scope_; }
 
@@ -232,10 +263,20 @@ class LITE_API RuntimeProgram {
   // according to the instructions
   void SaveToProgram(std::shared_ptr<cpp::ProgramDesc> program_desc);
 
+  // Add the weights packed by the kernels to the scope as the persistable
+  // vars, and link them to the ops with the input 'Prepacked' + the weight
+  // input name and the attr 'prepacked_tag', it's called before SaveToProgram.
+  // The names of the packed weights which replace the original weights for
+  // every op reading them are added to `prepacked_only`.
+  void AttachPrepackedWeights(std::set<std::string>* prepacked_only);
+
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
   std::vector<std::vector<Instruction>> instructions_;
   Scope* exec_scope_{};
+  std::unique_ptr<InterOpExecutor> inter_op_executor_;
+  std::unique_ptr<CompiledProgram> compiled_program_;
+  bool kernel_tuning_{false};
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler profiler_;
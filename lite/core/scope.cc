@@ -37,6 +37,12 @@ Scope &Scope::NewScope() const {
   return *kids_.back();
 }
 
+Scope *Scope::Root() {
+  const Scope *scope = this;
+  while (scope->parent_) scope = scope->parent_;
+  return const_cast<Scope *>(scope);
+}
+
 Variable *Scope::Var(const std::string &name) {
   SCOPE_VARS_WRITER_LOCK
   auto *var = FindVar(name);
@@ -52,6 +52,10 @@ class Scope final {
 
   const Scope* parent() const { return parent_; }
 
+  // The root of the scopes, which holds the persistable variables shared by
+  // the predictor and its clones.
+  Scope* Root();
+
   // Get attribute params stored in parent scopes.
   std::vector<std::string> AttributeVarNames() const;
   // Following the legacy scope interface.
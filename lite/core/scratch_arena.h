@@ -0,0 +1,182 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * A bump allocator for the short-lived host buffers of a kernel run, such as
+ * the index vectors and the absolute offsets of a LoD. The memory is taken
+ * from a stack of blocks and given back all at once by ScratchScope. When a
+ * run is over and the memory is all given back, the blocks are merged into
+ * one block of the peak size, so the following runs of the same model take
+ * their buffers without any heap allocation.
+ *
+ * The arena is not thread safe, a predictor runs its kernels on the calling
+ * thread, so each thread has its own arena(ThreadLocal). The buffers must not
+ * be allocated by the workers of a parallel for.
+ */
+class ScratchArena {
+ public:
+  struct Mark {
+    size_t blocks;
+    size_t used;
+    size_t in_use;
+  };
+
+  static ScratchArena& ThreadLocal() {
+    static thread_local ScratchArena arena;
+    return arena;
+  }
+
+  void* Allocate(size_t bytes) {
+    bytes = (bytes + kAlignment - 1) & ~(kAlignment - 1);
+    if (blocks_.empty() || used_ + bytes > blocks_.back().size) {
+      NewBlock(std::max(bytes, NextBlockSize()));
+    }
+    void* ptr = blocks_.back().data.get() + used_;
+    used_ += bytes;
+    in_use_ += bytes;
+    peak_ = std::max(peak_, in_use_);
+    return ptr;
+  }
+
+  Mark GetMark() const { return Mark{blocks_.size(), used_, in_use_}; }
+
+  // Gives back the memory allocated after the mark.
+  void Release(const Mark& mark) {
+    if (mark.in_use == 0) {
+      Reset();
+      return;
+    }
+    blocks_.resize(mark.blocks);
+    used_ = mark.used;
+    in_use_ = mark.in_use;
+  }
+
+  // The number of the blocks allocated from the heap so far.
+  int64_t num_block_allocations() const { return num_block_allocations_; }
+  size_t peak_bytes() const { return peak_; }
+
+ private:
+  static const size_t kAlignment = 16;
+  static const size_t kMinBlockSize = 4096;
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  size_t NextBlockSize() const {
+    return blocks_.empty() ? kMinBlockSize : blocks_.back().size * 2;
+  }
+
+  void NewBlock(size_t size) {
+    Block block;
+    // new[] of char is aligned for any fundamental type.
+    block.data.reset(new char[size]);
+    block.size = size;
+    blocks_.push_back(std::move(block));
+    used_ = 0;
+    num_block_allocations_++;
+  }
+
+  // Keeps a single block which holds the peak of the previous runs.
+  void Reset() {
+    if (blocks_.size() > 1 || (!blocks_.empty() && blocks_[0].size < peak_)) {
+      blocks_.clear();
+      NewBlock(peak_);
+    }
+    used_ = 0;
+    in_use_ = 0;
+  }
+
+  std::vector<Block> blocks_;
+  size_t used_{0};
+  size_t in_use_{0};
+  size_t peak_{0};
+  int64_t num_block_allocations_{0};
+};
+
+// Gives back the memory allocated from the arena in the scope.
+class ScratchScope {
+ public:
+  explicit ScratchScope(ScratchArena* arena)
+      : arena_(arena), mark_(arena->GetMark()) {}
+  ~ScratchScope() { arena_->Release(mark_); }
+
+  ScratchArena* arena() const { return arena_; }
+
+ private:
+  ScratchScope(const ScratchScope&) = delete;
+  ScratchScope& operator=(const ScratchScope&) = delete;
+
+  ScratchArena* arena_;
+  ScratchArena::Mark mark_;
+};
+
+// The STL allocator of the arena, the memory is only given back by the
+// ScratchScope. The vectors should reserve their sizes, since the buffers
+// left by the growth are not reused in the scope.
+template <typename T>
+class ScratchAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = ScratchAllocator<U>;
+  };
+
+  ScratchAllocator(ScratchArena* arena) : arena_(arena) {}  // NOLINT
+
+  template <typename U>
+  ScratchAllocator(const ScratchAllocator<U>& other)  // NOLINT
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T*, size_t) {}
+
+  ScratchArena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ScratchAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ScratchAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+ private:
+  ScratchArena* arena_;
+};
+
+template <typename T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+}  // namespace lite
+}  // namespace paddle
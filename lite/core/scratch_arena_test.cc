@@ -0,0 +1,74 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/scratch_arena.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+TEST(scratch_arena, alignment) {
+  ScratchArena arena;
+  ScratchScope scope(&arena);
+  for (size_t bytes : {1, 3, 16, 17, 100, 5000}) {
+    auto* ptr = arena.Allocate(bytes);
+    ASSERT_TRUE(ptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 16, 0u);
+  }
+}
+
+TEST(scratch_arena, nested_scope) {
+  ScratchArena arena;
+  ScratchScope outer(&arena);
+  auto* a = static_cast<char*>(arena.Allocate(64));
+  char* b = nullptr;
+  {
+    ScratchScope inner(&arena);
+    b = static_cast<char*>(arena.Allocate(64));
+    EXPECT_EQ(b, a + 64);
+  }
+  // The memory of the inner scope is given back and taken again.
+  EXPECT_EQ(arena.Allocate(32), b);
+}
+
+TEST(scratch_arena, reuse) {
+  ScratchArena arena;
+  auto run = [&arena](int n) {
+    ScratchScope scope(&arena);
+    for (int i = 1; i <= n; i++) {
+      ScratchVector<uint64_t> offsets(&arena);
+      offsets.reserve(i * 100);
+      for (int j = 0; j < i * 100; j++) offsets.push_back(j);
+      EXPECT_EQ(offsets.back(), static_cast<uint64_t>(i * 100 - 1));
+    }
+  };
+  run(20);
+  int64_t warmup_allocations = arena.num_block_allocations();
+  size_t peak = arena.peak_bytes();
+  LOG(INFO) << "warm up allocations: " << warmup_allocations
+            << ", peak bytes: " << peak;
+  for (int i = 0; i < 10; i++) {
+    run(20);
+  }
+  // The blocks are merged at the end of the first run, the following runs
+  // take their memory from the merged block.
+  EXPECT_EQ(arena.num_block_allocations(), warmup_allocations);
+  EXPECT_EQ(arena.peak_bytes(), peak);
+}
+
+}  // namespace lite
+}  // namespace paddle
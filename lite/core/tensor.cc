@@ -16,6 +16,7 @@
 
 #include "lite/core/tensor.h"
 #include <string>
+#include <utility>
 #include "lite/utils/string.h"
 
 namespace paddle {
@@ -88,6 +89,16 @@ void TensorLite::CopyDataFrom(const TensorLite &other) {
   buffer_->CopyDataFrom(*other.buffer_, memory_size_);
 }
 
+void TensorLite::SwapDataWith(TensorLite *other) {
+  std::swap(dims_, other->dims_);
+  std::swap(target_, other->target_);
+  std::swap(lod_, other->lod_);
+  std::swap(memory_size_, other->memory_size_);
+  std::swap(precision_, other->precision_);
+  std::swap(buffer_, other->buffer_);
+  std::swap(offset_, other->offset_);
+}
+
 void *TensorLite::mutable_data(size_t memory_size) {
   memory_size_ = memory_size;
   buffer_->ResetLazy(target_, memory_size_);
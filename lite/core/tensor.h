@@ -201,8 +201,13 @@ class TensorLite {
 
   void CopyDataFrom(const TensorLite &other);
 
+  // Swap the data, shape and LoD with other, no data is copied.
+  void SwapDataWith(TensorLite *other);
+
   void ResetBuffer(std::shared_ptr<Buffer> buffer, size_t memory_size);
 
+  std::shared_ptr<Buffer> buffer() const { return buffer_; }
+
   TargetType target() const { return target_; }
 
   template <typename T>
@@ -0,0 +1,145 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/tuning_cache.h"
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <limits>
+#include "lite/core/device_info.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+thread_local bool tls_tuning = false;
+
+// The separators of the records can't appear in the keys.
+std::string Sanitize(const std::string& s) {
+  std::string out;
+  bool space = false;
+  for (char c : s) {
+    if (c == '\n' || c == '\r' || c == '\t' || c == ' ') {
+      space = !out.empty();
+      continue;
+    }
+    if (space) out.push_back(' ');
+    space = false;
+    out.push_back(c);
+  }
+  return out;
+}
+
+}  // namespace
+
+TuningCache& TuningCache::Global() {
+  static auto* x = new TuningCache;
+  return *x;
+}
+
+bool TuningCache::tuning() { return tls_tuning; }
+
+void TuningCache::SetThreadLocalTuning(bool tuning) { tls_tuning = tuning; }
+
+std::string TuningCache::CpuModel() {
+#if (defined LITE_WITH_ARM)
+  DeviceInfo::Init();
+  return Sanitize(DeviceInfo::Global().dev_name());
+#else
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      auto pos = line.find(':');
+      if (pos != std::string::npos) return Sanitize(line.substr(pos + 1));
+    }
+  }
+  return "unknown";
+#endif
+}
+
+void TuningCache::Init(const std::string& path, bool tuning) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (cpu_model_.empty()) cpu_model_ = CpuModel();
+  if (path.empty()) return;
+  if (tuning) paths_.insert(path);
+  std::ifstream file(path);
+  std::string line;
+  int loaded = 0;
+  while (std::getline(file, line)) {
+    auto pos = line.rfind('\t');
+    if (pos == std::string::npos) continue;
+    records_[line.substr(0, pos)] = line.substr(pos + 1);
+    loaded++;
+  }
+  VLOG(3) << "Loaded " << loaded << " tuning records from " << path;
+}
+
+std::string TuningCache::FullKey(const std::string& key) const {
+  return cpu_model_ + "|" + Sanitize(key);
+}
+
+std::string TuningCache::Find(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = records_.find(FullKey(key));
+  return it == records_.end() ? std::string() : it->second;
+}
+
+void TuningCache::Update(const std::string& key, const std::string& choice) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  records_[FullKey(key)] = choice;
+  VLOG(3) << "Tuned " << key << ": " << choice;
+  Save();
+}
+
+void TuningCache::Save() {
+  for (auto& path : paths_) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+      LOG(WARNING) << "Failed to write the tuning cache " << path;
+      continue;
+    }
+    for (auto& record : records_) {
+      file << record.first << "\t" << record.second << "\n";
+    }
+  }
+}
+
+int TuningCache::Tune(const std::vector<std::function<void()>>& candidates,
+                      int warmup,
+                      int repeats) {
+  int best = 0;
+  double best_time = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < candidates.size(); i++) {
+    for (int j = 0; j < warmup; j++) {
+      candidates[i]();
+    }
+    // Take the fastest of the repeats, which is the least noisy.
+    for (int j = 0; j < repeats; j++) {
+      auto start = std::chrono::steady_clock::now();
+      candidates[i]();
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (elapsed.count() < best_time) {
+        best_time = elapsed.count();
+        best = static_cast<int>(i);
+      }
+    }
+  }
+  return best;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,101 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * TuningCache records the kernel implementations measured to be the fastest,
+ * keyed by the CPU model and a signature of the op (type, shapes, attributes
+ * and threads). The kernels having several implementations look it up in
+ * PrepareForRun instead of relying on the hard-coded shape rules only:
+ * - a recorded choice is used as is;
+ * - otherwise, if the tuning is enabled, the eligible implementations are
+ *   timed on the actual inputs and the winner is recorded;
+ * - otherwise the rules apply.
+ *
+ * The records are stored in a text file, one `<key>\t<choice>` per line, so
+ * a file produced on one device can be shipped with the model and shared by
+ * the devices of different CPU models.
+ *
+ * The records are shared by all the predictors of the process, each of which
+ * calls Init with its own file: they are merged, as the keys identify the ops
+ * whatever the model. The tuning is enabled per predictor: its program sets
+ * it on the threads running the kernels, see ScopedTuning.
+ */
+class TuningCache {
+ public:
+  static TuningCache& Global();
+
+  // Merge the records of `path` into the cache. If `tuning` is set, `path`
+  // is rewritten with all the records whenever one is added. An empty path
+  // adds no record. It doesn't enable the tuning.
+  void Init(const std::string& path, bool tuning);
+
+  // Whether the kernels prepared on the current thread are tuned.
+  static bool tuning();
+  static void SetThreadLocalTuning(bool tuning);
+
+  // Returns the recorded choice for `key` on this CPU model, or an empty
+  // string.
+  std::string Find(const std::string& key);
+
+  void Update(const std::string& key, const std::string& choice);
+
+  // Time each of the candidates and return the index of the fastest one.
+  static int Tune(const std::vector<std::function<void()>>& candidates,
+                  int warmup = 1,
+                  int repeats = 3);
+
+  static std::string CpuModel();
+
+ private:
+  TuningCache() = default;
+
+  std::string FullKey(const std::string& key) const;
+  void Save();
+
+  std::mutex mutex_;
+  std::set<std::string> paths_;
+  std::string cpu_model_;
+  std::map<std::string, std::string> records_;
+};
+
+// Enables the tuning on the current thread in the scope. An enclosing scope
+// which enabled it, e.g. the program running a sub-block, is kept.
+class ScopedTuning {
+ public:
+  explicit ScopedTuning(bool tuning) : saved_(TuningCache::tuning()) {
+    TuningCache::SetThreadLocalTuning(saved_ || tuning);
+  }
+  ~ScopedTuning() { TuningCache::SetThreadLocalTuning(saved_); }
+
+ private:
+  ScopedTuning(const ScopedTuning&) = delete;
+  ScopedTuning& operator=(const ScopedTuning&) = delete;
+
+  bool saved_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,111 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/tuning_cache.h"
+#include <gtest/gtest.h>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(TuningCache, tune) {
+  auto sleep_ms = [](int ms) {
+    return [ms] { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); };
+  };
+  std::vector<std::function<void()>> candidates{
+      sleep_ms(20), sleep_ms(1), sleep_ms(10)};
+  EXPECT_EQ(TuningCache::Tune(candidates), 1);
+}
+
+const char* kTuningFile = "tuning_cache_test.txt";
+
+TEST(TuningCache, records) {
+  const std::string path = kTuningFile;
+  std::remove(path.c_str());
+  auto& cache = TuningCache::Global();
+  cache.Init(path, true);
+  EXPECT_EQ(cache.Find("conv2d|x:1,3,224,224"), "");
+  cache.Update("conv2d|x:1,3,224,224", "winograd");
+  EXPECT_EQ(cache.Find("conv2d|x:1,3,224,224"), "winograd");
+
+  std::ifstream file(path);
+  std::string line;
+  ASSERT_TRUE(static_cast<bool>(std::getline(file, line)));
+  EXPECT_EQ(line,
+            TuningCache::CpuModel() + "|conv2d|x:1,3,224,224\twinograd");
+  std::remove(path.c_str());
+}
+
+TEST(TuningCache, merge) {
+  // Another predictor, which loads its own file without tuning, keeps the
+  // records of the first one.
+  const std::string path = "tuning_cache_merge_test.txt";
+  {
+    std::ofstream file(path, std::ios::trunc);
+    file << TuningCache::CpuModel() << "|conv2d|x:1,8,56,56\tdirect\n";
+    file << "another cpu|conv2d|x:1,8,56,56\tgemm\n";
+  }
+  auto& cache = TuningCache::Global();
+  cache.Init("", true);
+  cache.Update("conv2d|x:1,16,28,28", "gemm");
+  cache.Init(path, false);
+  EXPECT_EQ(cache.Find("conv2d|x:1,8,56,56"), "direct");
+  EXPECT_EQ(cache.Find("conv2d|x:1,16,28,28"), "gemm");
+
+  // The file of a predictor which doesn't tune is left as it is.
+  cache.Update("conv2d|x:1,32,14,14", "winograd");
+  std::ifstream file(path);
+  std::string line;
+  int lines = 0;
+  while (std::getline(file, line)) lines++;
+  EXPECT_EQ(lines, 2);
+  std::remove(path.c_str());
+  // The file of the tuning predictor is still rewritten.
+  std::remove(kTuningFile);
+}
+
+TEST(TuningCache, scoped_tuning) {
+  // Init doesn't enable the tuning, the programs of the tuning predictors do
+  // on the threads running them.
+  TuningCache::Global().Init("", true);
+  EXPECT_FALSE(TuningCache::tuning());
+  {
+    ScopedTuning tuning(true);
+    EXPECT_TRUE(TuningCache::tuning());
+    {
+      // A sub-block program of the tuning predictor.
+      ScopedTuning sub_block(false);
+      EXPECT_TRUE(TuningCache::tuning());
+    }
+    EXPECT_TRUE(TuningCache::tuning());
+    // Another predictor running concurrently doesn't tune.
+    bool other_tuning = true;
+    std::thread other([&other_tuning] {
+      ScopedTuning tuning(false);
+      other_tuning = TuningCache::tuning();
+    });
+    other.join();
+    EXPECT_FALSE(other_tuning);
+  }
+  EXPECT_FALSE(TuningCache::tuning());
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -49,6 +49,12 @@ class WorkSpace {
     return data;
   }
 
+  // The size allocated since the last reset.
+  size_t cursor() const { return cursor_; }
+
+  // Make sure that `size` bytes can be allocated without reallocation.
+  void Reserve(size_t size) { buffer_.ResetLazy(target_, size); }
+
   static WorkSpace& Global_Host() {
     thread_local std::unique_ptr<WorkSpace> x(new WorkSpace(TARGET(kHost)));
     return *x;
@@ -33,6 +33,26 @@ static LoD ToAbsOffset(const LoD &in) {
   }
   return result;
 }
+
+// Writes the absolute offsets of a level of the lod to offsets, the same as
+// ToAbsOffset(in)[level] without copying the whole lod.
+template <typename Vector>
+void ToAbsOffsetLevel(const LoD &in, size_t level, Vector *offsets) {
+  offsets->assign(in[level].begin(), in[level].end());
+  for (size_t lower = level + 1; lower < in.size(); lower++) {
+    for (auto &offset : *offsets) {
+      offset = in[lower][offset];
+    }
+  }
+}
+
+// Sets the lod to the single level [first, last) in place, so the vectors
+// of the lod keep their capacity across the runs.
+template <typename Iterator>
+void SetSingleLevelLoD(Iterator first, Iterator last, LoD *lod) {
+  lod->resize(1);
+  (*lod)[0].assign(first, last);
+}
 }  // namespace fluid
 }  // namespace lite
 }  // namespace paddle
@@ -34,6 +34,7 @@ void BeamSearchCompute::Run() {
                                param.beam_size,
                                param.end_id,
                                param.is_accumulated,
+                               &searcher_,
                                &ctx);
 }
 
@@ -15,6 +15,7 @@
 #pragma once
 #include <stdint.h>
 #include "lite/backends/arm/math/type_trans.h"
+#include "lite/backends/host/math/beam_search.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -30,6 +31,8 @@ class BeamSearchCompute : public KernelLite<TARGET(kARM), PRECISION(kFloat)> {
   ~BeamSearchCompute() {}
 
  private:
+  // The candidate pools are reused by the steps of the decoding loop.
+  lite::host::math::BeamSearcher searcher_;
 };
 
 }  // namespace arm
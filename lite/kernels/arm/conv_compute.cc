@@ -13,8 +13,15 @@
 // limitations under the License.
 
 #include "lite/kernels/arm/conv_compute.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
 #include "lite/core/op_registry.h"
+#include "lite/core/tuning_cache.h"
 #include "lite/core/type_system.h"
 #include "lite/kernels/arm/conv_depthwise.h"
 #include "lite/kernels/arm/conv_direct.h"
@@ -26,6 +33,72 @@ namespace lite {
 namespace kernels {
 namespace arm {
 
+namespace {
+
+KernelLite<TARGET(kARM), PRECISION(kFloat)>* NewFloatConvImpl(
+    const std::string& name) {
+  if (name == "depthwise") {
+    return new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
+  } else if (name == "winograd") {
+    return new WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>;
+  } else if (name == "direct") {
+    return new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>;
+  }
+  return new GemmLikeConv<PRECISION(kFloat), PRECISION(kFloat)>;
+}
+
+// The signature of a conv for the tuning cache.
+std::string ConvTuningKey(const operators::ConvParam& param, int threads) {
+  std::stringstream ss;
+  auto dims_str = [&](const DDim& dims) {
+    for (size_t i = 0; i < dims.size(); i++) {
+      ss << (i ? "," : "") << dims[i];
+    }
+  };
+  auto vec_str = [&](const std::vector<int>& v) {
+    for (size_t i = 0; i < v.size(); i++) {
+      ss << (i ? "," : "") << v[i];
+    }
+  };
+  ss << "conv2d|fp32|x:";
+  dims_str(param.x->dims());
+  ss << "|w:";
+  dims_str(param.filter->dims());
+  ss << "|s:";
+  vec_str(param.strides);
+  ss << "|p:";
+  vec_str(*param.paddings);
+  ss << "|d:";
+  vec_str(*param.dilations);
+  ss << "|g:" << param.groups << "|t:" << threads;
+  return ss.str();
+}
+
+// Time the eligible implementations on the actual inputs and return the
+// fastest one.
+std::string TuneFloatConvImpl(const operators::ConvParam& param,
+                              const std::vector<std::string>& impls) {
+  std::vector<std::unique_ptr<KernelLite<TARGET(kARM), PRECISION(kFloat)>>>
+      kernels;
+  std::vector<std::function<void()>> candidates;
+  for (auto& name : impls) {
+    kernels.emplace_back(NewFloatConvImpl(name));
+    auto* kernel = kernels.back().get();
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<ARMContext>();
+    kernel->SetContext(std::move(ctx));
+    kernel->SetParam(param);
+    kernel->PrepareForRun();
+    candidates.push_back([kernel] {
+      kernel->ReInitWhenNeeded();
+      kernel->Run();
+    });
+  }
+  return impls[TuningCache::Tune(candidates)];
+}
+
+}  // namespace
+
 template <>
 void ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   auto& param = this->Param<param_t>();
@@ -67,22 +140,47 @@ void ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
 #endif
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
 
-  /// select conv impl
+  /// the eligible conv impls, the one picked by the rules comes first
+  std::vector<std::string> impls;
   if (param.groups == ic && ic == oc && ks_equal && no_dilation && flag_dw) {
-    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking dw conv";
-  } else if (param.groups == 1 && kw == 3 && stride == 1 && ks_equal &&
-             no_dilation) {
-    impl_ = new WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking winograd conv";
-  } else if (param.groups == 1 && kw == 3 && stride == 2 &&
-             chin * chout < 4 * hin * win && ks_equal && no_dilation) {
-    impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking direct conv";
-  } else {
-    impl_ = new GemmLikeConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking gemm like conv";
+    impls.push_back("depthwise");
+  }
+  if (param.groups == 1 && kw == 3 && stride == 1 && ks_equal &&
+      no_dilation) {
+    impls.push_back("winograd");
+  }
+  bool flag_direct =
+      param.groups == 1 && kw == 3 && stride == 2 && ks_equal && no_dilation;
+  bool direct_first = flag_direct && chin * chout < 4 * hin * win;
+  if (direct_first) {
+    impls.push_back("direct");
+  }
+  impls.push_back("gemm");
+  if (flag_direct && !direct_first) {
+    impls.push_back("direct");
+  }
+
+  /// the gemm prepacked filter may replace the original filter, which the
+  /// other impls need
+  if (param.prepacked_only && param.prepacked_tag.find("gemm_") == 0) {
+    impls = {"gemm"};
+  }
+
+  /// select conv impl, measured or recorded by the tuning cache if any
+  auto& tuning_cache = TuningCache::Global();
+  std::string key = ConvTuningKey(param, threads);
+  std::string choice = tuning_cache.Find(key);
+  if (std::find(impls.begin(), impls.end(), choice) == impls.end()) {
+    choice.clear();
   }
+  if (choice.empty() && impls.size() > 1 && TuningCache::tuning()) {
+    choice = TuneFloatConvImpl(param, impls);
+    tuning_cache.Update(key, choice);
+  }
+  if (choice.empty()) {
+    choice = impls.front();
+  }
+  impl_ = NewFloatConvImpl(choice);
   impl_->SetContext(std::move(this->ctx_));
   impl_->SetParam(param);
   impl_->PrepareForRun();
@@ -190,6 +288,66 @@ void ConvCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
   is_first_epoch_ = false;
 }
 
+void ConvWeightOnlyCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto& ctx = this->ctx_->template As<ARMContext>();
+  CHECK_EQ(param.groups, 1);
+  auto x_dims = param.x->dims();
+  auto filter_dims = param.filter->dims();
+  auto out_dims = param.output->dims();
+  const int num = x_dims[0];
+  const int ic = x_dims[1];
+  const int ih = x_dims[2];
+  const int iw = x_dims[3];
+  const int kh = filter_dims[2];
+  const int kw = filter_dims[3];
+  const int m = out_dims[1];
+  const int n = out_dims[2] * out_dims[3];
+  const int k = ic * kh * kw;
+  CHECK_EQ(lite::QuantWeightRows(k, param.bit_length) * m,
+           filter_dims.production());
+  CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(m));
+
+  auto paddings = *param.paddings;
+  auto dilations = *param.dilations;
+  col_.resize(static_cast<size_t>(k) * n);
+  const float* i_data = param.x->data<float>();
+  float* o_data = param.output->mutable_data<float>();
+  const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+  for (int b = 0; b < num; ++b) {
+    lite::arm::math::im2col(i_data + static_cast<int64_t>(b) * ic * ih * iw,
+                            ic,
+                            ih,
+                            iw,
+                            kh,
+                            kw,
+                            paddings[0],
+                            paddings[1],
+                            paddings[2],
+                            paddings[3],
+                            param.strides[0],
+                            param.strides[1],
+                            dilations[0],
+                            dilations[1],
+                            col_.data());
+    lite::arm::math::QuantWeightGemm(m,
+                                     n,
+                                     k,
+                                     param.filter->data<int8_t>(),
+                                     param.weight_scale.data(),
+                                     param.bit_length,
+                                     col_.data(),
+                                     n,
+                                     o_data + static_cast<int64_t>(b) * m * n,
+                                     n,
+                                     bias,
+                                     bias != nullptr,
+                                     param.activation_param,
+                                     &panel_,
+                                     &ctx);
+  }
+}
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
@@ -209,6 +367,8 @@ REGISTER_LITE_KERNEL(conv2d, kARM, kFloat, kNCHW, ConvFp32, def)
     .BindInput("Input", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("PrepackedFilter",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
     .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kARM))})
     .Finalize();
 
@@ -216,6 +376,8 @@ REGISTER_LITE_KERNEL(depthwise_conv2d, kARM, kFloat, kNCHW, ConvFp32, def)
     .BindInput("Input", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("PrepackedFilter",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
     .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kARM))})
     .Finalize();
 
@@ -224,6 +386,8 @@ REGISTER_LITE_KERNEL(conv2d, kARM, kInt8, kNCHW, ConvInt8_Int8, int8_out)
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
     .BindInput("Filter",
                {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindInput("PrepackedFilter",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
     .BindOutput("Output",
                 {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
     .Finalize();
@@ -233,6 +397,8 @@ REGISTER_LITE_KERNEL(conv2d, kARM, kInt8, kNCHW, ConvInt8_Fp32, fp32_out)
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
     .BindInput("Filter",
                {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindInput("PrepackedFilter",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
     .BindOutput("Output",
                 {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
     .Finalize();
@@ -243,6 +409,8 @@ REGISTER_LITE_KERNEL(
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
     .BindInput("Filter",
                {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindInput("PrepackedFilter",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
     .BindOutput("Output",
                 {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
     .Finalize();
@@ -251,6 +419,23 @@ REGISTER_LITE_KERNEL(
     depthwise_conv2d, kARM, kInt8, kNCHW, ConvInt8_Fp32, fp32_out)
     .BindInput("Input", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindInput("PrepackedFilter",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(conv2d,
+                     kARM,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::arm::ConvWeightOnlyCompute,
+                     weight_only)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
     .BindInput("Filter",
                {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
     .BindOutput("Output",
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <string>
+#include <vector>
 #include "lite/backends/arm/math/funcs.h"
 #include "lite/core/kernel.h"
 #ifdef LITE_WITH_PROFILE
@@ -39,6 +41,12 @@ class ConvCompute : public KernelLite<TARGET(kARM), Ptype> {
     impl_->Run();
   }
 
+  virtual bool GetPrepackedWeights(std::string* arg,
+                                   const Tensor** packed,
+                                   std::string* tag) const {
+    return impl_ != nullptr && impl_->GetPrepackedWeights(arg, packed, tag);
+  }
+
 #ifdef LITE_WITH_PROFILE
   virtual void SetProfileRuntimeKernelInfo(
       paddle::lite::profile::OpCharacter* ch) {
@@ -57,6 +65,23 @@ class ConvCompute : public KernelLite<TARGET(kARM), Ptype> {
   KernelLite<TARGET(kARM), Ptype>* impl_{nullptr};
 };
 
+// The conv2d kernel without groups whose filter is weight-only quantized to 8
+// or 4 bits. The filter holds the [C * kh * kw, out_channels] weights in the
+// layout of lite/utils/weight_quant.h, see weight_only_quantization_pass.
+class ConvWeightOnlyCompute
+    : public KernelLite<TARGET(kARM), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::ConvParam;
+
+  void Run() override;
+
+  ~ConvWeightOnlyCompute() = default;
+
+ private:
+  std::vector<float> col_;
+  std::vector<float> panel_;
+};
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
@@ -101,7 +101,7 @@ void GemmLikeConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   ctx.ExtendWorkspace(workspace_size_);
   auto weights = param.filter->data<float>();
   if (flag_trans_weights_) {
-    weights = weights_.data<float>();
+    weights = packed_weights_->data<float>();
   }
   const float* bias = param.bias ? param.bias->data<float>() : nullptr;
   if (flag_trans_bias_) {
@@ -122,14 +122,38 @@ void GemmLikeConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   int ow = o_dims[3];
   int oc = o_dims[1];
   if (flag_1x1gemm_) {
-    lite::arm::math::conv1x1s1_gemm(
-        din, dout, bs, oc, oh, ow, ic, ih, iw, weights, bias, param, &ctx);
+    lite::arm::math::conv1x1s1_gemm(din,
+                                    dout,
+                                    bs,
+                                    oc,
+                                    oh,
+                                    ow,
+                                    ic,
+                                    ih,
+                                    iw,
+                                    weights,
+                                    bias,
+                                    param,
+                                    &ctx,
+                                    flag_force_gemm_);
 #ifdef LITE_WITH_PROFILE
     kernel_func_name_ = "conv1x1s1_gemm";
 #endif
   } else {
-    lite::arm::math::conv_im2col_gemm(
-        din, dout, bs, oc, oh, ow, ic, ih, iw, weights, bias, param, &ctx);
+    lite::arm::math::conv_im2col_gemm(din,
+                                      dout,
+                                      bs,
+                                      oc,
+                                      oh,
+                                      ow,
+                                      ic,
+                                      ih,
+                                      iw,
+                                      weights,
+                                      bias,
+                                      param,
+                                      &ctx,
+                                      flag_force_gemm_);
 #ifdef LITE_WITH_PROFILE
     kernel_func_name_ = "conv_im2col_gemm";
 #endif
@@ -151,7 +175,7 @@ void GemmLikeConv<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
   ctx.ExtendWorkspace(workspace_size_);
   auto weights = param.filter->data<int8_t>();
   if (flag_trans_weights_) {
-    weights = weights_.data<int8_t>();
+    weights = packed_weights_->data<int8_t>();
   }
   auto bias = param.bias ? param.bias->data<float>() : nullptr;
   if (flag_trans_bias_) {
@@ -185,7 +209,8 @@ void GemmLikeConv<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
                                          bias,
                                          param,
                                          &ctx,
-                                         w_scale_.data());
+                                         w_scale_.data(),
+                                         flag_force_gemm_);
 #ifdef LITE_WITH_PROFILE
     kernel_func_name_ = "conv1x1s1_gemm_int8";
 #endif
@@ -203,7 +228,8 @@ void GemmLikeConv<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
                                            bias,
                                            param,
                                            &ctx,
-                                           w_scale_.data());
+                                           w_scale_.data(),
+                                           flag_force_gemm_);
 #ifdef LITE_WITH_PROFILE
     kernel_func_name_ = "conv_im2col_gemm_int8";
 #endif
@@ -225,7 +251,7 @@ void GemmLikeConv<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   ctx.ExtendWorkspace(workspace_size_);
   auto weights = param.filter->data<int8_t>();
   if (flag_trans_weights_) {
-    weights = weights_.data<int8_t>();
+    weights = packed_weights_->data<int8_t>();
   }
   auto bias = param.bias ? param.bias->data<float>() : nullptr;
   if (flag_trans_bias_) {
@@ -259,7 +285,8 @@ void GemmLikeConv<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
                                          bias,
                                          param,
                                          &ctx,
-                                         w_scale_.data());
+                                         w_scale_.data(),
+                                         flag_force_gemm_);
 #ifdef LITE_WITH_PROFILE
     kernel_func_name_ = "conv1x1s1_gemm_int8";
 #endif
@@ -277,7 +304,8 @@ void GemmLikeConv<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
                                            bias,
                                            param,
                                            &ctx,
-                                           w_scale_.data());
+                                           w_scale_.data(),
+                                           flag_force_gemm_);
 #ifdef LITE_WITH_PROFILE
     kernel_func_name_ = "conv_im2col_gemm_int8";
 #endif
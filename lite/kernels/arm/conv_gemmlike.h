@@ -82,11 +82,30 @@ class GemmLikeConv : public KernelLite<TARGET(kARM), Ptype> {
       flag_1x1gemm_ = false;
       workspace_size_ = k * n * sizeof(float);
     }
-    if (!flag_trans_weights_ && n > 1) {
-      lite::arm::math::trans_gemm_weights<Ptype>(
-          *(param.filter), weights_, param.groups, &ctx);
+    if (!flag_trans_weights_ && param.prepacked_only &&
+        param.prepacked_filter &&
+        param.prepacked_tag ==
+            lite::arm::math::trans_gemm_weights_tag<Ptype>(&ctx)) {
+      //! the gemm runs on the weights packed ahead of time for n == 1 as
+      //! well, so the original filter is released, only its dims are kept
+      prepacked_tag_ = param.prepacked_tag;
+      packed_weights_ = param.prepacked_filter;
+      param.filter->clear();
       flag_trans_weights_ = true;
-    } else if (n == 1) {
+      flag_force_gemm_ = true;
+    } else if (!flag_trans_weights_ && n > 1) {
+      prepacked_tag_ = lite::arm::math::trans_gemm_weights_tag<Ptype>(&ctx);
+      if (param.prepacked_filter && param.prepacked_tag == prepacked_tag_) {
+        //! the weights packed ahead of time are used without a copy
+        packed_weights_ = param.prepacked_filter;
+      } else {
+        lite::arm::math::trans_gemm_weights<Ptype>(
+            *(param.filter), weights_, param.groups, &ctx);
+        weights_.set_precision(Ptype);
+        packed_weights_ = &weights_;
+      }
+      flag_trans_weights_ = true;
+    } else if (n == 1 && !flag_force_gemm_) {
       flag_trans_weights_ = false;
     }
     last_shape_ = x_dims;
@@ -95,6 +114,20 @@ class GemmLikeConv : public KernelLite<TARGET(kARM), Ptype> {
   virtual void PrepareForRun();
   virtual void Run();
 
+  virtual bool GetPrepackedWeights(std::string* arg,
+                                   const Tensor** packed,
+                                   std::string* tag) const {
+    if (!flag_trans_weights_ || packed_weights_ == nullptr) {
+      return false;
+    }
+    *arg = "Filter";
+    *packed = packed_weights_;
+    *tag = prepacked_tag_;
+    return true;
+  }
+
+  virtual bool PrepackedWeightsOnly() const { return true; }
+
 #ifdef LITE_WITH_PROFILE
   virtual void SetProfileRuntimeKernelInfo(
       paddle::lite::profile::OpCharacter* ch) {
@@ -112,7 +145,12 @@ class GemmLikeConv : public KernelLite<TARGET(kARM), Ptype> {
   bool flag_1x1gemm_{true};
   bool flag_trans_weights_{false};
   bool flag_trans_bias_{false};
+  //! n == 1 runs the gemm on the packed weights instead of the gemv
+  bool flag_force_gemm_{false};
   Tensor weights_;
+  //! weights_ or the filter packed ahead of time
+  const Tensor* packed_weights_{nullptr};
+  std::string prepacked_tag_;
   Tensor bias_;
   int workspace_size_{0};
 };
@@ -75,6 +75,13 @@ void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::ReInitWhenNeeded() {
     last_function_ = 1;
   }
 
+  prepacked_tag_ =
+      choose_small_ ? "winograd_fp32_c4_4x4" : "winograd_fp32_c4_8x8";
+  if (param.prepacked_filter && param.prepacked_tag == prepacked_tag_) {
+    //! the weights transformed ahead of time are used without a copy
+    packed_weights_ = param.prepacked_filter;
+    return;
+  }
   weights_.Resize({1, 1, 1, wino_iw * wino_iw * oc_pad * ic_pad});
   void* trans_tmp_ptr = malloc(sizeof(float) * wino_iw * wino_iw * oc * ic);
   auto weights_data_ = weights_.mutable_data<float>();
@@ -89,6 +96,7 @@ void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::ReInitWhenNeeded() {
         weights_data_, param.filter->data<float>(), ic, oc, trans_tmp_ptr);
   }
   free(trans_tmp_ptr);
+  packed_weights_ = &weights_;
 }
 
 template <>
@@ -110,7 +118,7 @@ void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto& ctx = this->ctx_->template As<ARMContext>();
   ctx.ExtendWorkspace(workspace_size_);
   const auto* i_data = param.x->data<float>();
-  const auto* w_data = weights_.data<float>();
+  const auto* w_data = packed_weights_->data<float>();
   const auto* b_data = param.bias ? param.bias->data<float>() : nullptr;
   auto* o_data = param.output->mutable_data<float>();
 
@@ -35,6 +35,18 @@ class WinogradConv : public KernelLite<TARGET(kARM), Ptype> {
   virtual void PrepareForRun();
   virtual void ReInitWhenNeeded();
   virtual void Run();
+
+  virtual bool GetPrepackedWeights(std::string* arg,
+                                   const Tensor** packed,
+                                   std::string* tag) const {
+    if (packed_weights_ == nullptr) {
+      return false;
+    }
+    *arg = "Filter";
+    *packed = packed_weights_;
+    *tag = prepacked_tag_;
+    return true;
+  }
 #ifdef LITE_WITH_PROFILE
   virtual void SetProfileRuntimeKernelInfo(
       paddle::lite::profile::OpCharacter* ch) {
@@ -46,6 +58,9 @@ class WinogradConv : public KernelLite<TARGET(kARM), Ptype> {
  protected:
   using param_t = operators::ConvParam;
   Tensor weights_;
+  //! weights_ or the filter transformed ahead of time
+  const Tensor* packed_weights_{nullptr};
+  std::string prepacked_tag_;
   DDim last_shape_;
   int workspace_size_{0};
   int last_function_{-1};
@@ -258,6 +258,42 @@ void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   }
 }
 
+void FcWeightOnlyCompute::Run() {
+  auto& param = this->Param<operators::FcParam>();
+  auto& ctx = this->ctx_->template As<ARMContext>();
+
+  auto x_dims = param.input->dims();
+  int m = x_dims.Slice(0, param.in_num_col_dims).production();
+  int k = x_dims.Slice(param.in_num_col_dims, x_dims.size()).production();
+  int n = param.w->dims()[1];
+  CHECK_EQ(lite::QuantWeightRows(k, param.bit_length), param.w->dims()[0]);
+  CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(n));
+  auto o_data = param.output->mutable_data<float>();
+  lite::arm::math::QuantWeightGemm(false,
+                                   m,
+                                   n,
+                                   k,
+                                   1.f,
+                                   param.input->data<float>(),
+                                   k,
+                                   param.w->data<int8_t>(),
+                                   param.weight_scale.data(),
+                                   param.bit_length,
+                                   0.f,
+                                   o_data,
+                                   n,
+                                   &panel_,
+                                   &ctx);
+  if (param.bias) {
+    CHECK_EQ(param.bias->numel(), n);
+    lite::arm::math::fill_bias_fc(o_data,
+                                  param.bias->data<float>(),
+                                  m,
+                                  n,
+                                  param.activation_type == "relu");
+  }
+}
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
@@ -293,3 +329,16 @@ REGISTER_LITE_KERNEL(fc, kARM, kInt8, kNCHW, FcCompute_int8_fp32, fp32out)
     .BindInput("W", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(fc,
+                     kARM,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::arm::FcWeightOnlyCompute,
+                     weight_only)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .BindInput("W", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .Finalize();
@@ -129,6 +129,21 @@ class FcCompute : public KernelLite<TARGET(kARM), PType> {
   std::vector<float> scale_;
 };
 
+// The fc kernel whose weights are weight-only quantized to 8 or 4 bits, see
+// lite/utils/weight_quant.h for the layout.
+class FcWeightOnlyCompute
+    : public KernelLite<TARGET(kARM), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::FcParam;
+
+  void Run() override;
+
+  ~FcWeightOnlyCompute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,100 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/arm/fusion_elementwise_chain_compute.h"
+#include <algorithm>
+#include "lite/backends/arm/math/funcs.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace arm {
+
+namespace {
+
+struct NeonTranscendental {
+  void operator()(host::math::ChainOp op,
+                  const float* x,
+                  float* y,
+                  int len) const {
+    switch (op) {
+      case host::math::ChainOp::kSigmoid:
+        lite::arm::math::act_sigmoid<float>(x, y, len, 1);
+        break;
+      case host::math::ChainOp::kTanh:
+        lite::arm::math::act_tanh<float>(x, y, len, 1);
+        break;
+      default:
+        lite::arm::math::act_exp<float>(x, y, len, 1);
+        break;
+    }
+  }
+};
+
+}  // namespace
+
+void FusionElementwiseChainCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  CHECK(host::math::BuildChainSteps(
+      param.op_types, param.operand_ids, param.alphas, param.betas, &steps_))
+      << "Unsupported elementwise chain";
+}
+
+void FusionElementwiseChainCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto& ctx = this->ctx_->template As<ARMContext>();
+  auto x_dims = param.X->dims().Vectorize();
+  std::vector<host::math::ChainOperand> operands(param.Y.size());
+  for (size_t i = 0; i < param.Y.size(); i++) {
+    CHECK(host::math::ChainOperandLayout(
+        x_dims, param.Y[i]->dims().Vectorize(), param.axes[i], &operands[i]));
+    operands[i].data = param.Y[i]->data<float>();
+  }
+  const float* x = param.X->data<float>();
+  float* out = param.Out->mutable_data<float>();
+  int64_t numel = param.X->numel();
+  int64_t num_tiles =
+      (numel + host::math::kChainTileSize - 1) / host::math::kChainTileSize;
+  int threads = static_cast<int>(
+      std::max<int64_t>(std::min<int64_t>(ctx.threads(), num_tiles), 1));
+  int64_t tiles_per_thread = (num_tiles + threads - 1) / threads;
+  NeonTranscendental transcendental;
+#pragma omp parallel for
+  for (int i = 0; i < threads; i++) {
+    int64_t begin = i * tiles_per_thread * host::math::kChainTileSize;
+    int64_t end = std::min(
+        (i + 1) * tiles_per_thread * host::math::kChainTileSize, numel);
+    if (begin < end) {
+      host::math::ElementwiseChain(
+          x, operands, steps_, begin, end, out, transcendental);
+    }
+  }
+}
+
+}  // namespace arm
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fusion_elementwise_chain,
+                     kARM,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::arm::FusionElementwiseChainCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
+    .Finalize();
@@ -0,0 +1,161 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/arm/fusion_elementwise_chain_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace arm {
+
+void RunChain(const lite::Tensor& x,
+              const std::vector<lite::Tensor*>& ys,
+              const std::vector<int>& axes,
+              const std::vector<std::string>& op_types,
+              const std::vector<int>& operand_ids,
+              const std::vector<float>& alphas,
+              const std::vector<float>& betas,
+              int threads,
+              lite::Tensor* out) {
+  FusionElementwiseChainCompute chain;
+  operators::FusionElementwiseChainParam param;
+  param.X = &x;
+  param.Y = ys;
+  param.Out = out;
+  param.axes = axes;
+  param.op_types = op_types;
+  param.operand_ids = operand_ids;
+  param.alphas = alphas;
+  param.betas = betas;
+  out->Resize(x.dims());
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<ARMContext>().SetRunMode(lite_api::LITE_POWER_HIGH, threads);
+  chain.SetParam(param);
+  chain.SetContext(std::move(ctx));
+  chain.PrepareForRun();
+  chain.Run();
+}
+
+TEST(fusion_elementwise_chain_arm, retrive_op) {
+  auto chain = KernelRegistry::Global().Create("fusion_elementwise_chain");
+  ASSERT_FALSE(chain.empty());
+  ASSERT_TRUE(chain.front());
+}
+
+// out = relu6(sigmoid(x * w + b) * x * 0.5 + 1), w and b are per channel.
+TEST(fusion_elementwise_chain_arm, run_sigmoid_test) {
+  DeviceInfo::Init();
+  const int n = 2, c = 3, h = 37, w = 41;
+  lite::Tensor x, weight, bias, out;
+  x.Resize({n, c, h, w});
+  weight.Resize({c});
+  bias.Resize({c, 1, 1});
+  auto* x_data = x.mutable_data<float>();
+  auto* weight_data = weight.mutable_data<float>();
+  auto* bias_data = bias.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 17) / 4.f - 2.f;
+  }
+  for (int i = 0; i < c; i++) {
+    weight_data[i] = 0.5f * (i + 1);
+    bias_data[i] = 0.1f * i - 0.1f;
+  }
+
+  for (int threads : {1, 2, 4}) {
+    RunChain(x,
+             {&weight, &bias},
+             {1, 1},
+             {"elementwise_mul",
+              "elementwise_add",
+              "sigmoid",
+              "elementwise_mul",
+              "scale",
+              "relu6"},
+             {0, 1, -1, -2, -1, -1},
+             {0.f, 0.f, 0.f, 0.f, 0.5f, 6.f},
+             {0.f, 0.f, 0.f, 0.f, 1.f, 0.f},
+             threads,
+             &out);
+    auto* out_data = out.data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      int ch = static_cast<int>(i / (h * w) % c);
+      float v = x_data[i] * weight_data[ch] + bias_data[ch];
+      v = 1.f / (1.f + std::exp(-v)) * x_data[i] * 0.5f + 1.f;
+      v = std::min(std::max(v, 0.f), 6.f);
+      EXPECT_NEAR(out_data[i], v, 1e-4) << "threads " << threads;
+    }
+  }
+}
+
+// out = abs(max(exp(leaky_relu(tanh(x - y))), x)) / z, y has the shape of x
+// and z is a scalar. The size is not a multiple of the tile nor of the NEON
+// width.
+TEST(fusion_elementwise_chain_arm, run_tanh_exp_test) {
+  DeviceInfo::Init();
+  const int64_t numel = 3 * 1024 + 7;
+  lite::Tensor x, y, z, out;
+  x.Resize({numel});
+  y.Resize({numel});
+  z.Resize({1});
+  auto* x_data = x.mutable_data<float>();
+  auto* y_data = y.mutable_data<float>();
+  for (int64_t i = 0; i < numel; i++) {
+    x_data[i] = static_cast<float>(i % 23) / 5.f - 2.f;
+    y_data[i] = static_cast<float>(i % 13) / 6.f - 1.f;
+  }
+  z.mutable_data<float>()[0] = -2.f;
+
+  RunChain(x,
+           {&y, &z},
+           {-1, -1},
+           {"elementwise_sub",
+            "tanh",
+            "leaky_relu",
+            "exp",
+            "elementwise_max",
+            "abs",
+            "elementwise_div"},
+           {0, -1, -1, -1, -2, -1, 1},
+           {0.f, 0.f, 0.1f, 0.f, 0.f, 0.f, 0.f},
+           {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f},
+           2,
+           &out);
+  auto* out_data = out.data<float>();
+  for (int64_t i = 0; i < numel; i++) {
+    float v = std::tanh(x_data[i] - y_data[i]);
+    v = v > 0.f ? v : v * 0.1f;
+    v = std::exp(v);
+    v = std::abs(std::max(v, x_data[i])) / -2.f;
+    EXPECT_NEAR(out_data[i], v, 1e-4);
+  }
+}
+
+}  // namespace arm
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fusion_elementwise_chain, kARM, kFloat, kNCHW, def);
@@ -0,0 +1,110 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/arm/fusion_kv_cache_attention_compute.h"
+#include <algorithm>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace arm {
+
+void FusionKVCacheAttentionCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto q_dims = param.Q->dims();
+  host::math::KVCacheShape shape;
+  shape.batch = static_cast<int>(q_dims[0]);
+  shape.heads = static_cast<int>(q_dims[1]);
+  shape.tokens = static_cast<int>(q_dims[2]);
+  shape.dim = static_cast<int>(q_dims[3]);
+  shape.capacity = param.capacity;
+  shape.pos = static_cast<int>(host::math::ReadIndices(param.Position)[0]);
+  CHECK(shape.pos >= 0 && shape.pos + shape.tokens <= shape.capacity)
+      << "The kv cache of capacity " << shape.capacity << " can't hold "
+      << shape.pos + shape.tokens << " tokens";
+  std::vector<int64_t> parent_idx;
+  if (param.ParentIdx) {
+    parent_idx = host::math::ReadIndices(param.ParentIdx);
+    CHECK_EQ(static_cast<int>(parent_idx.size()), shape.batch);
+  }
+  host::math::UpdateCache(
+      param.K, parent_idx, shape, &gather_buffer_, param.CacheK);
+  host::math::UpdateCache(
+      param.V, parent_idx, shape, &gather_buffer_, param.CacheV);
+
+  host::math::KVCacheBias bias;
+  if (param.BiasQK) {
+    auto bias_dims = param.BiasQK->dims();
+    bias.data = param.BiasQK->data<float>();
+    bias.batch = static_cast<int>(bias_dims[0]);
+    bias.heads = static_cast<int>(bias_dims[1]);
+    bias.tokens = static_cast<int>(bias_dims[2]);
+    bias.len = bias_dims[3];
+    CHECK_GE(bias.len, shape.pos + shape.tokens);
+  }
+  const float* q = param.Q->data<float>();
+  const float* cache_k = param.CacheK->data<float>();
+  const float* cache_v = param.CacheV->data<float>();
+  float* out = param.Out->mutable_data<float>();
+  float alpha = param.alpha;
+  auto& ctx = this->ctx_->template As<ARMContext>();
+  int num_heads = shape.batch * shape.heads;
+  int threads = std::max(std::min(ctx.threads(), num_heads), 1);
+  int heads_per_thread = (num_heads + threads - 1) / threads;
+#pragma omp parallel for
+  for (int i = 0; i < threads; i++) {
+    int begin = i * heads_per_thread;
+    int end = std::min(begin + heads_per_thread, num_heads);
+    if (begin < end) {
+      std::vector<float> scores(shape.pos + shape.tokens);
+      host::math::KVCacheAttention(q,
+                                   cache_k,
+                                   cache_v,
+                                   bias,
+                                   shape,
+                                   alpha,
+                                   begin,
+                                   end,
+                                   scores.data(),
+                                   out);
+    }
+  }
+}
+
+}  // namespace arm
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fusion_kv_cache_attention,
+                     kARM,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::arm::FusionKVCacheAttentionCompute,
+                     def)
+    .BindInput("Q", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("K", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("V", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("Position",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
+    .BindInput("ParentIdx",
+               {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kAny))})
+    .BindInput("BiasQK", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("CacheK", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("CacheV", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindOutput("CacheKOut", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindOutput("CacheVOut", {LiteType::GetTensorTy(TARGET(kARM))})
+    .Finalize();
@@ -247,6 +247,43 @@ void MatMulCompute::Run() {
   }
 }
 
+void MatMulWeightOnlyCompute::Run() {
+  auto& param = Param<param_t>();
+  auto& ctx = this->ctx_->template As<ARMContext>();
+
+  auto x_dims = param.X->dims();
+  CHECK(!param.transpose_Y);
+  CHECK(!param.transpose_X || x_dims.size() == 2UL)
+      << "The weight-only matmul kernel only supports a 2-D transposed X";
+  int m = 0;
+  int k = 0;
+  if (param.transpose_X) {
+    k = x_dims[0];
+    m = x_dims[1];
+  } else {
+    m = x_dims.Slice(0, x_dims.size() - 1).production();
+    k = x_dims[x_dims.size() - 1];
+  }
+  int n = param.Y->dims()[1];
+  CHECK_EQ(lite::QuantWeightRows(k, param.bit_length), param.Y->dims()[0]);
+  CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(n));
+  lite::arm::math::QuantWeightGemm(param.transpose_X,
+                                   m,
+                                   n,
+                                   k,
+                                   param.alpha,
+                                   param.X->data<float>(),
+                                   param.transpose_X ? m : k,
+                                   param.Y->data<int8_t>(),
+                                   param.weight_scale.data(),
+                                   param.bit_length,
+                                   0.f,
+                                   param.Out->mutable_data<float>(),
+                                   n,
+                                   &panel_,
+                                   &ctx);
+}
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
@@ -258,3 +295,14 @@ REGISTER_LITE_KERNEL(
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(matmul,
+                     kARM,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::arm::MatMulWeightOnlyCompute,
+                     weight_only)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .Finalize();
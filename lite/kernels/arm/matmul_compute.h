@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <vector>
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -36,6 +37,21 @@ class MatMulCompute : public KernelLite<TARGET(kARM), PRECISION(kFloat)> {
   int m_, n_, k_;
 };
 
+// The matmul kernel whose 2-D `Y` is weight-only quantized to 8 or 4 bits,
+// `Y` is never transposed.
+class MatMulWeightOnlyCompute
+    : public KernelLite<TARGET(kARM), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void Run() override;
+
+  virtual ~MatMulWeightOnlyCompute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
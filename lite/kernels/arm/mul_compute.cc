@@ -95,6 +95,33 @@ void MulCompute::Run() {
   }
 }
 
+void MulWeightOnlyCompute::Run() {
+  auto& param = Param<param_t>();
+  auto& ctx = this->ctx_->template As<ARMContext>();
+
+  auto x_dims = param.x->dims();
+  int m = x_dims.Slice(0, param.x_num_col_dims).production();
+  int k = x_dims.Slice(param.x_num_col_dims, x_dims.size()).production();
+  int n = param.y->dims()[1];
+  CHECK_EQ(lite::QuantWeightRows(k, param.bit_length), param.y->dims()[0]);
+  CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(n));
+  lite::arm::math::QuantWeightGemm(false,
+                                   m,
+                                   n,
+                                   k,
+                                   1.f,
+                                   param.x->data<float>(),
+                                   k,
+                                   param.y->data<int8_t>(),
+                                   param.weight_scale.data(),
+                                   param.bit_length,
+                                   0.f,
+                                   param.output->mutable_data<float>(),
+                                   n,
+                                   &panel_,
+                                   &ctx);
+}
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
@@ -106,3 +133,14 @@ REGISTER_LITE_KERNEL(
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(mul,
+                     kARM,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::arm::MulWeightOnlyCompute,
+                     weight_only)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .Finalize();
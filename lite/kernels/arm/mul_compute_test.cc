@@ -175,9 +175,64 @@ TEST(mul_arm, num_col_dims) {
   }
 }
 
+TEST(mul_arm, weight_only) {
+  using T = float;
+  // An odd k spans several dequantized panels of the weights.
+  const int m = 5;
+  const int k = 3001;
+  const int n = 33;
+  for (int bits : {8, 4}) {
+    lite::Tensor x, y_quant, out;
+    x.Resize({m, k});
+    y_quant.Resize({lite::QuantWeightRows(k, bits), n});
+    out.Resize({m, n});
+    std::vector<T> y_data(k * n);
+    std::vector<T> ref_data(m * n);
+
+    auto* x_data = x.mutable_data<T>();
+    FillData<T>(x_data, x.dims().production());
+    FillData<T>(y_data.data(), k * n);
+    std::vector<float> scale(n);
+    lite::QuantizeWeight(y_data.data(),
+                         k,
+                         n,
+                         bits,
+                         y_quant.mutable_data<int8_t>(),
+                         scale.data());
+    // The reference multiplies the dequantized weights.
+    lite::DequantizeWeight(
+        y_quant.data<int8_t>(), scale.data(), 0, k, n, bits, y_data.data());
+
+    MulWeightOnlyCompute mul;
+    operators::MulParam param;
+    param.x = &x;
+    param.y = &y_quant;
+    param.output = &out;
+    param.weight_scale = scale;
+    param.bit_length = bits;
+
+    DeviceInfo::Init();
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<ARMContext>();
+    mul.SetParam(param);
+    mul.SetContext(std::move(ctx));
+    mul.PrepareForRun();
+
+    mul.Run();
+
+    mul_gemm<T>(x_data, m, k, y_data.data(), k, n, ref_data.data());
+
+    auto* out_data = out.data<T>();
+    for (int i = 0; i < out.dims().production(); i++) {
+      EXPECT_NEAR(out_data[i], ref_data[i], 1e-2);
+    }
+  }
+}
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(mul, kARM, kFloat, kNCHW, def);
+USE_LITE_KERNEL(mul, kARM, kInt8, kNCHW, weight_only);
@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #include "lite/kernels/arm/sequence_expand_compute.h"
+#include <numeric>
 #include <vector>
 #include "lite/backends/arm/math/funcs.h"
+#include "lite/core/scratch_arena.h"
 
 namespace paddle {
 namespace lite {
@@ -22,7 +24,7 @@ namespace kernels {
 namespace arm {
 
 void SequenceExpandFunc(const Tensor& x,
-                        const std::vector<uint64_t>& x_lod,
+                        const uint64_t* x_lod,
                         const std::vector<uint64_t>& ref_lod,
                         Tensor* out) {
   uint64_t out_offset = 0;
@@ -74,8 +76,8 @@ void SequenceExpandCompute::Run() {
   auto* y = param.Y;
   auto* out = param.Out;
   int ref_level = param.ref_level;
-  auto x_lod = x->lod();
-  auto y_lod = y->lod();
+  const auto& x_lod = x->lod();
+  const auto& y_lod = y->lod();
 
   if (ref_level == -1) ref_level = y_lod.size() - 1;
 
@@ -85,8 +87,12 @@ void SequenceExpandCompute::Run() {
     return;
   }
 
-  std::vector<uint64_t> out_lod;
   if (x_lod.size() == 1) {
+    // write lod to out if x has lod, in place so the lod keeps its capacity
+    auto* lod = out->mutable_lod();
+    lod->resize(1);
+    auto& out_lod = (*lod)[0];
+    out_lod.clear();
     out_lod.push_back(0);
     uint64_t out_offset = 0;
     for (size_t i = 1; i < y_lod[ref_level].size(); ++i) {
@@ -99,20 +105,17 @@ void SequenceExpandCompute::Run() {
         out_offset++;
       }
     }
-    // write lod to out if x has lod
-    auto& ref_lod = *out->mutable_lod();
-    ref_lod[0] = out_lod;
   }
 
-  std::vector<uint64_t> ref_x_lod;
-  if (x->lod().size() == 1) {
-    ref_x_lod = x->lod()[0];
+  if (x_lod.size() == 1) {
+    SequenceExpandFunc(*x, x_lod[0].data(), y_lod[ref_level], out);
   } else {
-    ref_x_lod.resize(x->dims()[0] + 1);
+    auto& ctx = this->ctx_->template As<ARMContext>();
+    ScratchScope scratch(ctx.scratch_arena());
+    ScratchVector<uint64_t> ref_x_lod(x->dims()[0] + 1, 0, scratch.arena());
     std::iota(ref_x_lod.begin(), ref_x_lod.end(), 0);
+    SequenceExpandFunc(*x, ref_x_lod.data(), y_lod[ref_level], out);
   }
-
-  SequenceExpandFunc(*x, ref_x_lod, y_lod[ref_level], out);
 }
 
 }  // namespace arm
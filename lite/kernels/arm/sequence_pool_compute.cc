@@ -34,7 +34,7 @@ void SequencePoolCompute::Run() {
   float* dout = output->mutable_data<float>();
   int64_t* max_index = param.MaxIndex->mutable_data<int64_t>();
   const auto pool_type = param.pool_type;
-  const auto lod = param.X->lod()[0];
+  const auto& lod = param.X->lod()[0];
 
   int64_t width = param.X->numel() / param.X->dims()[0];
 
@@ -56,12 +56,14 @@ void SequencePoolCompute::Run() {
     LOG(ERROR) << " UNKNOWN sequence pool type";
   }
   int batch_size = lod.size() - 1;
-  std::vector<uint64_t> offset_new(static_cast<uint64_t>(batch_size + 1));
+  // the lod of the output is written in place to keep its capacity
+  auto* out_lod = output->mutable_lod();
+  out_lod->resize(1);
+  auto& offset_new = (*out_lod)[0];
+  offset_new.resize(batch_size + 1);
   for (int i = 0; i <= batch_size; i++) {
     offset_new[i] = i;
   }
-  output->mutable_lod()->clear();
-  output->mutable_lod()->push_back(offset_new);
 }
 
 }  // namespace arm
@@ -22,6 +22,15 @@ namespace host {
 void AssignCompute::Run() {
   auto& param = Param<param_t>();
   if (param.X != nullptr) {
+#ifndef LITE_WITH_FPGA
+    // The buffers shared with other tensors are copied, a move would change
+    // the values seen through them. buffer() returns one more reference.
+    if (param.move_x && param.X->buffer().use_count() == 2 &&
+        param.Out->buffer().use_count() == 2) {
+      param.Out->SwapDataWith(const_cast<Tensor*>(param.X));
+      return;
+    }
+#endif
     param.Out->CopyDataFrom(*param.X);
   } else if (param.X_array != nullptr) {
     auto x_array = param.X_array;
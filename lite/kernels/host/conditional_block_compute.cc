@@ -27,9 +27,6 @@ void ConditionalBlockCompute::PrepareForRun() {
 
 void ConditionalBlockCompute::Run() {
   auto& param = this->Param<param_t>();
-  for (auto& out : param.outs) {
-    out->clear();
-  }
   bool need_run = true;
   if (param.is_scalar_condition) {
     auto* cond = param.cond;
@@ -45,7 +42,21 @@ void ConditionalBlockCompute::Run() {
     }
   }
   if (need_run) {
+    // In the compiled mode, the runs with the same input shapes skip
+    // InferShape of the sub-block.
+    if (compiled_execution_ != param.compiled_execution) {
+      compiled_execution_ = param.compiled_execution;
+      program_->EnableCompiledMode(
+          compiled_execution_ &&
+          CompiledProgram::IsSupported(program_->instructions()));
+    }
+    // The outputs are written by the sub-block in place, so their buffers
+    // are reused by the following runs.
     program_->Run();
+  } else {
+    for (auto& out : param.outs) {
+      out->clear();
+    }
   }
 }
 
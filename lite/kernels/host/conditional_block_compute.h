@@ -36,6 +36,7 @@ class ConditionalBlockCompute
 
  private:
   std::unique_ptr<RuntimeProgram> program_;
+  bool compiled_execution_{false};
 };
 
 }  // namespace host
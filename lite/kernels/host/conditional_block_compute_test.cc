@@ -0,0 +1,104 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/conditional_block_compute.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+// The sub-block 1 computes out = 2 * x.
+void RunConditionalBlock(bool compiled_execution) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  program_desc->AddBlock<cpp::BlockDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->SetIdx(1);
+  block_desc->SetParentIdx(0);
+  auto* op = block_desc->AddOp<cpp::OpDesc>();
+  op->SetType("scale");
+  op->SetInput("X", {"x"});
+  op->SetOutput("Out", {"out"});
+  op->SetAttr("scale", 2.f);
+  op->SetAttr("bias", 0.f);
+  op->SetAttr("bias_after_scale", true);
+  op->SetAttr(kKernelTypeAttr,
+              KernelBase::SerializeKernelType(
+                  "scale",
+                  "def",
+                  Place{TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW)}));
+
+  Scope scope;
+  auto* x = scope.Var("x")->GetMutable<Tensor>();
+  auto* out = scope.Var("out")->GetMutable<Tensor>();
+  Tensor cond;
+  cond.Resize({1});
+  x->Resize({4});
+  auto* x_data = x->mutable_data<float>();
+  for (int i = 0; i < 4; i++) {
+    x_data[i] = static_cast<float>(i);
+  }
+
+  operators::ConditionalBlockParam param;
+  param.cond = &cond;
+  param.inputs = {x};
+  param.outs = {out};
+  param.block_idx = 1;
+  param.program_desc = program_desc;
+  param.exec_scope = &scope;
+  param.is_scalar_condition = true;
+  param.compiled_execution = compiled_execution;
+  ConditionalBlockCompute kernel;
+  kernel.SetParam(param);
+
+  // The runs of the block write the outputs in place, their buffers are
+  // reused.
+  const float* out_data = nullptr;
+  for (int run = 0; run < 3; run++) {
+    x_data[0] = static_cast<float>(run);
+    cond.mutable_data<bool>()[0] = true;
+    kernel.Launch();
+    ASSERT_EQ(out->dims(), DDim({4}));
+    if (out_data) EXPECT_EQ(out->data<float>(), out_data);
+    out_data = out->data<float>();
+    EXPECT_EQ(out_data[0], 2.f * run);
+    for (int i = 1; i < 4; i++) {
+      EXPECT_EQ(out_data[i], 2.f * i);
+    }
+  }
+
+  // The outputs of a skipped block are cleared.
+  cond.mutable_data<bool>()[0] = false;
+  kernel.Launch();
+  EXPECT_FALSE(out->IsInitialized());
+}
+
+TEST(conditional_block_host, reuse_outputs) { RunConditionalBlock(false); }
+
+TEST(conditional_block_host, reuse_outputs_compiled) {
+  RunConditionalBlock(true);
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(conditional_block, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(scale, kHost, kFloat, kNCHW, def);
+USE_LITE_OP(scale);
@@ -0,0 +1,123 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/elementwise_compute.h"
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+// Returns the strides of the tensor in the dims of the output, 0 for the
+// broadcast dims.
+std::vector<int64_t> BroadcastStrides(const DDim& dims,
+                                      const DDim& out_dims,
+                                      int axis) {
+  int rank = static_cast<int>(out_dims.size());
+  int size = static_cast<int>(dims.size());
+  if (size == rank) {
+    axis = 0;
+  } else if (axis < 0) {
+    axis = rank - size;
+  }
+  // The trailing dims of size 1 past the output are dropped.
+  while (size > 0 && axis + size > rank && dims[size - 1] == 1) size--;
+  CHECK_LE(axis + size, rank) << "can't broadcast " << dims << " to "
+                              << out_dims;
+  std::vector<int64_t> strides(rank, 0);
+  int64_t stride = 1;
+  for (int i = size - 1; i >= 0; i--) {
+    if (dims[i] != 1) {
+      CHECK_EQ(dims[i], out_dims[axis + i]) << "can't broadcast " << dims
+                                            << " to " << out_dims;
+      strides[axis + i] = stride;
+    }
+    stride *= dims[i];
+  }
+  return strides;
+}
+
+template <typename Functor>
+void ElementwiseCompute<Functor>::Run() {
+  auto& param = Param<param_t>();
+  auto out_dims = param.Out->dims();
+  auto x_strides = BroadcastStrides(param.X->dims(), out_dims, param.axis);
+  auto y_strides = BroadcastStrides(param.Y->dims(), out_dims, param.axis);
+  const float* x_data = param.X->data<float>();
+  const float* y_data = param.Y->data<float>();
+  float* out_data = param.Out->mutable_data<float>();
+  int rank = static_cast<int>(out_dims.size());
+  std::vector<int64_t> index(rank, 0);
+  int64_t x_offset = 0;
+  int64_t y_offset = 0;
+  Functor functor;
+  for (int64_t i = 0; i < param.Out->numel(); i++) {
+    out_data[i] = functor(x_data[x_offset], y_data[y_offset]);
+    // Moves to the next index of the output, the last dim first.
+    for (int d = rank - 1; d >= 0; d--) {
+      x_offset += x_strides[d];
+      y_offset += y_strides[d];
+      if (++index[d] < out_dims[d]) break;
+      x_offset -= x_strides[d] * out_dims[d];
+      y_offset -= y_strides[d] * out_dims[d];
+      index[d] = 0;
+    }
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+using elementwise_add_float = paddle::lite::kernels::host::ElementwiseCompute<
+    paddle::lite::kernels::host::AddFunctor>;
+REGISTER_LITE_KERNEL(
+    elementwise_add, kHost, kFloat, kNCHW, elementwise_add_float, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .Finalize();
+
+using elementwise_sub_float = paddle::lite::kernels::host::ElementwiseCompute<
+    paddle::lite::kernels::host::SubFunctor>;
+REGISTER_LITE_KERNEL(
+    elementwise_sub, kHost, kFloat, kNCHW, elementwise_sub_float, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .Finalize();
+
+using elementwise_mul_float = paddle::lite::kernels::host::ElementwiseCompute<
+    paddle::lite::kernels::host::MulFunctor>;
+REGISTER_LITE_KERNEL(
+    elementwise_mul, kHost, kFloat, kNCHW, elementwise_mul_float, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .Finalize();
+
+using elementwise_div_float = paddle::lite::kernels::host::ElementwiseCompute<
+    paddle::lite::kernels::host::DivFunctor>;
+REGISTER_LITE_KERNEL(
+    elementwise_div, kHost, kFloat, kNCHW, elementwise_div_float, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .Finalize();
@@ -0,0 +1,56 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+// Broadcasts X and Y to the dims of Out, the one of the lower rank is aligned
+// at axis.
+template <typename Functor>
+class ElementwiseCompute
+    : public KernelLite<TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW)> {
+ public:
+  using param_t = operators::ElementwiseParam;
+
+  void Run() override;
+
+  virtual ~ElementwiseCompute() = default;
+};
+
+struct AddFunctor {
+  float operator()(float x, float y) const { return x + y; }
+};
+
+struct SubFunctor {
+  float operator()(float x, float y) const { return x - y; }
+};
+
+struct MulFunctor {
+  float operator()(float x, float y) const { return x * y; }
+};
+
+struct DivFunctor {
+  float operator()(float x, float y) const { return x / y; }
+};
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
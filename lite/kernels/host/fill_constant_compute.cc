@@ -0,0 +1,66 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/fill_constant_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+template <typename T>
+void Fill(Tensor* out, float value) {
+  auto* data = out->mutable_data<T>();
+  for (int64_t i = 0; i < out->numel(); i++) {
+    data[i] = static_cast<T>(value);
+  }
+}
+
+void FillConstantCompute::Run() {
+  auto& param = Param<param_t>();
+  switch (param.dtype) {
+    case static_cast<int>(lite::core::FluidType::FP32):
+      Fill<float>(param.out, param.value);
+      break;
+    case static_cast<int>(lite::core::FluidType::INT32):
+      Fill<int32_t>(param.out, param.value);
+      break;
+    case static_cast<int>(lite::core::FluidType::INT64):
+      Fill<int64_t>(param.out, param.value);
+      break;
+    case static_cast<int>(lite::core::FluidType::INT8):
+      Fill<int8_t>(param.out, param.value);
+      break;
+    default:
+      LOG(FATAL) << "not supported dtype " << param.dtype;
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fill_constant,
+                     kHost,
+                     kAny,
+                     kNCHW,
+                     paddle::lite::kernels::host::FillConstantCompute,
+                     def)
+    .BindInput("ShapeTensor",
+               {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kInt32))})
+    .BindInput("ShapeTensorList",
+               {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kInt32))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kAny))})
+    .Finalize();
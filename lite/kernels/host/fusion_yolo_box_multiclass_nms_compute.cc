@@ -0,0 +1,284 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/fusion_yolo_box_multiclass_nms_compute.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+#include "lite/backends/host/math/nms.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+namespace {
+
+inline float Sigmoid(float x) { return 1.f / (1.f + expf(-x)); }
+
+// The decoded anchors of an image, the boxes are [num, 4], the scores are
+// [num, class_num] and the indices are the positions of the anchors in the
+// concatenated outputs of the yolo_box ops.
+struct YoloCandidates {
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  std::vector<int> indices;
+
+  int64_t size() const { return static_cast<int64_t>(indices.size()); }
+};
+
+/*
+ * Decodes the anchors of a head of an image like yolo_box. The anchors with
+ * the objectness < conf_thresh have zero scores in yolo_box, and the anchors
+ * with the objectness <= score_threshold have all the scores <= it, so both
+ * are never selected by the NMS and skipped before decoding.
+ */
+void DecodeYoloHead(const float* x,
+                    int h,
+                    int w,
+                    const int* anchors,
+                    int an_num,
+                    int class_num,
+                    int downsample_ratio,
+                    int img_height,
+                    int img_width,
+                    float conf_thresh,
+                    float score_threshold,
+                    int index_offset,
+                    YoloCandidates* candidates) {
+  const int stride = h * w;
+  const int an_stride = (class_num + 5) * stride;
+  const int input_size = downsample_ratio * h;
+  for (int j = 0; j < an_num; j++) {
+    const float* x_an = x + j * an_stride;
+    const float* obj = x_an + 4 * stride;
+    for (int hw = 0; hw < stride; hw++) {
+      float conf = Sigmoid(obj[hw]);
+      if (conf < conf_thresh || conf <= score_threshold) continue;
+      int k = hw / w;
+      int l = hw % w;
+      float cx = (l + Sigmoid(x_an[hw])) * img_width / h;
+      float cy = (k + Sigmoid(x_an[stride + hw])) * img_height / h;
+      float bw = std::exp(x_an[2 * stride + hw]) * anchors[2 * j] * img_width /
+                 input_size;
+      float bh = std::exp(x_an[3 * stride + hw]) * anchors[2 * j + 1] *
+                 img_height / input_size;
+      float x1 = cx - bw / 2;
+      float y1 = cy - bh / 2;
+      float x2 = cx + bw / 2;
+      float y2 = cy + bh / 2;
+      candidates->boxes.push_back(x1 > 0 ? x1 : 0.f);
+      candidates->boxes.push_back(y1 > 0 ? y1 : 0.f);
+      candidates->boxes.push_back(
+          x2 < img_width - 1 ? x2 : static_cast<float>(img_width - 1));
+      candidates->boxes.push_back(
+          y2 < img_height - 1 ? y2 : static_cast<float>(img_height - 1));
+      const float* cls = x_an + 5 * stride + hw;
+      for (int c = 0; c < class_num; c++) {
+        candidates->scores.push_back(conf * Sigmoid(cls[c * stride]));
+      }
+      candidates->indices.push_back(index_offset + j * stride + hw);
+    }
+  }
+}
+
+// The multiclass_nms of the candidates of an image, the indices are the
+// positions in the candidates.
+void CandidatesNMS(const operators::FusionYoloBoxMulticlassNmsParam& param,
+                   const YoloCandidates& candidates,
+                   std::map<int, std::vector<int>>* indices,
+                   int* num_nmsed_out) {
+  const int class_num = param.class_num;
+  const int64_t num = candidates.size();
+  const float* scores = candidates.scores.data();
+  std::vector<std::pair<float, int>> sorted;
+  int num_det = 0;
+  for (int c = 0; c < class_num; c++) {
+    if (c == param.background_label) continue;
+    // The candidates are in the order of the indices, so are the ties.
+    lite::host::math::SelectTopKScores(scores + c,
+                                       num,
+                                       class_num,
+                                       param.score_threshold,
+                                       param.nms_top_k,
+                                       &sorted);
+    if (sorted.empty()) continue;
+    auto& kept = (*indices)[c];
+    lite::host::math::NmsSorted(candidates.boxes.data(),
+                                4,
+                                sorted,
+                                param.nms_threshold,
+                                param.nms_eta,
+                                param.normalized,
+                                &kept);
+    num_det += kept.size();
+  }
+
+  *num_nmsed_out = num_det;
+  int keep_top_k = param.keep_top_k;
+  if (keep_top_k > -1 && num_det > keep_top_k) {
+    // The ties keep the order of the labels and the indices of a label.
+    std::vector<std::pair<float, int>> score_order;
+    std::vector<std::pair<int, int>> label_indices;
+    score_order.reserve(num_det);
+    label_indices.reserve(num_det);
+    for (const auto& it : *indices) {
+      int label = it.first;
+      for (int idx : it.second) {
+        score_order.emplace_back(scores[idx * class_num + label],
+                                 label_indices.size());
+        label_indices.emplace_back(label, idx);
+      }
+    }
+    std::nth_element(score_order.begin(),
+                     score_order.begin() + keep_top_k,
+                     score_order.end(),
+                     lite::host::math::ScoreIndexGreater<int>);
+    score_order.resize(keep_top_k);
+    std::sort(score_order.begin(),
+              score_order.end(),
+              lite::host::math::ScoreIndexGreater<int>);
+    std::map<int, std::vector<int>> new_indices;
+    for (auto& item : score_order) {
+      auto& label_index = label_indices[item.second];
+      new_indices[label_index.first].push_back(label_index.second);
+    }
+    new_indices.swap(*indices);
+    *num_nmsed_out = keep_top_k;
+  }
+}
+
+}  // namespace
+
+void FusionYoloBoxMulticlassNmsCompute::Run() {
+  auto& param = Param<operators::FusionYoloBoxMulticlassNmsParam>();
+  auto* outs = param.Out;
+  auto* index = param.Index;
+  bool return_index = index != nullptr;
+  const int class_num = param.class_num;
+  const int* img_size = param.ImgSize->data<int>();
+  const int64_t batch_size = param.X.front()->dims()[0];
+  const int64_t out_dim = 6;
+
+  // The offsets of the heads in the concatenated boxes.
+  std::vector<int> head_offsets;
+  std::vector<int> anchor_offsets;
+  int num_boxes = 0;
+  int num_anchors = 0;
+  for (size_t s = 0; s < param.X.size(); s++) {
+    auto x_dims = param.X[s]->dims();
+    head_offsets.push_back(num_boxes);
+    anchor_offsets.push_back(num_anchors);
+    num_boxes += param.anchor_nums[s] * x_dims[2] * x_dims[3];
+    num_anchors += param.anchor_nums[s];
+  }
+
+  std::vector<YoloCandidates> all_candidates(batch_size);
+  std::vector<std::map<int, std::vector<int>>> all_indices(batch_size);
+  std::vector<uint64_t> batch_starts = {0};
+  for (int64_t i = 0; i < batch_size; i++) {
+    auto& candidates = all_candidates[i];
+    for (size_t s = 0; s < param.X.size(); s++) {
+      auto x_dims = param.X[s]->dims();
+      int h = x_dims[2];
+      int w = x_dims[3];
+      const float* x =
+          param.X[s]->data<float>() + i * x_dims.production() / batch_size;
+      DecodeYoloHead(x,
+                     h,
+                     w,
+                     param.anchors.data() + 2 * anchor_offsets[s],
+                     param.anchor_nums[s],
+                     class_num,
+                     param.downsample_ratios[s],
+                     img_size[2 * i],
+                     img_size[2 * i + 1],
+                     param.conf_thresh,
+                     param.score_threshold,
+                     head_offsets[s],
+                     &candidates);
+    }
+    int num_nmsed_out = 0;
+    CandidatesNMS(param, candidates, &all_indices[i], &num_nmsed_out);
+    batch_starts.push_back(batch_starts.back() + num_nmsed_out);
+  }
+
+  uint64_t num_kept = batch_starts.back();
+  if (num_kept == 0) {
+    if (return_index) {
+      outs->Resize({0, out_dim});
+      index->Resize({0, 1});
+    } else {
+      outs->Resize({1, 1});
+      float* od = outs->mutable_data<float>();
+      od[0] = -1;
+      batch_starts = {0, 1};
+    }
+  } else {
+    outs->Resize({static_cast<int64_t>(num_kept), out_dim});
+    float* odata = outs->mutable_data<float>();
+    int* oindices = nullptr;
+    if (return_index) {
+      index->Resize({static_cast<int64_t>(num_kept), 1});
+      oindices = index->mutable_data<int>();
+    }
+    int64_t count = 0;
+    for (int64_t i = 0; i < batch_size; i++) {
+      auto& candidates = all_candidates[i];
+      for (const auto& it : all_indices[i]) {
+        int label = it.first;
+        for (int idx : it.second) {
+          float* row = odata + count * out_dim;
+          row[0] = label;
+          row[1] = candidates.scores[idx * class_num + label];
+          std::memcpy(row + 2, &candidates.boxes[idx * 4], 4 * sizeof(float));
+          if (oindices != nullptr) {
+            oindices[count] = i * num_boxes + candidates.indices[idx];
+          }
+          count++;
+        }
+      }
+    }
+  }
+
+  LoD lod;
+  lod.emplace_back(batch_starts);
+  if (return_index) {
+    index->set_lod(lod);
+  }
+  outs->set_lod(lod);
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(
+    fusion_yolo_box_multiclass_nms,
+    kHost,
+    kFloat,
+    kNCHW,
+    paddle::lite::kernels::host::FusionYoloBoxMulticlassNmsCompute,
+    def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindInput("ImgSize",
+               {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kInt32))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindOutput("Index",
+                {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kInt32))})
+    .Finalize();
@@ -0,0 +1,261 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/host/fusion_yolo_box_multiclass_nms_compute.h"
+#include "lite/kernels/host/multiclass_nms_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+inline float Sigmoid(float x) { return 1.f / (1.f + expf(-x)); }
+
+// The yolo_box of a head of an image: writes the boxes [an_num * h * w, 4] of
+// the concatenated boxes, and the scores to the column of each box in the
+// transposed scores [class_num, num_boxes].
+void YoloBoxRef(const float* x,
+                int h,
+                int w,
+                const int* anchors,
+                int an_num,
+                int class_num,
+                int downsample_ratio,
+                int img_height,
+                int img_width,
+                float conf_thresh,
+                int num_boxes,
+                float* boxes,
+                float* scores) {
+  const int stride = h * w;
+  const int an_stride = (class_num + 5) * stride;
+  const int input_size = downsample_ratio * h;
+  for (int j = 0; j < an_num; j++) {
+    const float* x_an = x + j * an_stride;
+    for (int k = 0; k < h; k++) {
+      for (int l = 0; l < w; l++) {
+        int hw = k * w + l;
+        int box = j * stride + hw;
+        float conf = Sigmoid(x_an[4 * stride + hw]);
+        if (conf < conf_thresh) continue;
+        float cx = (l + Sigmoid(x_an[hw])) * img_width / h;
+        float cy = (k + Sigmoid(x_an[stride + hw])) * img_height / h;
+        float bw = std::exp(x_an[2 * stride + hw]) * anchors[2 * j] *
+                   img_width / input_size;
+        float bh = std::exp(x_an[3 * stride + hw]) * anchors[2 * j + 1] *
+                   img_height / input_size;
+        float* b = boxes + box * 4;
+        b[0] = std::max(cx - bw / 2, 0.f);
+        b[1] = std::max(cy - bh / 2, 0.f);
+        b[2] = std::min(cx + bw / 2, static_cast<float>(img_width - 1));
+        b[3] = std::min(cy + bh / 2, static_cast<float>(img_height - 1));
+        for (int c = 0; c < class_num; c++) {
+          scores[c * num_boxes + box] =
+              conf * Sigmoid(x_an[(5 + c) * stride + hw]);
+        }
+      }
+    }
+  }
+}
+
+struct Head {
+  int size;
+  int anchor_num;
+  int downsample_ratio;
+};
+
+// Runs the fused kernel and the yolo_box + concat + multiclass_nms2 of the
+// unfused graph, the outputs must be equal.
+void RunFusedAndUnfused(const std::vector<Head>& heads,
+                        int batch_size,
+                        int class_num,
+                        float conf_thresh,
+                        float score_threshold,
+                        int nms_top_k,
+                        int keep_top_k,
+                        int background_label,
+                        bool normalized,
+                        std::mt19937* rng,
+                        bool with_ties) {
+  std::normal_distribution<float> dist(-1.5f, 2.f);
+  std::vector<Tensor> xs(heads.size());
+  std::vector<int> anchors;
+  std::vector<int> anchor_nums;
+  std::vector<int> downsample_ratios;
+  int num_boxes = 0;
+  for (size_t s = 0; s < heads.size(); s++) {
+    auto& head = heads[s];
+    xs[s].Resize(
+        {batch_size, head.anchor_num * (5 + class_num), head.size, head.size});
+    auto* x_data = xs[s].mutable_data<float>();
+    for (int64_t i = 0; i < xs[s].numel(); i++) {
+      x_data[i] = dist(*rng);
+    }
+    if (with_ties) {
+      // Equal scores and overlapping boxes.
+      for (int64_t i = 0; i + 7 < xs[s].numel(); i += 7) {
+        x_data[i + 3] = x_data[i];
+      }
+    }
+    for (int a = 0; a < head.anchor_num * 2; a++) {
+      anchors.push_back(10 + (*rng)() % 100);
+    }
+    anchor_nums.push_back(head.anchor_num);
+    downsample_ratios.push_back(head.downsample_ratio);
+    num_boxes += head.anchor_num * head.size * head.size;
+  }
+  Tensor img_size;
+  img_size.Resize({batch_size, 2});
+  auto* img_size_data = img_size.mutable_data<int>();
+  for (int i = 0; i < batch_size * 2; i++) {
+    img_size_data[i] = 100 + (*rng)() % 400;
+  }
+
+  // The unfused graph.
+  Tensor boxes, scores, ref_out, ref_index;
+  boxes.Resize({batch_size, num_boxes, 4});
+  scores.Resize({batch_size, class_num, num_boxes});
+  auto* boxes_data = boxes.mutable_data<float>();
+  auto* scores_data = scores.mutable_data<float>();
+  std::fill(boxes_data, boxes_data + boxes.numel(), 0.f);
+  std::fill(scores_data, scores_data + scores.numel(), 0.f);
+  for (int i = 0; i < batch_size; i++) {
+    int box_offset = 0;
+    int anchor_offset = 0;
+    for (size_t s = 0; s < heads.size(); s++) {
+      auto& head = heads[s];
+      YoloBoxRef(xs[s].data<float>() + i * xs[s].numel() / batch_size,
+                 head.size,
+                 head.size,
+                 anchors.data() + 2 * anchor_offset,
+                 head.anchor_num,
+                 class_num,
+                 head.downsample_ratio,
+                 img_size_data[2 * i],
+                 img_size_data[2 * i + 1],
+                 conf_thresh,
+                 num_boxes,
+                 boxes_data + (i * num_boxes + box_offset) * 4,
+                 scores_data + i * class_num * num_boxes + box_offset);
+      box_offset += head.anchor_num * head.size * head.size;
+      anchor_offset += head.anchor_num;
+    }
+  }
+  MulticlassNmsCompute nms;
+  operators::MulticlassNmsParam nms_param;
+  nms_param.bboxes = &boxes;
+  nms_param.scores = &scores;
+  nms_param.out = &ref_out;
+  nms_param.index = &ref_index;
+  nms_param.background_label = background_label;
+  nms_param.score_threshold = score_threshold;
+  nms_param.nms_top_k = nms_top_k;
+  nms_param.nms_threshold = 0.45f;
+  nms_param.nms_eta = 1.f;
+  nms_param.keep_top_k = keep_top_k;
+  nms_param.normalized = normalized;
+  nms.SetParam(nms_param);
+  nms.Run();
+
+  Tensor out, index;
+  FusionYoloBoxMulticlassNmsCompute fused;
+  operators::FusionYoloBoxMulticlassNmsParam param;
+  for (auto& x : xs) {
+    param.X.push_back(&x);
+  }
+  param.ImgSize = &img_size;
+  param.Out = &out;
+  param.Index = &index;
+  param.anchors = anchors;
+  param.anchor_nums = anchor_nums;
+  param.downsample_ratios = downsample_ratios;
+  param.class_num = class_num;
+  param.conf_thresh = conf_thresh;
+  param.background_label = background_label;
+  param.keep_top_k = keep_top_k;
+  param.nms_top_k = nms_top_k;
+  param.score_threshold = score_threshold;
+  param.nms_threshold = 0.45f;
+  param.nms_eta = 1.f;
+  param.normalized = normalized;
+  fused.SetParam(param);
+  fused.Run();
+
+  ASSERT_EQ(out.dims(), ref_out.dims());
+  ASSERT_EQ(index.dims(), ref_index.dims());
+  EXPECT_EQ(out.lod(), ref_out.lod());
+  EXPECT_EQ(index.lod(), ref_index.lod());
+  for (int64_t i = 0; i < out.numel(); i++) {
+    EXPECT_EQ(out.data<float>()[i], ref_out.data<float>()[i]) << i;
+  }
+  for (int64_t i = 0; i < index.numel(); i++) {
+    EXPECT_EQ(index.data<int>()[i], ref_index.data<int>()[i]) << i;
+  }
+}
+
+TEST(fusion_yolo_box_multiclass_nms, compare_with_unfused) {
+  std::mt19937 rng(3);
+  const std::vector<std::vector<Head>> all_heads = {
+      {{5, 3, 32}},
+      {{3, 3, 32}, {6, 3, 16}},
+      {{2, 1, 32}, {4, 2, 16}, {7, 3, 8}}};
+  int num_tests = 0;
+  for (auto& heads : all_heads) {
+    for (int batch_size : {1, 2}) {
+      for (int class_num : {1, 4}) {
+        for (float conf_thresh : {0.f, 0.1f}) {
+          for (float score_threshold : {0.f, 0.05f}) {
+            for (int keep_top_k : {-1, 5}) {
+              RunFusedAndUnfused(heads,
+                                 batch_size,
+                                 class_num,
+                                 conf_thresh,
+                                 score_threshold,
+                                 num_tests % 3 == 0 ? -1 : 10,
+                                 keep_top_k,
+                                 num_tests % 4 - 1,
+                                 num_tests % 2 == 0,
+                                 &rng,
+                                 num_tests % 3 == 1);
+              num_tests++;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// No anchor passes the thresholds: the outputs are empty.
+TEST(fusion_yolo_box_multiclass_nms, empty) {
+  std::mt19937 rng(7);
+  RunFusedAndUnfused(
+      {{3, 2, 32}}, 2, 3, 1.1f, 0.f, -1, -1, -1, true, &rng, false);
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fusion_yolo_box_multiclass_nms, kHost, kFloat, kNCHW, def);
+USE_LITE_KERNEL(multiclass_nms2, kHost, kFloat, kNCHW, def);
@@ -13,10 +13,13 @@
 // limitations under the License.
 
 #include "lite/kernels/host/retinanet_detection_output_compute.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 #include "lite/operators/retinanet_detection_output_op.h"
 
 namespace paddle {
@@ -24,117 +27,32 @@ namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-bool SortScorePairDescend(const std::pair<float, T>& pair1,
-                          const std::pair<float, T>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-bool SortScoreTwoPairDescend(const std::pair<float, std::pair<T, T>>& pair1,
-                             const std::pair<float, std::pair<T, T>>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-static inline void GetMaxScoreIndex(
-    const std::vector<T>& scores,
-    const T threshold,
-    int top_k,
-    std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
-    }
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
-  }
-}
-
-template <class T>
-static inline T BBoxArea(const std::vector<T>& box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static inline T JaccardOverlap(const std::vector<T>& box1,
-                               const std::vector<T>& box2,
-                               const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = std::max(box1[0], box2[0]);
-    const T inter_ymin = std::max(box1[1], box2[1]);
-    const T inter_xmax = std::min(box1[2], box2[2]);
-    const T inter_ymax = std::min(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
 template <class T>
 void NMSFast(const std::vector<std::vector<T>>& cls_dets,
              const T nms_threshold,
              const T eta,
              std::vector<int>* selected_indices) {
   int64_t num_boxes = cls_dets.size();
-  std::vector<std::pair<T, int>> sorted_indices;
+  // [xmin, ymin, xmax, ymax, score] of the boxes
+  std::vector<float> dets(num_boxes * 5);
   for (int64_t i = 0; i < num_boxes; ++i) {
-    sorted_indices.push_back(std::make_pair(cls_dets[i][4], i));
+    std::copy_n(cls_dets[i].begin(), 5, dets.begin() + i * 5);
   }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(
-      sorted_indices.begin(), sorted_indices.end(), SortScorePairDescend<int>);
+  std::vector<std::pair<float, int>> sorted_indices;
+  lite::host::math::SelectTopKScores(dets.data() + 4,
+                                     num_boxes,
+                                     5,
+                                     -std::numeric_limits<float>::infinity(),
+                                     -1,
+                                     &sorted_indices);
   selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-
-        overlap = JaccardOverlap<T>(cls_dets[idx], cls_dets[kept_idx], false);
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
-  }
+  lite::host::math::NmsSorted(dets.data(),
+                              5,
+                              sorted_indices,
+                              nms_threshold,
+                              eta,
+                              false,
+                              selected_indices);
 }
 
 template <class T>
@@ -211,35 +129,38 @@ void MultiClassNMS(const std::map<int, std::vector<std::vector<T>>>& preds,
   int num_det = 0;
   for (int c = 0; c < class_num; ++c) {
     if (static_cast<bool>(preds.count(c))) {
-      const std::vector<std::vector<T>> cls_dets = preds.at(c);
+      const auto& cls_dets = preds.at(c);
       NMSFast(cls_dets, nms_threshold, nms_eta, &(indices[c]));
       num_det += indices[c].size();
     }
   }
 
-  std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
+  // The ties keep the order of the labels and the indices of a label.
+  std::vector<std::pair<float, int>> score_order;
+  std::vector<std::pair<int, int>> label_indices;
   for (const auto& it : indices) {
     int label = it.first;
-    const std::vector<int>& label_indices = it.second;
-    for (size_t j = 0; j < label_indices.size(); ++j) {
-      int idx = label_indices[j];
-      score_index_pairs.push_back(
-          std::make_pair(preds.at(label)[idx][4], std::make_pair(label, idx)));
+    for (int idx : it.second) {
+      score_order.emplace_back(preds.at(label)[idx][4], label_indices.size());
+      label_indices.emplace_back(label, idx);
     }
   }
   // Keep top k results per image.
-  std::stable_sort(score_index_pairs.begin(),
-                   score_index_pairs.end(),
-                   SortScoreTwoPairDescend<int>);
   if (num_det > keep_top_k) {
-    score_index_pairs.resize(keep_top_k);
+    std::nth_element(score_order.begin(),
+                     score_order.begin() + keep_top_k,
+                     score_order.end(),
+                     lite::host::math::ScoreIndexGreater<int>);
+    score_order.resize(keep_top_k);
   }
+  std::sort(score_order.begin(),
+            score_order.end(),
+            lite::host::math::ScoreIndexGreater<int>);
 
   // Store the new indices.
-  std::map<int, std::vector<int>> new_indices;
-  for (const auto& it : score_index_pairs) {
-    int label = it.second.first;
-    int idx = it.second.second;
+  for (const auto& it : score_order) {
+    int label = label_indices[it.second].first;
+    int idx = label_indices[it.second].second;
     std::vector<T> one_pred;
     one_pred.push_back(label);
     one_pred.push_back(preds.at(label)[idx][4]);
@@ -290,7 +211,12 @@ void RetinanetDetectionOutput(
 
     // For the highest level, we take the threshold 0.0
     T threshold = (l < (scores.size() - 1) ? score_threshold : 0.0);
-    GetMaxScoreIndex(scores_data, threshold, nms_top_k, &sorted_indices);
+    lite::host::math::SelectTopKScores(scores_data.data(),
+                                       scores_num,
+                                       1,
+                                       threshold,
+                                       nms_top_k,
+                                       &sorted_indices);
     auto* im_info_data = im_info.data<T>();
     auto im_height = im_info_data[0];
     auto im_width = im_info_data[1];
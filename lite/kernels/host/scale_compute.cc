@@ -0,0 +1,62 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/scale_compute.h"
+#include <algorithm>
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+void ScaleCompute::Run() {
+  auto& param = Param<param_t>();
+  const float* x_data = param.x->data<float>();
+  float* out_data = param.output->mutable_data<float>();
+  float scale = param.scale;
+  float bias = param.bias_after_scale ? param.bias : param.bias * scale;
+  float alpha = param.alpha;
+  int64_t num = param.x->numel();
+  for (int64_t i = 0; i < num; i++) {
+    out_data[i] = x_data[i] * scale + bias;
+  }
+  if (param.activation_type == "relu") {
+    for (int64_t i = 0; i < num; i++) {
+      out_data[i] = std::max(out_data[i], 0.f);
+    }
+  } else if (param.activation_type == "relu6") {
+    for (int64_t i = 0; i < num; i++) {
+      out_data[i] = std::min(std::max(out_data[i], 0.f), alpha);
+    }
+  } else if (param.activation_type == "leaky_relu") {
+    for (int64_t i = 0; i < num; i++) {
+      out_data[i] = out_data[i] > 0.f ? out_data[i] : out_data[i] * alpha;
+    }
+  }
+  if (!param.x->lod().empty()) {
+    param.output->set_lod(param.x->lod());
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(
+    scale, kHost, kFloat, kNCHW, paddle::lite::kernels::host::ScaleCompute, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kHost), PRECISION(kFloat))})
+    .Finalize();
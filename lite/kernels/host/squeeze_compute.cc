@@ -25,7 +25,11 @@ void SqueezeCompute::Run() {
   auto x = param.X;
   auto output = param.Out;
   auto output_dims = output->dims();
-  output->CopyDataFrom(*x);
+  if (param.inplace) {
+    output->ShareDataWith(*x);
+  } else {
+    output->CopyDataFrom(*x);
+  }
   output->Resize(output_dims);
 }
 
@@ -34,7 +38,11 @@ void Squeeze2Compute::Run() {
   auto x = param.X;
   auto output = param.Out;
   auto output_dims = output->dims();
-  output->CopyDataFrom(*x);
+  if (param.inplace) {
+    output->ShareDataWith(*x);
+  } else {
+    output->CopyDataFrom(*x);
+  }
   output->Resize(output_dims);
 }
 
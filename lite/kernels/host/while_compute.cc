@@ -13,8 +13,9 @@
 // limitations under the License.
 
 #include "lite/kernels/host/while_compute.h"
-#include <unordered_map>
-#include <utility>
+#include <map>
+#include <set>
+#include <string>
 
 namespace paddle {
 namespace lite {
@@ -25,12 +26,71 @@ void WhileCompute::PrepareForRun() {
   auto &param = this->Param<param_t>();
   program_.reset(new RuntimeProgram(
       param.program_desc, param.exec_scope, param.block_idx));
+  MoveLoopTemporaries();
 }
+
+void WhileCompute::MoveLoopTemporaries() {
+  auto &param = this->Param<param_t>();
+  auto *block_desc =
+      param.program_desc->GetBlock<cpp::BlockDesc>(param.block_idx);
+  std::set<std::string> block_vars;
+  for (size_t i = 0; i < block_desc->VarsSize(); i++) {
+    auto *var_desc = block_desc->GetVar<cpp::VarDesc>(i);
+    if (!var_desc->Persistable()) block_vars.insert(var_desc->Name());
+  }
+  auto *insts = program_->mutable_instructions();
+  std::map<std::string, int> num_readers;
+  for (auto &inst : *insts) {
+    for (auto &name : inst.op()->op_info()->input_names()) {
+      num_readers[name]++;
+    }
+  }
+  // The temporaries of the block written by an earlier op and only read by
+  // an assign are dead after it, their buffers are moved to the loop-carried
+  // variables.
+  std::set<std::string> written;
+  for (auto &inst : *insts) {
+    auto *op_info = inst.op()->op_info();
+    if (op_info->Type() == "assign" && op_info->HasInput("X") &&
+        op_info->Input("X").size() == 1 && op_info->Output("Out").size() == 1) {
+      auto x = op_info->Input("X").front();
+      auto out = op_info->Output("Out").front();
+      auto &assign_param =
+          inst.mutable_kernel()->Param<operators::AssignParam>();
+      if (assign_param.X != nullptr && x != out && block_vars.count(x) &&
+          written.count(x) && num_readers[x] == 1) {
+        assign_param.move_x = true;
+        VLOG(4) << "while: move " << x << " to " << out;
+      }
+    }
+    for (auto &name : op_info->output_names()) {
+      written.insert(name);
+    }
+  }
+}
+
 void WhileCompute::Run() {
   auto &param = this->Param<param_t>();
+  // The compiled mode follows the option of the predictor, which may be
+  // changed after the program is prepared.
+  if (compiled_execution_ != param.compiled_execution) {
+    compiled_execution_ = param.compiled_execution;
+    program_->EnableCompiledMode(
+        compiled_execution_ &&
+        CompiledProgram::IsSupported(program_->instructions()));
+  }
+  const CompiledProgram *compiled = program_->compiled_program();
+  int64_t iterations = 0;
+  int64_t shape_inferences = 0;
   while (param.cond->data<bool>()[0]) {
     program_->Run();
+    iterations++;
+    if (compiled) shape_inferences += compiled->num_shape_inferences();
   }
+  last_iterations_ = iterations;
+  last_shape_inferences_ = shape_inferences;
+  VLOG(4) << "while: " << iterations << " iterations, " << shape_inferences
+          << " InferShape calls";
 }
 
 }  // namespace host
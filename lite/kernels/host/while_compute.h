@@ -34,10 +34,32 @@ class WhileCompute
   void Run() override;
   void PrepareForRun() override;
 
+  // The iterations of the last run.
+  int64_t last_iterations() const { return last_iterations_; }
+  // The InferShape calls of the sub-block in all the iterations of the last
+  // run, it's 0 if the sub-block doesn't run in the compiled mode.
+  int64_t last_shape_inferences() const { return last_shape_inferences_; }
+
+#ifdef LITE_WITH_PROFILE
+  virtual void SetProfileRuntimeKernelInfo(
+      paddle::lite::profile::OpCharacter* ch) {
+    ch->kernel_func_name = "while";
+    ch->remark = "iterations:" + std::to_string(last_iterations_) +
+                 ",infershape:" + std::to_string(last_shape_inferences_);
+  }
+#endif
+
   virtual ~WhileCompute() = default;
 
  private:
+  // Sets AssignParam::move_x of the assign ops of the sub-block which copy
+  // a dead temporary to a loop-carried variable.
+  void MoveLoopTemporaries();
+
   std::unique_ptr<RuntimeProgram> program_;
+  bool compiled_execution_{false};
+  int64_t last_iterations_{0};
+  int64_t last_shape_inferences_{0};
 };
 
 }  // namespace host
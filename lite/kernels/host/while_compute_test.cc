@@ -0,0 +1,154 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/while_compute.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+// The loop of the sub-block 1 doubles the length of x in each iteration:
+//   tmp = expand(x, 2); x = assign(tmp); i = i + 1; cond = i < n
+class WhileComputeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    program_desc_ = std::make_shared<cpp::ProgramDesc>();
+    program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->SetIdx(1);
+    block_desc_->SetParentIdx(0);
+    auto* tmp = block_desc_->AddVar<cpp::VarDesc>();
+    tmp->SetName("tmp");
+    tmp->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    tmp->SetPersistable(false);
+    for (auto name : {"x", "tmp", "i", "n", "cond"}) {
+      scope_.Var(name)->GetMutable<Tensor>();
+    }
+
+    auto* expand = AddOp("expand", "def", "x", "tmp", PRECISION(kFloat));
+    expand->SetAttr("expand_times", std::vector<int>{2});
+    AddOp("assign", "def", "tmp", "x", PRECISION(kAny));
+    auto* scale = AddOp("scale", "def", "i", "i", PRECISION(kFloat));
+    scale->SetAttr("scale", 1.f);
+    scale->SetAttr("bias", 1.f);
+    scale->SetAttr("bias_after_scale", true);
+    auto* less_than = AddOp("less_than", "def", "i", "cond", PRECISION(kFloat));
+    less_than->SetInput("Y", {"n"});
+    less_than->SetAttr("axis", -1);
+    less_than->SetAttr("force_cpu", false);
+
+    param_.cond = Var("cond");
+    param_.block_idx = 1;
+    param_.program_desc = program_desc_;
+    param_.exec_scope = &scope_;
+  }
+
+  cpp::OpDesc* AddOp(const std::string& type,
+                     const std::string& alias,
+                     const std::string& x,
+                     const std::string& out,
+                     PrecisionType precision) {
+    auto* op = block_desc_->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    op->SetInput("X", {x});
+    op->SetOutput("Out", {out});
+    DataLayoutType layout =
+        type == "scale" ? DATALAYOUT(kNCHW) : DATALAYOUT(kAny);
+    op->SetAttr(kKernelTypeAttr,
+                KernelBase::SerializeKernelType(
+                    type, alias, Place{TARGET(kHost), precision, layout}));
+    return op;
+  }
+
+  Tensor* Var(const std::string& name) {
+    return scope_.FindVar(name)->GetMutable<Tensor>();
+  }
+
+  // x = [1, 2], i = 0, the loop runs n times.
+  void Reset(float n) {
+    auto* x = Var("x");
+    x->Resize({2});
+    auto* x_data = x->mutable_data<float>();
+    x_data[0] = 1.f;
+    x_data[1] = 2.f;
+    Var("i")->Resize({1});
+    Var("i")->mutable_data<float>()[0] = 0.f;
+    Var("n")->Resize({1});
+    Var("n")->mutable_data<float>()[0] = n;
+    Var("cond")->Resize({1});
+    Var("cond")->mutable_data<bool>()[0] = true;
+  }
+
+  void CheckLoop(WhileCompute* kernel, int iterations) {
+    Reset(iterations);
+    kernel->Launch();
+    EXPECT_EQ(kernel->last_iterations(), iterations);
+    int64_t size = 2 << iterations;
+    auto* x = Var("x");
+    ASSERT_EQ(x->dims(), DDim({size}));
+    for (int64_t k = 0; k < size; k++) {
+      EXPECT_EQ(x->data<float>()[k], static_cast<float>(k % 2 + 1));
+    }
+    // tmp is moved to x, so it holds the buffer of x before the last
+    // iteration.
+    EXPECT_EQ(Var("tmp")->memory_size(), size / 2 * sizeof(float));
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  cpp::BlockDesc* block_desc_{nullptr};
+  Scope scope_;
+  operators::WhileParam param_;
+};
+
+TEST_F(WhileComputeTest, grow_loop_carried) {
+  WhileCompute kernel;
+  kernel.SetParam(param_);
+  CheckLoop(&kernel, 3);
+  CheckLoop(&kernel, 5);
+  EXPECT_EQ(kernel.last_shape_inferences(), 0);
+}
+
+TEST_F(WhileComputeTest, grow_loop_carried_compiled) {
+  param_.compiled_execution = true;
+  WhileCompute kernel;
+  kernel.SetParam(param_);
+  CheckLoop(&kernel, 3);
+  // The shape of x changes in each iteration, expand and assign infer it
+  // again.
+  EXPECT_GT(kernel.last_shape_inferences(), 0);
+  CheckLoop(&kernel, 5);
+  EXPECT_GT(kernel.last_shape_inferences(), 0);
+  CheckLoop(&kernel, 1);
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(while, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(expand, kHost, kFloat, kAny, def);
+USE_LITE_KERNEL(assign, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(scale, kHost, kFloat, kNCHW, def);
+USE_LITE_KERNEL(less_than, kHost, kFloat, kAny, def);
+USE_LITE_OP(expand);
+USE_LITE_OP(assign);
+USE_LITE_OP(scale);
+USE_LITE_OP(less_than);
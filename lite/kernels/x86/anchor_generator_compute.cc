@@ -0,0 +1,67 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/anchor_generator_compute.h"
+#include "lite/backends/x86/math/prior_box.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void AnchorGeneratorCompute::ReInitWhenNeeded() {
+  auto& param = this->template Param<param_t>();
+  auto input_dims = param.Input->dims();
+  if (last_input_shape_ == input_dims) {
+    return;
+  }
+  const int height = input_dims[2];
+  const int width = input_dims[3];
+  int64_t num_anchors = param.aspect_ratios.size() * param.anchor_sizes.size();
+  DDim out_dims({height, width, num_anchors, 4});
+  anchors_.Resize(out_dims);
+  variances_.Resize(out_dims);
+  lite::x86::math::AnchorGenerator(height,
+                                   width,
+                                   param.anchor_sizes,
+                                   param.aspect_ratios,
+                                   param.stride,
+                                   param.variances,
+                                   param.offset,
+                                   anchors_.mutable_data<float>(),
+                                   variances_.mutable_data<float>());
+  last_input_shape_ = input_dims;
+}
+
+void AnchorGeneratorCompute::Run() {
+  auto& param = this->template Param<param_t>();
+  param.Anchors->CopyDataFrom(anchors_);
+  param.Variances->CopyDataFrom(variances_);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(anchor_generator,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::AnchorGeneratorCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Anchors", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Variances", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
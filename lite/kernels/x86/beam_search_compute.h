@@ -0,0 +1,60 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/backends/host/math/beam_search.h"
+#include "lite/backends/x86/math/beam_search.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+class BeamSearchCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::BeamSearchParam;
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<param_t>();
+    lite::x86::math::BeamSearchFunctor<TARGET(kX86), float> beam_search;
+    beam_search(context,
+                param.pre_ids,
+                param.pre_scores,
+                param.ids,
+                param.scores,
+                param.selected_ids,
+                param.selected_scores,
+                param.parent_idx,
+                param.level,
+                param.beam_size,
+                param.end_id,
+                param.is_accumulated,
+                &searcher_);
+  }
+
+  virtual ~BeamSearchCompute() = default;
+
+ private:
+  // The candidate pools are reused by the steps of the decoding loop.
+  lite::host::math::BeamSearcher searcher_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,51 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/backends/host/math/beam_search_decode.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+class BeamSearchDecodeCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::BeamSearchDecodeParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    // Only the float scores are supported.
+    lite::host::math::BeamSearchDecode<float>(*param.ids,
+                                              *param.scores,
+                                              param.beam_size,
+                                              param.end_id,
+                                              param.sentence_ids,
+                                              param.sentence_scores);
+    // The steps are cleared when the decoding finishes.
+    param.ids->clear();
+    param.scores->clear();
+  }
+
+  virtual ~BeamSearchDecodeCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
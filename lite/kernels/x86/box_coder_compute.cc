@@ -0,0 +1,186 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/box_coder_compute.h"
+#include <cmath>
+#include <string>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+// The boxes of a parallel task.
+const int64_t kBoxGrain = 256;
+
+const float kUnitVariance[4] = {1.f, 1.f, 1.f, 1.f};
+
+/*
+ * The variances of the prior j are var + j * var_stride, so the variances of
+ * PriorBoxVar, of the attribute(stride 0) and the unit ones(stride 0) are
+ * handled by the same branch-free loop.
+ */
+void EncodeCenterSize(const float* target_box,
+                      const float* prior_box,
+                      const float* var,
+                      int64_t var_stride,
+                      int64_t row,
+                      int64_t col,
+                      int64_t len,
+                      bool normalized,
+                      float* output) {
+  const float norm = normalized ? 0.f : 1.f;
+  lite::x86::RunParallelFor(
+      0,
+      row * col,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t k = begin; k < end; ++k) {
+          int64_t i = k / col;
+          int64_t j = k % col;
+          const float* prior = prior_box + j * len;
+          const float* target = target_box + i * len;
+          const float* v = var + j * var_stride;
+          float* out = output + k * len;
+          float prior_w = prior[2] - prior[0] + norm;
+          float prior_h = prior[3] - prior[1] + norm;
+          float prior_cx = prior[0] + prior_w / 2;
+          float prior_cy = prior[1] + prior_h / 2;
+          float target_cx = (target[2] + target[0]) / 2;
+          float target_cy = (target[3] + target[1]) / 2;
+          float target_w = target[2] - target[0] + norm;
+          float target_h = target[3] - target[1] + norm;
+          out[0] = (target_cx - prior_cx) / prior_w / v[0];
+          out[1] = (target_cy - prior_cy) / prior_h / v[1];
+          out[2] = std::log(std::fabs(target_w / prior_w)) / v[2];
+          out[3] = std::log(std::fabs(target_h / prior_h)) / v[3];
+        }
+      },
+      kBoxGrain);
+}
+
+// The prior of the box(i, j) is the j-th one if axis is 0, or the i-th one.
+void DecodeCenterSize(const float* target_box,
+                      const float* prior_box,
+                      const float* var,
+                      int64_t var_stride,
+                      int64_t row,
+                      int64_t col,
+                      int64_t len,
+                      int axis,
+                      bool normalized,
+                      float* output) {
+  const float norm = normalized ? 0.f : 1.f;
+  lite::x86::RunParallelFor(
+      0,
+      row * col,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t k = begin; k < end; ++k) {
+          int64_t prior_id = axis == 0 ? k % col : k / col;
+          const float* prior = prior_box + prior_id * len;
+          const float* target = target_box + k * len;
+          const float* v = var + prior_id * var_stride;
+          float* out = output + k * len;
+          float prior_w = prior[2] - prior[0] + norm;
+          float prior_h = prior[3] - prior[1] + norm;
+          float prior_cx = prior[0] + prior_w / 2;
+          float prior_cy = prior[1] + prior_h / 2;
+          float target_cx = v[0] * target[0] * prior_w + prior_cx;
+          float target_cy = v[1] * target[1] * prior_h + prior_cy;
+          float target_w = std::exp(v[2] * target[2]) * prior_w;
+          float target_h = std::exp(v[3] * target[3]) * prior_h;
+          out[0] = target_cx - target_w / 2;
+          out[1] = target_cy - target_h / 2;
+          out[2] = target_cx + target_w / 2 - norm;
+          out[3] = target_cy + target_h / 2 - norm;
+        }
+      },
+      kBoxGrain);
+}
+
+}  // namespace
+
+void BoxCoderCompute::Run() {
+  auto& param = Param<operators::BoxCoderParam>();
+  auto* prior_box = param.prior_box;
+  auto* prior_box_var = param.prior_box_var;
+  auto* target_box = param.target_box;
+  auto* output_box = param.proposals;
+  const std::string& code_type = param.code_type;
+  bool normalized = param.box_normalized;
+
+  auto row = target_box->dims()[0];
+  auto col = prior_box->dims()[0];
+  if (code_type == "decode_center_size") {
+    col = target_box->dims()[1];
+  }
+  auto len = prior_box->dims()[1];
+  output_box->Resize({row, col, len});
+  auto* output = output_box->mutable_data<float>();
+
+  const float* var = kUnitVariance;
+  int64_t var_stride = 0;
+  if (prior_box_var) {
+    var = prior_box_var->data<float>();
+    var_stride = len;
+  } else if (!param.variance.empty()) {
+    CHECK_EQ(param.variance.size(), 4UL);
+    var = param.variance.data();
+  }
+
+  if (code_type == "encode_center_size") {
+    EncodeCenterSize(target_box->data<float>(),
+                     prior_box->data<float>(),
+                     var,
+                     var_stride,
+                     row,
+                     col,
+                     len,
+                     normalized,
+                     output);
+  } else if (code_type == "decode_center_size") {
+    DecodeCenterSize(target_box->data<float>(),
+                     prior_box->data<float>(),
+                     var,
+                     var_stride,
+                     row,
+                     col,
+                     len,
+                     param.axis,
+                     normalized,
+                     output);
+  } else {
+    LOG(FATAL) << "not supported type: " << code_type;
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(box_coder,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::BoxCoderCompute,
+                     def)
+    .BindInput("PriorBox", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("PriorBoxVar", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("TargetBox", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("OutputBox", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,85 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/calib_compute.h"
+#include "lite/backends/x86/math/half_gemm.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/type_system.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void CalibComputeFp32ToFp16::Run() {
+  auto& param = this->Param<operators::CalibParam>();
+  const auto* din = param.input->data<float>();
+  auto* dout = param.output->mutable_data<float16>();
+  param.output->set_precision(PRECISION(kFP16));
+  lite::x86::math::FloatToHalf(din, dout, param.input->numel());
+}
+
+void CalibComputeFp16ToFp32::Run() {
+  auto& param = this->Param<operators::CalibParam>();
+  const auto* din = param.input->data<float16>();
+  auto* dout = param.output->mutable_data<float>();
+  lite::x86::math::HalfToFloat(din, dout, param.input->numel());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(calib,
+                     kX86,
+                     kFP16,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeFp32ToFp16,
+                     fp32_to_fp16)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFP16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(calib,
+                     kX86,
+                     kFP16,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeFp16ToFp32,
+                     fp16_to_fp32)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFP16))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(calib_once,
+                     kX86,
+                     kFP16,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeFp32ToFp16,
+                     fp32_to_fp16)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFP16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(calib_once,
+                     kX86,
+                     kFP16,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeFp16ToFp32,
+                     fp16_to_fp32)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFP16))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
@@ -15,9 +15,12 @@
 
 #include <Eigen/Core>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/half_gemm.h"
 #include "lite/backends/x86/math/im2col.h"
+#include "lite/backends/x86/math/quant_weight_gemm.h"
 #include "lite/backends/x86/math/vol2col.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
@@ -44,13 +47,73 @@ inline bool IsExpand(const std::vector<int64_t>& filter_dim,
   return !(filter_1 && strides_1 && padding_0 && dilation_1);
 }
 
+// out = filter * col, the filter is a [out_channels, k] matrix. `panel` is
+// the buffer of the fp16 filters converted to fp32.
 template <typename T>
-class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+inline void ConvGemm(const X86Context& context,
+                     const lite::Tensor& filter,
+                     const lite::Tensor& col,
+                     lite::Tensor* out,
+                     std::vector<float>* panel) {
+  auto blas =
+      paddle::lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+  blas.MatMul(filter, false, col, false, T(1.0), out, T(0.0));
+}
+
+template <>
+inline void ConvGemm<float16>(const X86Context& context,
+                              const lite::Tensor& filter,
+                              const lite::Tensor& col,
+                              lite::Tensor* out,
+                              std::vector<float>* panel) {
+  int M = filter.dims()[0];
+  int K = filter.dims()[1];
+  int N = col.dims()[1];
+  paddle::lite::x86::math::HalfWeightGemm(context,
+                                          false,
+                                          false,
+                                          M,
+                                          N,
+                                          K,
+                                          1.f,
+                                          filter.data<float16>(),
+                                          K,
+                                          col.data<float>(),
+                                          N,
+                                          0.f,
+                                          out->mutable_data<float>(),
+                                          N,
+                                          panel);
+}
+
+// out[n, c, :] += bias[c], the bias is folded from the elementwise_add or the
+// batch_norm after the conv.
+template <typename T>
+inline void AddChannelBias(
+    const T* bias, int batch_size, int64_t channels, int64_t size, T* out) {
+  for (int n = 0; n < batch_size; n++) {
+    for (int64_t c = 0; c < channels; c++) {
+      T b = bias[c];
+      for (int64_t i = 0; i < size; i++) {
+        out[i] += b;
+      }
+      out += size;
+    }
+  }
+}
+
+// With `Precision` kFP16 the filter is stored in fp16 while the input and the
+// output stay in `T`.
+template <typename T, PrecisionType Precision = PRECISION(kFloat)>
+class Conv2dCompute : public KernelLite<TARGET(kX86), Precision> {
  public:
   using param_t = operators::ConvParam;
+  using filter_t = typename std::
+      conditional<Precision == PRECISION(kFP16), float16, T>::type;
+
   void Run() override {
-    auto& context = ctx_->As<X86Context>();
-    auto& param = *param_.get_mutable<operators::ConvParam>();
+    auto& context = this->ctx_->template As<X86Context>();
+    auto& param = *this->param_.template get_mutable<operators::ConvParam>();
     lite::Tensor filter = *param.filter;
     param.output->template mutable_data<T>();
     const int batch_size = static_cast<int>(param.x->dims()[0]);
@@ -92,8 +155,6 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
         lite::TargetType::kX86,
         T>
         im2col;
-    auto blas =
-        paddle::lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     for (int i = 0; i < batch_size; i++) {
       lite::Tensor in_batch = param.x->template Slice<T>(i, i + 1);
       in_batch.Resize(input_shape);
@@ -134,20 +195,108 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
                                static_cast<int64_t>((g + 1) * out_step));
         lite::Tensor filter_slice;
         filter_slice =
-            filter.Slice<T>(static_cast<int64_t>(g * out_step),
-                            static_cast<int64_t>((g + 1) * out_step));
-        blas.MatMul(filter_slice,
-                    false,
-                    col_matrix,
-                    false,
-                    T(1.0),
-                    &(out_slice),
-                    T(0.0));
+            filter.Slice<filter_t>(static_cast<int64_t>(g * out_step),
+                                   static_cast<int64_t>((g + 1) * out_step));
+        ConvGemm<filter_t>(
+            context, filter_slice, col_matrix, &(out_slice), &panel_);
       }
     }
+    if (param.bias) {
+      AddChannelBias(param.bias->template data<T>(),
+                     batch_size,
+                     param.output->dims()[1],
+                     output_matrix_shape[1],
+                     param.output->template mutable_data<T>());
+    }
   }
 
   virtual ~Conv2dCompute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
+// The conv2d kernel without groups whose filter is weight-only quantized to 8
+// or 4 bits. The filter holds the [C * kh * kw, out_channels] weights in the
+// layout of lite/utils/weight_quant.h, see weight_only_quantization_pass.
+class Conv2dWeightOnlyCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::ConvParam;
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::ConvParam>();
+    CHECK_EQ(param.groups, 1);
+    auto x_dims = param.x->dims();
+    auto filter_dims = param.filter->dims();
+    auto out_dims = param.output->dims();
+    CHECK_EQ(x_dims.size(), 4UL);
+    const int batch_size = static_cast<int>(x_dims[0]);
+    int M = static_cast<int>(out_dims[1]);
+    int K = static_cast<int>(x_dims[1] * filter_dims[2] * filter_dims[3]);
+    int N = static_cast<int>(out_dims[2] * out_dims[3]);
+    CHECK_EQ(lite::QuantWeightRows(K, param.bit_length) * M,
+             filter_dims.production());
+    CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(M));
+
+    std::vector<int64_t> col_shape{
+        x_dims[1], filter_dims[2], filter_dims[3], out_dims[2], out_dims[3]};
+    bool is_expand = IsExpand(filter_dims.Vectorize(),
+                              param.strides,
+                              *param.paddings,
+                              *param.dilations);
+    if (is_expand) {
+      col_.Resize(col_shape);
+    }
+    auto paddings = *param.paddings;
+    paddle::lite::x86::math::Im2ColFunctor<
+        paddle::lite::x86::math::ColFormat::kCFO,
+        lite::TargetType::kX86,
+        float>
+        im2col;
+    lite::DDim input_shape = x_dims.Slice(1, x_dims.size());
+    float* out_data = param.output->mutable_data<float>();
+    for (int i = 0; i < batch_size; i++) {
+      lite::Tensor in_batch = param.x->Slice<float>(i, i + 1);
+      in_batch.Resize(input_shape);
+      const float* col_data = in_batch.data<float>();
+      if (is_expand) {
+        im2col(context,
+               in_batch,
+               *param.dilations,
+               param.strides,
+               std::vector<int>{
+                   paddings[0], paddings[2], paddings[0], paddings[2]},
+               &col_);
+        col_data = col_.data<float>();
+      }
+      float* out_batch = out_data + static_cast<int64_t>(M) * N * i;
+      lite::x86::math::QuantWeightGemm(context,
+                                       M,
+                                       N,
+                                       K,
+                                       1.f,
+                                       param.filter->data<int8_t>(),
+                                       param.weight_scale.data(),
+                                       param.bit_length,
+                                       col_data,
+                                       N,
+                                       0.f,
+                                       out_batch,
+                                       N,
+                                       &panel_);
+    }
+    if (param.bias) {
+      AddChannelBias(param.bias->data<float>(), batch_size, M, N, out_data);
+    }
+  }
+
+  virtual ~Conv2dWeightOnlyCompute() = default;
+
+ private:
+  lite::Tensor col_;
+  std::vector<float> panel_;
 };
 
 }  // namespace x86
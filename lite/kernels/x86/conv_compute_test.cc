@@ -45,7 +45,7 @@ TEST(conv2d_x86, run_test) {
   x.Resize(lite::DDim(x_shape));
   std::vector<int64_t> filter_shape{1, 3, 3, 3};
   filter.Resize(lite::DDim(filter_shape));
-  std::vector<int64_t> b_shape{1, 3, 1, 1};
+  std::vector<int64_t> b_shape{1};
   b.Resize(lite::DDim(b_shape));
   std::vector<int64_t> out_shape{batch_size, 1, 1, 1};
   out.Resize(lite::DDim(out_shape));
@@ -62,7 +62,7 @@ TEST(conv2d_x86, run_test) {
     filter_data[i] = 1;
   }
   for (int64_t i = 0; i < b.dims().production(); i++) {
-    b_data[i] = 0;
+    b_data[i] = 0.5;
   }
 
   Conv2dCompute<float> conv2d;
@@ -86,15 +86,101 @@ TEST(conv2d_x86, run_test) {
   conv2d.Run();
 
   LOG(INFO) << "output: ";
-  float ref_result[1] = {27.};
+  float ref_result[1] = {27.5};
   for (int i = 0; i < out.dims().production(); i++) {
     EXPECT_NEAR(out_data[i], ref_result[i], 1e-5);
   }
 }
 
+TEST(conv2d_x86, run_weight_only_test) {
+  // K = 256 * 3 * 3 spans two dequantized panels of the 40 output channels.
+  const int batch_size = 2;
+  const int C = 256;
+  const int M = 40;
+  const int K = C * 3 * 3;
+  for (int bits : {8, 4}) {
+    lite::Tensor x, filter, filter_quant, b, out, out_ref;
+    x.Resize({batch_size, C, 6, 6});
+    filter.Resize({M, C, 3, 3});
+    filter_quant.Resize({M, lite::QuantWeightRows(K, bits) / 9, 3, 3});
+    b.Resize({M});
+    out.Resize({batch_size, M, 6, 6});
+    out_ref.Resize({batch_size, M, 6, 6});
+    auto* x_data = x.mutable_data<float>();
+    auto* filter_data = filter.mutable_data<float>();
+    auto* b_data = b.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>(i % 7) * 0.1f - 0.3f;
+    }
+    for (int64_t i = 0; i < b.numel(); i++) {
+      b_data[i] = static_cast<float>(i) * 0.01f;
+    }
+    // The quantized filter holds the [K, M] weights, the reference runs the
+    // dequantized ones.
+    std::vector<float> w(K * M);
+    for (int k = 0; k < K; k++) {
+      for (int m = 0; m < M; m++) {
+        w[k * M + m] = static_cast<float>((k + m) % 11) * 0.05f - 0.25f;
+      }
+    }
+    std::vector<float> scale(M);
+    lite::QuantizeWeight(w.data(),
+                         K,
+                         M,
+                         bits,
+                         filter_quant.mutable_data<int8_t>(),
+                         scale.data());
+    lite::DequantizeWeight(
+        filter_quant.data<int8_t>(), scale.data(), 0, K, M, bits, w.data());
+    for (int k = 0; k < K; k++) {
+      for (int m = 0; m < M; m++) {
+        filter_data[m * K + k] = w[k * M + m];
+      }
+    }
+
+    operators::ConvParam param;
+    param.x = &x;
+    param.filter = &filter;
+    param.bias = &b;
+    param.output = &out_ref;
+    param.strides = {1, 1};
+    param.groups = 1;
+    std::vector<int> paddings = {1, 1, 1, 1};
+    std::vector<int> dilations = {1, 1};
+    param.paddings = std::make_shared<std::vector<int>>(paddings);
+    param.dilations = std::make_shared<std::vector<int>>(dilations);
+    Conv2dCompute<float> conv2d;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    conv2d.SetContext(std::move(ctx));
+    conv2d.SetParam(param);
+    conv2d.Run();
+
+    param.filter = &filter_quant;
+    param.output = &out;
+    param.weight_scale = scale;
+    param.bit_length = bits;
+    Conv2dWeightOnlyCompute conv2d_quant;
+    std::unique_ptr<KernelContext> ctx_quant(new KernelContext);
+    ctx_quant->As<X86Context>();
+    conv2d_quant.SetContext(std::move(ctx_quant));
+    conv2d_quant.SetParam(param);
+    // The second run reuses the columns and the panel of the kernel.
+    for (int repeat = 0; repeat < 2; repeat++) {
+      conv2d_quant.Run();
+      auto* out_data = out.data<float>();
+      auto* out_ref_data = out_ref.data<float>();
+      for (int64_t i = 0; i < out.numel(); i++) {
+        EXPECT_NEAR(out_data[i], out_ref_data[i], 1e-3);
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, weight_only);
@@ -0,0 +1,214 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/conv_transpose_compute.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+inline bool InRange(int a, int b) {
+  return static_cast<unsigned>(a) < static_cast<unsigned>(b);
+}
+
+// Accumulates the [kh * kw, in_h * in_w] columns of a channel into the
+// zeroed image of the channel.
+void Col2ImChannel(const float* col,
+                   int height,
+                   int width,
+                   int in_h,
+                   int in_w,
+                   int kernel_h,
+                   int kernel_w,
+                   int pad_top,
+                   int pad_left,
+                   int stride_h,
+                   int stride_w,
+                   int dilation_h,
+                   int dilation_w,
+                   float* im) {
+  memset(im, 0, sizeof(float) * height * width);
+  for (int kr = 0; kr < kernel_h; kr++) {
+    for (int kc = 0; kc < kernel_w; kc++) {
+      int row = -pad_top + kr * dilation_h;
+      for (int ir = 0; ir < in_h; ir++, row += stride_h, col += in_w) {
+        if (!InRange(row, height)) continue;
+        float* im_row = im + row * width;
+        int c = -pad_left + kc * dilation_w;
+        // The columns inside the image are a contiguous range of ic.
+        int ic_begin = 0;
+        while (ic_begin < in_w && c + ic_begin * stride_w < 0) ic_begin++;
+        int ic_end = in_w;
+        while (ic_end > ic_begin && c + (ic_end - 1) * stride_w >= width) {
+          ic_end--;
+        }
+        for (int ic = ic_begin; ic < ic_end; ic++) {
+          im_row[c + ic * stride_w] += col[ic];
+        }
+      }
+    }
+  }
+}
+
+void BiasActivation(const float* bias,
+                    const operators::ActivationParam& act,
+                    int64_t size,
+                    float* out) {
+  const float b = bias ? *bias : 0.f;
+  if (bias) {
+    for (int64_t i = 0; i < size; i++) out[i] += b;
+  }
+  if (!act.has_active) return;
+  switch (act.active_type) {
+    case lite_api::ActivationType::kRelu:
+      for (int64_t i = 0; i < size; i++) out[i] = std::max(out[i], 0.f);
+      break;
+    case lite_api::ActivationType::kRelu6: {
+      const float threshold = act.Relu_clipped_coef;
+      for (int64_t i = 0; i < size; i++) {
+        out[i] = std::min(std::max(out[i], 0.f), threshold);
+      }
+      break;
+    }
+    case lite_api::ActivationType::kLeakyRelu: {
+      const float alpha = act.Leaky_relu_alpha;
+      for (int64_t i = 0; i < size; i++) {
+        out[i] = out[i] > 0.f ? out[i] : out[i] * alpha;
+      }
+      break;
+    }
+    default:
+      LOG(FATAL) << "Unsupported activation of conv2d_transpose: "
+                 << static_cast<int>(act.active_type);
+  }
+}
+
+}  // namespace
+
+/*
+ * The filter of a group is a [k, m] matrix with k = chin / group and
+ * m = chout / group * kh * kw, so the columns of a group are the GEMM of the
+ * transposed filter and the input, [m, k] * [k, hin * win]. The columns are
+ * scattered back to the output channel by channel in parallel, the bias and
+ * the activation are applied while the channel is in cache.
+ */
+void Conv2DTransposeCompute::Run() {
+  auto& ctx = this->ctx_->template As<X86Context>();
+  auto& param = this->Param<param_t>();
+  auto x_dims = param.x->dims();
+  auto o_dims = param.output->dims();
+  auto w_dims = param.filter->dims();
+  const int num = x_dims[0];
+  const int chin = x_dims[1];
+  const int hin = x_dims[2];
+  const int win = x_dims[3];
+  const int chout = o_dims[1];
+  const int hout = o_dims[2];
+  const int wout = o_dims[3];
+  const int kh = w_dims[2];
+  const int kw = w_dims[3];
+  const int group = param.groups;
+  auto paddings = *param.paddings;
+  auto dilations = *param.dilations;
+  const int m = chout / group * kh * kw;
+  const int n = hin * win;
+  const int k = chin / group;
+  const bool is_1x1 = kh == 1 && kw == 1 && param.strides[0] == 1 &&
+                      param.strides[1] == 1 && paddings[0] == 0 &&
+                      paddings[1] == 0 && paddings[2] == 0 &&
+                      paddings[3] == 0 && dilations[0] == 1 &&
+                      dilations[1] == 1;
+  const float* din = param.x->data<float>();
+  const float* weights = param.filter->data<float>();
+  const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+  float* dout = param.output->mutable_data<float>();
+  auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, float>(ctx);
+  float* col = dout;
+  if (!is_1x1) {
+    col_.Resize({group * m, n});
+    col = col_.mutable_data<float>();
+  }
+  const int64_t out_size = hout * wout;
+
+  for (int i = 0; i < num; i++) {
+    const float* din_batch = din + i * chin * n;
+    float* dout_batch = dout + i * chout * out_size;
+    if (is_1x1) col = dout_batch;
+    for (int g = 0; g < group; g++) {
+      blas.GEMM(true,
+                false,
+                m,
+                n,
+                k,
+                1.f,
+                weights + g * k * m,
+                m,
+                din_batch + g * k * n,
+                n,
+                0.f,
+                col + g * m * n,
+                n);
+    }
+    lite::x86::RunParallelFor(0, chout, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        float* out_channel = dout_batch + c * out_size;
+        if (!is_1x1) {
+          Col2ImChannel(col + c * kh * kw * n,
+                        hout,
+                        wout,
+                        hin,
+                        win,
+                        kh,
+                        kw,
+                        paddings[0],
+                        paddings[2],
+                        param.strides[0],
+                        param.strides[1],
+                        dilations[0],
+                        dilations[1],
+                        out_channel);
+        }
+        BiasActivation(bias ? bias + c : nullptr,
+                       param.activation_param,
+                       out_size,
+                       out_channel);
+      }
+    });
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(conv2d_transpose,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::Conv2DTransposeCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -19,6 +19,8 @@
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/half_gemm.h"
+#include "lite/backends/x86/math/quant_weight_gemm.h"
 #include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
@@ -161,6 +163,125 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   virtual ~FcCompute() = default;
 };
 
+// Adds the bias to each row of the [M, N] output, and applies relu if needed.
+inline void FcAddBias(
+    int M, int N, const float* bias, bool relu, float* output) {
+  auto compute =
+      relu ? jit::KernelFuncs<jit::VAddReluTuple<float>,
+                              fluid::CPUPlace>::Cache()
+                 .At(N)
+           : jit::KernelFuncs<jit::VAddTuple<float>, fluid::CPUPlace>::Cache()
+                 .At(N);
+  lite::x86::RunParallelFor(0, M, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      float* dst = output + i * N;
+      compute(bias, dst, dst, N);
+    }
+  });
+}
+
+// The fc kernel whose weights are stored in fp16, the weights are converted
+// back to fp32 panel by panel inside the GEMM.
+class FcFp16Compute : public KernelLite<TARGET(kX86), PRECISION(kFP16)> {
+ public:
+  using param_t = operators::FcParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto* input = param.input;
+    auto* w = param.w;
+    auto* bias = param.bias;
+    auto* output = param.output;
+    bool with_relu = (param.activation_type == "relu") ? true : false;
+
+    // The padded weights are used in place with a larger leading dimension.
+    bool padding_weights = param.padding_weights;
+    const auto& w_dims = w->dims();
+    int K = padding_weights ? w_dims[0] - 4 : w_dims[0];
+    int N = padding_weights ? w_dims[1] - 4 : w_dims[1];
+    int M = output->dims().production() / N;
+
+    const float* input_data = input->data<float>();
+    const float16* w_data = w->data<float16>();
+    float* output_data = output->mutable_data<float>();
+
+    auto& context = ctx_->As<X86Context>();
+    lite::x86::math::HalfWeightGemm(context,
+                                    false,
+                                    false,
+                                    M,
+                                    N,
+                                    K,
+                                    1.f,
+                                    input_data,
+                                    K,
+                                    w_data,
+                                    w_dims[1],
+                                    0.f,
+                                    output_data,
+                                    N,
+                                    &panel_);
+    if (bias) {
+      FcAddBias(M, N, bias->data<float>(), with_relu, output_data);
+    }
+  }
+
+  virtual ~FcFp16Compute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
+// The fc kernel whose weights are weight-only quantized to 8 or 4 bits, see
+// quant_weight_gemm.h for the layout.
+class FcWeightOnlyCompute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::FcParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto* input = param.input;
+    auto* w = param.w;
+    auto* bias = param.bias;
+    auto* output = param.output;
+    bool with_relu = (param.activation_type == "relu") ? true : false;
+
+    auto in_mat_dims = input->dims().Flatten2D(param.in_num_col_dims);
+    int M = in_mat_dims[0];
+    int K = in_mat_dims[1];
+    int N = w->dims()[1];
+    CHECK_EQ(lite::QuantWeightRows(K, param.bit_length),
+             w->dims()[0]);
+    CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(N));
+    float* output_data = output->mutable_data<float>();
+
+    auto& context = ctx_->As<X86Context>();
+    lite::x86::math::QuantWeightGemm(context,
+                                     false,
+                                     M,
+                                     N,
+                                     K,
+                                     1.f,
+                                     input->data<float>(),
+                                     K,
+                                     w->data<int8_t>(),
+                                     param.weight_scale.data(),
+                                     param.bit_length,
+                                     0.f,
+                                     output_data,
+                                     N,
+                                     &panel_);
+    if (bias) {
+      FcAddBias(M, N, bias->data<float>(), with_relu, output_data);
+    }
+  }
+
+  virtual ~FcWeightOnlyCompute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,102 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fusion_elementwise_chain_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+struct JitTranscendental {
+  void operator()(host::math::ChainOp op,
+                  const float* x,
+                  float* y,
+                  int len) const {
+    switch (op) {
+      case host::math::ChainOp::kSigmoid:
+        jit::KernelFuncs<jit::VSigmoidTuple<float>, fluid::CPUPlace>::Cache()
+            .At(len)(x, y, len);
+        break;
+      case host::math::ChainOp::kTanh:
+        jit::KernelFuncs<jit::VTanhTuple<float>, fluid::CPUPlace>::Cache().At(
+            len)(x, y, len);
+        break;
+      default:
+        jit::KernelFuncs<jit::VExpTuple<float>, fluid::CPUPlace>::Cache().At(
+            len)(x, y, len);
+        break;
+    }
+  }
+};
+
+}  // namespace
+
+void FusionElementwiseChainCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  CHECK(host::math::BuildChainSteps(
+      param.op_types, param.operand_ids, param.alphas, param.betas, &steps_))
+      << "Unsupported elementwise chain";
+}
+
+void FusionElementwiseChainCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto x_dims = param.X->dims().Vectorize();
+  std::vector<host::math::ChainOperand> operands(param.Y.size());
+  for (size_t i = 0; i < param.Y.size(); i++) {
+    CHECK(host::math::ChainOperandLayout(
+        x_dims, param.Y[i]->dims().Vectorize(), param.axes[i], &operands[i]));
+    operands[i].data = param.Y[i]->data<float>();
+  }
+  const float* x = param.X->data<float>();
+  float* out = param.Out->mutable_data<float>();
+  int64_t numel = param.X->numel();
+  int64_t num_tiles =
+      (numel + host::math::kChainTileSize - 1) / host::math::kChainTileSize;
+  JitTranscendental transcendental;
+  lite::x86::RunParallelFor(0, num_tiles, [&](int64_t begin, int64_t end) {
+    host::math::ElementwiseChain(
+        x,
+        operands,
+        steps_,
+        begin * host::math::kChainTileSize,
+        std::min(end * host::math::kChainTileSize, numel),
+        out,
+        transcendental);
+  });
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fusion_elementwise_chain,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::FusionElementwiseChainCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,94 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/fusion_elementwise_chain_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(fusion_elementwise_chain_x86, retrive_op) {
+  auto chain = KernelRegistry::Global().Create("fusion_elementwise_chain");
+  ASSERT_FALSE(chain.empty());
+  ASSERT_TRUE(chain.front());
+}
+
+// out = relu6(sigmoid(x * w + b) * x * 0.5 + 1), w and b are per channel.
+TEST(fusion_elementwise_chain_x86, run_test) {
+  const int n = 2, c = 3, h = 37, w = 41;
+  lite::Tensor x, weight, bias, out;
+  x.Resize({n, c, h, w});
+  weight.Resize({c});
+  bias.Resize({c, 1, 1});
+  out.Resize({n, c, h, w});
+  auto* x_data = x.mutable_data<float>();
+  auto* weight_data = weight.mutable_data<float>();
+  auto* bias_data = bias.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 17) / 4.f - 2.f;
+  }
+  for (int i = 0; i < c; i++) {
+    weight_data[i] = 0.5f * (i + 1);
+    bias_data[i] = 0.1f * i - 0.1f;
+  }
+
+  FusionElementwiseChainCompute chain;
+  operators::FusionElementwiseChainParam param;
+  param.X = &x;
+  param.Y = {&weight, &bias};
+  param.Out = &out;
+  param.axes = {1, 1};
+  param.op_types = {"elementwise_mul",
+                    "elementwise_add",
+                    "sigmoid",
+                    "elementwise_mul",
+                    "scale",
+                    "relu6"};
+  param.operand_ids = {0, 1, -1, -2, -1, -1};
+  param.alphas = {0.f, 0.f, 0.f, 0.f, 0.5f, 6.f};
+  param.betas = {0.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  chain.SetParam(param);
+  chain.SetContext(std::move(ctx));
+  chain.PrepareForRun();
+  chain.Run();
+
+  auto* out_data = out.data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    int ch = static_cast<int>(i / (h * w) % c);
+    float v = x_data[i] * weight_data[ch] + bias_data[ch];
+    v = 1.f / (1.f + std::exp(-v)) * x_data[i] * 0.5f + 1.f;
+    v = std::min(std::max(v, 0.f), 6.f);
+    EXPECT_NEAR(out_data[i], v, 1e-5);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fusion_elementwise_chain, kX86, kFloat, kNCHW, def);
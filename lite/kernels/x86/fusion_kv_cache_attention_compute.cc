@@ -0,0 +1,103 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fusion_kv_cache_attention_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void FusionKVCacheAttentionCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto q_dims = param.Q->dims();
+  host::math::KVCacheShape shape;
+  shape.batch = static_cast<int>(q_dims[0]);
+  shape.heads = static_cast<int>(q_dims[1]);
+  shape.tokens = static_cast<int>(q_dims[2]);
+  shape.dim = static_cast<int>(q_dims[3]);
+  shape.capacity = param.capacity;
+  shape.pos = static_cast<int>(host::math::ReadIndices(param.Position)[0]);
+  CHECK(shape.pos >= 0 && shape.pos + shape.tokens <= shape.capacity)
+      << "The kv cache of capacity " << shape.capacity << " can't hold "
+      << shape.pos + shape.tokens << " tokens";
+  std::vector<int64_t> parent_idx;
+  if (param.ParentIdx) {
+    parent_idx = host::math::ReadIndices(param.ParentIdx);
+    CHECK_EQ(static_cast<int>(parent_idx.size()), shape.batch);
+  }
+  host::math::UpdateCache(
+      param.K, parent_idx, shape, &gather_buffer_, param.CacheK);
+  host::math::UpdateCache(
+      param.V, parent_idx, shape, &gather_buffer_, param.CacheV);
+
+  host::math::KVCacheBias bias;
+  if (param.BiasQK) {
+    auto bias_dims = param.BiasQK->dims();
+    bias.data = param.BiasQK->data<float>();
+    bias.batch = static_cast<int>(bias_dims[0]);
+    bias.heads = static_cast<int>(bias_dims[1]);
+    bias.tokens = static_cast<int>(bias_dims[2]);
+    bias.len = bias_dims[3];
+    CHECK_GE(bias.len, shape.pos + shape.tokens);
+  }
+  const float* q = param.Q->data<float>();
+  const float* cache_k = param.CacheK->data<float>();
+  const float* cache_v = param.CacheV->data<float>();
+  float* out = param.Out->mutable_data<float>();
+  float alpha = param.alpha;
+  lite::x86::RunParallelFor(
+      0, shape.batch * shape.heads, [&](int64_t begin, int64_t end) {
+        std::vector<float> scores(shape.pos + shape.tokens);
+        host::math::KVCacheAttention(q,
+                                     cache_k,
+                                     cache_v,
+                                     bias,
+                                     shape,
+                                     alpha,
+                                     static_cast<int>(begin),
+                                     static_cast<int>(end),
+                                     scores.data(),
+                                     out);
+      });
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fusion_kv_cache_attention,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::FusionKVCacheAttentionCompute,
+                     def)
+    .BindInput("Q", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("K", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("V", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Position",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindInput("ParentIdx",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindInput("BiasQK", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("CacheK", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("CacheV", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("CacheKOut", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("CacheVOut", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,169 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/fusion_kv_cache_attention_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(fusion_kv_cache_attention_x86, retrive_op) {
+  auto attention =
+      KernelRegistry::Global().Create("fusion_kv_cache_attention");
+  ASSERT_FALSE(attention.empty());
+  ASSERT_TRUE(attention.front());
+}
+
+// The keys and values of a beam, [heads][tokens][dim], concatenated by the
+// steps as the decoders without the cache.
+typedef std::vector<std::vector<std::vector<float>>> BeamCache;
+
+void FillTensor(lite::Tensor* x, int seed) {
+  auto* data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    data[i] = static_cast<float>((i * 7 + seed * 13) % 23) / 11.f - 1.f;
+  }
+}
+
+// Prefills 3 tokens of 2 beams, then decodes 4 steps of 1 token, the beams
+// are reordered and grown to 3 by the parent indices.
+TEST(fusion_kv_cache_attention_x86, run_test) {
+  const int heads = 2, dim = 19, capacity = 16;
+  const float alpha = 0.25f;
+  std::vector<int> step_tokens = {3, 1, 1, 1, 1};
+  std::vector<std::vector<int64_t>> step_parents = {
+      {}, {1, 0}, {0, 0, 1}, {2, 1, 0}, {0, 1, 2}};
+  std::vector<int> step_batch = {2, 2, 3, 3, 3};
+
+  FusionKVCacheAttentionCompute attention;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  attention.SetContext(std::move(ctx));
+
+  lite::Tensor q, k, v, position, parent_idx, bias, cache_k, cache_v, out;
+  std::vector<BeamCache> ref_k, ref_v;
+  int pos = 0;
+  for (size_t step = 0; step < step_tokens.size(); step++) {
+    int batch = step_batch[step];
+    int tokens = step_tokens[step];
+    q.Resize({batch, heads, tokens, dim});
+    k.Resize({batch, heads, tokens, dim});
+    v.Resize({batch, heads, tokens, dim});
+    FillTensor(&q, step * 3);
+    FillTensor(&k, step * 3 + 1);
+    FillTensor(&v, step * 3 + 2);
+    position.Resize({1});
+    position.mutable_data<int64_t>()[0] = pos;
+    // The last position of each token is masked, except the token itself.
+    bias.Resize({1, 1, tokens, capacity});
+    auto* bias_data = bias.mutable_data<float>();
+    for (int t = 0; t < tokens; t++) {
+      for (int j = 0; j < capacity; j++) {
+        bias_data[t * capacity + j] = (j == pos + t - 1) ? -1e9f : 0.1f * j;
+      }
+    }
+
+    operators::FusionKVCacheAttentionParam param;
+    param.Q = &q;
+    param.K = &k;
+    param.V = &v;
+    param.Position = &position;
+    param.BiasQK = &bias;
+    param.CacheK = &cache_k;
+    param.CacheV = &cache_v;
+    param.Out = &out;
+    param.alpha = alpha;
+    param.capacity = capacity;
+    auto& parents = step_parents[step];
+    if (!parents.empty()) {
+      parent_idx.Resize({static_cast<int64_t>(parents.size())});
+      std::copy(parents.begin(),
+                parents.end(),
+                parent_idx.mutable_data<int64_t>());
+      param.ParentIdx = &parent_idx;
+    }
+    out.Resize(q.dims());
+    attention.SetParam(param);
+    attention.Run();
+
+    // The reference reorders and concatenates the whole caches.
+    if (!parents.empty()) {
+      std::vector<BeamCache> new_k, new_v;
+      for (auto p : parents) {
+        new_k.push_back(ref_k[p]);
+        new_v.push_back(ref_v[p]);
+      }
+      ref_k.swap(new_k);
+      ref_v.swap(new_v);
+    }
+    ref_k.resize(batch, BeamCache(heads));
+    ref_v.resize(batch, BeamCache(heads));
+    const float* q_data = q.data<float>();
+    const float* k_data = k.data<float>();
+    const float* v_data = v.data<float>();
+    const float* out_data = out.data<float>();
+    for (int b = 0; b < batch; b++) {
+      for (int h = 0; h < heads; h++) {
+        int64_t offset = (b * heads + h) * tokens * dim;
+        for (int t = 0; t < tokens; t++) {
+          const float* kt = k_data + offset + t * dim;
+          const float* vt = v_data + offset + t * dim;
+          ref_k[b][h].emplace_back(kt, kt + dim);
+          ref_v[b][h].emplace_back(vt, vt + dim);
+        }
+        for (int t = 0; t < tokens; t++) {
+          const float* qt = q_data + offset + t * dim;
+          int len = pos + t + 1;
+          std::vector<double> scores(len);
+          double max_score = -1e30;
+          for (int j = 0; j < len; j++) {
+            double s = 0;
+            for (int d = 0; d < dim; d++) s += qt[d] * ref_k[b][h][j][d];
+            scores[j] = s * alpha + bias_data[t * capacity + j];
+            max_score = std::max(max_score, scores[j]);
+          }
+          double sum = 0;
+          for (auto& s : scores) {
+            s = std::exp(s - max_score);
+            sum += s;
+          }
+          for (int d = 0; d < dim; d++) {
+            double o = 0;
+            for (int j = 0; j < len; j++) {
+              o += scores[j] / sum * ref_v[b][h][j][d];
+            }
+            EXPECT_NEAR(out_data[offset + t * dim + d], o, 1e-5);
+          }
+        }
+      }
+    }
+    pos += tokens;
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fusion_kv_cache_attention, kX86, kFloat, kNCHW, def);
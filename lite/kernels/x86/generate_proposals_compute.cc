@@ -0,0 +1,239 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/generate_proposals_compute.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "lite/backends/host/math/nms.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+const double kBBoxClipDefault = std::log(1000.0 / 16.0);
+
+struct ImageProposals {
+  std::vector<float> rois;
+  std::vector<float> probs;
+};
+
+// Decodes the delta of an anchor into the proposal, the same as the
+// reference kernel.
+inline void DecodeProposal(const float* anchor,
+                           const float* var,
+                           const float* delta,
+                           float* box) {
+  float anchor_width = anchor[2] - anchor[0] + 1.0;
+  float anchor_height = anchor[3] - anchor[1] + 1.0;
+  float anchor_center_x = anchor[0] + 0.5 * anchor_width;
+  float anchor_center_y = anchor[1] + 0.5 * anchor_height;
+  float center_x = var[0] * delta[0] * anchor_width + anchor_center_x;
+  float center_y = var[1] * delta[1] * anchor_height + anchor_center_y;
+  float width =
+      std::exp(std::min<float>(var[2] * delta[2], kBBoxClipDefault)) *
+      anchor_width;
+  float height =
+      std::exp(std::min<float>(var[3] * delta[3], kBBoxClipDefault)) *
+      anchor_height;
+  box[0] = center_x - width / 2;
+  box[1] = center_y - height / 2;
+  box[2] = center_x + width / 2 - 1;
+  box[3] = center_y + height / 2 - 1;
+}
+
+/*
+ * The proposals of an image. The anchor i of the NHWC order is the channel
+ * i % A at the position i / A of the NCHW scores and deltas, so only the
+ * scores are gathered for the selection of the pre_nms_top_n, and only the
+ * selected deltas are read and decoded.
+ */
+void ProposalForOneImage(const float* im_info,
+                         const float* anchors,
+                         const float* variances,
+                         const float* deltas,
+                         const float* scores,
+                         int64_t num_anchors,
+                         int64_t hw,
+                         int pre_nms_top_n,
+                         int post_nms_top_n,
+                         float nms_thresh,
+                         float min_size,
+                         float eta,
+                         ImageProposals* result) {
+  const int64_t num = num_anchors * hw;
+  std::vector<std::pair<float, int>> selected(num);
+  for (int64_t i = 0; i < num; ++i) {
+    float score = scores[(i % num_anchors) * hw + i / num_anchors];
+    selected[i] = std::make_pair(score, static_cast<int>(i));
+  }
+  if (pre_nms_top_n > 0 && pre_nms_top_n < num) {
+    std::nth_element(selected.begin(),
+                     selected.begin() + pre_nms_top_n,
+                     selected.end(),
+                     host::math::ScoreIndexGreater<int>);
+    selected.resize(pre_nms_top_n);
+  }
+  std::sort(selected.begin(),
+            selected.end(),
+            host::math::ScoreIndexGreater<int>);
+
+  // Decodes, clips and filters the selected boxes in the order of the scores.
+  const float im_h = im_info[0];
+  const float im_w = im_info[1];
+  const float im_scale = im_info[2];
+  min_size = std::max(min_size, 1.0f);
+  std::vector<float> boxes(selected.size() * 4);
+  std::vector<float> box_scores(selected.size());
+  int kept = 0;
+  for (auto& candidate : selected) {
+    const int i = candidate.second;
+    const int64_t a = i % num_anchors;
+    const int64_t pos = i / num_anchors;
+    float delta[4];
+    for (int k = 0; k < 4; ++k) {
+      delta[k] = deltas[(a * 4 + k) * hw + pos];
+    }
+    float* box = boxes.data() + kept * 4;
+    DecodeProposal(anchors + i * 4, variances + i * 4, delta, box);
+    box[0] = std::max(std::min(box[0], im_w - 1), 0.f);
+    box[1] = std::max(std::min(box[1], im_h - 1), 0.f);
+    box[2] = std::max(std::min(box[2], im_w - 1), 0.f);
+    box[3] = std::max(std::min(box[3], im_h - 1), 0.f);
+    float ws = box[2] - box[0] + 1;
+    float hs = box[3] - box[1] + 1;
+    float ws_origin_scale = (box[2] - box[0]) / im_scale + 1;
+    float hs_origin_scale = (box[3] - box[1]) / im_scale + 1;
+    float x_ctr = box[0] + ws / 2;
+    float y_ctr = box[1] + hs / 2;
+    if (ws_origin_scale >= min_size && hs_origin_scale >= min_size &&
+        x_ctr <= im_w && y_ctr <= im_h) {
+      box_scores[kept++] = candidate.first;
+    }
+  }
+  boxes.resize(kept * 4);
+  box_scores.resize(kept);
+  if (nms_thresh <= 0) {
+    result->rois.swap(boxes);
+    result->probs.swap(box_scores);
+    return;
+  }
+
+  // The reference pops the boxes from the back of the scores sorted by a
+  // stable ascending sort, so the boxes of the same score are visited from
+  // the last one.
+  host::math::NmsKeptSet kept_set(false, nms_thresh, eta);
+  kept_set.Reserve(kept);
+  size_t max_kept = post_nms_top_n > 0 ? post_nms_top_n : kept;
+  for (int begin = 0; begin < kept && result->probs.size() < max_kept;) {
+    int end = begin + 1;
+    while (end < kept && box_scores[end] == box_scores[begin]) end++;
+    for (int i = end - 1; i >= begin && result->probs.size() < max_kept; --i) {
+      const float* box = boxes.data() + i * 4;
+      if (kept_set.TryKeep(box)) {
+        result->rois.insert(result->rois.end(), box, box + 4);
+        result->probs.push_back(box_scores[i]);
+      }
+    }
+    begin = end;
+  }
+}
+
+}  // namespace
+
+void GenerateProposalsCompute::Run() {
+  auto& param = Param<operators::GenerateProposalsParam>();
+  auto* scores = param.Scores;              // N * A * H * W
+  auto* bbox_deltas = param.BboxDeltas;     // N * 4A * H * W
+  auto* im_info = param.ImInfo;             // N * 3
+  auto* anchors = param.Anchors;            // H * W * A * 4
+  auto* variances = param.Variances;        // H * W * A * 4
+  auto* rpn_rois = param.RpnRois;           // A * 4
+  auto* rpn_roi_probs = param.RpnRoiProbs;  // A * 1
+
+  auto& scores_dim = scores->dims();
+  const int64_t num = scores_dim[0];
+  const int64_t num_anchors = scores_dim[1];
+  const int64_t hw = scores_dim[2] * scores_dim[3];
+  CHECK_EQ(bbox_deltas->dims()[1], num_anchors * 4);
+  CHECK_EQ(anchors->numel(), num_anchors * hw * 4);
+  CHECK_EQ(variances->numel(), num_anchors * hw * 4);
+
+  std::vector<ImageProposals> proposals(num);
+  lite::x86::RunParallelFor(0, num, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      ProposalForOneImage(im_info->data<float>() + i * 3,
+                          anchors->data<float>(),
+                          variances->data<float>(),
+                          bbox_deltas->data<float>() + i * num_anchors * 4 * hw,
+                          scores->data<float>() + i * num_anchors * hw,
+                          num_anchors,
+                          hw,
+                          param.pre_nms_topN,
+                          param.post_nms_topN,
+                          param.nms_thresh,
+                          param.min_size,
+                          param.eta,
+                          &proposals[i]);
+    }
+  });
+
+  LoD lod;
+  lod.resize(1);
+  auto& lod0 = lod[0];
+  lod0.push_back(0);
+  int64_t num_proposals = 0;
+  for (auto& image : proposals) {
+    num_proposals += image.probs.size();
+    lod0.push_back(num_proposals);
+  }
+  rpn_rois->Resize({num_proposals, 4});
+  rpn_roi_probs->Resize({num_proposals, 1});
+  float* rois_data = rpn_rois->mutable_data<float>();
+  float* probs_data = rpn_roi_probs->mutable_data<float>();
+  for (auto& image : proposals) {
+    memcpy(rois_data, image.rois.data(), sizeof(float) * image.rois.size());
+    memcpy(probs_data, image.probs.data(), sizeof(float) * image.probs.size());
+    rois_data += image.rois.size();
+    probs_data += image.probs.size();
+  }
+  rpn_rois->set_lod(lod);
+  rpn_roi_probs->set_lod(lod);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(generate_proposals,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::GenerateProposalsCompute,
+                     def)
+    .BindInput("Scores", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("BboxDeltas", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("ImInfo", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Anchors", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Variances", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("RpnRois", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("RpnRoiProbs", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
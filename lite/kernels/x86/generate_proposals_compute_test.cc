@@ -0,0 +1,284 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/generate_proposals_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+float IouRef(const float* a, const float* b) {
+  if (b[0] > a[2] || b[2] < a[0] || b[1] > a[3] || b[3] < a[1]) {
+    return 0.f;
+  }
+  float inter_w = std::min(a[2], b[2]) - std::max(a[0], b[0]) + 1;
+  float inter_h = std::min(a[3], b[3]) - std::max(a[1], b[1]) + 1;
+  float inter = inter_w * inter_h;
+  float area_a = (a[2] - a[0] + 1) * (a[3] - a[1] + 1);
+  float area_b = (b[2] - b[0] + 1) * (b[3] - b[1] + 1);
+  return inter / (area_a + area_b - inter);
+}
+
+// The proposals of an image as the reference kernel computes them: the
+// scores are transposed to NHWC and sorted, all the top boxes are decoded,
+// clipped and filtered, and the NMS pops the boxes from the back of the
+// stable ascending sort of the scores.
+void ProposalsRef(const float* im_info,
+                  const float* anchors,
+                  const float* variances,
+                  const float* deltas,
+                  const float* scores,
+                  int num_anchors,
+                  int hw,
+                  int pre_nms_top_n,
+                  int post_nms_top_n,
+                  float nms_thresh,
+                  float min_size,
+                  float eta,
+                  std::vector<float>* rois,
+                  std::vector<float>* probs) {
+  const int num = num_anchors * hw;
+  std::vector<float> nhwc_scores(num);
+  std::vector<float> nhwc_deltas(num * 4);
+  for (int p = 0; p < hw; p++) {
+    for (int a = 0; a < num_anchors; a++) {
+      nhwc_scores[p * num_anchors + a] = scores[a * hw + p];
+      for (int k = 0; k < 4; k++) {
+        nhwc_deltas[(p * num_anchors + a) * 4 + k] =
+            deltas[(a * 4 + k) * hw + p];
+      }
+    }
+  }
+  std::vector<int> order(num);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int i, int j) {
+    return nhwc_scores[i] > nhwc_scores[j];
+  });
+  if (pre_nms_top_n > 0 && pre_nms_top_n < num) {
+    order.resize(pre_nms_top_n);
+  }
+
+  const float clip = std::log(1000.0 / 16.0);
+  min_size = std::max(min_size, 1.0f);
+  std::vector<float> boxes;
+  std::vector<float> box_scores;
+  for (int i : order) {
+    const float* anchor = anchors + i * 4;
+    const float* var = variances + i * 4;
+    const float* delta = nhwc_deltas.data() + i * 4;
+    float anchor_width = anchor[2] - anchor[0] + 1.0;
+    float anchor_height = anchor[3] - anchor[1] + 1.0;
+    float anchor_center_x = anchor[0] + 0.5 * anchor_width;
+    float anchor_center_y = anchor[1] + 0.5 * anchor_height;
+    float center_x = var[0] * delta[0] * anchor_width + anchor_center_x;
+    float center_y = var[1] * delta[1] * anchor_height + anchor_center_y;
+    float width =
+        std::exp(std::min<float>(var[2] * delta[2], clip)) * anchor_width;
+    float height =
+        std::exp(std::min<float>(var[3] * delta[3], clip)) * anchor_height;
+    float box[4] = {center_x - width / 2,
+                    center_y - height / 2,
+                    center_x + width / 2 - 1,
+                    center_y + height / 2 - 1};
+    for (int k = 0; k < 4; k++) {
+      float bound = (k % 2 == 0 ? im_info[1] : im_info[0]) - 1;
+      box[k] = std::max(std::min(box[k], bound), 0.f);
+    }
+    float ws = box[2] - box[0] + 1;
+    float hs = box[3] - box[1] + 1;
+    float ws_origin_scale = (box[2] - box[0]) / im_info[2] + 1;
+    float hs_origin_scale = (box[3] - box[1]) / im_info[2] + 1;
+    if (ws_origin_scale >= min_size && hs_origin_scale >= min_size &&
+        box[0] + ws / 2 <= im_info[1] && box[1] + hs / 2 <= im_info[0]) {
+      boxes.insert(boxes.end(), box, box + 4);
+      box_scores.push_back(nhwc_scores[i]);
+    }
+  }
+  if (nms_thresh <= 0) {
+    rois->swap(boxes);
+    probs->swap(box_scores);
+    return;
+  }
+
+  std::vector<int> sorted(box_scores.size());
+  std::iota(sorted.begin(), sorted.end(), 0);
+  std::stable_sort(sorted.begin(), sorted.end(), [&](int i, int j) {
+    return box_scores[i] < box_scores[j];
+  });
+  std::vector<int> keep;
+  float threshold = nms_thresh;
+  while (!sorted.empty()) {
+    int i = sorted.back();
+    sorted.pop_back();
+    bool flag = true;
+    for (int k : keep) {
+      if (IouRef(boxes.data() + i * 4, boxes.data() + k * 4) > threshold) {
+        flag = false;
+        break;
+      }
+    }
+    if (flag) {
+      keep.push_back(i);
+      if (eta < 1 && threshold > 0.5) {
+        threshold *= eta;
+      }
+    }
+  }
+  if (post_nms_top_n > 0 && post_nms_top_n < static_cast<int>(keep.size())) {
+    keep.resize(post_nms_top_n);
+  }
+  for (int k : keep) {
+    rois->insert(rois->end(), boxes.begin() + k * 4, boxes.begin() + k * 4 + 4);
+    probs->push_back(box_scores[k]);
+  }
+}
+
+TEST(generate_proposals_x86, retrive_op) {
+  auto generate_proposals =
+      KernelRegistry::Global().Create("generate_proposals");
+  ASSERT_FALSE(generate_proposals.empty());
+  ASSERT_TRUE(generate_proposals.front());
+}
+
+TEST(generate_proposals_x86, compute) {
+  std::mt19937 rng(11);
+  const int batch = 2;
+  const int num_anchors = 3;
+  const int height = 4;
+  const int width = 5;
+  const int hw = height * width;
+  Tensor scores, deltas, im_info, anchors, variances;
+  scores.Resize({batch, num_anchors, height, width});
+  deltas.Resize({batch, num_anchors * 4, height, width});
+  im_info.Resize({batch, 3});
+  anchors.Resize({height, width, num_anchors, 4});
+  variances.Resize({height, width, num_anchors, 4});
+
+  // Distinct scores, the order of the equal scores is not specified by the
+  // reference sort.
+  auto* scores_data = scores.mutable_data<float>();
+  std::vector<int> perm(scores.numel());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::shuffle(perm.begin(), perm.end(), rng);
+  for (int64_t i = 0; i < scores.numel(); i++) {
+    scores_data[i] = static_cast<float>(perm[i]) / scores.numel();
+  }
+  std::normal_distribution<float> delta_dist(0.f, 0.5f);
+  auto* deltas_data = deltas.mutable_data<float>();
+  for (int64_t i = 0; i < deltas.numel(); i++) {
+    deltas_data[i] = delta_dist(rng);
+  }
+  std::uniform_real_distribution<float> pos(0.f, 60.f);
+  std::uniform_real_distribution<float> size(4.f, 30.f);
+  std::uniform_real_distribution<float> var(0.5f, 1.f);
+  auto* anchors_data = anchors.mutable_data<float>();
+  auto* variances_data = variances.mutable_data<float>();
+  for (int64_t i = 0; i < anchors.numel(); i += 4) {
+    anchors_data[i] = pos(rng);
+    anchors_data[i + 1] = pos(rng);
+    anchors_data[i + 2] = anchors_data[i] + size(rng);
+    anchors_data[i + 3] = anchors_data[i + 1] + size(rng);
+    for (int k = 0; k < 4; k++) {
+      variances_data[i + k] = var(rng);
+    }
+  }
+  auto* im_info_data = im_info.mutable_data<float>();
+  const float infos[] = {64.f, 80.f, 1.f, 50.f, 70.f, 0.8f};
+  std::copy(infos, infos + 6, im_info_data);
+
+  for (int pre_nms_top_n : {0, 25}) {
+    for (int post_nms_top_n : {0, 6}) {
+      for (float nms_thresh : {0.f, 0.3f, 0.7f}) {
+        for (float min_size : {0.1f, 10.f}) {
+          for (float eta : {1.f, 0.9f}) {
+            Tensor rpn_rois, rpn_roi_probs;
+            GenerateProposalsCompute generate_proposals;
+            operators::GenerateProposalsParam param;
+            param.Scores = &scores;
+            param.BboxDeltas = &deltas;
+            param.ImInfo = &im_info;
+            param.Anchors = &anchors;
+            param.Variances = &variances;
+            param.pre_nms_topN = pre_nms_top_n;
+            param.post_nms_topN = post_nms_top_n;
+            param.nms_thresh = nms_thresh;
+            param.min_size = min_size;
+            param.eta = eta;
+            param.RpnRois = &rpn_rois;
+            param.RpnRoiProbs = &rpn_roi_probs;
+            std::unique_ptr<KernelContext> ctx(new KernelContext);
+            ctx->As<X86Context>();
+            generate_proposals.SetContext(std::move(ctx));
+            generate_proposals.SetParam(param);
+            generate_proposals.Run();
+
+            std::vector<uint64_t> ref_lod{0};
+            std::vector<float> ref_rois;
+            std::vector<float> ref_probs;
+            for (int i = 0; i < batch; i++) {
+              std::vector<float> rois;
+              std::vector<float> probs;
+              ProposalsRef(im_info_data + i * 3,
+                           anchors_data,
+                           variances_data,
+                           deltas_data + i * num_anchors * 4 * hw,
+                           scores_data + i * num_anchors * hw,
+                           num_anchors,
+                           hw,
+                           pre_nms_top_n,
+                           post_nms_top_n,
+                           nms_thresh,
+                           min_size,
+                           eta,
+                           &rois,
+                           &probs);
+              ref_rois.insert(ref_rois.end(), rois.begin(), rois.end());
+              ref_probs.insert(ref_probs.end(), probs.begin(), probs.end());
+              ref_lod.push_back(ref_probs.size());
+            }
+            ASSERT_EQ(rpn_rois.lod().size(), 1UL);
+            ASSERT_EQ(rpn_rois.lod()[0], ref_lod);
+            EXPECT_EQ(rpn_roi_probs.lod(), rpn_rois.lod());
+            ASSERT_EQ(rpn_rois.numel(), static_cast<int64_t>(ref_rois.size()));
+            for (size_t i = 0; i < ref_rois.size(); i++) {
+              EXPECT_NEAR(rpn_rois.data<float>()[i], ref_rois[i], 1e-4) << i;
+            }
+            for (size_t i = 0; i < ref_probs.size(); i++) {
+              EXPECT_EQ(rpn_roi_probs.data<float>()[i], ref_probs[i]) << i;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(generate_proposals, kX86, kFloat, kNCHW, def);
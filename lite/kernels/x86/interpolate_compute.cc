@@ -0,0 +1,198 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/interpolate_compute.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+// The source indices of the two neighbours and the weight of the higher one
+// of every output position of an axis.
+void BilinearAxisTable(int in_size,
+                       int out_size,
+                       bool align_corners,
+                       bool align_flag,
+                       std::vector<int>* low,
+                       std::vector<int>* high,
+                       std::vector<float>* high_weight) {
+  float ratio = 0.f;
+  if (out_size > 1) {
+    ratio = align_corners ? static_cast<float>(in_size - 1) / (out_size - 1)
+                          : static_cast<float>(in_size) / out_size;
+  }
+  low->resize(out_size);
+  high->resize(out_size);
+  high_weight->resize(out_size);
+  for (int k = 0; k < out_size; k++) {
+    int lo = align_flag ? static_cast<int>(ratio * (k + 0.5) - 0.5)
+                        : static_cast<int>(ratio * k);
+    lo = std::max(lo, 0);
+    float idx_src = ratio * (k + 0.5) - 0.5;
+    idx_src = std::max(idx_src, 0.f);
+    float d = align_flag ? idx_src - lo : ratio * k - lo;
+    (*low)[k] = lo;
+    (*high)[k] = std::min(lo + 1, in_size - 1);
+    (*high_weight)[k] = d;
+  }
+}
+
+void NearestAxisTable(int in_size,
+                      int out_size,
+                      bool align_corners,
+                      std::vector<int>* index) {
+  float ratio = align_corners
+                    ? static_cast<float>(in_size - 1) / (out_size - 1)
+                    : static_cast<float>(in_size) / out_size;
+  index->resize(out_size);
+  for (int k = 0; k < out_size; k++) {
+    int idx = align_corners ? static_cast<int>(ratio * k + 0.5)
+                            : static_cast<int>(ratio * k);
+    (*index)[k] = std::max(idx, 0);
+  }
+}
+
+}  // namespace
+
+/*
+ * The source indices and the weights only depend on the output position of
+ * an axis, so they are computed once per axis, and the N * C planes are
+ * interpolated in parallel by gathering with the tables.
+ */
+void BilinearInterpCompute::Run() {
+  auto& param = Param<operators::InterpolateParam>();
+  const lite::Tensor* x = param.X;
+  lite::Tensor* out = param.Out;
+  auto x_dims = x->dims();
+  const int in_h = x_dims[2];
+  const int in_w = x_dims[3];
+  const int out_h = out->dims()[2];
+  const int out_w = out->dims()[3];
+  if (in_h == out_h && in_w == out_w) {
+    out->CopyDataFrom(*x);
+    return;
+  }
+  const bool align_flag = param.align_mode == 0 && !param.align_corners;
+  std::vector<int> y_n, y_s, x_w, x_e;
+  std::vector<float> d_n, d_w;
+  BilinearAxisTable(
+      in_h, out_h, param.align_corners, align_flag, &y_n, &y_s, &d_n);
+  BilinearAxisTable(
+      in_w, out_w, param.align_corners, align_flag, &x_w, &x_e, &d_w);
+
+  const float* x_data = x->data<float>();
+  float* out_data = out->mutable_data<float>();
+  const int64_t in_size = in_h * in_w;
+  const int64_t out_size = out_h * out_w;
+  lite::x86::RunParallelFor(
+      0, x_dims[0] * x_dims[1], [&](int64_t begin, int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const float* src = x_data + plane * in_size;
+          float* dst = out_data + plane * out_size;
+          for (int k = 0; k < out_h; k++) {
+            const float* row_n = src + y_n[k] * in_w;
+            const float* row_s = src + y_s[k] * in_w;
+            const float dn = d_n[k];
+            const float ds = 1.f - dn;
+            for (int l = 0; l < out_w; l++) {
+              const float dw = d_w[l];
+              const float de = 1.f - dw;
+              dst[l] = row_n[x_w[l]] * ds * de + row_s[x_w[l]] * dn * de +
+                       row_n[x_e[l]] * ds * dw + row_s[x_e[l]] * dn * dw;
+            }
+            dst += out_w;
+          }
+        }
+      });
+}
+
+void NearestInterpCompute::Run() {
+  auto& param = Param<operators::InterpolateParam>();
+  const lite::Tensor* x = param.X;
+  lite::Tensor* out = param.Out;
+  auto x_dims = x->dims();
+  const int in_h = x_dims[2];
+  const int in_w = x_dims[3];
+  const int out_h = out->dims()[2];
+  const int out_w = out->dims()[3];
+  std::vector<int> y_index, x_index;
+  NearestAxisTable(in_h, out_h, param.align_corners, &y_index);
+  NearestAxisTable(in_w, out_w, param.align_corners, &x_index);
+
+  const float* x_data = x->data<float>();
+  float* out_data = out->mutable_data<float>();
+  const int64_t in_size = in_h * in_w;
+  const int64_t out_size = out_h * out_w;
+  lite::x86::RunParallelFor(
+      0, x_dims[0] * x_dims[1], [&](int64_t begin, int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const float* src = x_data + plane * in_size;
+          float* dst = out_data + plane * out_size;
+          for (int k = 0; k < out_h; k++) {
+            // The rows of the same source row are copied.
+            if (k > 0 && y_index[k] == y_index[k - 1]) {
+              memcpy(dst, dst - out_w, sizeof(float) * out_w);
+            } else {
+              const float* row = src + y_index[k] * in_w;
+              for (int l = 0; l < out_w; l++) {
+                dst[l] = row[x_index[l]];
+              }
+            }
+            dst += out_w;
+          }
+        }
+      });
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(bilinear_interp,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::BilinearInterpCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OutSize",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindInput("SizeTensor",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindInput("Scale", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(nearest_interp,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::NearestInterpCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OutSize",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindInput("SizeTensor",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindInput("Scale", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -71,15 +71,25 @@ class LayerNormCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto ker = paddle::lite::jit::KernelFuncs<jit::LayerNormTuple<T>,
                                               lite::fluid::CPUPlace>::Cache()
                    .At(right);
-    ker(in.mutable_data<T>(),
-        out.mutable_data<T>(),
-        Mean->template mutable_data<T>(),
-        Var->template mutable_data<T>(),
-        Scale->template data<T>(),
-        Bias->template data<T>(),
-        static_cast<int>(left),
-        epsilon,
-        right);
+    T* in_data = in.mutable_data<T>();
+    T* out_data = out.mutable_data<T>();
+    T* mean_data = Mean->template mutable_data<T>();
+    T* var_data = Var->template mutable_data<T>();
+    const T* scale_data = Scale->template data<T>();
+    const T* bias_data = Bias->template data<T>();
+    // Rows are normalized independently, split them over the thread pool.
+    auto& context = ctx_->As<X86Context>();
+    context.ParallelFor(0, left, [&](int64_t begin, int64_t end) {
+      ker(in_data + begin * right,
+          out_data + begin * right,
+          mean_data + begin,
+          var_data + begin,
+          scale_data,
+          bias_data,
+          static_cast<int>(end - begin),
+          epsilon,
+          right);
+    });
   }
 
   virtual ~LayerNormCompute() = default;
@@ -35,7 +35,12 @@ void MatchMatrixTensorCompute<T>::Run() {
   const auto& offset_l = x->lod()[0];
   const auto& offset_r = y->lod()[0];
 
-  std::vector<uint64_t> top_offset;
+  // The offsets of the output are the first level of its lod, written in
+  // place so the lod keeps its capacity across the runs.
+  auto* out_lod = out->mutable_lod();
+  out_lod->resize(3);
+  auto& top_offset = (*out_lod)[0];
+  top_offset.clear();
   int top_size = 0;
   top_offset.push_back(top_size);
   for (size_t b = 0; b < x->lod()[0].size() - 1; b++) {
@@ -94,32 +99,8 @@ void MatchMatrixTensorCompute<T>::Run() {
     }
   }
 
-  int batch_size = x->lod()[0].size() - 1;
-  int lod_lv1_size = batch_size * dim_t;
-  int lod_lv2_size = x->lod()[0].back() * dim_t;
-  std::vector<uint64_t> out_lod0(batch_size + 1, 0);
-  std::vector<uint64_t> out_lod1(lod_lv1_size + 1, 0);
-  std::vector<uint64_t> out_lod2(lod_lv2_size + 1, 0);
-  for (int i = 0; i < batch_size; i++) {
-    out_lod0[i + 1] = out_lod0[i] + dim_t;
-    int len_l = offset_l[i + 1] - offset_l[i];
-
-    for (int j = 0; j < dim_t; j++) {
-      out_lod1[i * dim_t + j + 1] = out_lod1[i * dim_t + j] + len_l;
-      int len_r = offset_r[i + 1] - offset_r[i];
-
-      for (int k = 0; k < len_l; k++) {
-        out_lod2[offset_l[i] * dim_t + j * len_l + k + 1] =
-            out_lod2[offset_l[i] * dim_t + j * len_l + k] + len_r;
-      }
-    }
-  }
-
-  LoD out_lod;
-  out_lod.push_back(top_offset);
-  out_lod.push_back(offset_l);
-  out_lod.push_back(offset_r);
-  out->set_lod(out_lod);
+  (*out_lod)[1] = offset_l;
+  (*out_lod)[2] = offset_r;
 }
 
 }  // namespace x86
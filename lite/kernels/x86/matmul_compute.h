@@ -13,7 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/half_gemm.h"
+#include "lite/backends/x86/math/quant_weight_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -70,6 +73,107 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   virtual ~MatMulCompute() = default;
 };
 
+// The matmul kernel whose `Y` is a 2-D weight stored in fp16. The leading
+// dimensions of `X` are folded into the rows unless `X` is transposed.
+class MatMulFp16Compute : public KernelLite<TARGET(kX86), PRECISION(kFP16)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void Run() override {
+    auto &context = ctx_->As<X86Context>();
+    auto &param = *param_.get_mutable<operators::MatMulParam>();
+
+    auto x_dims = RowMatrixFromVector(param.X->dims());
+    auto y_dims = ColumnMatrixFromVector(param.Y->dims());
+    CHECK_EQ(y_dims.size(), 2UL)
+        << "The fp16 matmul kernel only supports a 2-D Y";
+    CHECK(!param.transpose_X || x_dims.size() == 2UL)
+        << "The fp16 matmul kernel only supports a 2-D transposed X";
+    int M = 0;
+    int K = 0;
+    if (param.transpose_X) {
+      K = x_dims[0];
+      M = x_dims[1];
+    } else {
+      M = x_dims.count(0, x_dims.size() - 1);
+      K = x_dims[x_dims.size() - 1];
+    }
+    int N = param.transpose_Y ? y_dims[0] : y_dims[1];
+    CHECK_EQ(K, param.transpose_Y ? y_dims[1] : y_dims[0]);
+    lite::x86::math::HalfWeightGemm(context,
+                                    param.transpose_X,
+                                    param.transpose_Y,
+                                    M,
+                                    N,
+                                    K,
+                                    param.alpha,
+                                    param.X->data<float>(),
+                                    param.transpose_X ? M : K,
+                                    param.Y->data<float16>(),
+                                    y_dims[1],
+                                    0.f,
+                                    param.Out->mutable_data<float>(),
+                                    N,
+                                    &panel_);
+  }
+
+  virtual ~MatMulFp16Compute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
+// The matmul kernel whose 2-D `Y` is weight-only quantized to 8 or 4 bits,
+// `Y` is never transposed.
+class MatMulWeightOnlyCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void Run() override {
+    auto &context = ctx_->As<X86Context>();
+    auto &param = *param_.get_mutable<operators::MatMulParam>();
+
+    auto x_dims = RowMatrixFromVector(param.X->dims());
+    CHECK(!param.transpose_Y);
+    CHECK(!param.transpose_X || x_dims.size() == 2UL)
+        << "The weight-only matmul kernel only supports a 2-D transposed X";
+    int M = 0;
+    int K = 0;
+    if (param.transpose_X) {
+      K = x_dims[0];
+      M = x_dims[1];
+    } else {
+      M = x_dims.count(0, x_dims.size() - 1);
+      K = x_dims[x_dims.size() - 1];
+    }
+    int N = param.Y->dims()[1];
+    CHECK_EQ(lite::QuantWeightRows(K, param.bit_length),
+             param.Y->dims()[0]);
+    CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(N));
+    lite::x86::math::QuantWeightGemm(context,
+                                     param.transpose_X,
+                                     M,
+                                     N,
+                                     K,
+                                     param.alpha,
+                                     param.X->data<float>(),
+                                     param.transpose_X ? M : K,
+                                     param.Y->data<int8_t>(),
+                                     param.weight_scale.data(),
+                                     param.bit_length,
+                                     0.f,
+                                     param.Out->mutable_data<float>(),
+                                     N,
+                                     &panel_);
+  }
+
+  virtual ~MatMulWeightOnlyCompute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -80,9 +80,81 @@ TEST(matmul_x86, run_test) {
   }
 }
 
+TEST(matmul_x86, run_fp16_test) {
+  // K spans several converted panels of the fp16 weights, the leading
+  // dimensions of X are folded into the rows.
+  const int M = 7;
+  const int K = 2100;
+  const int N = 40;
+  for (bool trans_x : {false, true}) {
+    for (bool trans_y : {false, true}) {
+      lite::Tensor x, y, y_fp16, out, out_ref;
+      if (trans_x) {
+        x.Resize({K, M});
+      } else {
+        x.Resize({1, M, K});
+      }
+      if (trans_y) {
+        y.Resize({N, K});
+      } else {
+        y.Resize({K, N});
+      }
+      y_fp16.Resize(y.dims());
+      auto* x_data = x.mutable_data<float>();
+      auto* y_data = y.mutable_data<float>();
+      for (int64_t i = 0; i < x.numel(); i++) {
+        x_data[i] = static_cast<float>(i % 7) * 0.1f - 0.3f;
+      }
+      for (int64_t i = 0; i < y.numel(); i++) {
+        y_data[i] = static_cast<float>(i % 11) * 0.125f - 0.5f;
+      }
+      lite::x86::math::FloatToHalf(
+          y_data, y_fp16.mutable_data<float16>(), y.numel());
+
+      operators::MatMulParam param;
+      param.X = &x;
+      param.transpose_X = trans_x;
+      param.transpose_Y = trans_y;
+      param.alpha = 0.5f;
+
+      MatMulCompute<float> matmul;
+      param.Y = &y;
+      param.Out = &out_ref;
+      out_ref.Resize({M, N});
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      matmul.SetContext(std::move(ctx));
+      matmul.SetParam(param);
+      matmul.Run();
+
+      MatMulFp16Compute matmul_fp16;
+      ASSERT_EQ(matmul_fp16.precision(), PRECISION(kFP16));
+      param.Y = &y_fp16;
+      param.Out = &out;
+      out.Resize({M, N});
+      std::unique_ptr<KernelContext> ctx_fp16(new KernelContext);
+      ctx_fp16->As<X86Context>();
+      matmul_fp16.SetContext(std::move(ctx_fp16));
+      matmul_fp16.SetParam(param);
+      // The second run reuses the buffer of the converted panels.
+      for (int run = 0; run < 2; run++) {
+        matmul_fp16.Run();
+        // The test weights are exact in fp16.
+        auto* out_data = out.data<float>();
+        auto* out_ref_data = out_ref.data<float>();
+        for (int64_t i = 0; i < out.numel(); i++) {
+          EXPECT_NEAR(out_data[i], out_ref_data[i], 1e-3)
+              << "trans_x " << trans_x << " trans_y " << trans_y;
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(matmul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(matmul, kX86, kFP16, kNCHW, def);
@@ -13,7 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/half_gemm.h"
+#include "lite/backends/x86/math/quant_weight_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -81,6 +84,86 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   virtual ~MulCompute() = default;
 };
 
+// The mul kernel whose `Y` is stored in fp16.
+class MulFp16Compute : public KernelLite<TARGET(kX86), PRECISION(kFP16)> {
+ public:
+  using param_t = operators::MulParam;
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    auto x_dims = param.x->dims().size() > 2
+                      ? param.x->dims().Flatten2D(param.x_num_col_dims)
+                      : param.x->dims();
+    auto y_dims = param.y->dims().size() > 2
+                      ? param.y->dims().Flatten2D(param.y_num_col_dims)
+                      : param.y->dims();
+    int M = x_dims[0];
+    int K = x_dims[1];
+    int N = y_dims[1];
+    CHECK_EQ(K, y_dims[0]);
+    lite::x86::math::HalfWeightGemm(context,
+                                    false,
+                                    false,
+                                    M,
+                                    N,
+                                    K,
+                                    1.f,
+                                    param.x->data<float>(),
+                                    K,
+                                    param.y->data<float16>(),
+                                    N,
+                                    0.f,
+                                    param.output->mutable_data<float>(),
+                                    N,
+                                    &panel_);
+  }
+
+  virtual ~MulFp16Compute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
+// The mul kernel whose 2-D `Y` is weight-only quantized to 8 or 4 bits.
+class MulWeightOnlyCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MulParam;
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    auto x_dims = param.x->dims().Flatten2D(param.x_num_col_dims);
+    int M = x_dims[0];
+    int K = x_dims[1];
+    int N = param.y->dims()[1];
+    CHECK_EQ(lite::QuantWeightRows(K, param.bit_length),
+             param.y->dims()[0]);
+    CHECK_EQ(param.weight_scale.size(), static_cast<size_t>(N));
+    lite::x86::math::QuantWeightGemm(context,
+                                     false,
+                                     M,
+                                     N,
+                                     K,
+                                     1.f,
+                                     param.x->data<float>(),
+                                     K,
+                                     param.y->data<int8_t>(),
+                                     param.weight_scale.data(),
+                                     param.bit_length,
+                                     0.f,
+                                     param.output->mutable_data<float>(),
+                                     N,
+                                     &panel_);
+  }
+
+  virtual ~MulWeightOnlyCompute() = default;
+
+ private:
+  std::vector<float> panel_;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -80,9 +80,119 @@ TEST(mul_x86, run_test) {
   }
 }
 
+TEST(mul_x86, run_fp16_test) {
+  // K spans several converted panels of the fp16 weights.
+  const int M = 5;
+  const int K = 3000;
+  const int N = 33;
+  lite::Tensor x, y, y_fp16, out, out_ref;
+  x.Resize({M, K});
+  y.Resize({K, N});
+  y_fp16.Resize({K, N});
+  out.Resize({M, N});
+  out_ref.Resize({M, N});
+  auto* x_data = x.mutable_data<float>();
+  auto* y_data = y.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 7) * 0.1f - 0.3f;
+  }
+  for (int64_t i = 0; i < y.numel(); i++) {
+    y_data[i] = static_cast<float>(i % 11) * 0.05f - 0.25f;
+  }
+  lite::x86::math::FloatToHalf(
+      y_data, y_fp16.mutable_data<float16>(), y.numel());
+
+  MulCompute<float> mul;
+  operators::MulParam param;
+  param.x = &x;
+  param.y = &y;
+  param.output = &out_ref;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  mul.SetContext(std::move(ctx));
+  mul.SetParam(param);
+  mul.Run();
+
+  MulFp16Compute mul_fp16;
+  ASSERT_EQ(mul_fp16.precision(), PRECISION(kFP16));
+  param.y = &y_fp16;
+  param.output = &out;
+  std::unique_ptr<KernelContext> ctx_fp16(new KernelContext);
+  ctx_fp16->As<X86Context>();
+  mul_fp16.SetContext(std::move(ctx_fp16));
+  mul_fp16.SetParam(param);
+  mul_fp16.Run();
+
+  // The test weights are exact in fp16.
+  auto* out_data = out.data<float>();
+  auto* out_ref_data = out_ref.data<float>();
+  for (int64_t i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out_data[i], out_ref_data[i], 1e-2);
+  }
+}
+
+TEST(mul_x86, run_weight_only_test) {
+  // An odd K spans several dequantized panels of the weights.
+  const int M = 5;
+  const int K = 3001;
+  const int N = 33;
+  for (int bits : {8, 4}) {
+    lite::Tensor x, y, y_quant, out, out_ref;
+    x.Resize({M, K});
+    y.Resize({K, N});
+    y_quant.Resize({lite::QuantWeightRows(K, bits), N});
+    out.Resize({M, N});
+    out_ref.Resize({M, N});
+    auto* x_data = x.mutable_data<float>();
+    auto* y_data = y.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>(i % 7) * 0.1f - 0.3f;
+    }
+    for (int64_t i = 0; i < y.numel(); i++) {
+      y_data[i] = static_cast<float>(i % 11) * 0.05f - 0.25f;
+    }
+    std::vector<float> scale(N);
+    lite::QuantizeWeight(
+        y_data, K, N, bits, y_quant.mutable_data<int8_t>(), scale.data());
+    // The reference multiplies the dequantized weights.
+    lite::DequantizeWeight(
+        y_quant.data<int8_t>(), scale.data(), 0, K, N, bits, y_data);
+
+    MulCompute<float> mul;
+    operators::MulParam param;
+    param.x = &x;
+    param.y = &y;
+    param.output = &out_ref;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    mul.SetContext(std::move(ctx));
+    mul.SetParam(param);
+    mul.Run();
+
+    MulWeightOnlyCompute mul_quant;
+    param.y = &y_quant;
+    param.output = &out;
+    param.weight_scale = scale;
+    param.bit_length = bits;
+    std::unique_ptr<KernelContext> ctx_quant(new KernelContext);
+    ctx_quant->As<X86Context>();
+    mul_quant.SetContext(std::move(ctx_quant));
+    mul_quant.SetParam(param);
+    mul_quant.Run();
+
+    auto* out_data = out.data<float>();
+    auto* out_ref_data = out_ref.data<float>();
+    for (int64_t i = 0; i < out.numel(); i++) {
+      EXPECT_NEAR(out_data[i], out_ref_data[i], 1e-3);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(mul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(mul, kX86, kFP16, kNCHW, def);
+USE_LITE_KERNEL(mul, kX86, kInt8, kNCHW, weight_only);
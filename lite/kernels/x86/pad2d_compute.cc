@@ -0,0 +1,128 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/pad2d_compute.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+enum class PadMode { kConstant, kReflect, kEdge };
+
+// Maps the padded index to the source index, -1 means the pad value.
+inline int SourceIndex(int i, int size, PadMode mode) {
+  if (i >= 0 && i < size) return i;
+  switch (mode) {
+    case PadMode::kReflect:
+      return i < 0 ? -i : 2 * (size - 1) - i;
+    case PadMode::kEdge:
+      return i < 0 ? 0 : size - 1;
+    default:
+      return -1;
+  }
+}
+
+}  // namespace
+
+/*
+ * The source index of every padded row and column is computed once, then the
+ * N * C planes are padded in parallel, the middle of every row is a memcpy
+ * and only the pads are gathered.
+ */
+void Pad2dCompute::Run() {
+  auto& param = Param<operators::Pad2dParam>();
+  const lite::Tensor* x = param.X;
+  auto* out = param.Out;
+  CHECK_EQ(param.data_format, "NCHW") << "pad2d only supports NCHW on x86";
+  PadMode mode = PadMode::kConstant;
+  if (param.mode == "reflect") {
+    mode = PadMode::kReflect;
+  } else if (param.mode == "edge") {
+    mode = PadMode::kEdge;
+  } else if (param.mode != "constant") {
+    LOG(FATAL) << "Unknown mode type " << param.mode;
+  }
+  auto x_dims = x->dims();
+  const int in_h = x_dims[2];
+  const int in_w = x_dims[3];
+  const int pad_top = param.paddings[0];
+  const int pad_left = param.paddings[2];
+  const int out_h = out->dims()[2];
+  const int out_w = out->dims()[3];
+  if (mode != PadMode::kConstant) {
+    CHECK_LE(param.paddings[0], in_h - 1)
+        << "pad top size must <= inputs height - 1";
+    CHECK_LE(param.paddings[1], in_h - 1)
+        << "pad bottom size must <= inputs height - 1";
+    CHECK_LE(param.paddings[2], in_w - 1)
+        << "pad left size must <= inputs width - 1";
+    CHECK_LE(param.paddings[3], in_w - 1)
+        << "pad right size must <= inputs width - 1";
+  }
+  std::vector<int> rows(out_h);
+  for (int r = 0; r < out_h; r++) {
+    rows[r] = SourceIndex(r - pad_top, in_h, mode);
+  }
+  std::vector<int> cols(out_w);
+  for (int c = 0; c < out_w; c++) {
+    cols[c] = SourceIndex(c - pad_left, in_w, mode);
+  }
+  const int right_begin = pad_left + in_w;
+  const float pad_value = param.pad_value;
+  const float* x_data = x->data<float>();
+  float* out_data = out->mutable_data<float>();
+  const int64_t in_size = in_h * in_w;
+  const int64_t out_size = out_h * out_w;
+
+  lite::x86::RunParallelFor(
+      0, x_dims[0] * x_dims[1], [&](int64_t begin, int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const float* src = x_data + plane * in_size;
+          float* dst = out_data + plane * out_size;
+          for (int r = 0; r < out_h; r++, dst += out_w) {
+            if (rows[r] < 0) {
+              std::fill(dst, dst + out_w, pad_value);
+              continue;
+            }
+            const float* src_row = src + rows[r] * in_w;
+            for (int c = 0; c < pad_left; c++) {
+              dst[c] = cols[c] < 0 ? pad_value : src_row[cols[c]];
+            }
+            memcpy(dst + pad_left, src_row, sizeof(float) * in_w);
+            for (int c = right_begin; c < out_w; c++) {
+              dst[c] = cols[c] < 0 ? pad_value : src_row[cols[c]];
+            }
+          }
+        }
+      });
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(
+    pad2d, kX86, kFloat, kNCHW, paddle::lite::kernels::x86::Pad2dCompute, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
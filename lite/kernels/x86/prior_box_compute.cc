@@ -0,0 +1,119 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/prior_box_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+void SetDensityConfig(const operators::PriorBoxParam& param,
+                      lite::x86::math::PriorBoxConfig* config) {
+  lite::x86::math::ExpandAspectRatios(
+      param.aspect_ratios, param.flip, &config->aspect_ratios);
+}
+
+// density_prior_box uses the raw aspect ratios and always puts the boxes of
+// the max sizes after the aspect ratios.
+void SetDensityConfig(const operators::DensityPriorBoxParam& param,
+                      lite::x86::math::PriorBoxConfig* config) {
+  config->aspect_ratios = param.aspect_ratios;
+  config->fixed_sizes = param.fixed_sizes;
+  config->fixed_ratios = param.fixed_ratios;
+  config->density_sizes = param.density_sizes;
+  config->min_max_aspect_ratios_order = false;
+}
+
+}  // namespace
+
+template <typename ParamT>
+void PriorBoxCompute<ParamT>::ReInitWhenNeeded() {
+  auto& param = this->template Param<param_t>();
+  auto input_dims = param.input->dims();
+  auto image_dims = param.image->dims();
+  if (last_input_shape_ == input_dims && last_image_shape_ == image_dims) {
+    return;
+  }
+  const int height = input_dims[2];
+  const int width = input_dims[3];
+  lite::x86::math::PriorBoxConfig config;
+  config.img_w = param.img_w;
+  config.img_h = param.img_h;
+  if (config.img_w == 0 || config.img_h == 0) {
+    config.img_w = image_dims[3];
+    config.img_h = image_dims[2];
+  }
+  config.step_w = param.step_w;
+  config.step_h = param.step_h;
+  if (config.step_w == 0 || config.step_h == 0) {
+    config.step_w = static_cast<float>(config.img_w) / width;
+    config.step_h = static_cast<float>(config.img_h) / height;
+  }
+  config.offset = param.offset;
+  config.clip = param.clip;
+  config.min_max_aspect_ratios_order = param.min_max_aspect_ratios_order;
+  config.min_sizes = param.min_sizes;
+  config.max_sizes = param.max_sizes;
+  config.variances = param.variances_;
+  SetDensityConfig(param, &config);
+
+  int prior_num = lite::x86::math::PriorBoxNum(config);
+  DDim out_dims({height, width, prior_num, 4});
+  boxes_.Resize(out_dims);
+  variances_.Resize(out_dims);
+  lite::x86::math::PriorBox(config,
+                            height,
+                            width,
+                            boxes_.mutable_data<float>(),
+                            variances_.mutable_data<float>());
+  last_input_shape_ = input_dims;
+  last_image_shape_ = image_dims;
+}
+
+template <typename ParamT>
+void PriorBoxCompute<ParamT>::Run() {
+  auto& param = this->template Param<param_t>();
+  param.boxes->CopyDataFrom(boxes_);
+  param.variances->CopyDataFrom(variances_);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::PriorBoxCompute<
+    paddle::lite::operators::PriorBoxParam>
+    PriorBoxFp32;
+typedef paddle::lite::kernels::x86::PriorBoxCompute<
+    paddle::lite::operators::DensityPriorBoxParam>
+    DensityPriorBoxFp32;
+
+REGISTER_LITE_KERNEL(prior_box, kX86, kFloat, kNCHW, PriorBoxFp32, def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Image", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Boxes", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Variances", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    density_prior_box, kX86, kFloat, kNCHW, DensityPriorBoxFp32, def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Image", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Boxes", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Variances", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,210 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/roi_align_compute.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+const int kROISize = 4;
+
+// The positions and the weights of the 4 neighbours of every sample point of
+// a roi, they are shared by all the channels.
+void PreCalcForBilinearInterpolate(const int height,
+                                   const int width,
+                                   const int pooled_height,
+                                   const int pooled_width,
+                                   float roi_ymin,
+                                   float roi_xmin,
+                                   float bin_size_h,
+                                   float bin_size_w,
+                                   int roi_bin_grid_h,
+                                   int roi_bin_grid_w,
+                                   int* pre_pos,
+                                   float* pre_w) {
+  for (int ph = 0; ph < pooled_height; ph++) {
+    for (int pw = 0; pw < pooled_width; pw++) {
+      for (int iy = 0; iy < roi_bin_grid_h; iy++) {
+        float y = roi_ymin + ph * bin_size_h +
+                  static_cast<float>(iy + .5f) * bin_size_h /
+                      static_cast<float>(roi_bin_grid_h);
+        for (int ix = 0; ix < roi_bin_grid_w; ix++) {
+          float x = roi_xmin + pw * bin_size_w +
+                    static_cast<float>(ix + .5f) * bin_size_w /
+                        static_cast<float>(roi_bin_grid_w);
+          if (y < -1.0 || y > height || x < -1.0 || x > width) {
+            for (int i = 0; i < kROISize; ++i) {
+              pre_pos[i] = 0;
+              pre_w[i] = 0;
+            }
+            pre_pos += kROISize;
+            pre_w += kROISize;
+            continue;
+          }
+          float yy = y <= 0 ? 0 : y;
+          float xx = x <= 0 ? 0 : x;
+          int y_low = static_cast<int>(yy);
+          int x_low = static_cast<int>(xx);
+          int y_high;
+          int x_high;
+          if (y_low >= height - 1) {
+            y_high = y_low = height - 1;
+            yy = static_cast<float>(y_low);
+          } else {
+            y_high = y_low + 1;
+          }
+          if (x_low >= width - 1) {
+            x_high = x_low = width - 1;
+            xx = static_cast<float>(x_low);
+          } else {
+            x_high = x_low + 1;
+          }
+          float ly = yy - y_low;
+          float lx = xx - x_low;
+          float hy = 1. - ly;
+          float hx = 1. - lx;
+          pre_pos[0] = y_low * width + x_low;
+          pre_pos[1] = y_low * width + x_high;
+          pre_pos[2] = y_high * width + x_low;
+          pre_pos[3] = y_high * width + x_high;
+          pre_w[0] = hy * hx;
+          pre_w[1] = hy * lx;
+          pre_w[2] = ly * hx;
+          pre_w[3] = ly * lx;
+          pre_pos += kROISize;
+          pre_w += kROISize;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+// The rois are pooled in parallel, the bilinear positions and weights of a
+// roi are computed once and applied to all the channels.
+void RoiAlignCompute::Run() {
+  auto& param = Param<operators::RoiAlignParam>();
+  auto* in = param.X;
+  auto* rois = param.ROIs;
+  auto* out = param.Out;
+  const float spatial_scale = param.spatial_scale;
+  const int pooled_height = param.pooled_height;
+  const int pooled_width = param.pooled_width;
+  const int sampling_ratio = param.sampling_ratio;
+
+  auto in_dims = in->dims();
+  const int channels = in_dims[1];
+  const int height = in_dims[2];
+  const int width = in_dims[3];
+  const int64_t rois_num = rois->dims()[0];
+  const int64_t roi_stride = rois->dims()[1];
+  if (rois_num == 0) {
+    return;
+  }
+  const int64_t in_channel_size = height * width;
+  const int64_t out_channel_size = pooled_height * pooled_width;
+
+  auto rois_lod = rois->lod().back();
+  std::vector<int> roi_batch_ids(rois_num);
+  for (size_t n = 0; n + 1 < rois_lod.size(); ++n) {
+    for (size_t i = rois_lod[n]; i < rois_lod[n + 1]; ++i) {
+      roi_batch_ids[i] = n;
+    }
+  }
+
+  const float* input_data = in->data<float>();
+  const float* rois_data = rois->data<float>();
+  float* output_data = out->mutable_data<float>();
+  lite::x86::RunParallelFor(0, rois_num, [&](int64_t begin, int64_t end) {
+    std::vector<int> pre_pos;
+    std::vector<float> pre_w;
+    for (int64_t n = begin; n < end; ++n) {
+      const float* roi = rois_data + n * roi_stride;
+      float roi_xmin = roi[0] * spatial_scale;
+      float roi_ymin = roi[1] * spatial_scale;
+      float roi_xmax = roi[2] * spatial_scale;
+      float roi_ymax = roi[3] * spatial_scale;
+      float roi_width = std::max(roi_xmax - roi_xmin, 1.0f);
+      float roi_height = std::max(roi_ymax - roi_ymin, 1.0f);
+      float bin_size_h = roi_height / pooled_height;
+      float bin_size_w = roi_width / pooled_width;
+      int roi_bin_grid_h = (sampling_ratio > 0)
+                               ? sampling_ratio
+                               : std::ceil(roi_height / pooled_height);
+      int roi_bin_grid_w = (sampling_ratio > 0)
+                               ? sampling_ratio
+                               : std::ceil(roi_width / pooled_width);
+      const float count = roi_bin_grid_h * roi_bin_grid_w;
+      const int samples = roi_bin_grid_h * roi_bin_grid_w;
+      pre_pos.resize(out_channel_size * samples * kROISize);
+      pre_w.resize(out_channel_size * samples * kROISize);
+      PreCalcForBilinearInterpolate(height,
+                                    width,
+                                    pooled_height,
+                                    pooled_width,
+                                    roi_ymin,
+                                    roi_xmin,
+                                    bin_size_h,
+                                    bin_size_w,
+                                    roi_bin_grid_h,
+                                    roi_bin_grid_w,
+                                    pre_pos.data(),
+                                    pre_w.data());
+
+      const float* batch_data =
+          input_data + roi_batch_ids[n] * channels * in_channel_size;
+      float* roi_out = output_data + n * channels * out_channel_size;
+      for (int c = 0; c < channels; c++) {
+        const float* channel_data = batch_data + c * in_channel_size;
+        float* channel_out = roi_out + c * out_channel_size;
+        const int* pos = pre_pos.data();
+        const float* w = pre_w.data();
+        for (int64_t p = 0; p < out_channel_size; p++) {
+          float output_val = 0;
+          for (int s = 0; s < samples * kROISize; s++) {
+            output_val += w[s] * channel_data[pos[s]];
+          }
+          pos += samples * kROISize;
+          w += samples * kROISize;
+          channel_out[p] = output_val / count;
+        }
+      }
+    }
+  });
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(roi_align,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::RoiAlignCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("ROIs", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
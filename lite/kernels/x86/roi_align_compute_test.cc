@@ -0,0 +1,182 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/roi_align_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+float BilinearRef(const float* data, int height, int width, float y, float x) {
+  if (y < -1.0 || y > height || x < -1.0 || x > width) {
+    return 0;
+  }
+  y = y <= 0 ? 0 : y;
+  x = x <= 0 ? 0 : x;
+  int y_low = static_cast<int>(y);
+  int x_low = static_cast<int>(x);
+  int y_high;
+  int x_high;
+  if (y_low >= height - 1) {
+    y_high = y_low = height - 1;
+    y = static_cast<float>(y_low);
+  } else {
+    y_high = y_low + 1;
+  }
+  if (x_low >= width - 1) {
+    x_high = x_low = width - 1;
+    x = static_cast<float>(x_low);
+  } else {
+    x_high = x_low + 1;
+  }
+  float ly = y - y_low;
+  float lx = x - x_low;
+  float hy = 1. - ly;
+  float hx = 1. - lx;
+  return hy * hx * data[y_low * width + x_low] +
+         hy * lx * data[y_low * width + x_high] +
+         ly * hx * data[y_high * width + x_low] +
+         ly * lx * data[y_high * width + x_high];
+}
+
+// The roi_align of every output element, without the shared precomputation
+// of the kernel.
+void RoiAlignRef(const Tensor& x,
+                 const Tensor& rois,
+                 float spatial_scale,
+                 int pooled_height,
+                 int pooled_width,
+                 int sampling_ratio,
+                 std::vector<float>* out) {
+  const int channels = x.dims()[1];
+  const int height = x.dims()[2];
+  const int width = x.dims()[3];
+  auto lod = rois.lod().back();
+  for (size_t b = 0; b + 1 < lod.size(); b++) {
+    for (size_t n = lod[b]; n < lod[b + 1]; n++) {
+      const float* roi = rois.data<float>() + n * 4;
+      float roi_xmin = roi[0] * spatial_scale;
+      float roi_ymin = roi[1] * spatial_scale;
+      float roi_width = std::max(roi[2] * spatial_scale - roi_xmin, 1.0f);
+      float roi_height = std::max(roi[3] * spatial_scale - roi_ymin, 1.0f);
+      float bin_size_h = roi_height / pooled_height;
+      float bin_size_w = roi_width / pooled_width;
+      int grid_h = sampling_ratio > 0 ? sampling_ratio
+                                      : std::ceil(roi_height / pooled_height);
+      int grid_w = sampling_ratio > 0 ? sampling_ratio
+                                      : std::ceil(roi_width / pooled_width);
+      for (int c = 0; c < channels; c++) {
+        const float* data =
+            x.data<float>() + (b * channels + c) * height * width;
+        for (int ph = 0; ph < pooled_height; ph++) {
+          for (int pw = 0; pw < pooled_width; pw++) {
+            float sum = 0;
+            for (int iy = 0; iy < grid_h; iy++) {
+              float y = roi_ymin + ph * bin_size_h +
+                        (iy + .5f) * bin_size_h / static_cast<float>(grid_h);
+              for (int ix = 0; ix < grid_w; ix++) {
+                float xx = roi_xmin + pw * bin_size_w +
+                           (ix + .5f) * bin_size_w / static_cast<float>(grid_w);
+                sum += BilinearRef(data, height, width, y, xx);
+              }
+            }
+            out->push_back(sum / (grid_h * grid_w));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(roi_align_x86, retrive_op) {
+  auto roi_align = KernelRegistry::Global().Create("roi_align");
+  ASSERT_FALSE(roi_align.empty());
+  ASSERT_TRUE(roi_align.front());
+}
+
+TEST(roi_align_x86, compute) {
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  const int batch = 2;
+  const int channels = 3;
+  const int height = 12;
+  const int width = 10;
+  Tensor x;
+  x.Resize({batch, channels, height, width});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = dist(rng);
+  }
+  // The rois of the images, some of them are out of the feature map or
+  // smaller than a bin.
+  const std::vector<uint64_t> lod0{0, 3, 7};
+  Tensor rois;
+  rois.Resize({static_cast<int64_t>(lod0.back()), 4});
+  auto* rois_data = rois.mutable_data<float>();
+  std::uniform_real_distribution<float> pos(-8.f, 48.f);
+  std::uniform_real_distribution<float> size(1.f, 40.f);
+  for (uint64_t i = 0; i < lod0.back(); i++) {
+    rois_data[i * 4] = pos(rng);
+    rois_data[i * 4 + 1] = pos(rng);
+    rois_data[i * 4 + 2] = rois_data[i * 4] + size(rng);
+    rois_data[i * 4 + 3] = rois_data[i * 4 + 1] + size(rng);
+  }
+  rois.set_lod({lod0});
+
+  for (int sampling_ratio : {-1, 2}) {
+    for (int pooled : {1, 3}) {
+      Tensor out;
+      out.Resize({rois.dims()[0], channels, pooled, pooled});
+      RoiAlignCompute roi_align;
+      operators::RoiAlignParam param;
+      param.X = &x;
+      param.ROIs = &rois;
+      param.Out = &out;
+      param.spatial_scale = 0.25f;
+      param.pooled_height = pooled;
+      param.pooled_width = pooled;
+      param.sampling_ratio = sampling_ratio;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      roi_align.SetContext(std::move(ctx));
+      roi_align.SetParam(param);
+      roi_align.Run();
+
+      std::vector<float> ref;
+      RoiAlignRef(x, rois, 0.25f, pooled, pooled, sampling_ratio, &ref);
+      ASSERT_EQ(out.numel(), static_cast<int64_t>(ref.size()));
+      for (int64_t i = 0; i < out.numel(); i++) {
+        EXPECT_NEAR(out.data<float>()[i], ref[i], 1e-5) << i;
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(roi_align, kX86, kFloat, kNCHW, def);
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/fluid/lod.h"
 
 namespace paddle {
 namespace lite {
@@ -63,10 +64,11 @@ void SearchGrnnCompute<T>::PrepareLayout(const Tensor* input_blob) {
   int batch = _input->lod()[0].size() - 1;
   auto& offset = _input->lod()[0];
 
-  Tensor _width;
-  _width.Resize({batch});
+  auto& context = ctx_->As<X86Context>();
+  lite::ScratchScope scratch(context.scratch_arena());
+  lite::ScratchVector<int> width(batch, 0, scratch.arena());
   _idx_sorted_by_width->Resize({batch});
-  int* width_data = _width.template mutable_data<int>();
+  int* width_data = width.data();
   int* idx_sorted_by_width_data =
       _idx_sorted_by_width->template mutable_data<int>();
   // sort sequence by width (descending) and find the largest width in the
@@ -75,16 +77,20 @@ void SearchGrnnCompute<T>::PrepareLayout(const Tensor* input_blob) {
     width_data[i] = offset[i + 1] - offset[i];
     idx_sorted_by_width_data[i] = i;
   }
-  std::stable_sort(idx_sorted_by_width_data,
-                   idx_sorted_by_width_data + batch,
-                   [&_width](int a, int b) {
-                     return _width.template data<int>()[a] >
-                            _width.template data<int>()[b];
-                   });
+  // Sequences of equal width keep their input order.
+  std::sort(idx_sorted_by_width_data,
+            idx_sorted_by_width_data + batch,
+            [width_data](int a, int b) {
+              return width_data[a] > width_data[b] ||
+                     (width_data[a] == width_data[b] && a < b);
+            });
   int max_width = width_data[idx_sorted_by_width_data[0]];
 
-  // start of reorganizing the input
-  std::vector<uint64_t> new_offset;
+  // start of reorganizing the input, the offsets are written to the lod of
+  // the layout input in place.
+  auto* new_lod = _layout_input->mutable_lod();
+  new_lod->resize(1);
+  auto& new_offset = (*new_lod)[0];
   new_offset.resize(max_width + 1);
 
   new_offset[0] = 0;
@@ -117,9 +123,6 @@ void SearchGrnnCompute<T>::PrepareLayout(const Tensor* input_blob) {
     LOG(FATAL) << "_input->dims().size() = 1, error.";
   } else {
     // _layout_input.reshape_batch_sequence({dim0, dim1}, new_offset);
-    LoD new_lod;
-    new_lod.push_back(new_offset);
-    _layout_input->set_lod(new_lod);
     _layout_input->Resize({dim0, dim1});
   }
 
@@ -173,9 +176,8 @@ void SearchGrnnCompute<T>::Run() {
   int batch = bottom->lod()[0].size() - 1;
 
   const auto& offset = bottom->lod()[0];
-  LoD top_lod;
-  top_lod.push_back(offset);
-  top->set_lod(top_lod);
+  lite::fluid::SetSingleLevelLoD(
+      offset.begin(), offset.end(), top->mutable_lod());
   std::vector<int64_t> top_dims_vec{_cap_l, _cap_h};
   top->Resize(top_dims_vec);
   auto* top_hidden = top->template mutable_data<T>();
@@ -16,6 +16,7 @@
 #include <vector>
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
+#include "lite/fluid/lod.h"
 
 namespace paddle {
 namespace lite {
@@ -42,7 +43,7 @@ class SearchGroupPaddingCompute
     int dim0 = bottom0->dims()[0];
     int dim1 = bottom0->dims()[1];
 
-    const auto offset = bottom0->lod()[0];
+    const auto& offset = bottom0->lod()[0];
     int max_seq = 0;
     for (int i = 0; i < batch; ++i) {
       if (offset[i + 1] - offset[i] > max_seq) {
@@ -50,30 +51,26 @@ class SearchGroupPaddingCompute
       }
     }
 
-    std::vector<uint64_t> new_offset;
+    // for padding data, the lods are written in place.
+    auto* top0_lod = top0->mutable_lod();
+    top0_lod->resize(1);
+    auto& new_offset = (*top0_lod)[0];
     new_offset.resize(batch + 1);
     for (int i = 0; i < batch + 1; ++i) {
       new_offset[i] = i * max_seq;
     }
-
-    // for padding data
-    lite::LoD top0_lod;
-    top0_lod.push_back(new_offset);
-    top0->set_lod(top0_lod);
     top0->Resize({batch * max_seq, dim1});
     // for origin input id
     // already set by ShareLoD in InferShape
-    lite::LoD top1_lod;
-    top1_lod.push_back(offset);
-    top1->set_lod(top1_lod);
+    lite::fluid::SetSingleLevelLoD(
+        offset.begin(), offset.end(), top1->mutable_lod());
     top1->Resize({dim0, 1});
     memset(top1->template mutable_data<T>(),
            0,
            top1->dims()[0] * top1->dims()[1] * sizeof(T));
     // for padding input id
-    lite::LoD top2_lod;
-    top2_lod.push_back(new_offset);
-    top2->set_lod(top2_lod);
+    lite::fluid::SetSingleLevelLoD(
+        new_offset.begin(), new_offset.end(), top2->mutable_lod());
     top2->Resize({batch * max_seq, 1});
     // copy data
     const auto* bottom_data = bottom0->template data<T>();
@@ -14,6 +14,7 @@
 
 #include "lite/kernels/x86/search_seq_depadding_compute.h"
 #include <vector>
+#include "lite/fluid/lod.h"
 
 namespace paddle {
 namespace lite {
@@ -38,9 +39,8 @@ void SearchSeqDepaddingCompute<T>::Run() {
   const auto& src_offset = src->lod()[0];
   const int src_cap_l = src->dims()[0];
 
-  LoD out_lod;
-  out_lod.push_back(src_offset);
-  out->set_lod(out_lod);
+  lite::fluid::SetSingleLevelLoD(
+      src_offset.begin(), src_offset.end(), out->mutable_lod());
   out->Resize({src_cap_l, pad_cap_e});
 
   const auto* pad_data = pad->template data<T>();
@@ -22,28 +22,6 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
-template <typename T>
-inline LoD ConcatLoD(const std::vector<lite::Tensor*>& xs,
-                     std::vector<lite::Tensor>* xs_in_order) {
-  std::vector<uint64_t> result;
-  result.resize(xs[0]->lod()[0].size());
-
-  for (size_t i = 1; i < result.size(); ++i) {
-    size_t sum = 0;
-    for (size_t j = 0; j < xs.size(); ++j) {
-      auto& x_lod = xs[j]->lod()[0];
-      if (x_lod[i - 1] < x_lod[i]) {
-        xs_in_order->emplace_back(xs[j]->Slice<T>(x_lod[i - 1], x_lod[i]));
-      }
-      sum += x_lod[i];
-    }
-    result[i] = sum;
-  }
-  LoD lod;
-  lod.emplace_back(result);
-  return lod;
-}
-
 template <typename T>
 class SequenceConcatCompute
     : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
@@ -55,11 +33,11 @@ class SequenceConcatCompute
 
     int64_t batch_size = 0;
     int64_t feature_size = 0;
-    std::vector<int64_t> out_dims;
+    DDim out_dims;
     for (const auto& tensor : param.X) {
-      const auto x_dims = tensor->dims();
+      const auto& x_dims = tensor->dims();
       if (out_dims.empty()) {
-        out_dims = x_dims.Vectorize();
+        out_dims = x_dims;
       }
       batch_size += x_dims[0];
       if (feature_size == 0) {
@@ -77,23 +55,29 @@ class SequenceConcatCompute
 
     T* dout = param.Out->template mutable_data<T>();
 
-    std::vector<lite::Tensor> x_in_order;
-    param.Out->set_lod(ConcatLoD<T>(param.X, &x_in_order));
-
-    int num = x_in_order.size();
-    int out_rows = 1;
-
-    std::vector<int64_t> input_cols(num);
-    for (int i = 0; i < num; ++i) {
-      input_cols[i] = x_in_order[i].numel() / out_rows;
-    }
-
-    int col_idx = 0;
-    for (int j = 0; j < num; ++j) {
-      int col_len = input_cols[j];
-      auto input_data = x_in_order[j].data<T>();
-      memcpy(dout + col_idx, input_data, sizeof(T) * col_len);
-      col_idx += col_len;
+    // The i-th sequence of the output is the i-th sequences of the inputs in
+    // order, they are copied directly and the lod of the output is written in
+    // place, so no slice or lod is allocated per run.
+    const auto& x0_lod = param.X[0]->lod()[0];
+    auto* out_lod = param.Out->mutable_lod();
+    out_lod->resize(1);
+    auto& out_offset = (*out_lod)[0];
+    out_offset.assign(x0_lod.size(), 0);
+    for (size_t i = 1; i < out_offset.size(); ++i) {
+      uint64_t sum = 0;
+      for (auto* x : param.X) {
+        auto& x_lod = x->lod()[0];
+        if (x_lod[i - 1] < x_lod[i]) {
+          int64_t width = x->numel() / x->dims()[0];
+          int64_t len = (x_lod[i] - x_lod[i - 1]) * width;
+          memcpy(dout,
+                 x->template data<T>() + x_lod[i - 1] * width,
+                 sizeof(T) * len);
+          dout += len;
+        }
+        sum += x_lod[i];
+      }
+      out_offset[i] = sum;
     }
   }
 
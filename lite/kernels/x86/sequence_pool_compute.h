@@ -34,7 +34,7 @@ class SequencePoolCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto& context = ctx_->As<X86Context>();
     auto* out = param.Out;
     auto dims = param.X->dims();
-    auto lod = param.X->lod();
+    const auto& lod = param.X->lod();
     CHECK_EQ(lod.size(), 1UL);
     CHECK_GE(dims[0], static_cast<int64_t>(lod[0].size() - 1));
 
@@ -35,7 +35,7 @@ class SequenceReverseCompute : public KernelLite<TARGET(kX86), Ptype> {
     T* dout = output->template mutable_data<T>();
     CHECK_NE(din, dout)
         << "SequenceReverse Op does not support in-place operation";
-    const auto lod = param.X->lod()[param.X->lod().size() - 1];
+    const auto& lod = param.X->lod()[param.X->lod().size() - 1];
     const size_t lod_count = lod.size();
 
     size_t limit = static_cast<size_t>(param.X->numel());
@@ -0,0 +1,221 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/core/scratch_arena.h"
+#include "lite/kernels/x86/match_matrix_tensor_compute.h"
+#include "lite/kernels/x86/search_grnn_compute.h"
+#include "lite/kernels/x86/sequence_pool_compute.h"
+#include "lite/kernels/x86/sequence_topk_avg_pooling_compute.h"
+#include "lite/kernels/x86/var_conv_2d_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void FillTensor(Tensor* tensor, float scale) {
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = scale * static_cast<float>(i % 7 - 3);
+  }
+}
+
+template <typename Kernel>
+void SetX86Context(Kernel* kernel) {
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel->SetContext(std::move(ctx));
+}
+
+// The text matching network of the match pyramid models: the two sequences
+// are encoded by search_grnn, matched by match_matrix_tensor and the match
+// matrices are convolved and pooled by var_conv_2d and
+// sequence_topk_avg_pooling.
+class MatchPyramid {
+ public:
+  MatchPyramid() {
+    wi_.Resize({3, kHidden, kInput});
+    wh_.Resize({3, kHidden, kHidden});
+    w_.Resize({kHidden, kDimT, kHidden});
+    conv_w_.Resize({kOutputChannel, kDimT * 3 * 3});
+    FillTensor(&wi_, 0.01f);
+    FillTensor(&wh_, 0.01f);
+    FillTensor(&w_, 0.01f);
+    FillTensor(&conv_w_, 0.01f);
+
+    for (int i = 0; i < 2; i++) {
+      grnn_param_[i].x = &x_[i];
+      grnn_param_[i].wi = &wi_;
+      grnn_param_[i].wh = &wh_;
+      grnn_param_[i].num_input = kInput;
+      grnn_param_[i].num_hidden = kHidden;
+      grnn_param_[i].out = &hidden_[i];
+      grnn_param_[i].tmp_buffer = &grnn_tmp_[i];
+      grnn_param_[i].idx_sorted_by_width = &grnn_idx_[i];
+      grnn_param_[i].layout_input = &grnn_layout_[i];
+      SetX86Context(&grnn_[i]);
+      grnn_[i].SetParam(grnn_param_[i]);
+    }
+
+    pool_param_.X = &hidden_[0];
+    pool_param_.Out = &pooled_;
+    pool_param_.pool_type = "SUM";
+    SetX86Context(&pool_);
+    pool_.SetParam(pool_param_);
+
+    match_param_.x = &hidden_[0];
+    match_param_.w = &w_;
+    match_param_.y = &hidden_[1];
+    match_param_.dim_t = kDimT;
+    match_param_.out = &match_;
+    match_param_.tmp = &match_tmp_;
+    SetX86Context(&match_kernel_);
+    match_kernel_.SetParam(match_param_);
+
+    conv_param_.X = &match_;
+    conv_param_.W = &conv_w_;
+    conv_param_.Out = &conv_;
+    conv_param_.Col = &conv_col_;
+    conv_param_.input_channel = kDimT;
+    conv_param_.output_channel = kOutputChannel;
+    conv_param_.stride_h = 1;
+    conv_param_.stride_w = 1;
+    conv_param_.kernel_h = 3;
+    conv_param_.kernel_w = 3;
+    SetX86Context(&conv_kernel_);
+    conv_kernel_.SetParam(conv_param_);
+
+    topk_param_.X = &conv_;
+    topk_param_.ROW = &row_;
+    topk_param_.COLUMN = &column_;
+    topk_param_.Out = &topk_;
+    topk_param_.pos = &topk_pos_;
+    topk_param_.channel_num = kOutputChannel;
+    topk_param_.topks = {1, 3, 5};
+    SetX86Context(&topk_kernel_);
+    topk_kernel_.SetParam(topk_param_);
+  }
+
+  // Runs a batch, the output shapes are set as the InferShape of the ops.
+  void Run(const std::vector<uint64_t>& left_lod,
+           const std::vector<uint64_t>& right_lod) {
+    const std::vector<uint64_t>* lods[2] = {&left_lod, &right_lod};
+    for (int i = 0; i < 2; i++) {
+      x_[i].Resize({static_cast<int64_t>(lods[i]->back()), kInput});
+      x_[i].set_lod({*lods[i]});
+      FillTensor(&x_[i], 0.1f);
+      hidden_[i].Resize({static_cast<int64_t>(lods[i]->back()), kHidden});
+      grnn_[i].Run();
+    }
+    pool_.Run();
+
+    int64_t match_size = 0;
+    for (size_t b = 0; b + 1 < left_lod.size(); b++) {
+      match_size += kDimT * (left_lod[b + 1] - left_lod[b]) *
+                    (right_lod[b + 1] - right_lod[b]);
+    }
+    match_.Resize({match_size, 1});
+    match_tmp_.Resize(
+        {static_cast<int64_t>(left_lod.back()), kDimT * kHidden});
+    match_kernel_.Run();
+    conv_kernel_.Run();
+
+    row_.Resize({static_cast<int64_t>(left_lod.back()), 1});
+    row_.set_lod({left_lod});
+    column_.Resize({static_cast<int64_t>(right_lod.back()), 1});
+    column_.set_lod({right_lod});
+    topk_.Resize({static_cast<int64_t>(left_lod.back()),
+                  static_cast<int64_t>(kOutputChannel *
+                                       topk_param_.topks.size())});
+    topk_kernel_.Run();
+  }
+
+  const Tensor& topk() const { return topk_; }
+  const Tensor& pooled() const { return pooled_; }
+
+ private:
+  static const int kInput = 16;
+  static const int kHidden = 16;
+  static const int kDimT = 3;
+  static const int kOutputChannel = 4;
+
+  Tensor wi_, wh_, w_, conv_w_;
+  Tensor x_[2], hidden_[2], grnn_tmp_[2], grnn_idx_[2], grnn_layout_[2];
+  Tensor pooled_, match_, match_tmp_, conv_, conv_col_;
+  Tensor row_, column_, topk_, topk_pos_;
+
+  SearchGrnnCompute<float> grnn_[2];
+  operators::SearchGrnnParam grnn_param_[2];
+  SequencePoolCompute<float> pool_;
+  operators::SequencePoolParam pool_param_;
+  MatchMatrixTensorCompute<float> match_kernel_;
+  operators::MatchMatrixTensorParam match_param_;
+  VarConv2DCompute<float> conv_kernel_;
+  operators::VarConv2DParam conv_param_;
+  SequenceTopkAvgPoolingCompute<float> topk_kernel_;
+  operators::SequenceTopkAvgPoolingParam topk_param_;
+};
+
+// Reports the block allocations of the scratch arena over the runs of the
+// batches of different lengths. After the batches are seen once, the runs
+// take the host buffers of the sequence kernels from the merged block.
+TEST(sequence_scratch_arena_x86, match_pyramid) {
+  const std::vector<std::vector<uint64_t>> left_lods = {
+      {0, 3, 5}, {0, 7, 8, 14, 20}, {0, 1, 4, 9}, {0, 12, 30}};
+  const std::vector<std::vector<uint64_t>> right_lods = {
+      {0, 4, 9}, {0, 2, 10, 11, 15}, {0, 6, 8, 9}, {0, 20, 25}};
+  auto& arena = ScratchArena::ThreadLocal();
+  int64_t initial_allocations = arena.num_block_allocations();
+  MatchPyramid model;
+  for (size_t i = 0; i < left_lods.size(); i++) {
+    model.Run(left_lods[i], right_lods[i]);
+  }
+  int64_t warmup_allocations = arena.num_block_allocations();
+  size_t peak = arena.peak_bytes();
+  LOG(INFO) << "warm up block allocations: "
+            << warmup_allocations - initial_allocations
+            << ", peak bytes: " << peak;
+
+  const int repeats = 50;
+  for (int r = 0; r < repeats; r++) {
+    size_t i = r % left_lods.size();
+    model.Run(left_lods[i], right_lods[i]);
+    ASSERT_EQ(model.topk().dims()[0],
+              static_cast<int64_t>(left_lods[i].back()));
+    ASSERT_EQ(model.pooled().dims()[0],
+              static_cast<int64_t>(left_lods[i].size() - 1));
+  }
+  LOG(INFO) << "block allocations of " << repeats << " runs: "
+            << arena.num_block_allocations() - warmup_allocations;
+  EXPECT_EQ(arena.num_block_allocations(), warmup_allocations);
+  EXPECT_EQ(arena.peak_bytes(), peak);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(search_grnn, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(sequence_pool, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(match_matrix_tensor, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(var_conv_2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(sequence_topk_avg_pooling, kX86, kFloat, kNCHW, def);
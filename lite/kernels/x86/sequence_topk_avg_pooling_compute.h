@@ -31,9 +31,11 @@ class SequenceTopkAvgPoolingCompute
 
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
+    auto& context = ctx_->As<X86Context>();
     lite::x86::math::SequenceTopkAvgPoolingFunctor<lite::TargetType::kX86, T>
         sequence_topk_avg_pooling;
-    sequence_topk_avg_pooling(*param.X,
+    sequence_topk_avg_pooling(context,
+                              *param.X,
                               *param.ROW,
                               *param.COLUMN,
                               param.Out,
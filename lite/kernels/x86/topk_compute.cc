@@ -0,0 +1,68 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/topk_compute.h"
+#include <algorithm>
+#include "lite/backends/host/math/topk.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+// The rows of a parallel task cover at least this many values.
+const int64_t kMinTaskSize = 16 * 1024;
+
+}  // namespace
+
+void TopkCompute::Run() {
+  auto& param = Param<operators::TopkParam>();
+  const float* x_data = param.X->data<float>();
+  float* out_val = param.Out->mutable_data<float>();
+  auto out_ind = param.Indices->mutable_data<int64_t>();
+  DDim x_dims = param.X->dims();
+  int K = param.K;
+  int dim_size = x_dims.size();
+  int64_t m = x_dims.production() / x_dims[dim_size - 1];
+  int n = x_dims[dim_size - 1];
+  if (n == 0) return;
+  int64_t grain = std::max<int64_t>(kMinTaskSize / n, 1);
+  lite::x86::RunParallelFor(
+      0,
+      m,
+      [&](int64_t begin, int64_t end) {
+        host::math::TopKSelector<float> selector;
+        for (int64_t i = begin; i < end; i++) {
+          selector.Select(
+              x_data + i * n, n, K, out_val + i * K, out_ind + i * K);
+        }
+      },
+      grain);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(
+    top_k, kX86, kFloat, kNCHW, paddle::lite::kernels::x86::TopkCompute, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Indices",
+                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
+    .Finalize();
@@ -48,8 +48,12 @@ class VarConv2DCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     const auto& offset_y = param.X->lod()[1];
     const auto& offset_x = param.X->lod()[2];
 
-    // top offset is the whole size of each data sample
-    std::vector<uint64_t> top_offset;
+    // top offset is the whole size of each data sample, written to the lod
+    // of col in place.
+    auto* col_lod = col->mutable_lod();
+    col_lod->resize(1);
+    auto& top_offset = (*col_lod)[0];
+    top_offset.clear();
     int top_size = 0;
     top_offset.push_back(top_size);
     for (int b = 0; b < batch; ++b) {
@@ -72,11 +76,6 @@ class VarConv2DCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       top_size += top_y * top_x;
       top_offset.push_back(top_size);
     }
-    // std::vector<int64_t> col_lod_vec;
-    // col_lod_vec.push_back(top_offset);
-    LoD col_lod;
-    col_lod.push_back(top_offset);
-    col->set_lod(col_lod);
     std::vector<int64_t> col_dims_vec{top_size};
     col_dims_vec.push_back(1);
     col->Resize(col_dims_vec);
@@ -149,7 +148,10 @@ class VarConv2DCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     // const auto& offset_y = in_row->lod()[0];
     const auto& offset_y = param.X->lod()[1];
     const auto& offset_x = param.X->lod()[2];
-    std::vector<uint64_t> top_offset;
+    auto* top_lod = top->mutable_lod();
+    top_lod->resize(1);
+    auto& top_offset = (*top_lod)[0];
+    top_offset.clear();
     int top_size = 0;
     top_offset.push_back(top_size);
     for (int b = 0; b < batch; ++b) {
@@ -172,9 +174,6 @@ class VarConv2DCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       top_offset.push_back(top_size);
     }
 
-    LoD top_lod;
-    top_lod.push_back(top_offset);
-    top->set_lod(top_lod);
     std::vector<int64_t> top_dims_vec{top_size};
     top_dims_vec.push_back(1);
     top->Resize(top_dims_vec);
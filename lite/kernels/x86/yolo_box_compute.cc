@@ -0,0 +1,125 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/yolo_box_compute.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+inline float Sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+}  // namespace
+
+/*
+ * Each (image, anchor) plane is decoded by a parallel task. The objectness
+ * of the whole plane goes through the vectorized sigmoid first, then only
+ * the cells with conf >= conf_thresh are decoded, the others stay zero.
+ */
+void YoloBoxCompute::Run() {
+  auto& param = Param<operators::YoloBoxParam>();
+  const lite::Tensor* X = param.X;
+  const int* img_size = param.ImgSize->data<int>();
+  const std::vector<int>& anchors = param.anchors;
+  const int class_num = param.class_num;
+  const float conf_thresh = param.conf_thresh;
+
+  const int n = X->dims()[0];
+  const int h = X->dims()[2];
+  const int w = X->dims()[3];
+  const int an_num = anchors.size() / 2;
+  const int input_size = param.downsample_ratio * h;
+  const int stride = h * w;
+  const int an_stride = (class_num + 5) * stride;
+  const int b_num = an_num * stride;
+  CHECK_EQ(X->dims()[1], an_num * (class_num + 5));
+
+  param.Boxes->Resize({n, b_num, 4});
+  param.Scores->Resize({n, b_num, class_num});
+  const float* x_data = X->data<float>();
+  float* boxes = param.Boxes->mutable_data<float>();
+  float* scores = param.Scores->mutable_data<float>();
+  auto sigmoid =
+      jit::KernelFuncs<jit::VSigmoidTuple<float>, fluid::CPUPlace>::Cache().At(
+          stride);
+
+  lite::x86::RunParallelFor(0, n * an_num, [&](int64_t begin, int64_t end) {
+    std::vector<float> conf(stride);
+    for (int64_t plane = begin; plane < end; ++plane) {
+      const int i = plane / an_num;
+      const int j = plane % an_num;
+      const float img_height = img_size[2 * i];
+      const float img_width = img_size[2 * i + 1];
+      const float anchor_w = anchors[2 * j];
+      const float anchor_h = anchors[2 * j + 1];
+      const float* x = x_data + plane * an_stride;
+      float* plane_boxes = boxes + plane * stride * 4;
+      float* plane_scores = scores + plane * stride * class_num;
+      memset(plane_boxes, 0, sizeof(float) * stride * 4);
+      memset(plane_scores, 0, sizeof(float) * stride * class_num);
+      sigmoid(x + 4 * stride, conf.data(), stride);
+      for (int k = 0; k < h; ++k) {
+        for (int l = 0; l < w; ++l) {
+          const int hw = k * w + l;
+          if (conf[hw] < conf_thresh) continue;
+          float cx = (l + Sigmoid(x[hw])) * img_width / h;
+          float cy = (k + Sigmoid(x[hw + stride])) * img_height / h;
+          float bw =
+              std::exp(x[hw + 2 * stride]) * anchor_w * img_width / input_size;
+          float bh = std::exp(x[hw + 3 * stride]) * anchor_h * img_height /
+                     input_size;
+          float* box = plane_boxes + hw * 4;
+          box[0] = std::max(cx - bw / 2, 0.f);
+          box[1] = std::max(cy - bh / 2, 0.f);
+          box[2] = std::min(cx + bw / 2, img_width - 1);
+          box[3] = std::min(cy + bh / 2, img_height - 1);
+          float* score = plane_scores + hw * class_num;
+          const float* label = x + 5 * stride + hw;
+          for (int c = 0; c < class_num; ++c) {
+            score[c] = conf[hw] * Sigmoid(label[c * stride]);
+          }
+        }
+      }
+    }
+  });
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(yolo_box,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::YoloBoxCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("ImgSize",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindOutput("Boxes", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Scores", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -32,6 +32,7 @@
 #include "lite/model_parser/pb/program_desc.h"
 #include "lite/model_parser/pb/var_desc.h"
 #endif
+#include "lite/utils/float16.h"
 #include "lite/utils/io.h"
 
 namespace paddle {
@@ -45,7 +46,7 @@ int SizeOfType(framework::proto::VarType::Type type) {
   case Type::VarType_Type_##desc: \
     return sizeof(type);
     DO(BOOL, bool);
-    DO(FP16, float);
+    DO(FP16, float16);
     DO(FP32, float);
     DO(INT8, int8_t);
     DO(INT16, int16_t);
@@ -92,6 +93,7 @@ void TensorFromStream(std::istream &is, lite::Tensor *tensor) {
     break
 
     // SET_TENSOR(BOOL, bool, PRECISION(kBool));
+    SET_TENSOR(FP16, float16, PRECISION(kFP16));
     SET_TENSOR(FP32, float, PRECISION(kFloat));
     SET_TENSOR(INT8, int8_t, PRECISION(kInt8));
     SET_TENSOR(INT16, int16_t, PRECISION(kInt16));
@@ -369,6 +371,7 @@ void TensorToStream(std::ostream &os, const lite::Tensor &tensor) {
     desc.set_data_type(type_desc);          \
     break
 
+      SET_DATA_TYPE(PRECISION(kFP16), framework::proto::VarType_Type_FP16);
       SET_DATA_TYPE(PRECISION(kFloat), framework::proto::VarType_Type_FP32);
       SET_DATA_TYPE(PRECISION(kInt8), framework::proto::VarType_Type_INT8);
       SET_DATA_TYPE(PRECISION(kInt16), framework::proto::VarType_Type_INT16);
@@ -449,6 +452,7 @@ void SetParamInfoNaive(naive_buffer::ParamDesc *param_desc,
     desc.SetDataType(type_desc);            \
     break;
 
+    SET_DATA_TYPE(PRECISION(kFP16), VarDescAPI::VarDataType::FP16);
     SET_DATA_TYPE(PRECISION(kFloat), VarDescAPI::VarDataType::FP32);
     SET_DATA_TYPE(PRECISION(kInt8), VarDescAPI::VarDataType::INT8);
     SET_DATA_TYPE(PRECISION(kInt16), VarDescAPI::VarDataType::INT16);
@@ -494,6 +498,7 @@ void SetParamInfoNaive(naive_buffer::ParamDesc *param_desc,
   case precision:                                                \
     desc.SetData<type>(tensor.data<type>(), tensor.data_size()); \
     break;
+      DO(PRECISION(kFP16), float16);
       DO(PRECISION(kFloat), float);
       DO(PRECISION(kInt8), int8_t);
       DO(PRECISION(kInt16), int16_t);
@@ -683,6 +688,7 @@ void GetParamInfoNaive(const naive_buffer::ParamDesc &desc,
     break
 
     // SET_TENSOR(BOOL, bool, PRECISION(kBool));
+    SET_TENSOR(FP16, float16, PRECISION(kFP16));
     SET_TENSOR(FP32, float, PRECISION(kFloat));
     SET_TENSOR(INT8, int8_t, PRECISION(kInt8));
     SET_TENSOR(INT16, int16_t, PRECISION(kInt16));
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 #include "lite/model_parser/naive_buffer/naive_buffer_wrapper_helper.h"
+#include "lite/utils/float16.h"
 
 namespace paddle {
 namespace lite {
@@ -92,6 +93,7 @@ VarDescAPI::VarDataType ParamDesc::GetDataType() const {
     GET_DATA_TYPE_CASE_ITEM(INT16);
     GET_DATA_TYPE_CASE_ITEM(INT32);
     GET_DATA_TYPE_CASE_ITEM(INT64);
+    GET_DATA_TYPE_CASE_ITEM(FP16);
     GET_DATA_TYPE_CASE_ITEM(FP32);
     GET_DATA_TYPE_CASE_ITEM(FP64);
     default:
@@ -119,6 +121,7 @@ void ParamDesc::SetDataType(VarDescAPI::VarDataType data_type) {
     SET_DATA_TYPE_CASE_ITEM(INT16);
     SET_DATA_TYPE_CASE_ITEM(INT32);
     SET_DATA_TYPE_CASE_ITEM(INT64);
+    SET_DATA_TYPE_CASE_ITEM(FP16);
     SET_DATA_TYPE_CASE_ITEM(FP32);
     SET_DATA_TYPE_CASE_ITEM(FP64);
     default:
@@ -162,6 +165,7 @@ GET_DATA_IMPL(int8_t, INT8);
 GET_DATA_IMPL(int16_t, INT16);
 GET_DATA_IMPL(int32_t, INT32);
 GET_DATA_IMPL(int64_t, INT64);
+GET_DATA_IMPL(float16, FP16);
 GET_DATA_IMPL(float, FP32);
 GET_DATA_IMPL(double, FP64);
 #undef GET_DATA_IMPL
@@ -195,6 +199,7 @@ SET_DATA_IMPL(int8_t, INT8);
 SET_DATA_IMPL(int16_t, INT16);
 SET_DATA_IMPL(int32_t, INT32);
 SET_DATA_IMPL(int64_t, INT64);
+SET_DATA_IMPL(float16, FP16);
 SET_DATA_IMPL(float, FP32);
 SET_DATA_IMPL(double, FP64);
 #undef SET_DATA_IMPL
@@ -116,6 +116,7 @@ VarDescAPI::VarDataType VarDesc::GetDataType() const {
     GET_DATA_TYPE_CASE_ITEM(INT16);
     GET_DATA_TYPE_CASE_ITEM(INT32);
     GET_DATA_TYPE_CASE_ITEM(INT64);
+    GET_DATA_TYPE_CASE_ITEM(FP16);
     GET_DATA_TYPE_CASE_ITEM(FP32);
     GET_DATA_TYPE_CASE_ITEM(FP64);
     default:
@@ -152,6 +153,7 @@ void VarDesc::SetDataType(VarDescAPI::VarDataType data_type) {
       SET_DATA_TYPE_CASE_ITEM(INT16);
       SET_DATA_TYPE_CASE_ITEM(INT32);
       SET_DATA_TYPE_CASE_ITEM(INT64);
+      SET_DATA_TYPE_CASE_ITEM(FP16);
       SET_DATA_TYPE_CASE_ITEM(FP32);
       SET_DATA_TYPE_CASE_ITEM(FP64);
       default:
@@ -105,6 +105,23 @@ class ConvOpLite : public OpLite {
       }
     }
 
+    if (std::find(input_arg_names.begin(),
+                  input_arg_names.end(),
+                  "PrepackedFilter") != input_arg_names.end() &&
+        op_desc.HasAttr("prepacked_tag")) {
+      auto prepacked_arguments = op_desc.Input("PrepackedFilter");
+      if (prepacked_arguments.size() > 0) {
+        auto prepacked_var = scope->FindVar(prepacked_arguments.front());
+        if (prepacked_var != nullptr) {
+          param_.prepacked_filter = &(prepacked_var->Get<lite::Tensor>());
+          param_.prepacked_tag = op_desc.GetAttr<std::string>("prepacked_tag");
+          param_.prepacked_only =
+              op_desc.HasAttr("prepacked_only") &&
+              op_desc.GetAttr<bool>("prepacked_only");
+        }
+      }
+    }
+
     if (op_desc.HasAttr("with_act") && op_desc.GetAttr<bool>("with_act")) {
       param_.activation_param.has_active = true;
       auto act_type = op_desc.GetAttr<std::string>("act_type");
@@ -129,6 +146,13 @@ class ConvOpLite : public OpLite {
     if (op_desc.HasAttr("padding_algorithm")) {
       padding_algorithm_ = op_desc.GetAttr<std::string>("padding_algorithm");
     }
+    // For the weight-only quantization
+    if (op_desc.HasAttr("quantization_type") &&
+        op_desc.GetAttr<std::string>("quantization_type") == "weight_only") {
+      param_.weight_scale =
+          op_desc.GetAttr<std::vector<float>>(Filter + "_quant_scale");
+      param_.bit_length = op_desc.GetAttr<int>("quantize_weight_bits");
+    }
     // For Int8
     const OpInfo* op_info = dynamic_cast<const OpInfo*>(&op_desc);
     if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
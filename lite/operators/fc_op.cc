@@ -107,6 +107,13 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
   } else {
     param_.padding_weights = false;
   }
+  // For the weight-only quantization
+  if (op_desc.HasAttr("quantization_type") &&
+      op_desc.GetAttr<std::string>("quantization_type") == "weight_only") {
+    param_.weight_scale =
+        op_desc.GetAttr<std::vector<float>>(W + "_quant_scale");
+    param_.bit_length = op_desc.GetAttr<int>("quantize_weight_bits");
+  }
 
   // For Int8
   const OpInfo* op_info = dynamic_cast<const OpInfo*>(&op_desc);
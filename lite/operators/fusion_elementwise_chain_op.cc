@@ -0,0 +1,74 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fusion_elementwise_chain_op.h"
+#include <string>
+#include <vector>
+#include "lite/backends/host/math/elementwise_chain.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusionElementwiseChainOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.X);
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_EQ_OR_FALSE(param_.axes.size(), param_.Y.size());
+  size_t num_steps = param_.op_types.size();
+  CHECK_GT_OR_FALSE(num_steps, 0UL);
+  CHECK_EQ_OR_FALSE(param_.operand_ids.size(), num_steps);
+  CHECK_EQ_OR_FALSE(param_.alphas.size(), num_steps);
+  CHECK_EQ_OR_FALSE(param_.betas.size(), num_steps);
+  for (auto* y : param_.Y) {
+    CHECK_OR_FALSE(y);
+  }
+  return true;
+}
+
+bool FusionElementwiseChainOp::InferShapeImpl() const {
+  // Every step keeps the shape of X, the operands must broadcast to it.
+  auto x_dims = param_.X->dims().Vectorize();
+  for (size_t i = 0; i < param_.Y.size(); i++) {
+    host::math::ChainOperand operand;
+    CHECK_OR_FALSE(host::math::ChainOperandLayout(
+        x_dims, param_.Y[i]->dims().Vectorize(), param_.axes[i], &operand));
+  }
+  param_.Out->Resize(param_.X->dims());
+  param_.Out->set_lod(param_.X->lod());
+  return true;
+}
+
+bool FusionElementwiseChainOp::AttachImpl(const cpp::OpDesc& opdesc,
+                                          lite::Scope* scope) {
+  param_.X = GetVar<lite::Tensor>(scope, opdesc.Input("X").front());
+  param_.Y.clear();
+  for (auto& name : opdesc.Input("Y")) {
+    param_.Y.push_back(GetVar<lite::Tensor>(scope, name));
+  }
+  param_.Out = GetMutableVar<lite::Tensor>(scope, opdesc.Output("Out").front());
+  param_.axes = opdesc.GetAttr<std::vector<int>>("axes");
+  param_.op_types = opdesc.GetAttr<std::vector<std::string>>("op_types");
+  param_.operand_ids = opdesc.GetAttr<std::vector<int>>("operand_ids");
+  param_.alphas = opdesc.GetAttr<std::vector<float>>("alphas");
+  param_.betas = opdesc.GetAttr<std::vector<float>>("betas");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fusion_elementwise_chain,
+                 paddle::lite::operators::FusionElementwiseChainOp);
@@ -0,0 +1,84 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fusion_kv_cache_attention_op.h"
+#include <string>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusionKVCacheAttentionOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.Q);
+  CHECK_OR_FALSE(param_.K);
+  CHECK_OR_FALSE(param_.V);
+  CHECK_OR_FALSE(param_.Position);
+  CHECK_OR_FALSE(param_.CacheK);
+  CHECK_OR_FALSE(param_.CacheV);
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_GT_OR_FALSE(param_.capacity, 0);
+  auto q_dims = param_.Q->dims();
+  CHECK_EQ_OR_FALSE(q_dims.size(), 4UL);
+  CHECK_OR_FALSE(param_.K->dims() == q_dims);
+  CHECK_OR_FALSE(param_.V->dims() == q_dims);
+  CHECK_GE_OR_FALSE(param_.capacity, q_dims[2]);
+  if (param_.BiasQK) {
+    CHECK_EQ_OR_FALSE(param_.BiasQK->dims().size(), 4UL);
+  }
+  return true;
+}
+
+bool FusionKVCacheAttentionOp::InferShapeImpl() const {
+  // The caches are resized by the kernel, as their batch follows ParentIdx.
+  param_.Out->Resize(param_.Q->dims());
+  param_.Out->set_lod(param_.Q->lod());
+  return true;
+}
+
+bool FusionKVCacheAttentionOp::AttachImpl(const cpp::OpDesc& opdesc,
+                                          lite::Scope* scope) {
+  param_.Q = GetVar<lite::Tensor>(scope, opdesc.Input("Q").front());
+  param_.K = GetVar<lite::Tensor>(scope, opdesc.Input("K").front());
+  param_.V = GetVar<lite::Tensor>(scope, opdesc.Input("V").front());
+  param_.Position =
+      GetVar<lite::Tensor>(scope, opdesc.Input("Position").front());
+  param_.ParentIdx = nullptr;
+  if (opdesc.HasInput("ParentIdx") && !opdesc.Input("ParentIdx").empty()) {
+    param_.ParentIdx =
+        GetVar<lite::Tensor>(scope, opdesc.Input("ParentIdx").front());
+  }
+  param_.BiasQK = nullptr;
+  if (opdesc.HasInput("BiasQK") && !opdesc.Input("BiasQK").empty()) {
+    param_.BiasQK = GetVar<lite::Tensor>(scope, opdesc.Input("BiasQK").front());
+  }
+  // The caches are updated in place.
+  CHECK_EQ(opdesc.Input("CacheK").front(), opdesc.Output("CacheKOut").front());
+  CHECK_EQ(opdesc.Input("CacheV").front(), opdesc.Output("CacheVOut").front());
+  param_.CacheK =
+      GetMutableVar<lite::Tensor>(scope, opdesc.Output("CacheKOut").front());
+  param_.CacheV =
+      GetMutableVar<lite::Tensor>(scope, opdesc.Output("CacheVOut").front());
+  param_.Out = GetMutableVar<lite::Tensor>(scope, opdesc.Output("Out").front());
+  param_.alpha = opdesc.GetAttr<float>("alpha");
+  param_.capacity = opdesc.GetAttr<int>("capacity");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fusion_kv_cache_attention,
+                 paddle::lite::operators::FusionKVCacheAttentionOp);
@@ -0,0 +1,93 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fusion_yolo_box_multiclass_nms_op.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusionYoloBoxMulticlassNmsOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.ImgSize);
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_GT_OR_FALSE(param_.X.size(), 0UL);
+  CHECK_EQ_OR_FALSE(param_.anchor_nums.size(), param_.X.size());
+  CHECK_EQ_OR_FALSE(param_.downsample_ratios.size(), param_.X.size());
+  CHECK_GT_OR_FALSE(param_.class_num, 0);
+  auto dim_imgsize = param_.ImgSize->dims();
+  CHECK_EQ_OR_FALSE(dim_imgsize.size(), 2UL);
+  CHECK_EQ_OR_FALSE(dim_imgsize[1], 2);
+  int num_anchors = 0;
+  for (size_t i = 0; i < param_.X.size(); i++) {
+    CHECK_OR_FALSE(param_.X[i]);
+    auto dim_x = param_.X[i]->dims();
+    int anchor_num = param_.anchor_nums[i];
+    CHECK_OR_FALSE(anchor_num > 0);
+    CHECK_EQ_OR_FALSE(dim_x.size(), 4UL);
+    CHECK_EQ_OR_FALSE(dim_x[0], dim_imgsize[0]);
+    CHECK_EQ_OR_FALSE(dim_x[1], anchor_num * (5 + param_.class_num));
+    num_anchors += anchor_num;
+  }
+  CHECK_EQ_OR_FALSE(param_.anchors.size(),
+                    static_cast<size_t>(num_anchors * 2));
+  return true;
+}
+
+bool FusionYoloBoxMulticlassNmsOp::InferShapeImpl() const {
+  // The number of the detections is known after the NMS.
+  return true;
+}
+
+bool FusionYoloBoxMulticlassNmsOp::AttachImpl(const cpp::OpDesc& opdesc,
+                                              lite::Scope* scope) {
+  param_.X.clear();
+  for (auto& name : opdesc.Input("X")) {
+    param_.X.push_back(GetVar<lite::Tensor>(scope, name));
+  }
+  param_.ImgSize = GetVar<lite::Tensor>(scope, opdesc.Input("ImgSize").front());
+  param_.Out = GetMutableVar<lite::Tensor>(scope, opdesc.Output("Out").front());
+  std::vector<std::string> output_arg_names = opdesc.OutputArgumentNames();
+  if (std::find(output_arg_names.begin(), output_arg_names.end(), "Index") !=
+      output_arg_names.end()) {
+    auto index_name = opdesc.Output("Index").front();
+    param_.Index = GetMutableVar<lite::Tensor>(scope, index_name);
+  }
+  param_.anchors = opdesc.GetAttr<std::vector<int>>("anchors");
+  param_.anchor_nums = opdesc.GetAttr<std::vector<int>>("anchor_nums");
+  param_.downsample_ratios =
+      opdesc.GetAttr<std::vector<int>>("downsample_ratios");
+  param_.class_num = opdesc.GetAttr<int>("class_num");
+  param_.conf_thresh = opdesc.GetAttr<float>("conf_thresh");
+  param_.background_label = opdesc.GetAttr<int>("background_label");
+  param_.keep_top_k = opdesc.GetAttr<int>("keep_top_k");
+  param_.nms_top_k = opdesc.GetAttr<int>("nms_top_k");
+  param_.score_threshold = opdesc.GetAttr<float>("score_threshold");
+  param_.nms_threshold = opdesc.GetAttr<float>("nms_threshold");
+  param_.nms_eta = opdesc.GetAttr<float>("nms_eta");
+  if (opdesc.HasAttr("normalized")) {
+    param_.normalized = opdesc.GetAttr<bool>("normalized");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fusion_yolo_box_multiclass_nms,
+                 paddle::lite::operators::FusionYoloBoxMulticlassNmsOp);
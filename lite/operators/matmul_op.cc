@@ -147,6 +147,13 @@ bool MatMulOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   param_.transpose_X = op_desc.GetAttr<bool>("transpose_X");
   param_.transpose_Y = op_desc.GetAttr<bool>("transpose_Y");
   param_.alpha = op_desc.GetAttr<float>("alpha");
+  // For the weight-only quantization
+  if (op_desc.HasAttr("quantization_type") &&
+      op_desc.GetAttr<std::string>("quantization_type") == "weight_only") {
+    param_.weight_scale =
+        op_desc.GetAttr<std::vector<float>>(Y + "_quant_scale");
+    param_.bit_length = op_desc.GetAttr<int>("quantize_weight_bits");
+  }
   return true;
 }
 
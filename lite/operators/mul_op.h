@@ -58,6 +58,13 @@ class MulOpLite : public OpLite {
     param_.output = var->GetMutable<Tensor>();
     param_.x_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
     param_.y_num_col_dims = op_desc.GetAttr<int>("y_num_col_dims");
+    // For the weight-only quantization
+    if (op_desc.HasAttr("quantization_type") &&
+        op_desc.GetAttr<std::string>("quantization_type") == "weight_only") {
+      param_.weight_scale =
+          op_desc.GetAttr<std::vector<float>>(W + "_quant_scale");
+      param_.bit_length = op_desc.GetAttr<int>("quantize_weight_bits");
+    }
     return true;
   }
 
@@ -413,6 +413,13 @@ struct ConvParam : ParamBase {
   bool var_length{false};
   // only used in conv_transpose.
   std::vector<int> output_size;
+  // the filter packed ahead of time in the layout named by prepacked_tag,
+  // the kernels use it instead of packing the filter if the tags match.
+  const lite::Tensor* prepacked_filter{nullptr};
+  std::string prepacked_tag;
+  // every path of the kernel runs on the prepacked filter, so the original
+  // filter is released once the tags match, only its dims are kept.
+  bool prepacked_only{false};
   // for int8
   WITH_INT8_CONFIG
 
@@ -615,6 +622,61 @@ struct FusionElementwiseActivationGradParam : public ElementwiseGradParam {
   std::string act_type;
 };
 
+// The attention of the new tokens of a decoding step over the keys and values
+// cached by the previous steps, see lite/backends/host/math/
+// kv_cache_attention.h.
+struct FusionKVCacheAttentionParam : ParamBase {
+  // [B, H, T, D], the queries, keys and values of the T new tokens.
+  const lite::Tensor* Q{};
+  const lite::Tensor* K{};
+  const lite::Tensor* V{};
+  // [1], the number of the tokens cached by the previous steps.
+  const lite::Tensor* Position{};
+  // Optional [B], the beam b continues the beam ParentIdx[b] of the previous
+  // step.
+  const lite::Tensor* ParentIdx{};
+  // Optional, the additive mask of the scores, see KVCacheBias.
+  const lite::Tensor* BiasQK{};
+  // [B, H, capacity, D], read and written in place.
+  lite::Tensor* CacheK{};
+  lite::Tensor* CacheV{};
+  lite::Tensor* Out{};
+  float alpha{1.f};
+  int capacity{0};
+};
+
+// The chain of the elementwise, scale and activation ops fused by
+// lite_elementwise_chain_fuse_pass, see lite/backends/host/math/
+// elementwise_chain.h for the meaning of the attributes.
+struct FusionElementwiseChainParam : ParamBase {
+  const lite::Tensor* X{};
+  std::vector<const lite::Tensor*> Y{};
+  lite::Tensor* Out{};
+  // The broadcast axis of each Y.
+  std::vector<int> axes{};
+  std::vector<std::string> op_types{};
+  std::vector<int> operand_ids{};
+  std::vector<float> alphas{};
+  std::vector<float> betas{};
+  ///////////////////////////////////////////////////////////////////////////////////
+  // get a vector of input tensors
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (!input_tensor_ptrs_cache_) {
+      std::vector<const Tensor*> vec({X});
+      vec.insert(vec.end(), Y.begin(), Y.end());
+      input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>(vec));
+    }
+    return input_tensor_ptrs_cache_.get();
+  }
+  // get a vector of output tensors
+  std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (!output_tensor_ptrs_cache_) {
+      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({Out}));
+    }
+    return output_tensor_ptrs_cache_.get();
+  }
+};
+
 /// ----------------------- mean operators ----------------------
 struct MeanParam : ParamBase {
   const lite::Tensor* X{};
@@ -817,6 +879,28 @@ struct MulticlassNmsParam : ParamBase {
   bool normalized{true};
 };
 
+// For the yolo_box ops of the detection heads fused with the multiclass_nms
+struct FusionYoloBoxMulticlassNmsParam : ParamBase {
+  // The inputs of the yolo_box ops, in the order of the concatenated boxes.
+  std::vector<const lite::Tensor*> X{};
+  const lite::Tensor* ImgSize{};
+  lite::Tensor* Out{};
+  lite::Tensor* Index{};
+  // The anchors of all heads, the head i has anchor_nums[i] pairs.
+  std::vector<int> anchors{};
+  std::vector<int> anchor_nums{};
+  std::vector<int> downsample_ratios{};
+  int class_num{0};
+  float conf_thresh{0.f};
+  int background_label{0};
+  float score_threshold{};
+  int nms_top_k{};
+  float nms_threshold{0.3f};
+  float nms_eta{1.0f};
+  int keep_top_k;
+  bool normalized{true};
+};
+
 /// ----------------------- priorbox operators ----------------------
 struct PriorBoxParam : ParamBase {
   lite::Tensor* input{};
@@ -955,6 +1039,8 @@ struct WhileParam : ParamBase {
   int block_idx{-1};
   std::shared_ptr<const cpp::ProgramDesc> program_desc{nullptr};
   Scope* exec_scope{nullptr};
+  // Run the sub-block in the compiled mode, set by the predictor.
+  bool compiled_execution{false};
 };
 
 struct TopkParam : ParamBase {
@@ -1253,6 +1339,8 @@ struct SqueezeParam : ParamBase {
   lite::Tensor* Out{};
   lite::Tensor* XShape{};
   std::vector<int> axes{};
+  // The output shares the memory with X.
+  bool inplace{false};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
@@ -1275,6 +1363,8 @@ struct UnsqueezeParam : ParamBase {
   lite::Tensor* Out{};
   lite::Tensor* XShape{};
   std::vector<int> axes{};
+  // The output shares the memory with X.
+  bool inplace{false};
   const lite::Tensor* axes_tensor{};
   std::vector<const lite::Tensor*> axes_tensor_vct{};
   ///////////////////////////////////////////////////////////////////////////////////
@@ -1316,6 +1406,8 @@ struct MatMulParam : ParamBase {
   bool transpose_X{false};
   bool transpose_Y{false};
   float alpha{1.0f};
+  // for int8
+  WITH_INT8_CONFIG
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
@@ -1344,6 +1436,9 @@ struct AssignParam : ParamBase {
   // for tensor
   const lite::Tensor* X{nullptr};
   lite::Tensor* Out{nullptr};
+  // X is a temporary of a while block read by nothing else, its value is
+  // moved to Out instead of copied.
+  bool move_x{false};
 
   // for tensor_array
   const std::vector<lite::Tensor>* X_array{nullptr};
@@ -1490,6 +1585,8 @@ struct ConditionalBlockParam : ParamBase {
   std::shared_ptr<const cpp::ProgramDesc> program_desc{nullptr};
   Scope* exec_scope{nullptr};
   bool is_scalar_condition{};
+  // Run the sub-block in the compiled mode, set by the predictor.
+  bool compiled_execution{false};
 };
 
 struct CollectFpnProposalsParam : ParamBase {
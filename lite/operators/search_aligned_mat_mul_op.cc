@@ -62,16 +62,17 @@ bool SearchAlignedMatMulOpLite::InferShapeImpl() const {
   int Y_K = y_transpose ? y_inner_size : y_batch_size;
   CHECK_EQ(X_K, Y_K) << "K of Input(X) and Input(Y) is not equal";
 
-  LoD out_lod;
-  std::vector<uint64_t> out_lod_0(seq_num + 1);
+  // The lod is written in place, so its capacity is reused across the runs.
+  auto* out_lod = param_.Out->mutable_lod();
+  out_lod->resize(1);
+  auto& out_lod_0 = (*out_lod)[0];
+  out_lod_0.resize(seq_num + 1);
   out_lod_0[0] = 0;
   for (int i = 0; i < seq_num; i++) {
     out_lod_0[i + 1] = out_lod_0[i] + M;
   }
-  out_lod.push_back(out_lod_0);
   DDim out_dims(
       {static_cast<int64_t>(out_lod_0.back()), static_cast<int64_t>(N)});
-  param_.Out->set_lod(out_lod);
   param_.Out->Resize(out_dims);
   return true;
 }
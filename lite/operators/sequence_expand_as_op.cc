@@ -27,7 +27,7 @@ bool SequenceExpandAsOpLite::CheckShape() const {
 
   auto x_dims = param_.x->dims();
   CHECK_EQ_OR_FALSE(x_dims.size(), 2)
-  auto y_lod = param_.y->lod();
+  const auto &y_lod = param_.y->lod();
   CHECK_EQ_OR_FALSE(y_lod.size(), 1)
   CHECK_EQ_OR_FALSE(static_cast<size_t>(x_dims[0]), y_lod[0].size() - 1)
 
@@ -36,7 +36,7 @@ bool SequenceExpandAsOpLite::CheckShape() const {
 
 bool SequenceExpandAsOpLite::InferShapeImpl() const {
   auto x_dims = param_.x->dims();
-  auto y_lod = param_.y->lod();
+  const auto &y_lod = param_.y->lod();
   auto out_dims = x_dims;
 
   int64_t out_first_dim = 0;
@@ -23,8 +23,8 @@ bool SequenceExpandOp::CheckShape() const {
   CHECK_OR_FALSE(param_.X);
   CHECK_OR_FALSE(param_.Y);
   CHECK_OR_FALSE(param_.Out);
-  auto x_lod = param_.X->lod();
-  auto y_lod = param_.Y->lod();
+  const auto &x_lod = param_.X->lod();
+  const auto &y_lod = param_.Y->lod();
   CHECK_OR_FALSE(x_lod.size() <= 1);
   CHECK_OR_FALSE(y_lod.size() > 0);
   auto ref_level = param_.ref_level;
@@ -41,13 +41,13 @@ bool SequenceExpandOp::CheckShape() const {
 }
 
 bool SequenceExpandOp::InferShapeImpl() const {
-  const auto x_lod = param_.X->lod();
+  const auto &x_lod = param_.X->lod();
   auto x_dims = param_.X->dims();
   int ref_level = param_.ref_level;
   if (ref_level == -1) {
     ref_level = param_.Y->lod().size() - 1;
   }
-  const auto y_lod = param_.Y->lod()[ref_level];
+  const auto &y_lod = param_.Y->lod()[ref_level];
   auto out_dims = param_.X->dims();
   int64_t out_first_dim = 0;
   if (y_lod.size() <= 1) {
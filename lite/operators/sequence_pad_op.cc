@@ -41,7 +41,7 @@ bool SequencePadOp::InferShapeImpl() const {
       << "The SequencePad OP Input(PadValue) must be a scalar or a tensor "
          "whiose shape equals to time steps in sequences";
 
-  auto x_lod = param_.X->lod();
+  const auto &x_lod = param_.X->lod();
   CHECK_EQ(x_lod.empty(), false)
       << "The SequencePad OP Input(X) must hold lod info.";
   const auto &x_lod_0 = x_lod[0];
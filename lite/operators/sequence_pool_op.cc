@@ -22,7 +22,7 @@ namespace operators {
 bool SequencePoolOp::CheckShape() const {
   CHECK_OR_FALSE(param_.X);
   CHECK_OR_FALSE(param_.Out);
-  auto lod = param_.X->lod();
+  const auto &lod = param_.X->lod();
   CHECK_EQ_OR_FALSE(lod.size(), 1UL);
   auto dims = param_.X->dims();
   CHECK_GE_OR_FALSE(dims[0], (static_cast<int64_t>(lod[0].size()) - 1));
@@ -45,7 +45,7 @@ bool SequenceTopkAvgPoolingOpLite::CheckShape() const {
 
 bool SequenceTopkAvgPoolingOpLite::InferShapeImpl() const {
   int channel_num = param_.channel_num;
-  std::vector<int> topks = param_.topks;
+  const auto &topks = param_.topks;
   auto row_dim = param_.ROW->dims();
   auto num_k = topks.size();
   auto row_shape_0 = row_dim[0];
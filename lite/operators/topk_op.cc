@@ -27,6 +27,7 @@ bool TopkOp::CheckShape() const {
 
 bool TopkOp::InferShapeImpl() const {
   auto out_dims = param_.X->dims();
+  CHECK_GE_OR_FALSE(out_dims[out_dims.size() - 1], param_.K);
   out_dims[out_dims.size() - 1] = param_.K;
   auto out = param_.Out;
   out->Resize(out_dims);
@@ -96,6 +96,9 @@ bool UnsqueezeOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   if (opdesc.HasAttr("axes")) {
     param_.axes = opdesc.GetAttr<std::vector<int>>("axes");
   }
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
 
   if (opdesc.HasInput("AxesTensor") && opdesc.Input("AxesTensor").size() > 0) {
     auto var = scope->FindVar(opdesc.Input("AxesTensor").front());
@@ -0,0 +1,449 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <math.h>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include "lite/core/profile/timer.h"
+#include "lite/tests/cv/cv_basic.h"
+#include "lite/utils/cv/paddle_image_preprocess.h"
+#include "lite/utils/cv/x86/cv_simd.h"
+
+DEFINE_int32(srcw, 1920, "input width of the benchmark");
+DEFINE_int32(srch, 1080, "input height of the benchmark");
+DEFINE_int32(dstw, 960, "output width of the benchmark");
+DEFINE_int32(dsth, 540, "output height of the benchmark");
+DEFINE_int32(repeats, 10, "repeats times of the benchmark");
+
+typedef paddle::lite::utils::cv::TransParam TransParam;
+typedef paddle::lite::utils::cv::ImagePreprocess ImagePreprocess;
+typedef paddle::lite::utils::cv::CvIsa CvIsa;
+typedef paddle::lite_api::PrecisionType PrecisionType;
+typedef paddle::lite_api::Tensor Tensor_api;
+
+using paddle::lite::profile::Timer;
+using paddle::lite::utils::cv::GetCvIsa;
+using paddle::lite::utils::cv::SetCvIsa;
+
+namespace {
+
+const ImageFormat kFormats[] = {ImageFormat::RGBA,
+                                ImageFormat::BGRA,
+                                ImageFormat::RGB,
+                                ImageFormat::BGR,
+                                ImageFormat::GRAY,
+                                ImageFormat::NV21,
+                                ImageFormat::NV12};
+
+bool IsNV(ImageFormat format) {
+  return format == ImageFormat::NV12 || format == ImageFormat::NV21;
+}
+
+int Channels(ImageFormat format) {
+  switch (format) {
+    case ImageFormat::GRAY:
+      return 1;
+    case ImageFormat::BGR:
+    case ImageFormat::RGB:
+      return 3;
+    case ImageFormat::BGRA:
+    case ImageFormat::RGBA:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+int ImageSize(ImageFormat format, int w, int h) {
+  return IsNV(format) ? w * h * 3 / 2 : w * h * Channels(format);
+}
+
+std::vector<uint8_t> RandImage(int size) {
+  std::vector<uint8_t> image(size);
+  unsigned int seed = 256;
+  for (auto& v : image) {
+    v = rand_r(&seed) % 256;
+  }
+  return image;
+}
+
+void ExpectNear(const std::vector<uint8_t>& out,
+                const std::vector<uint8_t>& ref,
+                int tolerance,
+                int begin = 0) {
+  for (size_t i = begin; i < out.size(); i++) {
+    ASSERT_LE(std::abs(out[i] - ref[i]), tolerance) << "at " << i;
+  }
+}
+
+// Runs func with the best instruction set and with the scalar code, the
+// results must be the same.
+template <typename T>
+std::vector<T> RunSimdAndScalar(int size,
+                                const std::function<void(T*)>& func) {
+  std::vector<T> simd(size);
+  std::vector<T> scalar(size);
+  CvIsa isa = GetCvIsa();
+  func(simd.data());
+  SetCvIsa(CvIsa::kScalar);
+  func(scalar.data());
+  SetCvIsa(isa);
+  for (int i = 0; i < size; i++) {
+    EXPECT_EQ(simd[i], scalar[i]) << "at " << i;
+  }
+  return simd;
+}
+
+// Returns the speedup of func over the scalar code.
+float Benchmark(const char* name, const std::function<void()>& func) {
+  Timer t_simd;
+  Timer t_scalar;
+  CvIsa isa = GetCvIsa();
+  func();
+  for (int i = 0; i < FLAGS_repeats; i++) {
+    t_simd.Start();
+    func();
+    t_simd.Stop();
+  }
+  SetCvIsa(CvIsa::kScalar);
+  for (int i = 0; i < FLAGS_repeats; i++) {
+    t_scalar.Start();
+    func();
+    t_scalar.Stop();
+  }
+  SetCvIsa(isa);
+  float simd = t_simd.LapTimes().Avg();
+  float scalar = t_scalar.LapTimes().Avg();
+  LOG(INFO) << name << " avg time: " << simd << " ms, scalar: " << scalar
+            << " ms, speedup: " << scalar / std::max(simd, 1e-6f);
+  return scalar / std::max(simd, 1e-6f);
+}
+
+}  // namespace
+
+TEST(TestImagePreprocessX86, convert) {
+  for (auto w : {1, 4, 18, 37, 224}) {
+    for (auto h : {1, 4, 16, 23}) {
+      for (auto srcFormat : kFormats) {
+        for (auto dstFormat : kFormats) {
+          if (IsNV(dstFormat) || (IsNV(srcFormat) && (w % 2 || h % 2)) ||
+              (IsNV(srcFormat) && dstFormat == ImageFormat::GRAY)) {
+            continue;
+          }
+          auto src = RandImage(ImageSize(srcFormat, w, h));
+          int size = ImageSize(dstFormat, w, h);
+          std::vector<uint8_t> ref(size);
+          image_convert_basic(
+              src.data(), ref.data(), srcFormat, dstFormat, w, h, size);
+          TransParam tparam;
+          tparam.iw = w;
+          tparam.ih = h;
+          ImagePreprocess image_preprocess(srcFormat, dstFormat, tparam);
+          auto out =
+              RunSimdAndScalar<uint8_t>(size, [&](uint8_t* dst) {
+                image_preprocess.imageConvert(
+                    src.data(), dst, srcFormat, dstFormat);
+              });
+          ExpectNear(out, ref, 0);
+        }
+      }
+    }
+  }
+}
+
+TEST(TestImagePreprocessX86, resize) {
+  for (auto w : {8, 37, 224}) {
+    for (auto h : {4, 16, 112}) {
+      for (auto ww : {8, 32, 112}) {
+        for (auto hh : {8, 112}) {
+          for (auto format : kFormats) {
+            auto src = RandImage(ImageSize(format, w, h));
+            int size = ImageSize(format, ww, hh);
+            std::vector<uint8_t> ref(size);
+            image_resize_basic(src.data(), ref.data(), format, w, h, ww, hh);
+            TransParam tparam;
+            ImagePreprocess image_preprocess(format, format, tparam);
+            auto out = RunSimdAndScalar<uint8_t>(size, [&](uint8_t* dst) {
+              image_preprocess.imageResize(
+                  src.data(), dst, format, w, h, ww, hh);
+            });
+            // The vu of the reference reads over the right edge of the rows,
+            // only the y of NV12 and NV21 is compared.
+            if (IsNV(format)) {
+              out.resize(ww * hh);
+            }
+            ExpectNear(out, ref, 1);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestImagePreprocessX86, rotate_flip) {
+  for (auto w : {1, 8, 37, 224}) {
+    for (auto h : {1, 4, 16, 23}) {
+      for (auto format : kFormats) {
+        if (IsNV(format)) continue;
+        auto src = RandImage(ImageSize(format, w, h));
+        int size = ImageSize(format, w, h);
+        TransParam tparam;
+        ImagePreprocess image_preprocess(format, format, tparam);
+        for (auto rotate : {90, 180, 270}) {
+          std::vector<uint8_t> ref(size);
+          image_rotate_basic(src.data(), ref.data(), format, w, h, rotate);
+          auto out = RunSimdAndScalar<uint8_t>(size, [&](uint8_t* dst) {
+            image_preprocess.imageRotate(src.data(), dst, format, w, h, rotate);
+          });
+          ExpectNear(out, ref, 0);
+        }
+        for (auto flip : {FlipParam::XY, FlipParam::X, FlipParam::Y}) {
+          std::vector<uint8_t> ref(size);
+          image_flip_basic(src.data(), ref.data(), format, w, h, flip);
+          auto out = RunSimdAndScalar<uint8_t>(size, [&](uint8_t* dst) {
+            image_preprocess.imageFlip(src.data(), dst, format, w, h, flip);
+          });
+          ExpectNear(out, ref, 0);
+        }
+      }
+    }
+  }
+}
+
+TEST(TestImagePreprocessX86, image2tensor) {
+  // cv_basic pairs means[2] with the first channel, the symmetric means and
+  // scales make both orders the same.
+  float means[3] = {127.5f, 120.f, 127.5f};
+  float scales[3] = {0.017f, 0.5f, 0.017f};
+  for (auto w : {1, 5, 17, 224}) {
+    for (auto h : {1, 7, 16}) {
+      for (auto format : kFormats) {
+        if (IsNV(format)) continue;
+        for (auto layout : {LayoutType::kNCHW, LayoutType::kNHWC}) {
+          auto src = RandImage(ImageSize(format, w, h));
+          int c = format == ImageFormat::GRAY ? 1 : 3;
+          int size = c * w * h;
+          Tensor ref_tensor;
+          ref_tensor.Resize({1, std::max(c, Channels(format)), h, w});
+          image_to_tensor_basic(
+              src.data(), &ref_tensor, format, layout, w, h, means, scales);
+          const float* ref = ref_tensor.data<float>();
+          TransParam tparam;
+          ImagePreprocess image_preprocess(format, format, tparam);
+          Tensor tensor;
+          auto out = RunSimdAndScalar<float>(size, [&](float* dst) {
+            Tensor_api dst_tensor(&tensor);
+            dst_tensor.Resize({1, c, h, w});
+            image_preprocess.image2Tensor(
+                src.data(), &dst_tensor, format, w, h, layout, means, scales);
+            const float* data = tensor.data<float>();
+            std::copy(data, data + size, dst);
+          });
+          // The rows of the 4-channel NHWC reference are 4 * w floats apart,
+          // only its first row is packed as the output.
+          if (layout == LayoutType::kNHWC && Channels(format) == 4) {
+            size = 3 * w;
+          }
+          for (int i = 0; i < size; i++) {
+            ASSERT_NEAR(out[i], ref[i], 1e-5f) << "at " << i;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestImagePreprocessX86, image2tensor_fused) {
+  float means[3] = {103.94f, 116.78f, 123.68f};
+  float scales[3] = {0.017f, 0.5f, 0.2f};
+  for (auto w : {2, 18, 224}) {
+    for (auto h : {2, 16, 112}) {
+      for (auto ww : {8, 30, 112}) {
+        for (auto hh : {4, 112}) {
+          for (auto srcFormat : kFormats) {
+            for (auto dstFormat : kFormats) {
+              if (IsNV(dstFormat) ||
+                  (IsNV(srcFormat) && dstFormat == ImageFormat::GRAY)) {
+                continue;
+              }
+              auto src = RandImage(ImageSize(srcFormat, w, h));
+              // The resize, convert and image2Tensor one by one.
+              std::vector<uint8_t> resized(ImageSize(srcFormat, ww, hh));
+              std::vector<uint8_t> converted(ImageSize(dstFormat, ww, hh));
+              TransParam tparam;
+              tparam.iw = ww;
+              tparam.ih = hh;
+              ImagePreprocess image_preprocess(srcFormat, dstFormat, tparam);
+              image_preprocess.imageResize(
+                  src.data(), resized.data(), srcFormat, w, h, ww, hh);
+              image_preprocess.imageConvert(
+                  resized.data(), converted.data(), srcFormat, dstFormat);
+              for (auto layout : {LayoutType::kNCHW, LayoutType::kNHWC}) {
+                int c = dstFormat == ImageFormat::GRAY ? 1 : 3;
+                Tensor ref_tensor;
+                Tensor_api ref(&ref_tensor);
+                ref.Resize({1, c, hh, ww});
+                image_preprocess.image2Tensor(converted.data(),
+                                              &ref,
+                                              dstFormat,
+                                              ww,
+                                              hh,
+                                              layout,
+                                              means,
+                                              scales);
+                Tensor tensor;
+                Tensor_api fused(&tensor);
+                image_preprocess.image2TensorFused(src.data(),
+                                                   &fused,
+                                                   srcFormat,
+                                                   dstFormat,
+                                                   w,
+                                                   h,
+                                                   ww,
+                                                   hh,
+                                                   layout,
+                                                   means,
+                                                   scales);
+                ASSERT_EQ(tensor.numel(), c * ww * hh);
+                const float* ref_data = ref_tensor.data<float>();
+                const float* out = tensor.data<float>();
+                for (int i = 0; i < c * ww * hh; i++) {
+                  ASSERT_EQ(out[i], ref_data[i]) << "at " << i;
+                }
+                // The int8 output is the rounded and saturated float output.
+                Tensor int8_tensor;
+                Tensor_api fused_int8(&int8_tensor);
+                image_preprocess.image2TensorFused(src.data(),
+                                                   &fused_int8,
+                                                   srcFormat,
+                                                   dstFormat,
+                                                   w,
+                                                   h,
+                                                   ww,
+                                                   hh,
+                                                   layout,
+                                                   means,
+                                                   scales,
+                                                   PrecisionType::kInt8);
+                const int8_t* out_int8 = int8_tensor.data<int8_t>();
+                for (int i = 0; i < c * ww * hh; i++) {
+                  float v = std::min(std::max(roundf(out[i]), -127.f), 127.f);
+                  ASSERT_EQ(out_int8[i], static_cast<int8_t>(v)) << "at " << i;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestImagePreprocessX86, benchmark) {
+  int srcw = FLAGS_srcw;
+  int srch = FLAGS_srch;
+  int dstw = FLAGS_dstw;
+  int dsth = FLAGS_dsth;
+  LOG(INFO) << "instruction set: " << static_cast<int>(GetCvIsa())
+            << ", input: " << srcw << "x" << srch << ", output: " << dstw
+            << "x" << dsth;
+  auto nv21 = RandImage(ImageSize(ImageFormat::NV21, srcw, srch));
+  auto bgra = RandImage(ImageSize(ImageFormat::BGRA, srcw, srch));
+  std::vector<uint8_t> bgr(ImageSize(ImageFormat::BGR, srcw, srch));
+  std::vector<uint8_t> resized(ImageSize(ImageFormat::BGR, dstw, dsth));
+  std::vector<uint8_t> out(ImageSize(ImageFormat::BGR, dstw, dsth));
+  TransParam tparam;
+  tparam.iw = srcw;
+  tparam.ih = srch;
+  ImagePreprocess image_preprocess(ImageFormat::NV21, ImageFormat::BGR, tparam);
+  Benchmark("nv21 to bgr", [&]() {
+    image_preprocess.imageConvert(
+        nv21.data(), bgr.data(), ImageFormat::NV21, ImageFormat::BGR);
+  });
+  Benchmark("bgra to bgr", [&]() {
+    image_preprocess.imageConvert(
+        bgra.data(), bgr.data(), ImageFormat::BGRA, ImageFormat::BGR);
+  });
+  Benchmark("bgr resize", [&]() {
+    image_preprocess.imageResize(
+        bgr.data(), resized.data(), ImageFormat::BGR, srcw, srch, dstw, dsth);
+  });
+  Benchmark("bgr rotate 90", [&]() {
+    image_preprocess.imageRotate(
+        resized.data(), out.data(), ImageFormat::BGR, dstw, dsth, 90);
+  });
+  Benchmark("bgr flip y", [&]() {
+    image_preprocess.imageFlip(
+        resized.data(), out.data(), ImageFormat::BGR, dstw, dsth, FlipParam::Y);
+  });
+  float means[3] = {103.94f, 116.78f, 123.68f};
+  float scales[3] = {0.017f, 0.017f, 0.017f};
+  Tensor tensor;
+  Tensor_api dst_tensor(&tensor);
+  dst_tensor.Resize({1, 3, dsth, dstw});
+  Benchmark("bgr to tensor", [&]() {
+    image_preprocess.image2Tensor(resized.data(),
+                                  &dst_tensor,
+                                  ImageFormat::BGR,
+                                  dstw,
+                                  dsth,
+                                  LayoutType::kNCHW,
+                                  means,
+                                  scales);
+  });
+  // The nv21 camera frame to the input tensor, step by step and fused.
+  TransParam out_param;
+  out_param.iw = dstw;
+  out_param.ih = dsth;
+  ImagePreprocess out_preprocess(
+      ImageFormat::NV21, ImageFormat::BGR, out_param);
+  Timer t_steps;
+  Timer t_fused;
+  for (int i = 0; i < FLAGS_repeats; i++) {
+    t_steps.Start();
+    image_preprocess.imageResize(
+        nv21.data(), bgra.data(), ImageFormat::NV21, srcw, srch, dstw, dsth);
+    out_preprocess.imageConvert(
+        bgra.data(), resized.data(), ImageFormat::NV21, ImageFormat::BGR);
+    image_preprocess.image2Tensor(resized.data(),
+                                  &dst_tensor,
+                                  ImageFormat::BGR,
+                                  dstw,
+                                  dsth,
+                                  LayoutType::kNCHW,
+                                  means,
+                                  scales);
+    t_steps.Stop();
+    t_fused.Start();
+    image_preprocess.image2TensorFused(nv21.data(),
+                                       &dst_tensor,
+                                       ImageFormat::NV21,
+                                       ImageFormat::BGR,
+                                       srcw,
+                                       srch,
+                                       dstw,
+                                       dsth,
+                                       LayoutType::kNCHW,
+                                       means,
+                                       scales);
+    t_fused.Stop();
+  }
+  LOG(INFO) << "nv21 resize, convert and to tensor avg time: "
+            << t_steps.LapTimes().Avg()
+            << " ms, fused: " << t_fused.LapTimes().Avg() << " ms";
+}
@@ -143,8 +143,14 @@ class AnchorGeneratorComputeTester : public arena::TestCase {
 
 TEST(AnchorGenerator, precision) {
   LOG(INFO) << "test anchor_generator op";
-#ifdef LITE_WITH_ARM
-  Place place(TARGET(kARM));
+  Place place;
+#if defined(LITE_WITH_ARM)
+  place = TARGET(kARM);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+#else
+  return;
+#endif
   for (int n : {1, 3}) {
     for (int c : {3, 6}) {
       for (int h : {9, 18}) {
@@ -169,8 +175,6 @@ TEST(AnchorGenerator, precision) {
       }
     }
   }
-
-#endif
 }
 
 }  // namespace lite
@@ -0,0 +1,524 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/arena/framework.h"
+
+namespace paddle {
+namespace lite {
+
+// The outputs of a step of the beam search.
+struct BeamSearchStep {
+  std::vector<int64_t> ids;
+  std::vector<float> scores;
+  std::vector<int> parent_idx;
+  LoD lod;
+};
+
+struct BeamItem {
+  size_t offset;
+  int64_t id;
+  float score;
+
+  bool operator<(const BeamItem& in) const {
+    return (score < in.score) || ((score == in.score) && (offset < in.offset));
+  }
+};
+
+// The beam search of the reference kernel: the candidates of a source are
+// inserted into a sorted vector of beam_size items, then grouped by prefix,
+// and the sources whose prefixes and candidates all end are pruned.
+void BeamSearchRef(const std::vector<int64_t>& pre_ids,
+                   const std::vector<float>& pre_scores,
+                   const std::vector<int64_t>& ids,
+                   const std::vector<float>& scores,
+                   const std::vector<uint64_t>& high_level,
+                   size_t seq_width,
+                   size_t beam_size,
+                   int end_id,
+                   bool is_accumulated,
+                   BeamSearchStep* out) {
+  std::vector<std::vector<BeamItem>> items(high_level.back());
+  for (size_t src = 0; src + 1 < high_level.size(); src++) {
+    std::vector<BeamItem> top_beam;
+    auto insert = [&](const BeamItem& item) {
+      if (top_beam.size() < beam_size) {
+        top_beam.push_back(item);
+      } else if (item < top_beam.back()) {
+        return;
+      } else {
+        top_beam.back() = item;
+      }
+      for (size_t k = top_beam.size() - 1; k > 0; k--) {
+        if (!(top_beam[k - 1] < top_beam[k])) break;
+        std::swap(top_beam[k - 1], top_beam[k]);
+      }
+    };
+    for (size_t offset = high_level[src]; offset < high_level[src + 1];
+         offset++) {
+      if (pre_ids[offset] == end_id) {
+        insert({offset, end_id, pre_scores[offset]});
+        continue;
+      }
+      for (size_t d = 0; d < seq_width; d++) {
+        size_t index = offset * seq_width + d;
+        float score = is_accumulated
+                          ? scores[index]
+                          : pre_scores[offset] + std::log(scores[index]);
+        insert({offset, ids[index], score});
+      }
+    }
+    for (auto& item : top_beam) {
+      items[item.offset].push_back(item);
+    }
+  }
+  for (size_t src = 0; src + 1 < high_level.size(); src++) {
+    bool finish = true;
+    for (size_t offset = high_level[src];
+         finish && offset < high_level[src + 1];
+         offset++) {
+      for (auto& item : items[offset]) {
+        if (item.id != end_id || pre_ids[offset] != end_id) {
+          finish = false;
+          break;
+        }
+      }
+    }
+    if (finish) {
+      for (size_t offset = high_level[src]; offset < high_level[src + 1];
+           offset++) {
+        items[offset].clear();
+      }
+    }
+  }
+  out->ids.clear();
+  out->scores.clear();
+  out->parent_idx.clear();
+  out->lod.assign(2, {});
+  out->lod[0] = high_level;
+  for (size_t offset = 0; offset < items.size(); offset++) {
+    out->lod[1].push_back(out->ids.size());
+    for (auto& item : items[offset]) {
+      out->ids.push_back(item.id);
+      out->scores.push_back(item.score);
+      out->parent_idx.push_back(static_cast<int>(offset));
+    }
+  }
+  out->lod[1].push_back(out->ids.size());
+}
+
+// Random candidates of the prefixes, the scores are multiples of 1/8 so that
+// many of them are equal.
+void RandomCandidates(size_t num_prefixes,
+                      size_t seq_width,
+                      int vocab_size,
+                      std::mt19937* rng,
+                      std::vector<int64_t>* ids,
+                      std::vector<float>* scores) {
+  ids->resize(num_prefixes * seq_width);
+  scores->resize(num_prefixes * seq_width);
+  for (size_t i = 0; i < ids->size(); i++) {
+    (*ids)[i] = (*rng)() % vocab_size;
+    (*scores)[i] = static_cast<float>((*rng)() % 8 + 1) / 8;
+  }
+}
+
+class BeamSearchComputeTester : public arena::TestCase {
+ protected:
+  std::string pre_ids_ = "pre_ids";
+  std::string pre_scores_ = "pre_scores";
+  std::string ids_ = "ids";
+  std::string scores_ = "scores";
+  std::string selected_ids_ = "selected_ids";
+  std::string selected_scores_ = "selected_scores";
+  std::string parent_idx_ = "parent_idx";
+  std::vector<int64_t> pre_ids_data_;
+  std::vector<float> pre_scores_data_;
+  std::vector<int64_t> ids_data_;
+  std::vector<float> scores_data_;
+  std::vector<uint64_t> high_level_;
+  size_t seq_width_;
+  int beam_size_;
+  int end_id_;
+  bool is_accumulated_;
+
+ public:
+  BeamSearchComputeTester(const Place& place,
+                          const std::string& alias,
+                          const std::vector<int64_t>& pre_ids,
+                          const std::vector<float>& pre_scores,
+                          const std::vector<int64_t>& ids,
+                          const std::vector<float>& scores,
+                          const std::vector<uint64_t>& high_level,
+                          int beam_size,
+                          int end_id,
+                          bool is_accumulated)
+      : TestCase(place, alias),
+        pre_ids_data_(pre_ids),
+        pre_scores_data_(pre_scores),
+        ids_data_(ids),
+        scores_data_(scores),
+        high_level_(high_level),
+        seq_width_(ids.size() / pre_ids.size()),
+        beam_size_(beam_size),
+        end_id_(end_id),
+        is_accumulated_(is_accumulated) {}
+
+  void RunBaseline(Scope* scope) override {
+    BeamSearchStep step;
+    BeamSearchRef(pre_ids_data_,
+                  pre_scores_data_,
+                  ids_data_,
+                  scores_data_,
+                  high_level_,
+                  seq_width_,
+                  beam_size_,
+                  end_id_,
+                  is_accumulated_,
+                  &step);
+    int64_t num = static_cast<int64_t>(step.ids.size());
+    auto* selected_ids = scope->NewTensor(selected_ids_);
+    selected_ids->Resize({num, 1});
+    std::copy(step.ids.begin(),
+              step.ids.end(),
+              selected_ids->mutable_data<int64_t>());
+    selected_ids->set_lod(step.lod);
+    auto* selected_scores = scope->NewTensor(selected_scores_);
+    selected_scores->Resize({num, 1});
+    std::copy(step.scores.begin(),
+              step.scores.end(),
+              selected_scores->mutable_data<float>());
+    selected_scores->set_lod(step.lod);
+    auto* parent_idx = scope->NewTensor(parent_idx_);
+    parent_idx->Resize({num});
+    std::copy(step.parent_idx.begin(),
+              step.parent_idx.end(),
+              parent_idx->mutable_data<int>());
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) {
+    op_desc->SetType("beam_search");
+    op_desc->SetInput("pre_ids", {pre_ids_});
+    op_desc->SetInput("pre_scores", {pre_scores_});
+    op_desc->SetInput("ids", {ids_});
+    op_desc->SetInput("scores", {scores_});
+    op_desc->SetOutput("selected_ids", {selected_ids_});
+    op_desc->SetOutput("selected_scores", {selected_scores_});
+    op_desc->SetOutput("parent_idx", {parent_idx_});
+    op_desc->SetAttr("level", 0);
+    op_desc->SetAttr("beam_size", beam_size_);
+    op_desc->SetAttr("end_id", end_id_);
+    op_desc->SetAttr("is_accumulated", is_accumulated_);
+  }
+
+  void PrepareData() override {
+    int64_t num_prefixes = static_cast<int64_t>(pre_ids_data_.size());
+    std::vector<uint64_t> low_level(num_prefixes + 1);
+    for (int64_t i = 0; i <= num_prefixes; i++) {
+      low_level[i] = i;
+    }
+    LoD lod{high_level_, low_level};
+    SetCommonTensor(pre_ids_, DDim({num_prefixes, 1}), pre_ids_data_.data());
+    SetCommonTensor(
+        pre_scores_, DDim({num_prefixes, 1}), pre_scores_data_.data());
+    DDim dims({num_prefixes, static_cast<int64_t>(seq_width_)});
+    SetCommonTensor(ids_, dims, ids_data_.data(), lod);
+    SetCommonTensor(scores_, dims, scores_data_.data(), lod);
+  }
+};
+
+// The decoding of the reference kernel: a vector of words and of scores per
+// hypothesis, the hypotheses are sorted by the score of their last word and
+// the empty ones are put last.
+void BeamSearchDecodeRef(const std::vector<BeamSearchStep>& steps,
+                         size_t beam_size,
+                         int end_id,
+                         std::vector<int64_t>* sentence_ids,
+                         std::vector<float>* sentence_scores,
+                         LoD* lod) {
+  struct Sentence {
+    std::vector<int64_t> word_ids;
+    std::vector<float> scores;
+  };
+  const size_t src_num = steps[0].lod[0].size() - 1;
+  std::vector<std::vector<Sentence>> sentences(
+      src_num, std::vector<Sentence>(beam_size));
+  std::vector<std::vector<size_t>> prefixes(src_num);
+  for (int step_id = steps.size() - 1; step_id >= 0; --step_id) {
+    auto& step = steps[step_id];
+    auto& source_level = step.lod[0];
+    auto& sentence_level = step.lod[1];
+    for (size_t src = 0; src < src_num; ++src) {
+      auto& sentence_vector = sentences[src];
+      auto& prefix_idx_vector = prefixes[src];
+      if (prefix_idx_vector.empty()) {
+        for (size_t prefix = source_level[src];
+             prefix < source_level[src + 1];
+             ++prefix) {
+          for (size_t candidate = sentence_level[prefix];
+               candidate < sentence_level[prefix + 1];
+               ++candidate) {
+            prefix_idx_vector.push_back(prefix);
+            auto& sentence = sentence_vector.at(prefix_idx_vector.size() - 1);
+            sentence.word_ids.push_back(step.ids[candidate]);
+            sentence.scores.push_back(step.scores[candidate]);
+          }
+        }
+      } else {
+        size_t src_candidate_start = sentence_level[source_level[src]];
+        size_t prefix = source_level[src];
+        size_t candidate_num =
+            sentence_level[prefix + 1] - sentence_level[prefix];
+        for (size_t idx = 0; idx < prefix_idx_vector.size(); ++idx) {
+          auto candidate = prefix_idx_vector[idx];
+          auto& sentence = sentence_vector[idx];
+          if (step.ids[candidate] != end_id || sentence.word_ids.empty()) {
+            sentence.word_ids.push_back(step.ids[candidate]);
+            sentence.scores.push_back(step.scores[candidate]);
+          }
+          while (src_candidate_start + candidate_num <= candidate) {
+            prefix++;
+            candidate_num +=
+                sentence_level[prefix + 1] - sentence_level[prefix];
+          }
+          prefix_idx_vector[idx] = prefix;
+        }
+      }
+    }
+  }
+
+  lod->assign(2, {0});
+  for (auto& sentence_vector : sentences) {
+    std::stable_sort(sentence_vector.begin(),
+                     sentence_vector.end(),
+                     [](const Sentence& a, const Sentence& b) {
+                       if (a.scores.empty() || b.scores.empty()) {
+                         return b.scores.empty() && !a.scores.empty();
+                       }
+                       return a.scores.front() > b.scores.front();
+                     });
+    for (auto& sentence : sentence_vector) {
+      sentence_ids->insert(sentence_ids->end(),
+                           sentence.word_ids.rbegin(),
+                           sentence.word_ids.rend());
+      sentence_scores->insert(sentence_scores->end(),
+                              sentence.scores.rbegin(),
+                              sentence.scores.rend());
+      (*lod)[1].push_back(sentence_ids->size());
+    }
+    (*lod)[0].push_back((*lod)[0].back() + sentence_vector.size());
+  }
+}
+
+class BeamSearchDecodeComputeTester : public arena::TestCase {
+ protected:
+  std::string ids_ = "ids";
+  std::string scores_ = "scores";
+  std::string sentence_ids_ = "sentence_ids";
+  std::string sentence_scores_ = "sentence_scores";
+  std::vector<BeamSearchStep> steps_;
+  int beam_size_;
+  int end_id_;
+
+ public:
+  BeamSearchDecodeComputeTester(const Place& place,
+                                const std::string& alias,
+                                const std::vector<BeamSearchStep>& steps,
+                                int beam_size,
+                                int end_id)
+      : TestCase(place, alias),
+        steps_(steps),
+        beam_size_(beam_size),
+        end_id_(end_id) {}
+
+  void RunBaseline(Scope* scope) override {
+    std::vector<int64_t> ids;
+    std::vector<float> scores;
+    LoD lod;
+    BeamSearchDecodeRef(steps_, beam_size_, end_id_, &ids, &scores, &lod);
+    auto* sentence_ids = scope->NewTensor(sentence_ids_);
+    sentence_ids->Resize({static_cast<int64_t>(ids.size())});
+    std::copy(ids.begin(), ids.end(), sentence_ids->mutable_data<int64_t>());
+    sentence_ids->set_lod(lod);
+    auto* sentence_scores = scope->NewTensor(sentence_scores_);
+    sentence_scores->Resize({static_cast<int64_t>(scores.size())});
+    std::copy(
+        scores.begin(), scores.end(), sentence_scores->mutable_data<float>());
+    sentence_scores->set_lod(lod);
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) {
+    op_desc->SetType("beam_search_decode");
+    op_desc->SetInput("Ids", {ids_});
+    op_desc->SetInput("Scores", {scores_});
+    op_desc->SetOutput("SentenceIds", {sentence_ids_});
+    op_desc->SetOutput("SentenceScores", {sentence_scores_});
+    op_desc->SetAttr("beam_size", beam_size_);
+    op_desc->SetAttr("end_id", end_id_);
+  }
+
+  void PrepareData() override {
+    std::vector<DDim> dims;
+    std::vector<std::vector<int64_t>> ids;
+    std::vector<std::vector<float>> scores;
+    std::vector<LoD> lods;
+    for (auto& step : steps_) {
+      dims.push_back(DDim({static_cast<int64_t>(step.ids.size()), 1}));
+      ids.push_back(step.ids);
+      scores.push_back(step.scores);
+      lods.push_back(step.lod);
+    }
+    SetCommonTensorList(ids_, dims, ids, lods);
+    SetCommonTensorList(scores_, dims, scores, lods);
+  }
+};
+
+// The prefixes of the 3 sources, some of them ended: all the prefixes of the
+// second source end, so it is pruned, the first source is also pruned if its
+// ended prefix is the best, the third is never pruned.
+void test_beam_search(Place place) {
+  std::mt19937 rng(17);
+  const int end_id = 1;
+  const std::vector<uint64_t> high_level{0, 2, 4, 7};
+  const std::vector<int64_t> pre_ids{3, 1, 1, 1, 4, 1, 2};
+  const std::vector<float> pre_scores{
+      -0.5f, -0.25f, -1.f, -0.5f, -0.75f, -2.f, -0.5f};
+  for (int seq_width : {1, 3, 8}) {
+    for (int beam_size : {1, 2, 4}) {
+      for (bool is_accumulated : {false, true}) {
+        std::vector<int64_t> ids;
+        std::vector<float> scores;
+        RandomCandidates(pre_ids.size(), seq_width, 6, &rng, &ids, &scores);
+        if (is_accumulated) {
+          for (size_t i = 0; i < scores.size(); i++) {
+            scores[i] = pre_scores[i / seq_width] - scores[i];
+          }
+        }
+        std::unique_ptr<arena::TestCase> tester(
+            new BeamSearchComputeTester(place,
+                                        "def",
+                                        pre_ids,
+                                        pre_scores,
+                                        ids,
+                                        scores,
+                                        high_level,
+                                        beam_size,
+                                        end_id,
+                                        is_accumulated));
+        arena::Arena arena(std::move(tester), place, 0.f);
+        arena.TestPrecision();
+      }
+    }
+  }
+}
+
+// Runs the reference beam search from a start word per source until all the
+// sources are pruned or num_steps, the steps are the inputs of the decoding.
+std::vector<BeamSearchStep> BeamSearchSteps(int src_num,
+                                            int seq_width,
+                                            int beam_size,
+                                            int end_id,
+                                            int num_steps,
+                                            std::mt19937* rng) {
+  std::vector<BeamSearchStep> steps(1);
+  auto& init = steps[0];
+  init.lod.assign(2, {0});
+  for (int i = 0; i < src_num; i++) {
+    init.ids.push_back(0);
+    init.scores.push_back(0.f);
+    init.lod[0].push_back(i + 1);
+    init.lod[1].push_back(i + 1);
+  }
+  for (int t = 0; t < num_steps; t++) {
+    auto& prev = steps.back();
+    // The candidates of the previous step are the prefixes of this step.
+    std::vector<uint64_t> high_level;
+    for (auto offset : prev.lod[0]) {
+      high_level.push_back(prev.lod[1][offset]);
+    }
+    std::vector<int64_t> ids;
+    std::vector<float> scores;
+    RandomCandidates(prev.ids.size(), seq_width, 4, rng, &ids, &scores);
+    BeamSearchStep step;
+    BeamSearchRef(prev.ids,
+                  prev.scores,
+                  ids,
+                  scores,
+                  high_level,
+                  seq_width,
+                  beam_size,
+                  end_id,
+                  false,
+                  &step);
+    if (step.ids.empty()) break;
+    steps.push_back(step);
+  }
+  return steps;
+}
+
+void test_beam_search_decode(Place place) {
+  std::mt19937 rng(23);
+  const int end_id = 1;
+  for (int seq_width : {2, 5}) {
+    for (int beam_size : {3, 4}) {
+      // A single step has fewer candidates than beam_size when seq_width is
+      // 2, the remaining hypotheses are empty.
+      for (int num_steps : {1, 4, 10}) {
+        for (int src_num : {1, 3}) {
+          auto steps = BeamSearchSteps(
+              src_num, seq_width, beam_size, end_id, num_steps, &rng);
+          std::unique_ptr<arena::TestCase> tester(
+              new BeamSearchDecodeComputeTester(
+                  place, "def", steps, beam_size, end_id));
+          arena::Arena arena(std::move(tester), place, 0.f);
+          arena.TestPrecision();
+        }
+      }
+    }
+  }
+}
+
+TEST(BeamSearch, precision) {
+  Place place;
+#if defined(LITE_WITH_ARM)
+  place = TARGET(kARM);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+#else
+  return;
+#endif
+  test_beam_search(place);
+}
+
+TEST(BeamSearchDecode, precision) {
+  Place place;
+#if defined(LITE_WITH_ARM)
+  place = TARGET(kARM);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+#else
+  return;
+#endif
+  test_beam_search_decode(place);
+}
+
+}  // namespace lite
+}  // namespace paddle
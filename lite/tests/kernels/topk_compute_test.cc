@@ -101,6 +101,15 @@ void test_topk(Place place, float abs_error) {
       arena.TestPrecision();
     }
   }
+  // The vocabulary-sized rows take the heap path of the small k, fp16 has
+  // too many ties on them.
+  if (place.target == TARGET(kNPU)) return;
+  for (int k : {1, 10, 200}) {
+    std::unique_ptr<arena::TestCase> tester(new TopkComputeTester<T1, T2>(
+        place, "def", DDim(std::vector<int64_t>({4, 50000})), k));
+    arena::Arena arena(std::move(tester), place, abs_error);
+    arena.TestPrecision();
+  }
 }
 
 TEST(Topk, precision) {
@@ -111,6 +120,8 @@ TEST(Topk, precision) {
   abs_error = 1e-3;  // Using fp16 in NPU
 #elif defined(LITE_WITH_ARM)
   place = TARGET(kARM);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
 #else
   return;
 #endif
@@ -402,6 +402,7 @@ function make_x86 {
             -DXPU_SDK_ROOT=$XPU_SDK_ROOT \
             -DLITE_WITH_HUAWEI_ASCEND_NPU=$WITH_HUAWEI_ASCEND_NPU \
             -DHUAWEI_ASCEND_NPU_DDK_ROOT=$HUAWEI_ASCEND_NPU_DDK_ROOT \
+            -DLITE_WITH_CV=$BUILD_CV \
             -DCMAKE_BUILD_TYPE=Release \
             -DPY_VERSION=$PY_VERSION \
             $PYTHON_EXECUTABLE_OPTION
@@ -0,0 +1,358 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image_fused.h"
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "lite/utils/cv/image_convert.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+const int kResizeCoefBits = 11;
+const int kResizeCoefScale = 1 << kResizeCoefBits;
+// The bytes of the resized rows of a strip.
+const int kStripBytes = 32 * 1024;
+
+inline int16_t SaturateCastShort(float x) {
+  int v = static_cast<int>(x + (x >= 0.f ? 0.5f : -0.5f));
+  return static_cast<int16_t>(std::min(std::max(v, SHRT_MIN), SHRT_MAX));
+}
+
+bool IsNV(ImageFormat format) { return format == NV12 || format == NV21; }
+
+int Channels(ImageFormat format) {
+  if (format == GRAY || IsNV(format)) return 1;
+  if (format == BGR || format == RGB) return 3;
+  if (format == BGRA || format == RGBA) return 4;
+  return 0;
+}
+
+/*
+ * The bilinear resize of a plane row by row, in the fixed point of
+ * imageResize: the weights have 11 bits, the source rows are resized
+ * horizontally into int16 values, and two of them are blended vertically.
+ * The two last resized source rows are kept for the next output rows.
+ */
+class RowResizer {
+ public:
+  RowResizer(const uint8_t* src,
+             int srcw,
+             int srch,
+             int dstw,
+             int dsth,
+             int channels)
+      : src_(src),
+        srcw_(srcw),
+        dstw_(dstw),
+        channels_(channels),
+        copy_(srcw == dstw && srch == dsth) {
+    if (copy_) return;
+    xofs_.resize(dstw * 2);
+    yofs_.resize(dsth * 2);
+    alpha_.resize(dstw * 2);
+    beta_.resize(dsth * 2);
+    ComputeCoefs(srcw, dstw, xofs_.data(), alpha_.data());
+    ComputeCoefs(srch, dsth, yofs_.data(), beta_.data());
+    rows_.resize(dstw * channels * 2);
+  }
+
+  // Writes the output row dy to dst.
+  void Row(int dy, uint8_t* dst) {
+    int row_size = dstw_ * channels_;
+    if (copy_) {
+      memcpy(dst, src_ + static_cast<int64_t>(dy) * row_size, row_size);
+      return;
+    }
+    int dsth = static_cast<int>(beta_.size() / 2);
+    int y0 = yofs_[dy];
+    int y1 = yofs_[dsth + dy];
+    const int16_t* row0 = Resized(y0, y1);
+    const int16_t* row1 = Resized(y1, y0);
+    const int16_t b0 = beta_[2 * dy];
+    const int16_t b1 = beta_[2 * dy + 1];
+    // The products are kept in 16 bits, which the compiler maps to the high
+    // half multiplies of SIMD.
+    for (int i = 0; i < row_size; i++) {
+      int16_t v0 = static_cast<int16_t>((b0 * row0[i]) >> 16);
+      int16_t v1 = static_cast<int16_t>((b1 * row1[i]) >> 16);
+      dst[i] = static_cast<uint8_t>((v0 + v1 + 2) >> 2);
+    }
+  }
+
+ private:
+  // The two source coordinates and their weights of each output coordinate,
+  // the first coordinates are at ofs[d] and the second at ofs[dst_len + d].
+  static void ComputeCoefs(int src_len,
+                           int dst_len,
+                           int* ofs,
+                           int16_t* coefs) {
+    double scale = static_cast<double>(src_len) / dst_len;
+    for (int d = 0; d < dst_len; d++) {
+      float f = static_cast<float>((d + 0.5) * scale - 0.5);
+      int s = floor(f);
+      f -= s;
+      if (s < 0) {
+        s = 0;
+        f = 0.f;
+      }
+      if (s >= src_len - 1) {
+        s = src_len - 1;
+        f = 0.f;
+      }
+      ofs[d] = s;
+      ofs[dst_len + d] = std::min(s + 1, src_len - 1);
+      coefs[2 * d] = SaturateCastShort((1.f - f) * kResizeCoefScale);
+      coefs[2 * d + 1] = SaturateCastShort(f * kResizeCoefScale);
+    }
+  }
+
+  // Returns the source row y resized horizontally, it's kept in the buffer
+  // not holding the row other.
+  const int16_t* Resized(int y, int other) {
+    int row_size = dstw_ * channels_;
+    int16_t* bufs[2] = {rows_.data(), rows_.data() + row_size};
+    for (int k = 0; k < 2; k++) {
+      if (cached_[k] == y) return bufs[k];
+    }
+    int k = cached_[0] == other ? 1 : 0;
+    const uint8_t* s = src_ + static_cast<int64_t>(y) * srcw_ * channels_;
+    switch (channels_) {
+      case 1:
+        ResizeRow<1>(s, bufs[k]);
+        break;
+      case 2:
+        ResizeRow<2>(s, bufs[k]);
+        break;
+      case 3:
+        ResizeRow<3>(s, bufs[k]);
+        break;
+      default:
+        ResizeRow<4>(s, bufs[k]);
+        break;
+    }
+    cached_[k] = y;
+    return bufs[k];
+  }
+
+  // The channel count is a constant, so the inner loop is unrolled.
+  template <int C>
+  void ResizeRow(const uint8_t* s, int16_t* row) const {
+    const int* xofs0 = xofs_.data();
+    const int* xofs1 = xofs_.data() + dstw_;
+    const int16_t* alpha = alpha_.data();
+    for (int dx = 0; dx < dstw_; dx++) {
+      const uint8_t* s0 = s + xofs0[dx] * C;
+      const uint8_t* s1 = s + xofs1[dx] * C;
+      int a0 = alpha[2 * dx];
+      int a1 = alpha[2 * dx + 1];
+      for (int c = 0; c < C; c++) {
+        row[c] = (s0[c] * a0 + s1[c] * a1) >> 4;
+      }
+      row += C;
+    }
+  }
+
+  const uint8_t* src_;
+  int srcw_;
+  int dstw_;
+  int channels_;
+  bool copy_;
+  std::vector<int> xofs_;
+  std::vector<int> yofs_;
+  std::vector<int16_t> alpha_;
+  std::vector<int16_t> beta_;
+  std::vector<int16_t> rows_;
+  int cached_[2]{-1, -1};
+};
+
+inline void StoreValue(float v, float* dst) { *dst = v; }
+
+// The int8 values are rounded and saturated to [-127, 127].
+inline void StoreValue(float v, int8_t* dst) {
+  v = std::min(std::max(roundf(v), -127.f), 127.f);
+  *dst = static_cast<int8_t>(v);
+}
+
+/*
+ * The normalized values of the 256 bytes of each channel, (x - means[c]) *
+ * scales[c] as image2Tensor. The bytes are mapped by a table lookup instead
+ * of the arithmetic, as the channels of the pixels are interleaved.
+ */
+template <typename T>
+class NormalizeTable {
+ public:
+  // The tables of the first 3 channels, the alpha channel is dropped.
+  NormalizeTable(int channels, const float* means, const float* scales)
+      : table_(256 * std::min(channels, 3)) {
+    for (int c = 0; c < std::min(channels, 3); c++) {
+      for (int x = 0; x < 256; x++) {
+        StoreValue((x - means[c]) * scales[c], &table_[c * 256 + x]);
+      }
+    }
+  }
+
+  // Normalizes the h rows of pixels in the strip starting at the output row
+  // y0.
+  void Strip(const uint8_t* pixels,
+             int channels,
+             int w,
+             int h,
+             int y0,
+             int dsth,
+             LayoutType layout,
+             T* out) const {
+    int n = w * h;
+    const T* t0 = table_.data();
+    if (channels == 1) {
+      T* dst = out + static_cast<int64_t>(y0) * w;
+      for (int i = 0; i < n; i++) {
+        dst[i] = t0[pixels[i]];
+      }
+      return;
+    }
+    const T* t1 = t0 + 256;
+    const T* t2 = t1 + 256;
+    if (layout == LayoutType::kNCHW) {
+      int64_t plane = static_cast<int64_t>(dsth) * w;
+      T* dst0 = out + static_cast<int64_t>(y0) * w;
+      T* dst1 = dst0 + plane;
+      T* dst2 = dst1 + plane;
+      for (int i = 0; i < n; i++) {
+        const uint8_t* in = pixels + i * channels;
+        dst0[i] = t0[in[0]];
+        dst1[i] = t1[in[1]];
+        dst2[i] = t2[in[2]];
+      }
+    } else {
+      T* dst = out + static_cast<int64_t>(y0) * w * 3;
+      for (int i = 0; i < n; i++) {
+        const uint8_t* in = pixels + i * channels;
+        dst[3 * i] = t0[in[0]];
+        dst[3 * i + 1] = t1[in[1]];
+        dst[3 * i + 2] = t2[in[2]];
+      }
+    }
+  }
+
+ private:
+  std::vector<T> table_;
+};
+
+}  // namespace
+
+/*
+ * resize, color convert and change image data to tensor data in one pass
+ * support srcFormat: GRAY, NV12(NV21), BGR(RGB) and BGRA(RGBA)
+ * support dstFormat: GRAY, BGR(RGB) and BGRA(RGBA), Data layout is NHWC and
+ * NCHW
+ * The tensor is resized to the output shape, its data is float or int8.
+ */
+void ImageFusedToTensor::choose(const uint8_t* src,
+                                Tensor* dst,
+                                ImageFormat srcFormat,
+                                ImageFormat dstFormat,
+                                LayoutType layout,
+                                int srcw,
+                                int srch,
+                                int dstw,
+                                int dsth,
+                                float* means,
+                                float* scales,
+                                PrecisionType precision) {
+  int in_channels = Channels(srcFormat);
+  int channels = IsNV(dstFormat) ? 0 : Channels(dstFormat);
+  if (in_channels == 0 || channels == 0 ||
+      (IsNV(srcFormat) && dstFormat == GRAY)) {
+    printf("srcFormat: %d, dstFormat: %d does not support! \n",
+           srcFormat,
+           dstFormat);
+    return;
+  }
+  if (layout != LayoutType::kNCHW && layout != LayoutType::kNHWC) {
+    printf("this layout: %d does not support! \n", static_cast<int>(layout));
+    return;
+  }
+  if (precision != PrecisionType::kFloat && precision != PrecisionType::kInt8) {
+    printf("this precision: %d does not support! \n",
+           static_cast<int>(precision));
+    return;
+  }
+  if (IsNV(srcFormat) && (srcw % 2 || srch % 2 || dstw % 2 || dsth % 2)) {
+    printf("the size of NV12(NV21) image must be even \n");
+    return;
+  }
+  int64_t out_channels = channels == 1 ? 1 : 3;
+  if (layout == LayoutType::kNCHW) {
+    dst->Resize({1, out_channels, dsth, dstw});
+  } else {
+    dst->Resize({1, dsth, dstw, out_channels});
+  }
+  bool to_int8 = precision == PrecisionType::kInt8;
+  float* fout = to_int8 ? nullptr : dst->mutable_data<float>();
+  int8_t* iout = to_int8 ? dst->mutable_data<int8_t>() : nullptr;
+
+  RowResizer y_resizer(src, srcw, srch, dstw, dsth, in_channels);
+  // The interleaved vu of NV12(NV21) is a 2-channel plane of the half size.
+  RowResizer uv_resizer(
+      src + srcw * srch, srcw / 2, srch / 2, dstw / 2, dsth / 2, 2);
+  // An even number of rows, so a strip of NV12(NV21) is an image itself.
+  int rows = std::max(2, kStripBytes / (dstw * std::max(in_channels, 2)));
+  rows = std::min(rows - rows % 2, dsth);
+  std::vector<uint8_t> resized(
+      static_cast<size_t>(dstw) * rows * (IsNV(srcFormat) ? 2 : in_channels));
+  std::vector<uint8_t> converted;
+  if (srcFormat != dstFormat) {
+    converted.resize(static_cast<size_t>(dstw) * rows * channels);
+  }
+  ImageConvert img_convert;
+  NormalizeTable<float> float_table(to_int8 ? 0 : channels, means, scales);
+  NormalizeTable<int8_t> int8_table(to_int8 ? channels : 0, means, scales);
+  for (int y0 = 0; y0 < dsth; y0 += rows) {
+    int h = std::min(rows, dsth - y0);
+    int row_size = dstw * in_channels;
+    for (int k = 0; k < h; k++) {
+      y_resizer.Row(y0 + k, resized.data() + k * row_size);
+    }
+    if (IsNV(srcFormat)) {
+      uint8_t* uv = resized.data() + h * row_size;
+      for (int k = 0; k < h / 2; k++) {
+        uv_resizer.Row(y0 / 2 + k, uv + k * dstw);
+      }
+    }
+    const uint8_t* pixels = resized.data();
+    if (srcFormat != dstFormat) {
+      img_convert.choose(
+          resized.data(), converted.data(), srcFormat, dstFormat, dstw, h);
+      pixels = converted.data();
+    }
+    if (to_int8) {
+      int8_table.Strip(pixels, channels, dstw, h, y0, dsth, layout, iout);
+    } else {
+      float_table.Strip(pixels, channels, dstw, h, y0, dsth, layout, fout);
+    }
+  }
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
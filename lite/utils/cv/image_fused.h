@@ -0,0 +1,47 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/utils/cv/paddle_image_preprocess.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+/*
+ * resize, color convert and change image data to tensor data in one pass.
+ * The output rows are produced by strips small enough to stay in cache, so
+ * neither the resized image nor the converted image is written to memory.
+ * The results are the same as imageResize, imageConvert and image2Tensor.
+ */
+class ImageFusedToTensor {
+ public:
+  void choose(const uint8_t* src,
+              Tensor* dst,
+              ImageFormat srcFormat,
+              ImageFormat dstFormat,
+              LayoutType layout,
+              int srcw,
+              int srch,
+              int dstw,
+              int dsth,
+              float* means,
+              float* scales,
+              PrecisionType precision);
+};
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -20,6 +20,7 @@
 #include "lite/utils/cv/image2tensor.h"
 #include "lite/utils/cv/image_convert.h"
 #include "lite/utils/cv/image_flip.h"
+#include "lite/utils/cv/image_fused.h"
 #include "lite/utils/cv/image_resize.h"
 #include "lite/utils/cv/image_rotate.h"
 namespace paddle {
@@ -160,6 +161,56 @@ __attribute__((visibility("default"))) void ImagePreprocess::image2Tensor(
                     scales);
 }
 
+__attribute__((visibility("default"))) void ImagePreprocess::image2TensorFused(
+    const uint8_t* src,
+    Tensor* dstTensor,
+    ImageFormat srcFormat,
+    ImageFormat dstFormat,
+    int srcw,
+    int srch,
+    int dstw,
+    int dsth,
+    LayoutType layout,
+    float* means,
+    float* scales,
+    PrecisionType precision) {
+  ImageFusedToTensor img_fused;
+  img_fused.choose(src,
+                   dstTensor,
+                   srcFormat,
+                   dstFormat,
+                   layout,
+                   srcw,
+                   srch,
+                   dstw,
+                   dsth,
+                   means,
+                   scales,
+                   precision);
+}
+
+__attribute__((visibility("default"))) void ImagePreprocess::image2TensorFused(
+    const uint8_t* src,
+    Tensor* dstTensor,
+    LayoutType layout,
+    float* means,
+    float* scales,
+    PrecisionType precision) {
+  ImageFusedToTensor img_fused;
+  img_fused.choose(src,
+                   dstTensor,
+                   this->srcFormat_,
+                   this->dstFormat_,
+                   layout,
+                   this->transParam_.iw,
+                   this->transParam_.ih,
+                   this->transParam_.ow,
+                   this->transParam_.oh,
+                   means,
+                   scales,
+                   precision);
+}
+
 __attribute__((visibility("default"))) void ImagePreprocess::imageCrop(
     const uint8_t* src,
     uint8_t* dst,
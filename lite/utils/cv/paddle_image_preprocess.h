@@ -26,6 +26,7 @@ namespace utils {
 namespace cv {
 typedef paddle::lite_api::Tensor Tensor;
 typedef paddle::lite_api::DataLayoutType LayoutType;
+typedef paddle::lite_api::PrecisionType PrecisionType;
 // color enum
 enum ImageFormat {
   RGBA = 0,
@@ -211,6 +212,56 @@ class ImagePreprocess {
                     float* means,
                     float* scales);
 
+  /*
+  * resize, color convert and change image data to tensor data in one pass,
+  * without the intermediate images of imageResize and imageConvert
+  * support srcFormat is GRAY, NV12(NV21), BGR(RGB) and BGRA(RGBA), dstFormat
+  * is GRAY, BGR(RGB) and BGRA(RGBA), Data layout is NHWC and NCHW
+  * dstTensor is resized to the output shape, it can be the input tensor of
+  * the predictor.
+  * param src: input image data
+  * param dstTensor: output tensor data
+  * param layout: output tensor layout，support NHWC and NCHW
+  * param means: means of image
+  * param scales: scales of image
+  * param precision: output data type, support kFloat and kInt8. The int8
+  * data is rounded and saturated to [-127, 127], the scales should include
+  * the quantization scale
+  */
+  void image2TensorFused(const uint8_t* src,
+                         Tensor* dstTensor,
+                         LayoutType layout,
+                         float* means,
+                         float* scales,
+                         PrecisionType precision = PrecisionType::kFloat);
+  /*
+  * resize, color convert and change image data to tensor data in one pass
+  * param src: input image data
+  * param dstTensor: output tensor data
+  * param srcFormat: input image format
+  * param dstFormat: the image format of the tensor channels
+  * param srcw: input image width
+  * param srch: input image height
+  * param dstw: output width
+  * param dsth: output height
+  * param layout: output tensor layout，support NHWC and NCHW
+  * param means: means of image
+  * param scales: scales of image
+  * param precision: output data type, support kFloat and kInt8
+  */
+  void image2TensorFused(const uint8_t* src,
+                         Tensor* dstTensor,
+                         ImageFormat srcFormat,
+                         ImageFormat dstFormat,
+                         int srcw,
+                         int srch,
+                         int dstw,
+                         int dsth,
+                         LayoutType layout,
+                         float* means,
+                         float* scales,
+                         PrecisionType precision = PrecisionType::kFloat);
+
   /*
   * image crop process
   * color format support 1-channel image, 3-channel image and 4-channel image
@@ -0,0 +1,47 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/x86/cv_simd.h"
+#include <algorithm>
+#include "lite/backends/x86/cpu_info.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+CvIsa DetectCvIsa() {
+  if (x86::MayIUse(x86::avx2)) return CvIsa::kAvx2;
+  // SSE4.2 implies SSE4.1.
+  if (x86::MayIUse(x86::sse42)) return CvIsa::kSse41;
+  return CvIsa::kScalar;
+}
+
+CvIsa* CurrentCvIsa() {
+  static CvIsa isa = DetectCvIsa();
+  return &isa;
+}
+
+}  // namespace
+
+CvIsa GetCvIsa() { return *CurrentCvIsa(); }
+
+void SetCvIsa(CvIsa isa) { *CurrentCvIsa() = std::min(isa, DetectCvIsa()); }
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,143 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#define LITE_CV_SSE41
+#define LITE_CV_AVX2
+#else
+#define LITE_CV_SSE41 __attribute__((target("sse4.1")))
+#define LITE_CV_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+// The instruction sets of the x86 image preprocessing, in ascending order.
+enum class CvIsa { kScalar = 0, kSse41, kAvx2 };
+
+// The instruction set in use, it's the best one the CPU supports by default.
+CvIsa GetCvIsa();
+
+// Limits the instruction set to isa, e.g. to compare the SIMD code with the
+// scalar code. It's clamped to the instruction sets the CPU supports.
+void SetCvIsa(CvIsa isa);
+
+// The pshufb masks between 16 pixels of 3 interleaved channels(48 bytes in 3
+// registers) and the 3 planes of the channels.
+struct Shuffle3Masks {
+  Shuffle3Masks() {
+    for (int k = 0; k < 3; k++) {
+      for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < 16; i++) {
+          int n = 16 * k + i;
+          interleave[k][c][i] = n % 3 == c ? n / 3 : -1;
+          int m = 3 * i + c;
+          deinterleave[k][c][i] = m / 16 == k ? m % 16 : -1;
+        }
+      }
+    }
+  }
+  // interleave[k][c]: the bytes of the register k from the plane c.
+  alignas(16) int8_t interleave[3][3][16];
+  // deinterleave[k][c]: the bytes of the plane c from the register k.
+  alignas(16) int8_t deinterleave[3][3][16];
+};
+
+inline const Shuffle3Masks& GetShuffle3Masks() {
+  static const Shuffle3Masks masks;
+  return masks;
+}
+
+LITE_CV_SSE41 inline __m128i LoadMask(const int8_t* mask) {
+  return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+LITE_CV_SSE41 inline __m128i Load16(const uint8_t* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+LITE_CV_SSE41 inline void Store16(uint8_t* dst, __m128i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+}
+
+// Splits 16 pixels of 3 channels at src into the planes p[0], p[1], p[2].
+LITE_CV_SSE41 inline void Deinterleave3(const uint8_t* src, __m128i p[3]) {
+  const Shuffle3Masks& masks = GetShuffle3Masks();
+  __m128i v[3] = {Load16(src), Load16(src + 16), Load16(src + 32)};
+  for (int c = 0; c < 3; c++) {
+    p[c] = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(v[0], LoadMask(masks.deinterleave[0][c])),
+            _mm_shuffle_epi8(v[1], LoadMask(masks.deinterleave[1][c]))),
+        _mm_shuffle_epi8(v[2], LoadMask(masks.deinterleave[2][c])));
+  }
+}
+
+// Stores 16 pixels of the planes c0, c1, c2 as 3 interleaved channels.
+LITE_CV_SSE41 inline void Interleave3(__m128i c0,
+                                      __m128i c1,
+                                      __m128i c2,
+                                      uint8_t* dst) {
+  const Shuffle3Masks& masks = GetShuffle3Masks();
+  for (int k = 0; k < 3; k++) {
+    __m128i v = _mm_or_si128(
+        _mm_or_si128(_mm_shuffle_epi8(c0, LoadMask(masks.interleave[k][0])),
+                     _mm_shuffle_epi8(c1, LoadMask(masks.interleave[k][1]))),
+        _mm_shuffle_epi8(c2, LoadMask(masks.interleave[k][2])));
+    Store16(dst + 16 * k, v);
+  }
+}
+
+// Splits 16 pixels of 4 channels at src into the planes p[0] ... p[3].
+LITE_CV_SSE41 inline void Deinterleave4(const uint8_t* src, __m128i p[4]) {
+  const __m128i mask =
+      _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  __m128i v0 = _mm_shuffle_epi8(Load16(src), mask);
+  __m128i v1 = _mm_shuffle_epi8(Load16(src + 16), mask);
+  __m128i v2 = _mm_shuffle_epi8(Load16(src + 32), mask);
+  __m128i v3 = _mm_shuffle_epi8(Load16(src + 48), mask);
+  __m128i t0 = _mm_unpacklo_epi32(v0, v1);
+  __m128i t1 = _mm_unpacklo_epi32(v2, v3);
+  __m128i t2 = _mm_unpackhi_epi32(v0, v1);
+  __m128i t3 = _mm_unpackhi_epi32(v2, v3);
+  p[0] = _mm_unpacklo_epi64(t0, t1);
+  p[1] = _mm_unpackhi_epi64(t0, t1);
+  p[2] = _mm_unpacklo_epi64(t2, t3);
+  p[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+// Stores 16 pixels of the planes c0 ... c3 as 4 interleaved channels.
+LITE_CV_SSE41 inline void Interleave4(
+    __m128i c0, __m128i c1, __m128i c2, __m128i c3, uint8_t* dst) {
+  __m128i lo01 = _mm_unpacklo_epi8(c0, c1);
+  __m128i hi01 = _mm_unpackhi_epi8(c0, c1);
+  __m128i lo23 = _mm_unpacklo_epi8(c2, c3);
+  __m128i hi23 = _mm_unpackhi_epi8(c2, c3);
+  Store16(dst, _mm_unpacklo_epi16(lo01, lo23));
+  Store16(dst + 16, _mm_unpackhi_epi16(lo01, lo23));
+  Store16(dst + 32, _mm_unpacklo_epi16(hi01, hi23));
+  Store16(dst + 48, _mm_unpackhi_epi16(hi01, hi23));
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
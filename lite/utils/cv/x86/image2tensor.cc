@@ -0,0 +1,296 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image2tensor.h"
+#include "lite/utils/cv/x86/cv_simd.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+/*
+ * out = (in - mean[c]) * scale[c] of the channel c, as the ARM version. The
+ * 16 bytes of a register are widened to 32-bit by cvtepu8 and normalized by
+ * the lanes of mean and scale, which repeat the channels of the bytes.
+ */
+LITE_CV_SSE41 inline void Normalize4(__m128i bytes,
+                                     __m128 mean,
+                                     __m128 scale,
+                                     float* dst) {
+  __m128 v = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes));
+  _mm_storeu_ps(dst, _mm_mul_ps(_mm_sub_ps(v, mean), scale));
+}
+
+LITE_CV_SSE41 void Normalize16Sse41(__m128i bytes,
+                                    float mean,
+                                    float scale,
+                                    float* dst) {
+  __m128 vmean = _mm_set1_ps(mean);
+  __m128 vscale = _mm_set1_ps(scale);
+  for (int k = 0; k < 4; k++) {
+    Normalize4(bytes, vmean, vscale, dst + 4 * k);
+    bytes = _mm_srli_si128(bytes, 4);
+  }
+}
+
+LITE_CV_AVX2 void Normalize16Avx2(__m128i bytes,
+                                  float mean,
+                                  float scale,
+                                  float* dst) {
+  __m256 vmean = _mm256_set1_ps(mean);
+  __m256 vscale = _mm256_set1_ps(scale);
+  __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+  __m256 hi =
+      _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+  _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_sub_ps(lo, vmean), vscale));
+  _mm256_storeu_ps(dst + 8, _mm256_mul_ps(_mm256_sub_ps(hi, vmean), vscale));
+}
+
+void NormalizeScalar(const uint8_t* src,
+                     float* dst,
+                     int len,
+                     int stride,
+                     float mean,
+                     float scale) {
+  for (int i = 0; i < len; i++) {
+    dst[i] = (src[i * stride] - mean) * scale;
+  }
+}
+
+// Splits 16 pixels of kC channels and normalizes the first 3 channels (the
+// only one of gray) into the planes of dst.
+template <int kC>
+LITE_CV_SSE41 void ToPlanes16(const uint8_t* src,
+                              float* dst[3],
+                              const float* means,
+                              const float* scales,
+                              bool avx2) {
+  __m128i p[4];
+  if (kC == 1) {
+    p[0] = Load16(src);
+  } else if (kC == 3) {
+    Deinterleave3(src, p);
+  } else {
+    Deinterleave4(src, p);
+  }
+  for (int c = 0; c < (kC == 1 ? 1 : 3); c++) {
+    if (avx2) {
+      Normalize16Avx2(p[c], means[c], scales[c], dst[c]);
+    } else {
+      Normalize16Sse41(p[c], means[c], scales[c], dst[c]);
+    }
+  }
+}
+
+// The gray image and the NCHW tensors of the 3 and 4-channel images, the
+// alpha channel is dropped.
+template <int kC>
+void ToTensorChw(const uint8_t* src,
+                 float* dst,
+                 int srcw,
+                 int srch,
+                 float* means,
+                 float* scales) {
+  int64_t size = static_cast<int64_t>(srcw) * srch;
+  int planes = kC == 1 ? 1 : 3;
+  CvIsa isa = GetCvIsa();
+  // A gray image is a single row of the plane.
+  int rows = kC == 1 ? 1 : srch;
+  int64_t width = kC == 1 ? size : srcw;
+  for (int y = 0; y < rows; y++) {
+    const uint8_t* in = src + y * width * kC;
+    float* out[3];
+    for (int c = 0; c < planes; c++) {
+      out[c] = dst + c * size + y * width;
+    }
+    int64_t x = 0;
+    if (isa >= CvIsa::kSse41) {
+      for (; x + 16 <= width; x += 16) {
+        float* tile[3];
+        for (int c = 0; c < planes; c++) {
+          tile[c] = out[c] + x;
+        }
+        ToPlanes16<kC>(in + x * kC, tile, means, scales, isa == CvIsa::kAvx2);
+      }
+    }
+    for (int c = 0; c < planes; c++) {
+      NormalizeScalar(in + x * kC + c,
+                      out[c] + x,
+                      static_cast<int>(width - x),
+                      kC,
+                      means[c],
+                      scales[c]);
+    }
+  }
+}
+
+/*
+ * The NHWC tensors of the 3 and 4-channel images. Every 4 pixels give 12
+ * floats in 3 registers whose lanes repeat the channels with the period 3, so
+ * the means and scales of the lanes are the 3 rotations of the channels. The
+ * alpha bytes of the 4-channel pixels are dropped by a shuffle.
+ */
+template <int kC>
+LITE_CV_SSE41 int64_t ToTensorHwcSse41(const uint8_t* src,
+                                       float* dst,
+                                       int64_t num,
+                                       const float* means,
+                                       const float* scales) {
+  __m128 vmean[3];
+  __m128 vscale[3];
+  for (int k = 0; k < 3; k++) {
+    vmean[k] = _mm_setr_ps(means[(4 * k) % 3],
+                           means[(4 * k + 1) % 3],
+                           means[(4 * k + 2) % 3],
+                           means[(4 * k + 3) % 3]);
+    vscale[k] = _mm_setr_ps(scales[(4 * k) % 3],
+                            scales[(4 * k + 1) % 3],
+                            scales[(4 * k + 2) % 3],
+                            scales[(4 * k + 3) % 3]);
+  }
+  const __m128i drop_alpha = _mm_setr_epi8(
+      0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  int64_t i = 0;
+  // Loads 16 bytes for the 12 of 4 pixels, the last pixels of the 3-channel
+  // images are left to the scalar code.
+  int64_t end = kC == 3 ? num - 2 : num;
+  for (; i + 4 <= end; i += 4) {
+    __m128i bytes = Load16(src + i * kC);
+    if (kC == 4) bytes = _mm_shuffle_epi8(bytes, drop_alpha);
+    for (int k = 0; k < 3; k++) {
+      Normalize4(bytes, vmean[k], vscale[k], dst + i * 3 + 4 * k);
+      bytes = _mm_srli_si128(bytes, 4);
+    }
+  }
+  return i;
+}
+
+template <int kC>
+void ToTensorHwc(const uint8_t* src,
+                 float* dst,
+                 int srcw,
+                 int srch,
+                 float* means,
+                 float* scales) {
+  int64_t num = static_cast<int64_t>(srcw) * srch;
+  int64_t i = 0;
+  if (GetCvIsa() >= CvIsa::kSse41) {
+    i = ToTensorHwcSse41<kC>(src, dst, num, means, scales);
+  }
+  for (; i < num; i++) {
+    for (int c = 0; c < 3; c++) {
+      dst[i * 3 + c] = (src[i * kC + c] - means[c]) * scales[c];
+    }
+  }
+}
+
+void gray_to_tensor(const uint8_t* src,
+                    float* output,
+                    int width,
+                    int height,
+                    float* means,
+                    float* scales) {
+  ToTensorChw<1>(src, output, width, height, means, scales);
+}
+
+void bgr_to_tensor_chw(const uint8_t* src,
+                       float* output,
+                       int width,
+                       int height,
+                       float* means,
+                       float* scales) {
+  ToTensorChw<3>(src, output, width, height, means, scales);
+}
+
+void bgra_to_tensor_chw(const uint8_t* src,
+                        float* output,
+                        int width,
+                        int height,
+                        float* means,
+                        float* scales) {
+  ToTensorChw<4>(src, output, width, height, means, scales);
+}
+
+void bgr_to_tensor_hwc(const uint8_t* src,
+                       float* output,
+                       int width,
+                       int height,
+                       float* means,
+                       float* scales) {
+  ToTensorHwc<3>(src, output, width, height, means, scales);
+}
+
+void bgra_to_tensor_hwc(const uint8_t* src,
+                        float* output,
+                        int width,
+                        int height,
+                        float* means,
+                        float* scales) {
+  ToTensorHwc<4>(src, output, width, height, means, scales);
+}
+
+}  // namespace
+
+/*
+  * change image data to tensor data
+  * support image format is BGR(RGB) and BGRA(RGBA), Data layout is NHWC and
+ * NCHW
+  * param src: input image data
+  * param dstTensor: output tensor data
+  * param srcFormat: input image format, support GRAY, BGR(GRB) and BGRA(RGBA)
+  * param srcw: input image width
+  * param srch: input image height
+  * param layout: output tensor layout，support NHWC and NCHW
+  * param means: means of image
+  * param scales: scales of image
+*/
+void Image2Tensor::choose(const uint8_t* src,
+                          Tensor* dst,
+                          ImageFormat srcFormat,
+                          LayoutType layout,
+                          int srcw,
+                          int srch,
+                          float* means,
+                          float* scales) {
+  float* output = dst->mutable_data<float>();
+  if (layout == LayoutType::kNCHW && (srcFormat == BGR || srcFormat == RGB)) {
+    impl_ = bgr_to_tensor_chw;
+  } else if (layout == LayoutType::kNHWC &&
+             (srcFormat == BGR || srcFormat == RGB)) {
+    impl_ = bgr_to_tensor_hwc;
+  } else if (layout == LayoutType::kNCHW &&
+             (srcFormat == BGRA || srcFormat == RGBA)) {
+    impl_ = bgra_to_tensor_chw;
+  } else if (layout == LayoutType::kNHWC &&
+             (srcFormat == BGRA || srcFormat == RGBA)) {
+    impl_ = bgra_to_tensor_hwc;
+  } else if ((layout == LayoutType::kNHWC || layout == LayoutType::kNCHW) &&
+             (srcFormat == GRAY)) {
+    impl_ = gray_to_tensor;
+  } else {
+    printf("this layout: %d or image format: %d not support \n",
+           static_cast<int>(layout),
+           srcFormat);
+    return;
+  }
+  impl_(src, output, srcw, srch, means, scales);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,421 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image_convert.h"
+#include <math.h>
+#include <string.h>
+#include "lite/utils/cv/x86/cv_simd.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+/*
+ * The pixel conversions process the pixels of the whole image as one row,
+ * the SSE4.1 versions split 16 pixels into the channel planes, convert the
+ * planes and interleave them again, the remaining pixels are converted by the
+ * scalar versions, so both give the same results.
+ */
+
+// Gray = (15 * B + 75 * G + 38 * R) >> 7, the coefficients are
+// 0.114, 0.587 and 0.299 in 7-bit fixed point.
+const int kGrayB = 15;
+const int kGrayG = 75;
+const int kGrayR = 38;
+
+// dst channel c is src channel (swap ? 2 - c : c) for the first 3 channels,
+// the alpha of dst is the alpha of src or 255.
+template <int kSrcC, int kDstC, bool kSwap>
+void ReorderScalar(const uint8_t* src, uint8_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    dst[0] = src[kSwap ? 2 : 0];
+    dst[1] = src[1];
+    dst[2] = src[kSwap ? 0 : 2];
+    if (kDstC == 4) dst[3] = kSrcC == 4 ? src[3] : 255;
+    src += kSrcC;
+    dst += kDstC;
+  }
+}
+
+template <int kSrcC, int kDstC, bool kSwap>
+LITE_CV_SSE41 void ReorderSse41(const uint8_t* src, uint8_t* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i p[4];
+    if (kSrcC == 3) {
+      Deinterleave3(src, p);
+      p[3] = _mm_set1_epi8(-1);
+    } else {
+      Deinterleave4(src, p);
+    }
+    __m128i c0 = kSwap ? p[2] : p[0];
+    __m128i c2 = kSwap ? p[0] : p[2];
+    if (kDstC == 3) {
+      Interleave3(c0, p[1], c2, dst);
+    } else {
+      Interleave4(c0, p[1], c2, p[3], dst);
+    }
+    src += 16 * kSrcC;
+    dst += 16 * kDstC;
+  }
+  ReorderScalar<kSrcC, kDstC, kSwap>(src, dst, n - i);
+}
+
+template <int kSrcC>
+void ToGrayScalar(const uint8_t* src, uint8_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = (src[0] * kGrayB + src[1] * kGrayG + src[2] * kGrayR) >> 7;
+    src += kSrcC;
+  }
+}
+
+// The weighted sum of 8 pixels in 16-bit lanes, it's at most 255 * 128.
+LITE_CV_SSE41 inline __m128i GraySum(__m128i b, __m128i g, __m128i r) {
+  __m128i sum = _mm_mullo_epi16(b, _mm_set1_epi16(kGrayB));
+  sum = _mm_add_epi16(sum, _mm_mullo_epi16(g, _mm_set1_epi16(kGrayG)));
+  sum = _mm_add_epi16(sum, _mm_mullo_epi16(r, _mm_set1_epi16(kGrayR)));
+  return _mm_srli_epi16(sum, 7);
+}
+
+template <int kSrcC>
+LITE_CV_SSE41 void ToGraySse41(const uint8_t* src, uint8_t* dst, int64_t n) {
+  const __m128i zero = _mm_setzero_si128();
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i p[4];
+    if (kSrcC == 3) {
+      Deinterleave3(src, p);
+    } else {
+      Deinterleave4(src, p);
+    }
+    __m128i lo = GraySum(_mm_cvtepu8_epi16(p[0]),
+                         _mm_cvtepu8_epi16(p[1]),
+                         _mm_cvtepu8_epi16(p[2]));
+    __m128i hi = GraySum(_mm_unpackhi_epi8(p[0], zero),
+                         _mm_unpackhi_epi8(p[1], zero),
+                         _mm_unpackhi_epi8(p[2], zero));
+    Store16(dst + i, _mm_packus_epi16(lo, hi));
+    src += 16 * kSrcC;
+  }
+  ToGrayScalar<kSrcC>(src, dst + i, n - i);
+}
+
+template <int kDstC>
+void FromGrayScalar(const uint8_t* src, uint8_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i++) {
+    dst[0] = src[i];
+    dst[1] = src[i];
+    dst[2] = src[i];
+    if (kDstC == 4) dst[3] = 255;
+    dst += kDstC;
+  }
+}
+
+template <int kDstC>
+LITE_CV_SSE41 void FromGraySse41(const uint8_t* src, uint8_t* dst, int64_t n) {
+  const __m128i alpha = _mm_set1_epi8(-1);
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i gray = Load16(src + i);
+    if (kDstC == 3) {
+      Interleave3(gray, gray, gray, dst);
+    } else {
+      Interleave4(gray, gray, gray, alpha, dst);
+    }
+    dst += 16 * kDstC;
+  }
+  FromGrayScalar<kDstC>(src + i, dst, n - i);
+}
+
+typedef void (*PixelFunc)(const uint8_t* src, uint8_t* dst, int64_t n);
+
+void ConvertPixels(PixelFunc scalar,
+                   PixelFunc sse41,
+                   const uint8_t* src,
+                   uint8_t* dst,
+                   int srcw,
+                   int srch) {
+  int64_t n = static_cast<int64_t>(srcw) * srch;
+  if (GetCvIsa() >= CvIsa::kSse41) {
+    sse41(src, dst, n);
+  } else {
+    scalar(src, dst, n);
+  }
+}
+
+/*
+ * nv12(yuv) and nv21(yvu) to BGR(A), two pixels of a row share the v and u
+ * at vu[v_num] and vu[u_num], two rows share a vu row:
+ * R = Y + 1.402 * (V - 128)
+ * G = Y - 0.34414 * (U - 128) - 0.71414 * (V - 128)
+ * B = Y + 1.772 * (U - 128)
+ * in 7-bit fixed point: 179, 44, 91 and 227.
+ */
+inline uint8_t ClampU8(int v) {
+  return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+template <int kDstC>
+void NvRowScalar(const uint8_t* y,
+                 const uint8_t* vu,
+                 uint8_t* dst,
+                 int begin,
+                 int w,
+                 int v_num,
+                 int u_num) {
+  for (int j = begin; j < w; j++) {
+    const uint8_t* pair = vu + (j & ~1);
+    int v = pair[v_num] - 128;
+    int u = pair[u_num] - 128;
+    int ra = (179 * v) >> 7;
+    int ga = (44 * u + 91 * v) >> 7;
+    int ba = (227 * u) >> 7;
+    uint8_t* out = dst + j * kDstC;
+    out[0] = ClampU8(y[j] + ba);
+    out[1] = ClampU8(y[j] - ga);
+    out[2] = ClampU8(y[j] + ra);
+    if (kDstC == 4) out[3] = 255;
+  }
+}
+
+template <int kDstC>
+LITE_CV_SSE41 void NvRowSse41(const uint8_t* y,
+                              const uint8_t* vu,
+                              uint8_t* dst,
+                              int w,
+                              int v_num,
+                              int u_num) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i bias = _mm_set1_epi16(128);
+  const __m128i low = _mm_set1_epi16(0xff);
+  const __m128i alpha = _mm_set1_epi8(-1);
+  int j = 0;
+  for (; j + 16 <= w; j += 16) {
+    __m128i pairs = Load16(vu + j);
+    __m128i first = _mm_and_si128(pairs, low);
+    __m128i second = _mm_srli_epi16(pairs, 8);
+    __m128i v = _mm_sub_epi16(v_num == 0 ? first : second, bias);
+    __m128i u = _mm_sub_epi16(u_num == 0 ? first : second, bias);
+    __m128i ra = _mm_srai_epi16(_mm_mullo_epi16(v, _mm_set1_epi16(179)), 7);
+    __m128i ga = _mm_srai_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(44)),
+                      _mm_mullo_epi16(v, _mm_set1_epi16(91))),
+        7);
+    __m128i ba = _mm_srai_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(227)), 7);
+    __m128i ys = Load16(y + j);
+    __m128i y_lo = _mm_cvtepu8_epi16(ys);
+    __m128i y_hi = _mm_unpackhi_epi8(ys, zero);
+    // Each of the v and u is shared by two pixels.
+    __m128i r = _mm_packus_epi16(
+        _mm_add_epi16(y_lo, _mm_unpacklo_epi16(ra, ra)),
+        _mm_add_epi16(y_hi, _mm_unpackhi_epi16(ra, ra)));
+    __m128i g = _mm_packus_epi16(
+        _mm_sub_epi16(y_lo, _mm_unpacklo_epi16(ga, ga)),
+        _mm_sub_epi16(y_hi, _mm_unpackhi_epi16(ga, ga)));
+    __m128i b = _mm_packus_epi16(
+        _mm_add_epi16(y_lo, _mm_unpacklo_epi16(ba, ba)),
+        _mm_add_epi16(y_hi, _mm_unpackhi_epi16(ba, ba)));
+    if (kDstC == 3) {
+      Interleave3(b, g, r, dst + j * 3);
+    } else {
+      Interleave4(b, g, r, alpha, dst + j * 4);
+    }
+  }
+  NvRowScalar<kDstC>(y, vu, dst, j, w, v_num, u_num);
+}
+
+template <int kDstC>
+void NvToBgr(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, int v_num) {
+  int u_num = 1 - v_num;
+  const uint8_t* vu = src + srch * srcw;
+  bool sse41 = GetCvIsa() >= CvIsa::kSse41;
+  for (int i = 0; i < srch; i++) {
+    const uint8_t* y_row = src + i * srcw;
+    const uint8_t* vu_row = vu + (i / 2) * srcw;
+    uint8_t* dst_row = dst + i * srcw * kDstC;
+    if (sse41) {
+      NvRowSse41<kDstC>(y_row, vu_row, dst_row, srcw, v_num, u_num);
+    } else {
+      NvRowScalar<kDstC>(y_row, vu_row, dst_row, 0, srcw, v_num, u_num);
+    }
+  }
+}
+
+// nv21: v_num = 0, u_num = 1; nv12: v_num = 1, u_num = 0.
+void nv21_to_bgr(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  NvToBgr<3>(src, dst, srcw, srch, 0);
+}
+void nv12_to_bgr(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  NvToBgr<3>(src, dst, srcw, srch, 1);
+}
+void nv21_to_bgra(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  NvToBgr<4>(src, dst, srcw, srch, 0);
+}
+void nv12_to_bgra(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  NvToBgr<4>(src, dst, srcw, srch, 1);
+}
+
+// bgra rgba to gray
+void hwc4_to_hwc1(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ToGrayScalar<4>, ToGraySse41<4>, src, dst, srcw, srch);
+}
+// bgr rgb to gray
+void hwc3_to_hwc1(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ToGrayScalar<3>, ToGraySse41<3>, src, dst, srcw, srch);
+}
+// gray to bgr rgb
+void hwc1_to_hwc3(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(FromGrayScalar<3>, FromGraySse41<3>, src, dst, srcw, srch);
+}
+// gray to bgra rgba
+void hwc1_to_hwc4(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(FromGrayScalar<4>, FromGraySse41<4>, src, dst, srcw, srch);
+}
+// bgr to bgra or rgb to rgba
+void hwc3_to_hwc4(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ReorderScalar<3, 4, false>,
+                ReorderSse41<3, 4, false>,
+                src,
+                dst,
+                srcw,
+                srch);
+}
+// bgra to bgr or rgba to rgb
+void hwc4_to_hwc3(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ReorderScalar<4, 3, false>,
+                ReorderSse41<4, 3, false>,
+                src,
+                dst,
+                srcw,
+                srch);
+}
+// bgr to rgb or rgb to bgr
+void hwc3_trans(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ReorderScalar<3, 3, true>,
+                ReorderSse41<3, 3, true>,
+                src,
+                dst,
+                srcw,
+                srch);
+}
+// bgra to rgba or rgba to bgra
+void hwc4_trans(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ReorderScalar<4, 4, true>,
+                ReorderSse41<4, 4, true>,
+                src,
+                dst,
+                srcw,
+                srch);
+}
+// bgra to rgb or rgba to bgr
+void hwc4_trans_hwc3(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ReorderScalar<4, 3, true>,
+                ReorderSse41<4, 3, true>,
+                src,
+                dst,
+                srcw,
+                srch);
+}
+// bgr to rgba or rgb to bgra
+void hwc3_trans_hwc4(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  ConvertPixels(ReorderScalar<3, 4, true>,
+                ReorderSse41<3, 4, true>,
+                src,
+                dst,
+                srcw,
+                srch);
+}
+
+}  // namespace
+
+/*
+ * image color convert, the same formats as the arm version:
+ * NV12/NV21 to BGR(RGB) and BGRA(RGBA), GRAY, BGR(RGB) and BGRA(RGBA) to
+ * each other.
+ */
+void ImageConvert::choose(const uint8_t* src,
+                          uint8_t* dst,
+                          ImageFormat srcFormat,
+                          ImageFormat dstFormat,
+                          int srcw,
+                          int srch) {
+  if (srcFormat == dstFormat) {
+    // copy
+    int size = srcw * srch;
+    if (srcFormat == NV12 || srcFormat == NV21) {
+      size = srcw * (ceil(1.5 * srch));
+    } else if (srcFormat == BGR || srcFormat == RGB) {
+      size = 3 * srcw * srch;
+    } else if (srcFormat == BGRA || srcFormat == RGBA) {
+      size = 4 * srcw * srch;
+    }
+    memcpy(dst, src, sizeof(uint8_t) * size);
+    return;
+  }
+  impl_ = nullptr;
+  if (srcFormat == NV12 && (dstFormat == BGR || dstFormat == RGB)) {
+    impl_ = nv12_to_bgr;
+  } else if (srcFormat == NV21 && (dstFormat == BGR || dstFormat == RGB)) {
+    impl_ = nv21_to_bgr;
+  } else if (srcFormat == NV12 && (dstFormat == BGRA || dstFormat == RGBA)) {
+    impl_ = nv12_to_bgra;
+  } else if (srcFormat == NV21 && (dstFormat == BGRA || dstFormat == RGBA)) {
+    impl_ = nv21_to_bgra;
+  } else if ((srcFormat == RGBA && dstFormat == RGB) ||
+             (srcFormat == BGRA && dstFormat == BGR)) {
+    impl_ = hwc4_to_hwc3;
+  } else if ((srcFormat == RGB && dstFormat == RGBA) ||
+             (srcFormat == BGR && dstFormat == BGRA)) {
+    impl_ = hwc3_to_hwc4;
+  } else if ((srcFormat == RGB && dstFormat == BGR) ||
+             (srcFormat == BGR && dstFormat == RGB)) {
+    impl_ = hwc3_trans;
+  } else if ((srcFormat == RGBA && dstFormat == BGRA) ||
+             (srcFormat == BGRA && dstFormat == RGBA)) {
+    impl_ = hwc4_trans;
+  } else if ((srcFormat == RGB && dstFormat == GRAY) ||
+             (srcFormat == BGR && dstFormat == GRAY)) {
+    impl_ = hwc3_to_hwc1;
+  } else if ((srcFormat == GRAY && dstFormat == RGB) ||
+             (srcFormat == GRAY && dstFormat == BGR)) {
+    impl_ = hwc1_to_hwc3;
+  } else if ((srcFormat == RGBA && dstFormat == BGR) ||
+             (srcFormat == BGRA && dstFormat == RGB)) {
+    impl_ = hwc4_trans_hwc3;
+  } else if ((srcFormat == RGB && dstFormat == BGRA) ||
+             (srcFormat == BGR && dstFormat == RGBA)) {
+    impl_ = hwc3_trans_hwc4;
+  } else if ((srcFormat == GRAY && dstFormat == RGBA) ||
+             (srcFormat == GRAY && dstFormat == BGRA)) {
+    impl_ = hwc1_to_hwc4;
+  } else if ((srcFormat == RGBA && dstFormat == GRAY) ||
+             (srcFormat == BGRA && dstFormat == GRAY)) {
+    impl_ = hwc4_to_hwc1;
+  } else {
+    printf("srcFormat: %d, dstFormat: %d does not support! \n",
+           srcFormat,
+           dstFormat);
+    return;
+  }
+  impl_(src, dst, srcw, srch);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
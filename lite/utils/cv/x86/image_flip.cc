@@ -0,0 +1,173 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image_flip.h"
+#include <string.h>
+#include "lite/utils/cv/x86/cv_simd.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+// Writes the n pixels of kC channels at src in the reverse order to dst.
+template <int kC>
+void ReverseScalar(const uint8_t* src, uint8_t* dst, int n) {
+  const uint8_t* s = src + (n - 1) * kC;
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < kC; k++) {
+      dst[k] = s[k];
+    }
+    s -= kC;
+    dst += kC;
+  }
+}
+
+template <int kC>
+LITE_CV_SSE41 void ReverseSse41(const uint8_t* src, uint8_t* dst, int n) {
+  const __m128i reverse_bytes =
+      _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  // Each register holds 16 pixels of one channel or 4 pixels of 4 channels.
+  const int step = kC == 4 ? 4 : 16;
+  int i = 0;
+  for (; i + step <= n; i += step) {
+    const uint8_t* s = src + (n - i - step) * kC;
+    uint8_t* d = dst + i * kC;
+    if (kC == 1) {
+      Store16(d, _mm_shuffle_epi8(Load16(s), reverse_bytes));
+    } else if (kC == 4) {
+      Store16(d, _mm_shuffle_epi32(Load16(s), _MM_SHUFFLE(0, 1, 2, 3)));
+    } else {
+      __m128i p[3];
+      Deinterleave3(s, p);
+      Interleave3(_mm_shuffle_epi8(p[0], reverse_bytes),
+                  _mm_shuffle_epi8(p[1], reverse_bytes),
+                  _mm_shuffle_epi8(p[2], reverse_bytes),
+                  d);
+    }
+  }
+  ReverseScalar<kC>(src, dst + i * kC, n - i);
+}
+
+template <int kC>
+LITE_CV_AVX2 void ReverseAvx2(const uint8_t* src, uint8_t* dst, int n) {
+  const __m256i reverse_bytes = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+  const __m256i reverse_dwords = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+  const int step = kC == 4 ? 8 : 32;
+  int i = 0;
+  for (; i + step <= n; i += step) {
+    const __m256i* s =
+        reinterpret_cast<const __m256i*>(src + (n - i - step) * kC);
+    __m256i* d = reinterpret_cast<__m256i*>(dst + i * kC);
+    __m256i v = _mm256_loadu_si256(s);
+    if (kC == 1) {
+      // Reverses the bytes in each 128-bit lane, then swaps the lanes.
+      v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse_bytes),
+                                   _MM_SHUFFLE(1, 0, 3, 2));
+    } else {
+      v = _mm256_permutevar8x32_epi32(v, reverse_dwords);
+    }
+    _mm256_storeu_si256(d, v);
+  }
+  ReverseScalar<kC>(src, dst + i * kC, n - i);
+}
+
+template <int kC>
+void Reverse(CvIsa isa, const uint8_t* src, uint8_t* dst, int n) {
+  // The 3-channel pixels are reversed by the SSE4.1 shuffles.
+  if (isa == CvIsa::kAvx2 && kC != 3) {
+    ReverseAvx2<kC>(src, dst, n);
+  } else if (isa >= CvIsa::kSse41) {
+    ReverseSse41<kC>(src, dst, n);
+  } else {
+    ReverseScalar<kC>(src, dst, n);
+  }
+}
+
+/*
+ * flip X reverses the rows, flip Y reverses the pixels of each row and flip
+ * XY does both.
+ */
+template <int kC>
+void Flip(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, FlipParam flip) {
+  if (flip != X && flip != Y && flip != XY) {
+    printf("this flip_param: %d does not support! \n", flip);
+    return;
+  }
+  CvIsa isa = GetCvIsa();
+  int64_t row_size = static_cast<int64_t>(srcw) * kC;
+  for (int i = 0; i < srch; i++) {
+    const uint8_t* src_row = src + i * row_size;
+    int out_row = flip == Y ? i : srch - 1 - i;
+    uint8_t* dst_row = dst + out_row * row_size;
+    if (flip == X) {
+      memcpy(dst_row, src_row, row_size);
+    } else {
+      Reverse<kC>(isa, src_row, dst_row, srcw);
+    }
+  }
+}
+
+}  // namespace
+
+void ImageFlip::choose(const uint8_t* src,
+                       uint8_t* dst,
+                       ImageFormat srcFormat,
+                       int srcw,
+                       int srch,
+                       FlipParam flip_param) {
+  if (srcFormat == GRAY) {
+    flip_hwc1(src, dst, srcw, srch, flip_param);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    flip_hwc3(src, dst, srcw, srch, flip_param);
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    flip_hwc4(src, dst, srcw, srch, flip_param);
+  } else {
+    printf("this srcFormat: %d does not support! \n", srcFormat);
+    return;
+  }
+}
+
+void flip_hwc1(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  Flip<1>(src, dst, srcw, srch, flip_param);
+}
+
+void flip_hwc3(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  Flip<3>(src, dst, srcw, srch, flip_param);
+}
+
+void flip_hwc4(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  Flip<4>(src, dst, srcw, srch, flip_param);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,276 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image_resize.h"
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "lite/utils/cv/x86/cv_simd.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+/*
+ * The bilinear resize in fixed point as the arm version: the weights have 11
+ * bits, a row is resized horizontally into int16 values with 7 fraction
+ * bits, and two of such rows are blended vertically. The horizontal pass
+ * gathers the source pixels by the precomputed offsets, the vertical pass is
+ * vectorized by SSE4.1 or AVX2, a resized row is reused by the next output
+ * row when it maps to the same source row.
+ */
+const int kResizeCoefBits = 11;
+const int kResizeCoefScale = 1 << kResizeCoefBits;
+
+inline int16_t SaturateCastShort(float x) {
+  int v = static_cast<int>(x + (x >= 0.f ? 0.5f : -0.5f));
+  return static_cast<int16_t>(std::min(std::max(v, SHRT_MIN), SHRT_MAX));
+}
+
+// The two source coordinates and their weights of each output coordinate.
+void ComputeResizeCoefs(
+    int src_len, int dst_len, int* ofs0, int* ofs1, int16_t* coefs) {
+  double scale = static_cast<double>(src_len) / dst_len;
+  for (int d = 0; d < dst_len; d++) {
+    float f = static_cast<float>((d + 0.5) * scale - 0.5);
+    int s = floor(f);
+    f -= s;
+    if (s < 0) {
+      s = 0;
+      f = 0.f;
+    }
+    if (s >= src_len - 1) {
+      s = src_len - 1;
+      f = 0.f;
+    }
+    ofs0[d] = s;
+    ofs1[d] = std::min(s + 1, src_len - 1);
+    coefs[2 * d] = SaturateCastShort((1.f - f) * kResizeCoefScale);
+    coefs[2 * d + 1] = SaturateCastShort(f * kResizeCoefScale);
+  }
+}
+
+template <int kC>
+void HResizeRow(const uint8_t* src,
+                const int* xofs0,
+                const int* xofs1,
+                const int16_t* alpha,
+                int dstw,
+                int16_t* row) {
+  for (int dx = 0; dx < dstw; dx++) {
+    const uint8_t* s0 = src + xofs0[dx] * kC;
+    const uint8_t* s1 = src + xofs1[dx] * kC;
+    int a0 = alpha[2 * dx];
+    int a1 = alpha[2 * dx + 1];
+    for (int k = 0; k < kC; k++) {
+      row[k] = (s0[k] * a0 + s1[k] * a1) >> 4;
+    }
+    row += kC;
+  }
+}
+
+void VResizeScalar(const int16_t* row0,
+                   const int16_t* row1,
+                   int16_t b0,
+                   int16_t b1,
+                   uint8_t* dst,
+                   int begin,
+                   int n) {
+  for (int i = begin; i < n; i++) {
+    dst[i] = static_cast<uint8_t>(
+        (((b0 * row0[i]) >> 16) + ((b1 * row1[i]) >> 16) + 2) >> 2);
+  }
+}
+
+LITE_CV_SSE41 void VResizeSse41(const int16_t* row0,
+                                const int16_t* row1,
+                                int16_t b0,
+                                int16_t b1,
+                                uint8_t* dst,
+                                int n) {
+  const __m128i vb0 = _mm_set1_epi16(b0);
+  const __m128i vb1 = _mm_set1_epi16(b1);
+  const __m128i two = _mm_set1_epi16(2);
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i v[2];
+    for (int k = 0; k < 2; k++) {
+      const __m128i* r0 = reinterpret_cast<const __m128i*>(row0 + i + 8 * k);
+      const __m128i* r1 = reinterpret_cast<const __m128i*>(row1 + i + 8 * k);
+      // mulhi is (row * b) >> 16.
+      __m128i sum = _mm_add_epi16(_mm_mulhi_epi16(_mm_loadu_si128(r0), vb0),
+                                  _mm_mulhi_epi16(_mm_loadu_si128(r1), vb1));
+      v[k] = _mm_srai_epi16(_mm_add_epi16(sum, two), 2);
+    }
+    Store16(dst + i, _mm_packus_epi16(v[0], v[1]));
+  }
+  VResizeScalar(row0, row1, b0, b1, dst, i, n);
+}
+
+LITE_CV_AVX2 void VResizeAvx2(const int16_t* row0,
+                              const int16_t* row1,
+                              int16_t b0,
+                              int16_t b1,
+                              uint8_t* dst,
+                              int n) {
+  const __m256i vb0 = _mm256_set1_epi16(b0);
+  const __m256i vb1 = _mm256_set1_epi16(b1);
+  const __m256i two = _mm256_set1_epi16(2);
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i v[2];
+    for (int k = 0; k < 2; k++) {
+      const __m256i* r0 = reinterpret_cast<const __m256i*>(row0 + i + 16 * k);
+      const __m256i* r1 = reinterpret_cast<const __m256i*>(row1 + i + 16 * k);
+      __m256i sum =
+          _mm256_add_epi16(_mm256_mulhi_epi16(_mm256_loadu_si256(r0), vb0),
+                           _mm256_mulhi_epi16(_mm256_loadu_si256(r1), vb1));
+      v[k] = _mm256_srai_epi16(_mm256_add_epi16(sum, two), 2);
+    }
+    // packus works in 128-bit lanes, the permute restores the order.
+    __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(v[0], v[1]), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+  }
+  VResizeScalar(row0, row1, b0, b1, dst, i, n);
+}
+
+void VResize(CvIsa isa,
+             const int16_t* row0,
+             const int16_t* row1,
+             int16_t b0,
+             int16_t b1,
+             uint8_t* dst,
+             int n) {
+  if (isa == CvIsa::kAvx2) {
+    VResizeAvx2(row0, row1, b0, b1, dst, n);
+  } else if (isa == CvIsa::kSse41) {
+    VResizeSse41(row0, row1, b0, b1, dst, n);
+  } else {
+    VResizeScalar(row0, row1, b0, b1, dst, 0, n);
+  }
+}
+
+// Resizes an image of kC interleaved channels.
+template <int kC>
+void ResizePlane(const uint8_t* src,
+                 int srcw,
+                 int srch,
+                 uint8_t* dst,
+                 int dstw,
+                 int dsth) {
+  if (srcw <= 0 || srch <= 0 || dstw <= 0 || dsth <= 0) return;
+  std::vector<int> xofs(dstw * 2);
+  std::vector<int> yofs(dsth * 2);
+  std::vector<int16_t> alpha(dstw * 2);
+  std::vector<int16_t> beta(dsth * 2);
+  ComputeResizeCoefs(srcw, dstw, xofs.data(), xofs.data() + dstw, alpha.data());
+  ComputeResizeCoefs(srch, dsth, yofs.data(), yofs.data() + dsth, beta.data());
+
+  int row_size = dstw * kC;
+  std::vector<int16_t> rows(row_size * 2);
+  int16_t* bufs[2] = {rows.data(), rows.data() + row_size};
+  int cached[2] = {-1, -1};
+  // Returns the resized source row y, it's kept in the buffer not holding
+  // the row other.
+  auto resized_row = [&](int y, int other) -> const int16_t* {
+    for (int k = 0; k < 2; k++) {
+      if (cached[k] == y) return bufs[k];
+    }
+    int k = cached[0] == other ? 1 : 0;
+    HResizeRow<kC>(src + static_cast<int64_t>(y) * srcw * kC,
+                   xofs.data(),
+                   xofs.data() + dstw,
+                   alpha.data(),
+                   dstw,
+                   bufs[k]);
+    cached[k] = y;
+    return bufs[k];
+  };
+  CvIsa isa = GetCvIsa();
+  for (int dy = 0; dy < dsth; dy++) {
+    int y0 = yofs[dy];
+    int y1 = yofs[dsth + dy];
+    const int16_t* row0 = resized_row(y0, y1);
+    const int16_t* row1 = resized_row(y1, y0);
+    VResize(isa,
+            row0,
+            row1,
+            beta[2 * dy],
+            beta[2 * dy + 1],
+            dst + static_cast<int64_t>(dy) * row_size,
+            row_size);
+  }
+}
+
+}  // namespace
+
+void ImageResize::choose(const uint8_t* src,
+                         uint8_t* dst,
+                         ImageFormat srcFormat,
+                         int srcw,
+                         int srch,
+                         int dstw,
+                         int dsth) {
+  resize(src, dst, srcFormat, srcw, srch, dstw, dsth);
+}
+
+void resize(const uint8_t* src,
+            uint8_t* dst,
+            ImageFormat srcFormat,
+            int srcw,
+            int srch,
+            int dstw,
+            int dsth) {
+  int size = srcw * srch;
+  if (srcw == dstw && srch == dsth) {
+    if (srcFormat == NV12 || srcFormat == NV21) {
+      size = srcw * (static_cast<int>(1.5 * srch));
+    } else if (srcFormat == BGR || srcFormat == RGB) {
+      size = 3 * srcw * srch;
+    } else if (srcFormat == BGRA || srcFormat == RGBA) {
+      size = 4 * srcw * srch;
+    }
+    memcpy(dst, src, sizeof(uint8_t) * size);
+    return;
+  }
+  if (srcFormat == GRAY) {
+    ResizePlane<1>(src, srcw, srch, dst, dstw, dsth);
+  } else if (srcFormat == NV12 || srcFormat == NV21) {
+    // y, then the interleaved vu of the half size.
+    ResizePlane<1>(src, srcw, srch, dst, dstw, dsth);
+    ResizePlane<2>(src + srch * srcw,
+                   srcw / 2,
+                   srch / 2,
+                   dst + dsth * dstw,
+                   dstw / 2,
+                   dsth / 2);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    ResizePlane<3>(src, srcw, srch, dst, dstw, dsth);
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    ResizePlane<4>(src, srcw, srch, dst, dstw, dsth);
+  } else {
+    printf("this srcFormat: %d does not support! \n", srcFormat);
+  }
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,225 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image_rotate.h"
+#include <algorithm>
+#include "lite/utils/cv/image_flip.h"
+#include "lite/utils/cv/x86/cv_simd.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+const int kBlockSize = 32;
+
+/*
+ * Rotating by 90 degrees moves the pixel (x, y) of the input row x and
+ * column y to (y, srch - 1 - x), by 270 degrees to (srcw - 1 - y, x). The
+ * output is srch wide and srcw high, it's written by square tiles which are
+ * transposed in registers: 8 x 8 pixels of 1 channel or 4 x 4 pixels of 4
+ * channels. The 3-channel pixels and the borders are copied one by one.
+ */
+template <int kC>
+void RotatePixels(const uint8_t* src,
+                  uint8_t* dst,
+                  int srcw,
+                  int srch,
+                  bool clockwise,
+                  int x_begin,
+                  int x_end,
+                  int y_begin,
+                  int y_end) {
+  for (int x = x_begin; x < x_end; x++) {
+    const uint8_t* in = src + (static_cast<int64_t>(x) * srcw + y_begin) * kC;
+    for (int y = y_begin; y < y_end; y++) {
+      int row = clockwise ? y : srcw - 1 - y;
+      int col = clockwise ? srch - 1 - x : x;
+      uint8_t* out = dst + (static_cast<int64_t>(row) * srch + col) * kC;
+      for (int k = 0; k < kC; k++) {
+        out[k] = in[k];
+      }
+      in += kC;
+    }
+  }
+}
+
+// Loads the tile rows in the reverse order when clockwise, so the columns of
+// the transposed tile are in the order of the output.
+LITE_CV_SSE41 void RotateTile8x8(const uint8_t* src,
+                                 uint8_t* dst,
+                                 int srcw,
+                                 int srch,
+                                 bool clockwise,
+                                 int x0,
+                                 int y0) {
+  __m128i a[8];
+  for (int c = 0; c < 8; c++) {
+    int x = clockwise ? x0 + 7 - c : x0 + c;
+    a[c] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(
+        src + static_cast<int64_t>(x) * srcw + y0));
+  }
+  __m128i t0 = _mm_unpacklo_epi8(a[0], a[1]);
+  __m128i t1 = _mm_unpacklo_epi8(a[2], a[3]);
+  __m128i t2 = _mm_unpacklo_epi8(a[4], a[5]);
+  __m128i t3 = _mm_unpacklo_epi8(a[6], a[7]);
+  __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+  __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+  __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+  __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+  // Each register holds two rows of the transposed tile.
+  __m128i v[4] = {_mm_unpacklo_epi32(u0, u2),
+                  _mm_unpackhi_epi32(u0, u2),
+                  _mm_unpacklo_epi32(u1, u3),
+                  _mm_unpackhi_epi32(u1, u3)};
+  int col = clockwise ? srch - 8 - x0 : x0;
+  for (int r = 0; r < 8; r++) {
+    int row = clockwise ? y0 + r : srcw - 1 - y0 - r;
+    __m128i rows = v[r / 2];
+    if (r % 2) rows = _mm_srli_si128(rows, 8);
+    _mm_storel_epi64(
+        reinterpret_cast<__m128i*>(dst + static_cast<int64_t>(row) * srch +
+                                   col),
+        rows);
+  }
+}
+
+LITE_CV_SSE41 void RotateTile4x4(const uint8_t* src,
+                                 uint8_t* dst,
+                                 int srcw,
+                                 int srch,
+                                 bool clockwise,
+                                 int x0,
+                                 int y0) {
+  __m128i a[4];
+  for (int c = 0; c < 4; c++) {
+    int x = clockwise ? x0 + 3 - c : x0 + c;
+    a[c] = Load16(src + (static_cast<int64_t>(x) * srcw + y0) * 4);
+  }
+  __m128i t0 = _mm_unpacklo_epi32(a[0], a[1]);
+  __m128i t1 = _mm_unpacklo_epi32(a[2], a[3]);
+  __m128i t2 = _mm_unpackhi_epi32(a[0], a[1]);
+  __m128i t3 = _mm_unpackhi_epi32(a[2], a[3]);
+  __m128i v[4] = {_mm_unpacklo_epi64(t0, t1),
+                  _mm_unpackhi_epi64(t0, t1),
+                  _mm_unpacklo_epi64(t2, t3),
+                  _mm_unpackhi_epi64(t2, t3)};
+  int col = clockwise ? srch - 4 - x0 : x0;
+  for (int r = 0; r < 4; r++) {
+    int row = clockwise ? y0 + r : srcw - 1 - y0 - r;
+    Store16(dst + (static_cast<int64_t>(row) * srch + col) * 4, v[r]);
+  }
+}
+
+template <int kC>
+void RotateQuarter(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, bool clockwise) {
+  int tile = kC == 1 ? 8 : (kC == 4 ? 4 : 0);
+  int x_tiled = 0;
+  int y_tiled = 0;
+  if (tile > 0 && GetCvIsa() >= CvIsa::kSse41) {
+    x_tiled = srch / tile * tile;
+    y_tiled = srcw / tile * tile;
+    for (int x0 = 0; x0 < x_tiled; x0 += tile) {
+      for (int y0 = 0; y0 < y_tiled; y0 += tile) {
+        if (kC == 1) {
+          RotateTile8x8(src, dst, srcw, srch, clockwise, x0, y0);
+        } else {
+          RotateTile4x4(src, dst, srcw, srch, clockwise, x0, y0);
+        }
+      }
+    }
+  }
+  if (tile == 0) {
+    // The 3-channel pixels are copied by blocks, so the output rows written
+    // by a block stay in cache.
+    for (int x0 = 0; x0 < srch; x0 += kBlockSize) {
+      int x1 = std::min(x0 + kBlockSize, srch);
+      for (int y0 = 0; y0 < srcw; y0 += kBlockSize) {
+        int y1 = std::min(y0 + kBlockSize, srcw);
+        RotatePixels<kC>(src, dst, srcw, srch, clockwise, x0, x1, y0, y1);
+      }
+    }
+    return;
+  }
+  // The right columns of the tiled rows, then the bottom rows.
+  RotatePixels<kC>(src, dst, srcw, srch, clockwise, 0, x_tiled, y_tiled, srcw);
+  RotatePixels<kC>(src, dst, srcw, srch, clockwise, x_tiled, srch, 0, srcw);
+}
+
+template <int kC>
+void Rotate(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  if (degree == 90) {
+    RotateQuarter<kC>(src, dst, srcw, srch, true);
+  } else if (degree == 180) {
+    // The same as flipping along XY.
+    if (kC == 1) {
+      flip_hwc1(src, dst, srcw, srch, XY);
+    } else if (kC == 3) {
+      flip_hwc3(src, dst, srcw, srch, XY);
+    } else {
+      flip_hwc4(src, dst, srcw, srch, XY);
+    }
+  } else if (degree == 270) {
+    RotateQuarter<kC>(src, dst, srcw, srch, false);
+  } else {
+    printf("this degree: %f does not support! \n", degree);
+  }
+}
+
+}  // namespace
+
+void ImageRotate::choose(const uint8_t* src,
+                         uint8_t* dst,
+                         ImageFormat srcFormat,
+                         int srcw,
+                         int srch,
+                         float degree) {
+  if (degree != 90 && degree != 180 && degree != 270) {
+    printf("this degree: %f not support \n", degree);
+  }
+  if (srcFormat == GRAY) {
+    rotate_hwc1(src, dst, srcw, srch, degree);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    rotate_hwc3(src, dst, srcw, srch, degree);
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    rotate_hwc4(src, dst, srcw, srch, degree);
+  } else {
+    printf("this srcFormat: %d does not support! \n", srcFormat);
+    return;
+  }
+}
+
+void rotate_hwc1(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  Rotate<1>(src, dst, srcw, srch, degree);
+}
+
+void rotate_hwc3(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  Rotate<3>(src, dst, srcw, srch, degree);
+}
+
+void rotate_hwc4(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  Rotate<4>(src, dst, srcw, srch, degree);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
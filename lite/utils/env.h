@@ -33,6 +33,20 @@
 // target device model online during the execution phase.
 #define SUBGRAPH_ONLINE_MODE "SUBGRAPH_ONLINE_MODE"
 
+// The weights of the x86 and ARM fc/mul/matmul/conv2d ops are quantized to
+// 'WEIGHT_ONLY_QUANT_BITS'(8 or 4) bits during the analysis phase, the
+// default 0 disables it.
+#define WEIGHT_ONLY_QUANT_BITS "WEIGHT_ONLY_QUANT_BITS"
+
+// The weights packed by the kernels(eg. the arm gemm and winograd conv) are
+// saved with the optimized model if 'PREPACK_WEIGHTS' is set to true when the
+// model is saved by the full api after running once on the target device.
+#define PREPACK_WEIGHTS "PREPACK_WEIGHTS"
+
+// The identical params of the models loaded by the light api in one process
+// share one buffer if 'SHARE_MODEL_PARAMS' is set to true, see ParamStore.
+#define SHARE_MODEL_PARAMS "SHARE_MODEL_PARAMS"
+
 namespace paddle {
 namespace lite {
 
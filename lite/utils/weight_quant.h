@@ -0,0 +1,105 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * The weight-only quantized [K, N] weights keep one fp32 scale per output
+ * column, w[k][n] = q[k][n] * scale[n].
+ * - 8 bits: q is a [K, N] int8 matrix.
+ * - 4 bits: q is a [(K + 1) / 2, N] int8 matrix, the rows 2i and 2i + 1 are
+ *   packed into the low and the high nibble of the row i, in [-7, 7].
+ */
+inline int64_t QuantWeightRows(int K, int bits) {
+  CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+  return bits == 8 ? K : (K + 1) / 2;
+}
+
+// Returns the quantized value of the row k and the column n.
+inline int QuantWeightAt(const int8_t* q, int N, int bits, int k, int n) {
+  if (bits == 8) {
+    return q[static_cast<int64_t>(k) * N + n];
+  }
+  int8_t b = q[static_cast<int64_t>(k / 2) * N + n];
+  if (k & 1) {
+    return b >> 4;
+  }
+  return static_cast<int8_t>(static_cast<uint8_t>(b) << 4) >> 4;
+}
+
+// Quantizes the fp32 [K, N] weights with the abs max of each column.
+inline void QuantizeWeight(
+    const float* w, int K, int N, int bits, int8_t* q, float* scale) {
+  const int qmax = (1 << (bits - 1)) - 1;
+  for (int n = 0; n < N; n++) {
+    float abs_max = 0.f;
+    for (int k = 0; k < K; k++) {
+      abs_max =
+          std::max(abs_max, std::fabs(w[static_cast<int64_t>(k) * N + n]));
+    }
+    scale[n] = abs_max / qmax;
+  }
+  memset(q, 0, QuantWeightRows(K, bits) * N);
+  for (int k = 0; k < K; k++) {
+    for (int n = 0; n < N; n++) {
+      int v = 0;
+      if (scale[n] > 0.f) {
+        v = static_cast<int>(
+            std::round(w[static_cast<int64_t>(k) * N + n] / scale[n]));
+        v = std::min(std::max(v, -qmax), qmax);
+      }
+      if (bits == 8) {
+        q[static_cast<int64_t>(k) * N + n] = static_cast<int8_t>(v);
+      } else {
+        auto& b = q[static_cast<int64_t>(k / 2) * N + n];
+        b = static_cast<int8_t>(b | ((v & 0xF) << ((k & 1) ? 4 : 0)));
+      }
+    }
+  }
+}
+
+// Restores the fp32 rows [k, k + rows) of the weights into a [rows, N] matrix.
+inline void DequantizeWeight(const int8_t* q,
+                             const float* scale,
+                             int k,
+                             int rows,
+                             int N,
+                             int bits,
+                             float* w) {
+  for (int r = 0; r < rows; r++) {
+    float* dst = w + static_cast<int64_t>(r) * N;
+    if (bits == 8) {
+      const int8_t* src = q + static_cast<int64_t>(k + r) * N;
+      for (int n = 0; n < N; n++) {
+        dst[n] = src[n] * scale[n];
+      }
+    } else {
+      for (int n = 0; n < N; n++) {
+        dst[n] = QuantWeightAt(q, N, bits, k + r, n) * scale[n];
+      }
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle